@@ -23,6 +23,7 @@
 #include "RG.h"
 #include "GraphBLAS.h"
 #include "LAGraph_bfs.h"
+#include "../../query_ctx.h"
 
 //****************************************************************************
 int LG_BreadthFirstSearch_SSGrB
@@ -122,6 +123,9 @@ int LG_BreadthFirstSearch_SSGrB
 
 	for (int64_t nvisited = 1, k = 1 ; nvisited < n ; nvisited += nq, k++)
 	{
+		// stop the search once the query timed out
+		if (QueryCtx_TimedOut ( )) break ;
+
 		//----------------------------------------------------------------------
 		// q = kth level of the BFS
 		//----------------------------------------------------------------------
@@ -9,6 +9,10 @@
 #include "all_shortest_paths.h"
 #include "../util/arr.h"
 #include "../util/rmalloc.h"
+#include "../query_ctx.h"
+
+// number of traversal steps between query timeout checks
+#define TIMEOUT_CHECK_INTERVAL 1024
 
 // Make sure context level array have 'cap' available entries.
 static void _AllPathsCtx_EnsureLevelArrayCap(AllPathsCtx *ctx, uint level, uint cap) {
@@ -232,8 +236,16 @@ AllPathsCtx *AllPathsCtx_New
 }
 
 static Path *_AllPathsCtx_NextPath(AllPathsCtx *ctx) {
+	uint steps = 0;
+
 	// As long as path is not empty OR there are neighbors to traverse.
 	while(Path_NodeCount(ctx->path) || _AllPathsCtx_LevelNotEmpty(ctx, 0)) {
+		// a traversal might go on for long without producing a path
+		// stop once the query timed out
+		if(++steps % TIMEOUT_CHECK_INTERVAL == 0 && QueryCtx_TimedOut()) {
+			return NULL;
+		}
+
 		uint32_t depth = Path_NodeCount(ctx->path);
 
 		// Can we advance?
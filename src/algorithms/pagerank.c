@@ -25,6 +25,7 @@
 */
 
 #include "pagerank.h"
+#include "../query_ctx.h"
 #include "../util/rmalloc.h"
 #include <assert.h>
 
@@ -161,6 +162,9 @@ GrB_Info Pagerank               // GrB_SUCCESS or error condition
 
 	for((*iters) = 0 ; (*iters) < itermax && rdiff > ftol ; (*iters)++) {
 
+		// stop iterating once the query timed out
+		if(QueryCtx_TimedOut()) break ;
+
 		//----------------------------------------------------------------------
 		// t = (r*C or C*r) + (teleport * sum (r)) ;
 		//----------------------------------------------------------------------
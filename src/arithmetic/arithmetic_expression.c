@@ -12,7 +12,9 @@
 #include "../errors.h"
 #include "../util/arr.h"
 #include "../query_ctx.h"
+#include "../util/arena.h"
 #include "../util/strcmp.h"
+#include "../util/strutil.h"
 #include "../graph/graph.h"
 #include "../util/rmalloc.h"
 #include "../graph/graphcontext.h"
@@ -46,6 +48,14 @@ static void _AR_EXP_ResolveVariables(AR_ExpNode *root, const Record r);
 // Clear an op node internals, without freeing the node allocation itself.
 static void _AR_EXP_FreeOpInternals(AR_ExpNode *op_node);
 
+// Discard an op node compiled program.
+static void _AR_EXP_Invalidate(AR_ExpNode *node);
+
+// Compiled program slot management.
+static AR_EXP_ProgramSlot *_AR_EXP_SlotNew(void);
+static AR_EXP_ProgramSlot *_AR_EXP_SlotShare(AR_EXP_ProgramSlot *slot);
+static void _AR_EXP_SlotRelease(AR_EXP_ProgramSlot *slot);
+
 inline bool AR_EXP_IsConstant(const AR_ExpNode *exp) {
 	return exp->type == AR_EXP_OPERAND && exp->operand.type == AR_EXP_CONSTANT;
 }
@@ -139,6 +149,8 @@ static AR_ExpNode *_AR_EXP_NewOpNode(uint child_count) {
 
 static AR_ExpNode *_AR_EXP_CloneOp(AR_ExpNode *exp) {
 	AR_ExpNode *clone = _AR_EXP_NewOpNode(exp->op.child_count);
+	// clones are compiled once, share the original tree's program
+	clone->op.slot = _AR_EXP_SlotShare(exp->op.slot);
 	/* If the function has private data, the function descriptor
 	 * itself should be cloned. Otherwise, we can perform a direct assignment. */
 	if(exp->op.f->bclone) clone->op.f = AR_CloneFuncDesc(exp->op.f);
@@ -153,6 +165,7 @@ static AR_ExpNode *_AR_EXP_CloneOp(AR_ExpNode *exp) {
 AR_ExpNode *AR_EXP_NewOpNode(const char *func_name, uint child_count) {
 
 	AR_ExpNode *node = _AR_EXP_NewOpNode(child_count);
+	node->op.slot = _AR_EXP_SlotNew();
 
 	// retrieve function
 	AR_FuncDesc *func = AR_GetFunc(func_name);
@@ -220,17 +233,16 @@ AR_ExpNode *AR_EXP_NewRecordNode() {
 	return _AR_EXP_InitializeOperand(AR_EXP_BORROW_RECORD);
 }
 
-/* Compact tree by evaluating constant expressions
- * e.g. MINUS(X) where X is a constant number will be reduced to
- * a single node with the value -X
- * PLUS(MINUS(A), B) will be reduced to a single constant: B-A. */
-bool AR_EXP_ReduceToScalar(AR_ExpNode *root, bool reduce_params, SIValue *val) {
+// see AR_EXP_ReduceToScalar, sets 'modified' if the tree was modified
+static bool _AR_EXP_ReduceToScalar(AR_ExpNode *root, bool reduce_params,
+		SIValue *val, bool *modified) {
 	if(val != NULL) *val = SI_NullVal();
 	if(root->type == AR_EXP_OPERAND) {
 		// In runtime, parameters are set so they can be evaluated
 		if(reduce_params && AR_EXP_IsParameter(root)) {
 			SIValue v = AR_EXP_Evaluate(root, NULL);
 			if(val != NULL) *val = v;
+			*modified = true;
 			return true;
 		}
 		if(AR_EXP_IsConstant(root)) {
@@ -247,12 +259,21 @@ bool AR_EXP_ReduceToScalar(AR_ExpNode *root, bool reduce_params, SIValue *val) {
 		/* See if we're able to reduce each child of root
 		 * if so we'll be able to reduce root. */
 		bool reduce_children = true;
+		bool children_modified = false;
 		for(int i = 0; i < root->op.child_count; i++) {
-			if(!AR_EXP_ReduceToScalar(root->op.children[i], reduce_params, NULL)) {
+			if(!_AR_EXP_ReduceToScalar(root->op.children[i], reduce_params, NULL,
+						&children_modified)) {
 				// Root reduce is not possible, but continue to reduce every reducable child.
 				reduce_children = false;
 			}
 		}
+
+		// tree changed, discard compiled program
+		if(children_modified) {
+			_AR_EXP_Invalidate(root);
+			*modified = true;
+		}
+
 		// Can't reduce root as one of its children is not a constant.
 		if(!reduce_children) return false;
 
@@ -271,15 +292,28 @@ bool AR_EXP_ReduceToScalar(AR_ExpNode *root, bool reduce_params, SIValue *val) {
 		root->type = AR_EXP_OPERAND;
 		root->operand.type = AR_EXP_CONSTANT;
 		root->operand.constant = v;
+		*modified = true;
 		return true;
 		// Root is an aggregation function, can't reduce.
 		return false;
 	}
 }
 
+/* Compact tree by evaluating constant expressions
+ * e.g. MINUS(X) where X is a constant number will be reduced to
+ * a single node with the value -X
+ * PLUS(MINUS(A), B) will be reduced to a single constant: B-A. */
+bool AR_EXP_ReduceToScalar(AR_ExpNode *root, bool reduce_params, SIValue *val) {
+	bool modified = false;
+	return _AR_EXP_ReduceToScalar(root, reduce_params, val, &modified);
+}
+
 static void _AR_EXP_OpResolveVariables(AR_ExpNode *node, const Record r) {
 	ASSERT(node->type == AR_EXP_OP);
 
+	// variables might be replaced, discard compiled program
+	_AR_EXP_Invalidate(node);
+
 	for(uint i = 0; i < node->op.child_count; i++) {
 		AR_ExpNode *child = node->op.children[i];
 		_AR_EXP_ResolveVariables(child, r);
@@ -523,9 +557,396 @@ static AR_EXP_Result _AR_EXP_Evaluate(AR_ExpNode *root, const Record r,
 	return res;
 }
 
+//------------------------------------------------------------------------------
+// Compiled evaluation
+//------------------------------------------------------------------------------
+
+// an expression tree is compiled into a flat program of instructions
+// listed in evaluation order, each instruction writes its result into register
+// 'dst' while operations read their arguments from the registers starting at
+// 'dst', such that the first child of an operation shares its register
+//
+// frequently used operations are given dedicated instructions which
+// skip invocation validation when their arguments' types are as expected
+// falling back to a generic function call otherwise
+
+typedef enum {
+	AR_INS_CONSTANT,  // load constant
+	AR_INS_VARIABLE,  // load record entry
+	AR_INS_RECORD,    // load record
+	AR_INS_PARAM,     // load query parameter
+	AR_INS_CALL,      // generic function call
+	AR_INS_ADD,       // numeric addition
+	AR_INS_EQ,        // equality comparison
+	AR_INS_NEQ,       // inequality comparison
+	AR_INS_LT,        // less than comparison
+	AR_INS_LE,        // less than or equal comparison
+	AR_INS_GT,        // greater than comparison
+	AR_INS_GE,        // greater than or equal comparison
+	AR_INS_PROPERTY,  // graph entity attribute access
+	AR_INS_TOLOWER,   // string lowercase
+} AR_InsCode;
+
+typedef struct {
+	AR_InsCode code;         // instruction code
+	uint dst;                // result register, arguments start here
+	uint argc;               // number of arguments
+	AR_FuncDesc *f;          // function to invoke
+	union {
+		SIValue constant;    // constant to load
+		uint idx;            // record entry to load
+		char *param;         // parameter to load
+		Attribute_ID attr;   // resolved attribute
+	};
+} AR_Instruction;
+
+// programs are immutable once compiled
+// such that a single program can serve concurrent evaluations
+// of the tree it was compiled from and of that tree's clones
+typedef struct {
+	AR_Instruction *instructions;  // instructions in evaluation order
+	uint register_count;           // number of registers required
+} AR_EXP_Program;
+
+typedef enum {
+	AR_SLOT_EMPTY,      // tree wasn't compiled yet
+	AR_SLOT_COMPILING,  // tree is being compiled
+	AR_SLOT_READY       // compilation attempted
+} AR_SlotState;
+
+// program slot, shared by a tree and its clones
+// the first tree to be evaluated compiles the program
+struct AR_EXP_ProgramSlot {
+	int refcount;             // number of trees sharing slot
+	int state;                // slot state
+	AR_EXP_Program *program;  // compiled program, NULL if tree can't be compiled
+};
+
+// maps function names to dedicated instruction codes
+static AR_InsCode _AR_EXP_InsCode(const AR_ExpNode *node) {
+	const char *name = node->op.f->name;
+
+	if(strcmp(name, "add")     == 0) return AR_INS_ADD;
+	if(strcmp(name, "eq")      == 0) return AR_INS_EQ;
+	if(strcmp(name, "neq")     == 0) return AR_INS_NEQ;
+	if(strcmp(name, "lt")      == 0) return AR_INS_LT;
+	if(strcmp(name, "le")      == 0) return AR_INS_LE;
+	if(strcmp(name, "gt")      == 0) return AR_INS_GT;
+	if(strcmp(name, "ge")      == 0) return AR_INS_GE;
+	if(strcmp(name, "tolower") == 0) return AR_INS_TOLOWER;
+	// attribute name and index are expected to be constants
+	if(strcmp(name, "property") == 0 &&
+	   AR_EXP_IsConstant(NODE_CHILD(node, 1)) &&
+	   AR_EXP_IsConstant(NODE_CHILD(node, 2))) return AR_INS_PROPERTY;
+
+	return AR_INS_CALL;
+}
+
+// compile 'node' into 'program', placing its result in register 'dst'
+// returns false if the expression can't be compiled
+static bool _AR_EXP_Compile(AR_ExpNode *node, const Record r, uint dst,
+		AR_EXP_Program *program) {
+	AR_Instruction ins = {.dst = dst, .argc = 0, .f = NULL};
+	uint registers = dst + 1;
+
+	if(AR_EXP_IsOperation(node)) {
+		// aggregation functions accumulate state, evaluate via tree
+		if(node->op.f->aggregate) return false;
+		// private data is bound to the tree, while programs are shared
+		if(node->op.f->privdata != NULL) return false;
+
+		// compile children into consecutive registers
+		for(uint i = 0; i < NODE_CHILD_COUNT(node); i++) {
+			if(!_AR_EXP_Compile(NODE_CHILD(node, i), r, dst + i, program)) {
+				return false;
+			}
+		}
+
+		ins.f    = node->op.f;
+		ins.argc = NODE_CHILD_COUNT(node);
+		ins.code = _AR_EXP_InsCode(node);
+		if(ins.code == AR_INS_PROPERTY) {
+			// resolve attribute once, attribute IDs never change
+			GraphContext *gc = QueryCtx_GetGraphCtx();
+			SIValue attr = NODE_CHILD(node, 1)->operand.constant;
+			ins.attr = GraphContext_GetAttributeID(gc, attr.stringval);
+		}
+
+		registers = MAX(registers, dst + ins.argc);
+	} else {
+		switch(node->operand.type) {
+		case AR_EXP_CONSTANT:
+			// program owns its constants, it might outlive the tree
+			ins.code = AR_INS_CONSTANT;
+			ins.constant = SI_CloneValue(node->operand.constant);
+			break;
+		case AR_EXP_VARIADIC:
+			// resolve record entry index
+			if(node->operand.variadic.entity_alias_idx == IDENTIFIER_NOT_FOUND) {
+				int idx = Record_GetEntryIdx(r, node->operand.variadic.entity_alias);
+				// unknown alias, leave error reporting to the tree evaluation
+				if(idx == INVALID_INDEX) return false;
+				node->operand.variadic.entity_alias_idx = idx;
+			}
+			ins.code = AR_INS_VARIABLE;
+			ins.idx = node->operand.variadic.entity_alias_idx;
+			break;
+		case AR_EXP_BORROW_RECORD:
+			ins.code = AR_INS_RECORD;
+			break;
+		case AR_EXP_PARAM:
+			ins.code = AR_INS_PARAM;
+			ins.param = rm_strdup(node->operand.param_name);
+			break;
+		default:
+			return false;
+		}
+	}
+
+	program->register_count = MAX(program->register_count, registers);
+	array_append(program->instructions, ins);
+	return true;
+}
+
+static void _AR_EXP_ProgramFree(AR_EXP_Program *program) {
+	uint count = array_len(program->instructions);
+	for(uint i = 0; i < count; i++) {
+		AR_Instruction *ins = program->instructions + i;
+		if(ins->code == AR_INS_CONSTANT) SIValue_Free(ins->constant);
+		else if(ins->code == AR_INS_PARAM) rm_free(ins->param);
+	}
+
+	array_free(program->instructions);
+	rm_free(program);
+}
+
+// compile expression tree, returns NULL if the tree can't be compiled
+static AR_EXP_Program *_AR_EXP_ProgramNew(AR_ExpNode *root, const Record r) {
+	AR_EXP_Program *program = rm_malloc(sizeof(AR_EXP_Program));
+	program->instructions   = array_new(AR_Instruction, 4);
+	program->register_count = 0;
+
+	if(!_AR_EXP_Compile(root, r, 0, program)) {
+		_AR_EXP_ProgramFree(program);
+		return NULL;
+	}
+
+	return program;
+}
+
+static AR_EXP_ProgramSlot *_AR_EXP_SlotNew(void) {
+	AR_EXP_ProgramSlot *slot = rm_malloc(sizeof(AR_EXP_ProgramSlot));
+
+	slot->refcount  =  1;
+	slot->state     =  AR_SLOT_EMPTY;
+	slot->program   =  NULL;
+
+	return slot;
+}
+
+static AR_EXP_ProgramSlot *_AR_EXP_SlotShare(AR_EXP_ProgramSlot *slot) {
+	__atomic_add_fetch(&slot->refcount, 1, __ATOMIC_RELAXED);
+	return slot;
+}
+
+static void _AR_EXP_SlotRelease(AR_EXP_ProgramSlot *slot) {
+	if(__atomic_sub_fetch(&slot->refcount, 1, __ATOMIC_ACQ_REL) > 0) return;
+
+	if(slot->program != NULL) _AR_EXP_ProgramFree(slot->program);
+	rm_free(slot);
+}
+
+// returns slot's program, compiling 'root' if no program was compiled yet
+// returns NULL if the tree can't be compiled or is being compiled
+// by another thread, in which case the tree is evaluated as is
+static AR_EXP_Program *_AR_EXP_SlotProgram(AR_EXP_ProgramSlot *slot,
+		AR_ExpNode *root, const Record r) {
+	int state = __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE);
+	if(state == AR_SLOT_READY) return slot->program;
+	if(state == AR_SLOT_COMPILING) return NULL;
+
+	if(!__atomic_compare_exchange_n(&slot->state, &state, AR_SLOT_COMPILING,
+				false, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+		return (state == AR_SLOT_READY) ? slot->program : NULL;
+	}
+
+	slot->program = _AR_EXP_ProgramNew(root, r);
+	__atomic_store_n(&slot->state, AR_SLOT_READY, __ATOMIC_RELEASE);
+
+	return slot->program;
+}
+
+// discard node's compiled program, the node will be recompiled
+// on its next evaluation, clones keep sharing the discarded program
+static void _AR_EXP_Invalidate(AR_ExpNode *node) {
+	ASSERT(AR_EXP_IsOperation(node));
+
+	AR_EXP_ProgramSlot *slot = node->op.slot;
+	if(__atomic_load_n(&slot->refcount, __ATOMIC_RELAXED) == 1 &&
+	   __atomic_load_n(&slot->state, __ATOMIC_RELAXED) == AR_SLOT_EMPTY) {
+		return;
+	}
+
+	_AR_EXP_SlotRelease(slot);
+	node->op.slot = _AR_EXP_SlotNew();
+}
+
+// evaluate dedicated instruction, returns false if arguments types
+// do not match the instruction's expectations
+static inline bool _AR_EXP_RunSpecialized(const AR_Instruction *ins, SIValue *argv,
+		SIValue *result) {
+	SIValue a = argv[0];
+	SIType t = SI_TYPE(a);
+
+	switch(ins->code) {
+	case AR_INS_ADD:
+		if(!(t & SI_NUMERIC) || !(SI_TYPE(argv[1]) & SI_NUMERIC)) return false;
+		*result = SIValue_Add(a, argv[1]);
+		return true;
+	case AR_INS_EQ:
+	case AR_INS_NEQ:
+	case AR_INS_LT:
+	case AR_INS_LE:
+	case AR_INS_GT:
+	case AR_INS_GE: {
+		if(t != SI_TYPE(argv[1])) return false;
+		if(!(t & (T_INT64 | T_DOUBLE | T_STRING))) return false;
+		int c = SIValue_Compare(a, argv[1], NULL);
+		bool res;
+		switch(ins->code) {
+		case AR_INS_EQ:  res = (c == 0); break;
+		case AR_INS_NEQ: res = (c != 0); break;
+		case AR_INS_LT:  res = (c < 0);  break;
+		case AR_INS_LE:  res = (c <= 0); break;
+		case AR_INS_GT:  res = (c > 0);  break;
+		default:         res = (c >= 0); break;
+		}
+		*result = SI_BoolVal(res);
+		return true;
+	}
+	case AR_INS_PROPERTY: {
+		if(!(t & SI_GRAPHENTITY)) return false;
+		Attribute_ID attr = argv[2].longval;
+		if(attr == ATTRIBUTE_NOTFOUND) attr = ins->attr;
+		if(attr == ATTRIBUTE_NOTFOUND) {
+			// attribute might have been introduced after compilation
+			GraphContext *gc = QueryCtx_GetGraphCtx();
+			attr = GraphContext_GetAttributeID(gc, argv[1].stringval);
+		}
+		*result = SI_ConstValue(GraphEntity_GetProperty(a.ptrval, attr));
+		return true;
+	}
+	case AR_INS_TOLOWER: {
+		if(t != T_STRING) return false;
+		size_t len = strlen(a.stringval);
+		*result = SI_TransientStringBuffer(len + 1);
+		str_tolower(a.stringval, result->stringval, &len);
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+// generic function invocation, see _AR_EXP_EvaluateFunctionCall
+static inline bool _AR_EXP_RunCall(const AR_Instruction *ins, SIValue *argv,
+		SIValue *result) {
+	uint argc = ins->argc;
+	if(!_AR_EXP_ValidateInvocation(ins->f, argv, argc)) return false;
+
+	*result = ins->f->func(argv, argc);
+	return !(SIValue_IsNull(*result) && ErrorCtx_EncounteredError());
+}
+
+// load query parameter 'name' into 'v', returns false if it is missing
+static inline bool _AR_EXP_LoadParam(const char *name, SIValue *v) {
+	rax *params = QueryCtx_GetParams();
+	AR_ExpNode *param_node = raxNotFound;
+	if(params) param_node = raxFind(params, (unsigned char *)name, strlen(name));
+	if(param_node == raxNotFound) {
+		// Set the query-level error.
+		ErrorCtx_SetError("Missing parameters");
+		return false;
+	}
+
+	*v = SI_ShareValue(param_node->operand.constant);
+	return true;
+}
+
+static AR_EXP_Result _AR_EXP_Run(const AR_EXP_Program *program,
+		const Record r, SIValue *result) {
+	SIValue registers[program->register_count];
+	uint count = array_len(program->instructions);
+
+	for(uint i = 0; i < count; i++) {
+		const AR_Instruction *ins = program->instructions + i;
+		SIValue *argv = registers + ins->dst;
+
+		switch(ins->code) {
+		case AR_INS_CONSTANT:
+			*argv = SI_ShareValue(ins->constant);
+			continue;
+		case AR_INS_VARIABLE:
+			*argv = SI_ShareValue(Record_Get(r, ins->idx));
+			continue;
+		case AR_INS_RECORD:
+			*argv = SI_PtrVal(r);
+			continue;
+		case AR_INS_PARAM:
+			if(!_AR_EXP_LoadParam(ins->param, argv)) {
+				_AR_EXP_FreeResultsArray(registers, ins->dst);
+				return EVAL_ERR;
+			}
+			continue;
+		default:
+			break;
+		}
+
+		SIValue v;
+		if(!_AR_EXP_RunSpecialized(ins, argv, &v) &&
+		   !_AR_EXP_RunCall(ins, argv, &v)) {
+			// free every value computed so far and propagate the error
+			_AR_EXP_FreeResultsArray(registers, ins->dst + ins->argc);
+			return EVAL_ERR;
+		}
+
+		// free arguments and store result in their place
+		_AR_EXP_FreeResultsArray(argv, ins->argc);
+		*argv = v;
+	}
+
+	*result = registers[0];
+	return EVAL_OK;
+}
+
 SIValue AR_EXP_Evaluate(AR_ExpNode *root, const Record r) {
 	SIValue result;
-	AR_EXP_Result res = _AR_EXP_Evaluate(root, r, &result);
+
+	// intermediate values are allocated from the thread's active arena, if any
+	// and are released as soon as the expression has been evaluated
+	ArenaMark mark = {0};
+	Arena *arena = Arena_GetActive();
+	if(arena != NULL) mark = Arena_Mark(arena);
+
+	// compile operation trees on their first evaluation against a record
+	AR_EXP_Program *program = NULL;
+	if(AR_EXP_IsOperation(root) && r != NULL) {
+		program = _AR_EXP_SlotProgram(root->op.slot, root, r);
+	}
+
+	AR_EXP_Result res = (program != NULL) ?
+		_AR_EXP_Run(program, r, &result) :
+		_AR_EXP_Evaluate(root, r, &result);
+
+	if(arena != NULL) {
+		// the result outlives the evaluation, move it out of the arena
+		if(res != EVAL_ERR && SI_TYPE(result) == T_STRING &&
+		   result.allocation == M_CONST &&
+		   Arena_Contains(arena, result.stringval)) {
+			result = SI_DuplicateStringVal(result.stringval);
+		}
+		Arena_Rewind(arena, mark);
+	}
 
 	if(res == EVAL_ERR) {
 		ErrorCtx_RaiseRuntimeException(NULL);  // Raise an exception if we're in a run-time context.
@@ -538,7 +959,7 @@ SIValue AR_EXP_Evaluate(AR_ExpNode *root, const Record r) {
 	return result;
 }
 
-void AR_EXP_Aggregate(AR_ExpNode *root, const Record r) {
+static void _AR_EXP_Aggregate(AR_ExpNode *root, const Record r) {
 	if(AR_EXP_IsOperation(root)) {
 		if(root->op.f->aggregate == true) {
 			AR_EXP_Result res = _AR_EXP_EvaluateFunctionCall(root, r, NULL);
@@ -550,12 +971,23 @@ void AR_EXP_Aggregate(AR_ExpNode *root, const Record r) {
 			/* Keep searching for aggregation nodes. */
 			for(int i = 0; i < root->op.child_count; i++) {
 				AR_ExpNode *child = root->op.children[i];
-				AR_EXP_Aggregate(child, r);
+				_AR_EXP_Aggregate(child, r);
 			}
 		}
 	}
 }
 
+void AR_EXP_Aggregate(AR_ExpNode *root, const Record r) {
+	// aggregation functions may retain their arguments,
+	// which must therefore not be allocated from the arena
+	Arena *arena = Arena_GetActive();
+	Arena_SetActive(NULL);
+
+	_AR_EXP_Aggregate(root, r);
+
+	Arena_SetActive(arena);
+}
+
 void _AR_EXP_Finalize(AR_ExpNode *root) {
 	//--------------------------------------------------------------------------
 	// finalize aggregation node
@@ -768,6 +1200,9 @@ AR_ExpNode *AR_EXP_Clone(AR_ExpNode *exp) {
 }
 
 static inline void _AR_EXP_FreeOpInternals(AR_ExpNode *op_node) {
+	_AR_EXP_SlotRelease(op_node->op.slot);
+	op_node->op.slot = NULL;
+
 	void *pdata = op_node->op.f->privdata;
 	AR_Func_Free free_func = op_node->op.f->bfree;
 
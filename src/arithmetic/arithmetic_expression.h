@@ -37,11 +37,15 @@ typedef enum {
 	EVAL_FOUND_PARAM = (1 << 1),
 } AR_EXP_Result;
 
+// compiled form of an expression tree, shared by the tree and its clones
+typedef struct AR_EXP_ProgramSlot AR_EXP_ProgramSlot;
+
 /* Op represents an operation applied to child args. */
 typedef struct {
-	AR_FuncDesc *f;                 // Operation to perform on children
-	int child_count;                // Number of children
-	struct AR_ExpNode **children;   // Child nodes
+	AR_FuncDesc *f;                    // Operation to perform on children
+	int child_count;                   // Number of children
+	struct AR_ExpNode **children;      // Child nodes
+	AR_EXP_ProgramSlot *slot;          // Compiled form of the expression
 } AR_OpNode;
 
 // OperandNode represents either constant, parameter, or graph entity
@@ -98,7 +102,10 @@ bool AR_EXP_ReduceToScalar(AR_ExpNode *root, bool reduce_params, SIValue *val);
 /* Resolve variables to constants */
 void AR_EXP_ResolveVariables(AR_ExpNode *root, const Record r);
 
-/* Evaluate arithmetic expression tree. */
+/* Evaluate arithmetic expression tree.
+ * On first evaluation the tree is compiled into a flat program
+ * of register-based instructions, which is used for subsequent evaluations.
+ * The program is shared by the tree's clones until either tree is modified. */
 SIValue AR_EXP_Evaluate(AR_ExpNode *root, const Record r);
 
 /* Evaluate aggregate functions in expression tree. */
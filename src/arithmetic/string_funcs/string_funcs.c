@@ -20,12 +20,13 @@ SIValue AR_LEFT(SIValue *argv, int argc) {
 	int64_t newlen = argv[1].longval;
 	if(strlen(argv[0].stringval) <= newlen) {
 		// No need to truncate this string based on the requested length
-		return SI_DuplicateStringVal(argv[0].stringval);
+		return SI_TransientStringVal(argv[0].stringval);
 	}
-	char *left_str = rm_malloc((newlen + 1) * sizeof(char));
+	SIValue left = SI_TransientStringBuffer((newlen + 1) * sizeof(char));
+	char *left_str = left.stringval;
 	strncpy(left_str, argv[0].stringval, newlen * sizeof(char));
 	left_str[newlen] = '\0';
-	return SI_TransferStringVal(left_str);
+	return left;
 }
 
 // returns the original string with leading whitespace removed.
@@ -38,7 +39,7 @@ SIValue AR_LTRIM(SIValue *argv, int argc) {
 		trimmed ++;
 	}
 
-	return SI_DuplicateStringVal(trimmed);
+	return SI_TransientStringVal(trimmed);
 }
 
 // returns a string containing the specified number of rightmost characters of the original string.
@@ -50,9 +51,9 @@ SIValue AR_RIGHT(SIValue *argv, int argc) {
 
 	if(start <= 0) {
 		// No need to truncate this string based on the requested length
-		return SI_DuplicateStringVal(argv[0].stringval);
+		return SI_TransientStringVal(argv[0].stringval);
 	}
-	return SI_DuplicateStringVal(argv[0].stringval + start);
+	return SI_TransientStringVal(argv[0].stringval + start);
 }
 
 // returns the original string with trailing whitespace removed.
@@ -66,11 +67,12 @@ SIValue AR_RTRIM(SIValue *argv, int argc) {
 		i --;
 	}
 
-	char *trimmed = rm_malloc((i + 1) * sizeof(char));
+	SIValue v = SI_TransientStringBuffer((i + 1) * sizeof(char));
+	char *trimmed = v.stringval;
 	strncpy(trimmed, str, i);
 	trimmed[i] = '\0';
 
-	return SI_TransferStringVal(trimmed);
+	return v;
 }
 
 // incase the parameter type is 
@@ -84,7 +86,8 @@ SIValue AR_REVERSE(SIValue *argv, int argc) {
 		// string reverse
 		char *str = value.stringval;
 		size_t str_len = strlen(str);
-		char *reverse = rm_malloc((str_len + 1) * sizeof(char));
+		SIValue v = SI_TransientStringBuffer((str_len + 1) * sizeof(char));
+		char *reverse = v.stringval;
 
 		int i = str_len - 1;
 		int j = 0;
@@ -92,7 +95,7 @@ SIValue AR_REVERSE(SIValue *argv, int argc) {
 			reverse[j++] = str[i--];
 		}
 		reverse[j] = '\0';
-		return SI_TransferStringVal(reverse);
+		return v;
 	} else {
 		SIValue reverse = SI_CloneValue(value);
 		array_reverse(reverse.array);
@@ -133,11 +136,12 @@ SIValue AR_SUBSTRING(SIValue *argv, int argc) {
 		}
 	}
 
-	char *substring = rm_malloc((length + 1) * sizeof(char));
+	SIValue v = SI_TransientStringBuffer((length + 1) * sizeof(char));
+	char *substring = v.stringval;
 	strncpy(substring, original + start, length);
 	substring[length] = '\0';
 
-	return SI_TransferStringVal(substring);
+	return v;
 }
 
 // returns the original string in lowercase.
@@ -145,9 +149,9 @@ SIValue AR_TOLOWER(SIValue *argv, int argc) {
 	if(SIValue_IsNull(argv[0])) return SI_NullVal();
 	char *original = argv[0].stringval;
 	size_t lower_len = strlen(original);
-	char *lower = rm_malloc((lower_len + 1) * sizeof(char));
-	str_tolower(original, lower, &lower_len);
-	return SI_TransferStringVal(lower);
+	SIValue lower = SI_TransientStringBuffer((lower_len + 1) * sizeof(char));
+	str_tolower(original, lower.stringval, &lower_len);
+	return lower;
 }
 
 // returns the original string in uppercase.
@@ -155,9 +159,9 @@ SIValue AR_TOUPPER(SIValue *argv, int argc) {
 	if(SIValue_IsNull(argv[0])) return SI_NullVal();
 	char *original = argv[0].stringval;
 	size_t upper_len = strlen(original);
-	char *upper = rm_malloc((upper_len + 1) * sizeof(char));
-	str_toupper(original, upper, &upper_len);
-	return SI_TransferStringVal(upper);
+	SIValue upper = SI_TransientStringBuffer((upper_len + 1) * sizeof(char));
+	str_toupper(original, upper.stringval, &upper_len);
+	return upper;
 }
 
 // converts an integer, float or boolean value to a string.
@@ -182,6 +186,7 @@ SIValue AR_TRIM(SIValue *argv, int argc) {
 	if(SIValue_IsNull(argv[0])) return SI_NullVal();
 	SIValue ltrim = AR_LTRIM(argv, argc);
 	SIValue trimmed = AR_RTRIM(&ltrim, 1);
+	SIValue_Free(ltrim);
 	return trimmed;
 }
 
@@ -283,14 +288,15 @@ SIValue AR_REPLACE(SIValue *argv, int argc) {
 	// if sub string not found return original string
 	if(occurrences == 0) {
 		array_free(arr);
-		return SI_DuplicateStringVal(str);
+		return SI_TransientStringVal(str);
 	}
 
 	// calculate new buffer size
 	size_t buffer_size = strlen(str) + (occurrences * new_string_len) - (occurrences * old_string_len);
 
 	// allocate buffer
-	char *buffer = (char*) rm_malloc(sizeof(char) * buffer_size + 1);
+	SIValue v = SI_TransientStringBuffer(sizeof(char) * buffer_size + 1);
+	char *buffer = v.stringval;
 
 	// set pointers to start point
 	ptr = str;
@@ -324,7 +330,7 @@ SIValue AR_REPLACE(SIValue *argv, int argc) {
 
 	array_free(arr);
 
-	return SI_TransferStringVal(buffer);
+	return v;
 }
 
 //==============================================================================
@@ -6,6 +6,8 @@
 
 #include "ast.h"
 #include <pthread.h>
+#include <ctype.h>
+#include <strings.h>
 
 #include "../RG.h"
 #include "../util/arr.h"
@@ -599,3 +601,385 @@ void parse_result_free(cypher_parse_result_t *parse_result) {
 	if(parse_result) cypher_parse_result_free(parse_result);
 }
 
+
+//------------------------------------------------------------------------------
+// literals parameterization
+//------------------------------------------------------------------------------
+
+// literals are located by scanning the query's tokens rather than by parsing
+// the query, such that a query served from the cache is never parsed
+// a literal is replaced only when its context is known to permit it,
+// anything else is left in place to be handled by the parser
+
+typedef enum {
+	TOKEN_INTEGER,  // integer literal
+	TOKEN_FLOAT,    // float literal
+	TOKEN_STRING,   // string literal without escape sequences
+	TOKEN_WORD,     // identifier or keyword
+	TOKEN_OTHER,    // operators, parameters, escaped names, etc
+} TokenType;
+
+typedef struct {
+	TokenType type;     // token type
+	const char *start;  // token's first character
+	uint len;           // token's length
+} Token;
+
+static inline bool _AST_IsWordChar(char c) {
+	return isalnum((unsigned char)c) || c == '_' || (unsigned char)c >= 0x80;
+}
+
+// scan a number, returns the first character following it
+static const char *_AST_ScanNumber
+(
+	const char *s,   // number's first character
+	TokenType *type  // [output] number type
+) {
+	const char *e = s;
+	*type = TOKEN_INTEGER;
+
+	if(s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) {
+		e += 2;
+		while(isxdigit((unsigned char)*e)) e++;
+	} else {
+		while(isdigit((unsigned char)*e)) e++;
+		// fraction, '..' is a range
+		if(e[0] == '.' && isdigit((unsigned char)e[1])) {
+			*type = TOKEN_FLOAT;
+			e++;
+			while(isdigit((unsigned char)*e)) e++;
+		}
+		// exponent
+		if(*e == 'e' || *e == 'E') {
+			const char *exp = e + 1;
+			if(*exp == '+' || *exp == '-') exp++;
+			if(isdigit((unsigned char)*exp)) {
+				*type = TOKEN_FLOAT;
+				e = exp;
+				while(isdigit((unsigned char)*e)) e++;
+			}
+		}
+	}
+
+	// malformed number, e.g. 12ab
+	if(_AST_IsWordChar(*e)) {
+		*type = TOKEN_OTHER;
+		while(_AST_IsWordChar(*e)) e++;
+	}
+
+	return e;
+}
+
+// scan the next token, returns false once the query is exhausted
+static bool _AST_NextToken
+(
+	const char **pos,  // scan position
+	Token *tok         // [output] scanned token
+) {
+	const char *s = *pos;
+
+	// skip whitespaces and comments
+	while(true) {
+		while(isspace((unsigned char)*s)) s++;
+		if(s[0] == '/' && s[1] == '/') {
+			while(*s != '\0' && *s != '\n') s++;
+		} else if(s[0] == '/' && s[1] == '*') {
+			const char *end = strstr(s + 2, "*/");
+			s = (end == NULL) ? s + strlen(s) : end + 2;
+		} else {
+			break;
+		}
+	}
+
+	if(*s == '\0') {
+		*pos = s;
+		return false;
+	}
+
+	const char *e = s + 1;
+	tok->type = TOKEN_OTHER;
+
+	if(*s == '\'' || *s == '"') {
+		// string literal
+		// strings containing escape sequences are left in place
+		tok->type = TOKEN_STRING;
+		while(*e != '\0' && *e != *s) {
+			if(*e == '\\') {
+				tok->type = TOKEN_OTHER;
+				if(e[1] != '\0') e++;
+			}
+			e++;
+		}
+		if(*e == '\0') tok->type = TOKEN_OTHER;  // unterminated string
+		else e++;
+	} else if(*s == '`') {
+		// escaped name, backticks within the name are doubled
+		while(*e != '\0') {
+			if(*e == '`' && *(++e) != '`') break;
+			e++;
+		}
+	} else if(*s == '$') {
+		// parameter
+		while(_AST_IsWordChar(*e)) e++;
+	} else if(isdigit((unsigned char)*s) ||
+			  (*s == '.' && isdigit((unsigned char)*e))) {
+		e = _AST_ScanNumber(s, &tok->type);
+	} else if(_AST_IsWordChar(*s)) {
+		tok->type = TOKEN_WORD;
+		while(_AST_IsWordChar(*e)) e++;
+	} else if(s[0] == '.' && s[1] == '.') {
+		e++;
+	}
+
+	tok->start = s;
+	tok->len   = e - s;
+	*pos       = e;
+	return true;
+}
+
+static inline bool _AST_TokenIsWord
+(
+	const Token *tok,
+	const char *word
+) {
+	return tok->type == TOKEN_WORD && strlen(word) == tok->len &&
+		strncasecmp(tok->start, word, tok->len) == 0;
+}
+
+static inline bool _AST_TokenIsOther
+(
+	const Token *tok,
+	const char *s
+) {
+	return tok->type == TOKEN_OTHER && strlen(s) == tok->len &&
+		strncmp(tok->start, s, tok->len) == 0;
+}
+
+// returns true if the i-th token starts a clause or a clause's subclause
+static bool _AST_TokenIsClauseKeyword
+(
+	const Token *tokens,  // query tokens
+	uint token_count,     // number of tokens
+	uint i                // token index
+) {
+	static const char *keywords[] = {"MATCH", "OPTIONAL", "UNWIND", "CREATE",
+		"MERGE", "DELETE", "DETACH", "SET", "REMOVE", "CALL", "UNION",
+		"RETURN", "WITH", "WHERE", "ORDER", "SKIP", "LIMIT"};
+
+	const Token *tok = tokens + i;
+	if(tok->type != TOKEN_WORD) return false;
+
+	// property keys and labels, e.g. n.limit, (:Match)
+	if(i > 0 && (_AST_TokenIsOther(tokens + i - 1, ".") ||
+				 _AST_TokenIsOther(tokens + i - 1, ":"))) {
+		return false;
+	}
+
+	// map keys, e.g. {skip: 1}
+	if(i + 1 < token_count && _AST_TokenIsOther(tokens + i + 1, ":")) {
+		return false;
+	}
+
+	// string operators, e.g. a STARTS WITH b
+	if(_AST_TokenIsWord(tok, "WITH") && i > 0 &&
+	   (_AST_TokenIsWord(tokens + i - 1, "STARTS") ||
+		_AST_TokenIsWord(tokens + i - 1, "ENDS"))) {
+		return false;
+	}
+
+	for(uint j = 0; j < sizeof(keywords) / sizeof(keywords[0]); j++) {
+		if(_AST_TokenIsWord(tok, keywords[j])) return true;
+	}
+
+	return false;
+}
+
+// returns true if the i-th token is a literal which can be replaced
+static bool _AST_LiteralReplaceable
+(
+	const Token *tokens,  // query tokens
+	uint token_count,     // number of tokens
+	uint i                // token index
+) {
+	const Token *prev = (i > 0) ? tokens + i - 1 : NULL;
+	const Token *next = (i + 1 < token_count) ? tokens + i + 1 : NULL;
+
+	// variable-length traversal bounds are required while building the plan
+	// e.g. [*2..3]
+	if(prev != NULL &&
+	   (_AST_TokenIsOther(prev, "*") || _AST_TokenIsOther(prev, ".."))) {
+		return false;
+	}
+	if(next != NULL && _AST_TokenIsOther(next, "..")) return false;
+
+	// SKIP and LIMIT are validated to be integers
+	if(prev != NULL && tokens[i].type != TOKEN_INTEGER &&
+	   (_AST_TokenIsWord(prev, "SKIP") || _AST_TokenIsWord(prev, "LIMIT"))) {
+		return false;
+	}
+
+	return true;
+}
+
+// collect literals which can be replaced by parameters
+static Token *_AST_CollectLiterals
+(
+	Token *tokens  // query tokens
+) {
+	Token *literals = array_new(Token, 0);
+
+	int  depth        = 0;      // nesting level of (, [ and {
+	bool in_order_by  = false;  // sort items are matched against projections
+	bool in_proj      = false;  // within RETURN or WITH projections
+	bool item_aliased = false;  // current projection is explicitly aliased
+	uint item_start   = 0;      // first literal of current projection
+
+	uint token_count = array_len(tokens);
+	for(uint i = 0; i <= token_count; i++) {
+		const Token *tok = (i < token_count) ? tokens + i : NULL;
+
+		// a projection ends at a top-level comma or clause keyword
+		// column names of unaliased projections are taken from the query text
+		bool clause_end = tok == NULL || _AST_TokenIsOther(tok, ";") ||
+			(depth == 0 && _AST_TokenIsClauseKeyword(tokens, token_count, i));
+		if(in_proj &&
+		   (clause_end || (depth == 0 && _AST_TokenIsOther(tok, ",")))) {
+			if(!item_aliased) literals = array_trimm_len(literals, item_start);
+			item_start   = array_len(literals);
+			item_aliased = false;
+		}
+
+		if(tok == NULL) break;
+
+		if(clause_end) {
+			in_proj = _AST_TokenIsWord(tok, "RETURN") ||
+				_AST_TokenIsWord(tok, "WITH");
+			in_order_by = _AST_TokenIsWord(tok, "ORDER");
+			item_start  = array_len(literals);
+			continue;
+		}
+
+		switch(tok->type) {
+			case TOKEN_INTEGER:
+			case TOKEN_FLOAT:
+			case TOKEN_STRING:
+				if(!in_order_by && _AST_LiteralReplaceable(tokens, token_count, i)) {
+					array_append(literals, *tok);
+				}
+				break;
+			case TOKEN_WORD:
+				if(in_proj && depth == 0 && _AST_TokenIsWord(tok, "AS")) {
+					item_aliased = true;
+				}
+				break;
+			case TOKEN_OTHER:
+				if(tok->len != 1) break;
+				if(strchr("([{", tok->start[0]) != NULL) depth++;
+				if(strchr(")]}", tok->start[0]) != NULL) depth--;
+				break;
+		}
+	}
+
+	return literals;
+}
+
+// convert a literal into a constant expression
+// returns NULL if literal value is invalid
+static AR_ExpNode *_AST_LiteralToExp
+(
+	const Token *literal,
+	const char **type_name
+) {
+	char *endptr = NULL;
+	const char *end = literal->start + literal->len;
+
+	if(literal->type == TOKEN_INTEGER) {
+		int64_t l = strtol(literal->start, &endptr, 0);
+		if(endptr != end) return NULL;
+		*type_name = "int";
+		return AR_EXP_NewConstOperandNode(SI_LongVal(l));
+	}
+
+	if(literal->type == TOKEN_FLOAT) {
+		double d = strtod(literal->start, &endptr);
+		if(endptr != end) return NULL;
+		*type_name = "float";
+		return AR_EXP_NewConstOperandNode(SI_DoubleVal(d));
+	}
+
+	ASSERT(literal->type == TOKEN_STRING);
+	// strip quotes
+	char *s = rm_strndup(literal->start + 1, literal->len - 2);
+	*type_name = "string";
+	return AR_EXP_NewConstOperandNode(SI_TransferStringVal(s));
+}
+
+char *AST_ParameterizeLiterals(const char *query) {
+	ASSERT(query != NULL);
+
+	Token tok;
+	const char *pos = query;
+	Token *tokens = array_new(Token, 32);
+	while(_AST_NextToken(&pos, &tok)) array_append(tokens, tok);
+
+	Token *literals = _AST_CollectLiterals(tokens);
+	array_free(tokens);
+
+	uint literal_count = array_len(literals);
+	if(literal_count == 0) {
+		array_free(literals);
+		return NULL;
+	}
+
+	// each literal is replaced by a placeholder of the form $__<type><idx>
+	size_t query_len = strlen(query);
+	char *normalized = rm_malloc(query_len + literal_count * 32 + 1);
+
+	char name[32];
+	uint replaced = 0;   // number of literals replaced
+	size_t offset = 0;   // position within original query
+	size_t len = 0;      // length of normalized query
+	rax *params = QueryCtx_GetParams();
+
+	for(uint i = 0; i < literal_count; i++) {
+		const char *type_name;
+		AR_ExpNode *exp = _AST_LiteralToExp(literals + i, &type_name);
+		// invalid literals are left in place, to be reported later on
+		if(exp == NULL) continue;
+
+		int name_len = sprintf(name, "__%s%u", type_name, i);
+
+		if(params == NULL) {
+			params = raxNew();
+			QueryCtx_SetParams(params);
+		}
+
+		// keep literal in place if its placeholder is a user-specified parameter
+		if(!raxTryInsert(params, (unsigned char *)name, name_len, exp, NULL)) {
+			AR_EXP_Free(exp);
+			continue;
+		}
+
+		size_t start = literals[i].start - query;
+		memcpy(normalized + len, query + offset, start - offset);
+		len += start - offset;
+		normalized[len++] = '$';
+		memcpy(normalized + len, name, name_len);
+		len += name_len;
+		offset = start + literals[i].len;
+		replaced++;
+	}
+
+	array_free(literals);
+
+	if(replaced == 0) {
+		rm_free(normalized);
+		return NULL;
+	}
+
+	memcpy(normalized + len, query + offset, query_len - offset);
+	len += query_len - offset;
+	normalized[len] = '\0';
+
+	return normalized;
+}
@@ -123,6 +123,12 @@ cypher_parse_result_t *parse_params(const char *query, const char **query_body);
 // Free the immutable AST generated by the parser.
 void parse_result_free(cypher_parse_result_t *parse_result);
 
+// Replace query literals with parameters, literal values are added to the
+// query parameters map. Returns the normalized query string, or NULL if the
+// query contains no literals which can be replaced.
+// The query is scanned rather than parsed and is not validated.
+char *AST_ParameterizeLiterals(const char *query);
+
 // Returns the ast annotation context collection of the AST.
 AST_AnnotationCtxCollection *AST_GetAnnotationCtxCollection(AST *ast);
 
@@ -10,6 +10,7 @@
 #include "../schema/schema.h"
 #include "../util/arr.h"
 #include "../util/rmalloc.h"
+#include "../configuration/config.h"
 
 // the first byte of each property in the binary stream
 // is used to indicate the type of the subsequent SIValue
@@ -193,6 +194,126 @@ static SIValue _BulkInsert_ReadProperty
     return v;
 }
 
+// advance data_idx past a single property without materializing it
+static void _BulkInsert_SkipProperty
+(
+	const char* data,
+	size_t* data_idx
+) {
+	int64_t len;
+	TYPE t = data[*data_idx];
+	*data_idx += 1;
+
+	switch (t) {
+		case BI_NULL:
+			break;
+
+		case BI_BOOL:
+			*data_idx += 1;
+			break;
+
+		case BI_DOUBLE:
+			*data_idx += sizeof(double);
+			break;
+
+		case BI_LONG:
+			*data_idx += sizeof(int64_t);
+			break;
+
+		case BI_STRING:
+			*data_idx += strlen(data + *data_idx) + 1;
+			break;
+
+		case BI_ARRAY:
+			len = *(int64_t*)&data[*data_idx];
+			*data_idx += sizeof(int64_t);
+			for (int64_t i = 0; i < len; i++) {
+				_BulkInsert_SkipProperty(data, data_idx);
+			}
+			break;
+
+		default:
+			ASSERT(false);
+			break;
+	}
+}
+
+// number of entities whose properties are decoded at once
+#define BULK_DECODE_BATCH 16384
+
+// decode the properties of each entity and attach them
+// entities[i] properties begin at data[offsets[i]]
+// entities are independent of one another
+// as such decoding is distributed across OpenMP threads
+//
+// OpenMP threads must not allocate, allocations are accounted against a
+// thread-local memory capacity and errors are set in a thread-local context
+// threads only decode scalars and strings into a preallocated buffer
+// properties are attached by the calling thread, which also decodes
+// the properties of entities holding arrays
+static void _BulkInsert_SetProperties
+(
+	GraphEntity* entities,
+	size_t entity_size,
+	const size_t* offsets,
+	uint64_t entity_count,
+	const Attribute_ID* prop_indices,
+	uint prop_count,
+	const char* data
+) {
+	if (prop_count == 0) return;
+
+	int nthreads;
+	Config_Option_get(Config_OPENMP_NTHREAD, &nthreads);
+
+	uint64_t batch_size = (entity_count < BULK_DECODE_BATCH) ?
+		entity_count : BULK_DECODE_BATCH;
+	SIValue* values = rm_malloc(sizeof(SIValue) * prop_count * batch_size);
+	bool* has_array = rm_malloc(sizeof(bool) * batch_size);
+
+	for (uint64_t offset = 0; offset < entity_count; offset += batch_size) {
+		uint64_t n = entity_count - offset;
+		if (n > batch_size) n = batch_size;
+
+		#pragma omp parallel for num_threads(nthreads) schedule(static)
+		for (uint64_t j = 0; j < n; j++) {
+			size_t data_idx = offsets[offset + j];
+			SIValue* v = values + j * prop_count;
+			has_array[j] = false;
+			for (uint i = 0; i < prop_count; i++) {
+				// decoding an array allocates
+				if (data[data_idx] == BI_ARRAY) {
+					has_array[j] = true;
+					break;
+				}
+				v[i] = _BulkInsert_ReadProperty(data, &data_idx);
+			}
+		}
+
+		for (uint64_t j = 0; j < n; j++) {
+			GraphEntity* ge = (GraphEntity*)((char*)entities +
+					(offset + j) * entity_size);
+			SIValue* v = values + j * prop_count;
+
+			if (!has_array[j]) {
+				// invalid attribute values are skipped by GraphEntity_AddProperties
+				GraphEntity_AddProperties(ge, prop_indices, v, prop_count);
+				continue;
+			}
+
+			size_t data_idx = offsets[offset + j];
+			for (uint i = 0; i < prop_count; i++) {
+				v[i] = _BulkInsert_ReadProperty(data, &data_idx);
+			}
+			GraphEntity_AddProperties(ge, prop_indices, v, prop_count);
+			for (uint i = 0; i < prop_count; i++) SIValue_Free(v[i]);
+		}
+	}
+
+	rm_free(values);
+	rm_free(has_array);
+}
+
 static int _BulkInsert_ProcessNodeFile
 (
 	GraphContext* gc,
@@ -224,24 +345,38 @@ static int _BulkInsert_ProcessNodeFile
     // load nodes
     //--------------------------------------------------------------------------
 
+	// create nodes and record the offset of each node's properties
+	Node* nodes = array_new(Node, 1024);
+	size_t* offsets = array_new(size_t, 1024);
+
 	while (data_idx < data_len) {
 		Node n;
-		GraphEntity* ge;
 		Graph_CreateNode(gc->g, &n, label_ids, label_count);
-		ge = (GraphEntity*)&n;
-		// process entity attributes
+		array_append(nodes, n);
+		array_append(offsets, data_idx);
+
 		for (uint i = 0; i < prop_count; i++) {
-			SIValue value = _BulkInsert_ReadProperty(data, &data_idx);
-			// skip invalid attribute values
-			if (!(SI_TYPE(value) & SI_VALID_PROPERTY_VALUE))
-				continue;
-			GraphEntity_AddProperty(ge, prop_indices[i], value);
+			_BulkInsert_SkipProperty(data, &data_idx);
+		}
+	}
+
+	_BulkInsert_SetProperties((GraphEntity*)nodes, sizeof(Node), offsets,
+			array_len(nodes), prop_indices, prop_count, data);
+
+	// update attribute statistics
+	uint node_count = array_len(nodes);
+	for (uint i = 0; i < label_count; i++) {
+		Schema* s = GraphContext_GetSchemaByID(gc, label_ids[i], SCHEMA_NODE);
+		for (uint j = 0; j < node_count; j++) {
+			Schema_AddNodeToAttributeStats(s, nodes + j);
 		}
 	}
 
     Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_RESIZE);
     if (prop_indices) rm_free(prop_indices);
     array_free(label_ids);
+    array_free(offsets);
+    array_free(nodes);
 
     return BULK_OK;
 }
@@ -278,10 +413,12 @@ static int _BulkInsert_ProcessEdgeFile
     // load edges
     //--------------------------------------------------------------------------
 
-	while (data_idx < data_len) {
-		Edge e;
-		GraphEntity* ge;
+	// collect edge endpoints and the offset of each edge's properties
+	NodeID* srcs = array_new(NodeID, 1024);
+	NodeID* dests = array_new(NodeID, 1024);
+	size_t* offsets = array_new(size_t, 1024);
 
+	while (data_idx < data_len) {
 		// next 8 bytes are source ID
 		NodeID src = *(NodeID*)&data[data_idx];
 		data_idx += sizeof(NodeID);
@@ -289,22 +426,29 @@ static int _BulkInsert_ProcessEdgeFile
 		NodeID dest = *(NodeID*)&data[data_idx];
 		data_idx += sizeof(NodeID);
 
-		Graph_CreateEdge(gc->g, src, dest, type_id, &e);
-		ge = (GraphEntity*)&e;
+		array_append(srcs, src);
+		array_append(dests, dest);
+		array_append(offsets, data_idx);
 
-		// process entity attributes
 		for (uint i = 0; i < prop_count; i++) {
-			SIValue value = _BulkInsert_ReadProperty(data, &data_idx);
-			// skip invalid attribute values
-			if (!(SI_TYPE(value) & SI_VALID_PROPERTY_VALUE)) {
-				continue;
-			}
-
-			GraphEntity_AddProperty(ge, prop_indices[i], value);
+			_BulkInsert_SkipProperty(data, &data_idx);
 		}
 	}
 
+	// create all edges at once, relation and adjacency matrices
+	// are built from the sorted edge tuples
+	uint64_t edge_count = array_len(srcs);
+	Edge* edges = rm_malloc(sizeof(Edge) * edge_count);
+	Graph_CreateEdges(gc->g, type_id, srcs, dests, edge_count, edges);
+
+	_BulkInsert_SetProperties((GraphEntity*)edges, sizeof(Edge), offsets,
+			edge_count, prop_indices, prop_count, data);
+
     array_free(type_ids);
+    array_free(srcs);
+    array_free(dests);
+    array_free(offsets);
+    rm_free(edges);
     if (prop_indices) rm_free(prop_indices);
     Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_RESIZE);
 
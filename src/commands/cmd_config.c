@@ -8,22 +8,41 @@
 #include "RG.h"
 #include "../configuration/config.h"
 
+// reply with a (name, value) pair
+// returns false if the field's value could not be retrieved
+static bool _Config_reply_field(RedisModuleCtx *ctx, const char *config_name,
+		Config_Option_Field field) {
+	// string valued fields, NULL if unset
+	if(field == Config_EXPORT_DIR) {
+		const char *value = NULL;
+		if(!Config_Option_get(field, &value)) return false;
+
+		RedisModule_ReplyWithArray(ctx, 2);
+		RedisModule_ReplyWithCString(ctx, config_name);
+		if(value == NULL) RedisModule_ReplyWithNull(ctx);
+		else RedisModule_ReplyWithCString(ctx, value);
+		return true;
+	}
+
+	long long value = 0;
+	if(!Config_Option_get(field, &value)) return false;
+
+	RedisModule_ReplyWithArray(ctx, 2);
+	RedisModule_ReplyWithCString(ctx, config_name);
+	RedisModule_ReplyWithLongLong(ctx, value);
+	return true;
+}
+
 void _Config_get_all(RedisModuleCtx *ctx) {
 	uint config_count = Config_END_MARKER;
 	RedisModule_ReplyWithArray(ctx, config_count);
 
 	for(Config_Option_Field field = 0; field < Config_END_MARKER; field++) {
-		long long value = 0;
 		const char *config_name = Config_Field_name(field);
-		bool res = Config_Option_get(field, &value);
 
-		if(!res || config_name == NULL) {
+		if(config_name == NULL || !_Config_reply_field(ctx, config_name, field)) {
 			RedisModule_ReplyWithError(ctx, "Configuration field was not found");
 			return;
-		} else {
-			RedisModule_ReplyWithArray(ctx, 2);
-			RedisModule_ReplyWithCString(ctx, config_name);
-			RedisModule_ReplyWithLongLong(ctx, value);
 		}
 	}
 }
@@ -45,13 +64,7 @@ void _Config_get(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 		return;
 	}
 
-	long long value = 0;
-
-	if(Config_Option_get(config_field, &value)) {
-		RedisModule_ReplyWithArray(ctx, 2);
-		RedisModule_ReplyWithCString(ctx, config_name);
-		RedisModule_ReplyWithLongLong(ctx, value);
-	} else {
+	if(!_Config_reply_field(ctx, config_name, config_field)) {
 		RedisModule_ReplyWithError(ctx, "Configuration field was not found");
 	}
 }
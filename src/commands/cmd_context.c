@@ -8,6 +8,7 @@
 #include "RG.h"
 #include "../query_ctx.h"
 #include "../util/rmalloc.h"
+#include "../util/simple_timer.h"
 #include "../util/thpool/pools.h"
 #include "../slow_log/slow_log.h"
 
@@ -37,7 +38,9 @@ CommandCtx *CommandCtx_New
 	context->timeout = timeout;
 	context->command_name = NULL;
 	context->graph_ctx = graph_ctx;
+	context->admitted = false;
 	context->replicated_command = replicated_command;
+	simple_tic(context->timer);
 
 	if(cmd_name) {
 		// Make a copy of command name.
@@ -141,6 +144,9 @@ void CommandCtx_Free(CommandCtx *command_ctx) {
 
 	CommandCtx_UntrackCtx(command_ctx);
 
+	// release graph admission, allowing another query to be admitted
+	if(command_ctx->admitted) GraphContext_ReleaseQuery(command_ctx->graph_ctx);
+
 	if(command_ctx->query) rm_free(command_ctx->query);
 	rm_free(command_ctx->command_name);
 	rm_free(command_ctx);
@@ -28,6 +28,8 @@ typedef struct {
 	bool compact;                   // Whether this query was issued with the compact flag.
 	ExecutorThread thread;          // Which thread executes this command
 	long long timeout;              // The query timeout, if specified.
+	bool admitted;                  // Whether the command holds a graph admission.
+	double timer[2];                // Time at which the command was received.
 } CommandCtx;
 
 // Create a new command context.
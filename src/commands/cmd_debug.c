@@ -8,6 +8,7 @@
 #include "../redismodule.h"
 #include "../graph/graphcontext.h"
 #include "../module_event_handlers.h"
+#include "execution_ctx.h"
 
 void ModuleEventHandler_AUXBeforeKeyspaceEvent(void);
 void ModuleEventHandler_AUXAfterKeyspaceEvent(void);
@@ -28,9 +29,55 @@ static void Debug_AUX(RedisModuleString **argv, int argc) {
 	}
 }
 
+// GRAPH.DEBUG PENDING <graph>
+// replies with 1 if graph has pending matrix changes, 0 otherwise
+static int Debug_Pending(RedisModuleCtx *ctx, RedisModuleString **argv,
+		int argc) {
+	if(argc < 2) return RedisModule_WrongArity(ctx);
+
+	GraphContext *gc = GraphContext_Retrieve(ctx, argv[1], true, false);
+	// error already emitted
+	if(gc == NULL) return REDISMODULE_OK;
+
+	Graph_AcquireReadLock(gc->g);
+	bool pending = Graph_Pending(gc->g);
+	Graph_ReleaseLock(gc->g);
+	GraphContext_Release(gc);
+
+	return RedisModule_ReplyWithLongLong(ctx, pending);
+}
+
+// GRAPH.DEBUG SPARES <graph> <query>
+// replies with the number of spare plans held for the cached query
+static int Debug_Spares(RedisModuleCtx *ctx, RedisModuleString **argv,
+		int argc) {
+	if(argc < 3) return RedisModule_WrongArity(ctx);
+
+	GraphContext *gc = GraphContext_Retrieve(ctx, argv[1], true, false);
+	// error already emitted
+	if(gc == NULL) return REDISMODULE_OK;
+
+	const char *query = RedisModule_StringPtrLen(argv[2], NULL);
+	uint count = ExecutionCtx_SparePlanCount(GraphContext_GetCache(gc), query);
+	GraphContext_Release(gc);
+
+	return RedisModule_ReplyWithLongLong(ctx, count);
+}
+
 int Graph_Debug(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 	ASSERT(ctx != NULL);
 	ASSERT(graphs_in_keyspace != NULL);
+
+	if(argc < 2) return RedisModule_WrongArity(ctx);
+
+	if(strcmp(RedisModule_StringPtrLen(argv[1], NULL), "PENDING") == 0) {
+		return Debug_Pending(ctx, argv + 1, argc - 1);
+	}
+
+	if(strcmp(RedisModule_StringPtrLen(argv[1], NULL), "SPARES") == 0) {
+		return Debug_Spares(ctx, argv + 1, argc - 1);
+	}
+
 	RedisModule_ReplicateVerbatim(ctx);
 
 	if(strcmp(RedisModule_StringPtrLen(argv[1], NULL), "AUX") == 0) {
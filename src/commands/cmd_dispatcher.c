@@ -101,8 +101,15 @@ static inline bool _validate_command_arity(GRAPH_Commands cmd, int arity) {
 			// Expect a command, graph name, a query, and optional config flags.
 			return arity >= 3 && arity <= 8;
 		case CMD_SLOWLOG:
+		case CMD_OPSTATS:
 			// Expect just a command and graph name.
 			return arity == 2;
+		case CMD_QUERYSTATS:
+			// Expect a command, graph name and an optional subcommand.
+			return arity == 2 || arity == 3;
+		case CMD_EXPORT:
+			// Expect a command, graph name and an export path.
+			return arity == 3;
 		default:
 			ASSERT("encountered unhandled query type" && false);
 			return false;
@@ -121,6 +128,12 @@ static Command_Handler get_command_handler(GRAPH_Commands cmd) {
 			return Graph_Profile;
 		case CMD_SLOWLOG:
 			return Graph_Slowlog;
+		case CMD_OPSTATS:
+			return Graph_OpStats;
+		case CMD_QUERYSTATS:
+			return Graph_QueryStats;
+		case CMD_EXPORT:
+			return Graph_Export;
 		default:
 			ASSERT(false);
 	}
@@ -134,6 +147,9 @@ static GRAPH_Commands determine_command(const char *cmd_name) {
 	if(strcasecmp(cmd_name, "graph.EXPLAIN")  == 0) return CMD_EXPLAIN;
 	if(strcasecmp(cmd_name, "graph.PROFILE")  == 0) return CMD_PROFILE;
 	if(strcasecmp(cmd_name, "graph.SLOWLOG")  == 0) return CMD_SLOWLOG;
+	if(strcasecmp(cmd_name, "graph.OPSTATS")  == 0) return CMD_OPSTATS;
+	if(strcasecmp(cmd_name, "graph.QUERYSTATS") == 0) return CMD_QUERYSTATS;
+	if(strcasecmp(cmd_name, "graph.EXPORT")   == 0) return CMD_EXPORT;
 
 	// we shouldn't reach this point
 	ASSERT(false);
@@ -148,6 +164,9 @@ static bool should_command_create_graph(GRAPH_Commands cmd) {
 		case CMD_PROFILE:
 			return true;
 		case CMD_SLOWLOG:
+		case CMD_OPSTATS:
+		case CMD_QUERYSTATS:
+		case CMD_EXPORT:
 			return false;
 		default:
 			ASSERT(false);
@@ -212,12 +231,32 @@ int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 								 is_replicated, compact, timeout);
 		handler(context);
 	} else {
+		// admit query only if the graph has not exhausted its budget of
+		// queued and running queries, such that a burst of queries against
+		// one graph does not occupy every worker thread
+		// replicated queries are always admitted, rejecting them would
+		// have the replica diverge from its primary
+		uint64_t max_queries_per_graph;
+		Config_Option_get(Config_MAX_QUERIES_PER_GRAPH, &max_queries_per_graph);
+		bool limited = !is_replicated;
+		if(limited && !GraphContext_AdmitQuery(gc, max_queries_per_graph)) {
+			RedisModule_ReplyWithError(ctx, "Max pending queries for graph exceeded");
+			// Release the GraphContext, as we increased its reference count
+			// when retrieving it.
+			GraphContext_Release(gc);
+			return REDISMODULE_OK;
+		}
+
 		// run query on a dedicated thread
 		RedisModuleBlockedClient *bc = RedisModule_BlockClient(ctx, NULL, NULL, NULL, 0);
 		context = CommandCtx_New(NULL, bc, argv[0], query, gc, exec_thread,
 								 is_replicated, compact, timeout);
+		context->admitted = limited;
 
-		if(ThreadPools_AddWorkReader(handler, context) == THPOOL_QUEUE_FULL) {
+		// queries are grouped by graph, such that a burst of queries
+		// against one graph does not starve queries against other graphs
+		if(ThreadPools_AddWorkReader(handler, context, (uintptr_t)gc) ==
+				THPOOL_QUEUE_FULL) {
 			// Report an error once our workers thread pool internal queue
 			// is full, this error usually happens when the server is
 			// under heavy load and is unable to catch up
@@ -0,0 +1,71 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "../query_ctx.h"
+#include "../effects/effects.h"
+#include "../graph/graphcontext.h"
+#include "../resultset/resultset.h"
+
+// apply effects replicated by the primary
+// GRAPH.EFFECT <graph> <effects>
+// effects are accepted from the replication stream and the AOF only
+int Graph_Effect(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	if(argc != 3) return RedisModule_WrongArity(ctx);
+
+	int flags = RedisModule_GetContextFlags(ctx);
+	if(!(flags & (REDISMODULE_CTX_FLAGS_REPLICATED |
+				  REDISMODULE_CTX_FLAGS_LOADING))) {
+		RedisModule_ReplyWithError(ctx,
+				"ERR GRAPH.EFFECT is restricted to replication");
+		return REDISMODULE_OK;
+	}
+
+	size_t len;
+	RedisModuleString *graph_name = argv[1];
+	const char *effects = RedisModule_StringPtrLen(argv[2], &len);
+
+	GraphContext *gc = GraphContext_Retrieve(ctx, graph_name, false, true);
+	// if the GraphContext is null, key access failed and an error has been emitted
+	if(gc == NULL) goto cleanup;
+
+	QueryCtx_SetGraphCtx(gc);
+
+	// index creation and removal report to a result-set
+	ResultSet *result_set = NewResultSet(ctx, FORMATTER_NOP);
+	QueryCtx_SetResultSet(result_set);
+
+	Graph_AcquireWriteLock(gc->g);
+	EffectsStatus status = Effects_Apply(gc, effects, len);
+	Graph_ReleaseLock(gc->g);
+
+	ResultSet_Free(result_set);
+
+	if(status == EFFECTS_MALFORMED) {
+		GraphContext_Release(gc);
+		RedisModule_ReplyWithError(ctx, "ERR Malformed graph effects");
+		goto cleanup;
+	}
+
+	if(status == EFFECTS_DIVERGED) {
+		RedisModule_Log(ctx, "warning",
+				"graph %s diverged from primary, effects partially applied",
+				GraphContext_GetName(gc));
+		GraphContext_Release(gc);
+		RedisModule_ReplyWithError(ctx, "ERR Graph diverged from primary");
+		goto cleanup;
+	}
+
+	GraphContext_Release(gc);
+
+	// effects should propagate to replicas of this replica
+	RedisModule_ReplicateVerbatim(ctx);
+	RedisModule_ReplyWithSimpleString(ctx, "OK");
+
+cleanup:
+	QueryCtx_Free(); // reset the QueryCtx and free its allocations
+	return REDISMODULE_OK;
+}
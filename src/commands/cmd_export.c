@@ -0,0 +1,98 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "cmd_context.h"
+#include "../export/export.h"
+#include "../util/simple_timer.h"
+#include "../configuration/config.h"
+
+#include <limits.h>
+#include <string.h>
+
+// an export name must be a bare file name, such that the export
+// is confined to the configured export directory
+static bool _Export_ValidName
+(
+	const char *name
+) {
+	// reject empty names, '.', '..' and hidden files
+	if(name[0] == '\0' || name[0] == '.') return false;
+	// reject paths
+	return strchr(name, '/') == NULL;
+}
+
+// GRAPH.EXPORT <graph> <name>
+// writes the graph into directory 'name' within the configured
+// EXPORT_DIR as columnar files
+// the export runs on a reader thread, holding the graph's read lock for one
+// chunk of the graph at a time, writers proceed in between chunks
+void Graph_Export(void *args) {
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+	const char *name = command_ctx->query;
+
+	double tic[2];
+	char *err = NULL;
+	ExportStats stats;
+	char time_ms[32];
+	char path[PATH_MAX];
+	const char *export_dir = NULL;
+
+	CommandCtx_TrackCtx(command_ctx);
+
+	// an export might take a while, don't block Redis main thread
+	if(command_ctx->thread == EXEC_THREAD_MAIN) {
+		RedisModule_ReplyWithError(ctx,
+				"GRAPH.EXPORT can't be issued within MULTI, Lua or while loading");
+		goto cleanup;
+	}
+
+	Config_Option_get(Config_EXPORT_DIR, &export_dir);
+	if(export_dir == NULL) {
+		RedisModule_ReplyWithError(ctx,
+				"GRAPH.EXPORT is disabled, EXPORT_DIR is not configured");
+		goto cleanup;
+	}
+
+	if(!_Export_ValidName(name)) {
+		RedisModule_ReplyWithError(ctx,
+				"Export name must be a file name, without a path");
+		goto cleanup;
+	}
+
+	if(snprintf(path, sizeof(path), "%s/%s", export_dir, name) >=
+			(int)sizeof(path)) {
+		RedisModule_ReplyWithError(ctx, "Export name is too long");
+		goto cleanup;
+	}
+
+	simple_tic(tic);
+
+	bool ok = Export_Graph(gc, path, &stats, &err);
+
+	if(!ok) {
+		RedisModule_ReplyWithError(ctx, err);
+		free(err);
+		goto cleanup;
+	}
+
+	RedisModule_ReplyWithArray(ctx, 8);
+	RedisModule_ReplyWithCString(ctx, "nodes");
+	RedisModule_ReplyWithLongLong(ctx, stats.nodes);
+	RedisModule_ReplyWithCString(ctx, "labels");
+	RedisModule_ReplyWithLongLong(ctx, stats.labels);
+	RedisModule_ReplyWithCString(ctx, "edges");
+	RedisModule_ReplyWithLongLong(ctx, stats.edges);
+	RedisModule_ReplyWithCString(ctx, "time_ms");
+	int len = snprintf(time_ms, sizeof(time_ms), "%.3f", simple_toc(tic) * 1000);
+	RedisModule_ReplyWithStringBuffer(ctx, time_ms, len);
+
+cleanup:
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+}
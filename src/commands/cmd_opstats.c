@@ -0,0 +1,23 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cmd_context.h"
+#include "../op_metrics/op_metrics.h"
+
+void Graph_OpStats(void *args) {
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+
+	CommandCtx_TrackCtx(command_ctx);
+
+	OpMetrics *op_metrics = GraphContext_GetOpMetrics(gc);
+	OpMetrics_Replay(op_metrics, ctx);
+
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+}
+
@@ -13,6 +13,7 @@
 #include "../query_ctx.h"
 #include "../graph/graph.h"
 #include "../util/rmalloc.h"
+#include "../util/simple_timer.h"
 #include "../util/cache/cache.h"
 #include "../util/thpool/pools.h"
 #include "../execution_plan/execution_plan.h"
@@ -87,20 +88,44 @@ static void _index_operation(RedisModuleCtx *ctx, GraphContext *gc, AST *ast,
 			}
 		}
 	
+		// the backing store is decided once, when the index is created
+		IndexProvider provider = Index_ConfiguredProvider();
+
 		// add index for each property
 		QueryCtx_LockForCommit();
+		const char **props = array_new(const char *, nprops);
 		for(unsigned int i = 0; i < nprops; i++) {
 			const cypher_astnode_t *prop_name = t == CYPHER_AST_CREATE_NODE_PROPS_INDEX
 				? cypher_ast_create_node_props_index_get_prop_name(index_op, i)
 				: cypher_ast_property_operator_get_prop_name(cypher_ast_create_pattern_props_index_get_property_operator(index_op, i));
 			const char *prop = cypher_ast_prop_name_get_value(prop_name);
+			array_append(props, prop);
 
 			index_added |= (GraphContext_AddExactMatchIndex(&idx, gc,
-						schema_type, label, prop) == INDEX_OK);
+						schema_type, label, prop, provider) == INDEX_OK);
+		}
+
+		// an index statement over multiple properties declares a composite key
+		bool composite_set = false;
+		if(nprops > 1) {
+			if(idx == NULL) {
+				idx = GraphContext_GetIndex(gc, label, NULL, IDX_EXACT_MATCH,
+						schema_type);
+			}
+			composite_set = (idx != NULL &&
+					Index_SetComposite(idx, props, nprops));
 		}
 
 		// populate the index only when at least one attribute was introduced
-		if(index_added) Index_Construct(idx);
+		// or a composite key was declared
+		if(index_added || composite_set) Index_Construct(idx);
+
+		EffectsBuffer *effects = QueryCtx_GetEffectsBuffer();
+		if(effects != NULL) {
+			EffectsBuffer_AddCreateIndex(effects, schema_type, label, props,
+					nprops, provider);
+		}
+		array_free(props);
 
 		QueryCtx_UnlockCommit(NULL);
 	} else if(exec_type == EXECUTION_TYPE_INDEX_DROP) {
@@ -120,6 +145,11 @@ static void _index_operation(RedisModuleCtx *ctx, GraphContext *gc, AST *ast,
 		QueryCtx_LockForCommit();
 		int res = GraphContext_DeleteIndex(gc, schema_type, label, prop,
 				idx_type);
+
+		EffectsBuffer *effects = QueryCtx_GetEffectsBuffer();
+		if(res == INDEX_OK && effects != NULL) {
+			EffectsBuffer_AddDropIndex(effects, schema_type, label, prop);
+		}
 		QueryCtx_UnlockCommit(NULL);
 
 		if(res != INDEX_OK) {
@@ -137,20 +167,43 @@ static void _index_operation(RedisModuleCtx *ctx, GraphContext *gc, AST *ast,
 // timeout handler
 void QueryTimedOut(void *pdata) {
 	ASSERT(pdata != NULL);
-	ExecutionPlan *plan = (ExecutionPlan *)pdata;
-	ExecutionPlan_Drain(plan);
+	GraphQueryCtx *gq_ctx = (GraphQueryCtx *)pdata;
+
+	// drain the plan, operations stop as soon as they pull from a child
+	ExecutionPlan_Drain(gq_ctx->exec_ctx->plan);
+
+	// notify long running operations which check for timeout cooperatively
+	QueryCtx_SetTimedOut(gq_ctx->query_ctx);
 }
 
 // set timeout for query execution
-CronTaskHandle Query_SetTimeOut(uint timeout, ExecutionPlan *plan) {
-	// increase execution plan ref count
-	return Cron_AddTask(timeout, QueryTimedOut, plan);
+CronTaskHandle Query_SetTimeOut(uint timeout, GraphQueryCtx *gq_ctx) {
+	return Cron_AddTask(timeout, QueryTimedOut, gq_ctx);
 }
 
 inline static bool _readonly_cmd_mode(CommandCtx *ctx) {
 	return strcasecmp(CommandCtx_GetCommandName(ctx), "graph.RO_QUERY") == 0;
 }
 
+// log the time a query spent in each stage
+// traces are logged at the verbose level, enabled by Redis' loglevel
+static void _TraceQuery
+(
+	GraphContext *gc,
+	const char *fingerprint
+) {
+	const double *t = QueryCtx_GetStageTimes();
+	RedisModule_Log(NULL, "verbose", "trace graph=%s %s=%.3f %s=%.3f %s=%.3f "
+			"%s=%.3f %s=%.3f %s=%.3f query=%s", GraphContext_GetName(gc),
+			QueryStats_StageName(QueryStage_WAITING),   t[QueryStage_WAITING],
+			QueryStats_StageName(QueryStage_PARSING),   t[QueryStage_PARSING],
+			QueryStats_StageName(QueryStage_PLANNING),  t[QueryStage_PLANNING],
+			QueryStats_StageName(QueryStage_LOCKING),   t[QueryStage_LOCKING],
+			QueryStats_StageName(QueryStage_EXECUTING), t[QueryStage_EXECUTING],
+			QueryStats_StageName(QueryStage_REPLYING),  t[QueryStage_REPLYING],
+			fingerprint);
+}
+
 /* _ExecuteQuery accepts a GraphQeuryCtx as an argument
  * it may be called directly by a reader thread or the Redis main thread,
  * or dispatched as a worker thread job. */
@@ -202,20 +255,32 @@ static void _ExecuteQuery(void *args) {
 		CommandCtx_ThreadSafeContextUnlock(command_ctx);
 	}
 
+	QueryCtx_AdvanceStage(QueryStage_EXECUTING);
+
+	bool sampled = false;  // profile sampled executions
 	if(exec_type == EXECUTION_TYPE_QUERY) {  // query operation
 		// set policy after lock acquisition,
 		// avoid resetting policies between readers and writers
 		Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_FLUSH_RESIZE);
 
+		// sampled executions are profiled to gather per operation statistics
+		OpMetrics *op_metrics = GraphContext_GetOpMetrics(gc);
+		sampled = !profile && OpMetrics_Sample(op_metrics);
+
 		ExecutionPlan_PreparePlan(plan);
 		if(profile) {
 			ExecutionPlan_Profile(plan);
 			if(!ErrorCtx_EncounteredError()) ExecutionPlan_Print(plan, rm_ctx);
 		}
+		else if(sampled) {
+			result_set = ExecutionPlan_Profile(plan);
+		}
 		else {
 			result_set = ExecutionPlan_Execute(plan);
 		}
 
+		if(profile || sampled) OpMetrics_Collect(op_metrics, plan->root);
+
 		// abort timeout if set
 		if(gq_ctx->timeout != 0) Cron_AbortTask(gq_ctx->timeout);
 
@@ -233,6 +298,8 @@ static void _ExecuteQuery(void *args) {
 
 	QueryCtx_ForceUnlockCommit();
 
+	QueryCtx_AdvanceStage(QueryStage_REPLYING);
+
 	if(!profile || ErrorCtx_EncounteredError()) {
 		// if we encountered an error, ResultSet_Reply will emit the error
 		// send result-set back to client
@@ -241,11 +308,31 @@ static void _ExecuteQuery(void *args) {
 
 	if(readonly) Graph_ReleaseLock(gc->g); // release read lock
 
+	QueryCtx_AdvanceStage(QueryStage_DONE);
+
 	// log query to slowlog
 	SlowLog *slowlog = GraphContext_GetSlowLog(gc);
 	SlowLog_Add(slowlog, command_ctx->command_name, command_ctx->query,
 				QueryCtx_GetExecutionTime(), NULL);
 
+	// account for execution under the query's fingerprint
+	const char *fingerprint = query_ctx->query_data.query_no_params;
+	if(fingerprint != NULL && !ErrorCtx_EncounteredError()) {
+		QueryStats *query_stats = GraphContext_GetQueryStats(gc);
+		QueryStats_Add(query_stats, fingerprint, QueryCtx_GetExecutionTime(),
+				ResultSet_RowCount(result_set), exec_ctx->cached);
+		QueryStats_AddStages(query_stats, QueryCtx_GetStageTimes());
+
+		// sampled executions emit a trace of their stages
+		if(sampled) _TraceQuery(gc, fingerprint);
+	}
+
+	// reply has been sent, prepare a plan for the next execution of this query
+	// such that cache hits do not pay for cloning the cached plan
+	if(exec_type == EXECUTION_TYPE_QUERY && !ErrorCtx_EncounteredError()) {
+		ExecutionCtx_AddSparePlan();
+	}
+
 	// clean up
 	ExecutionCtx_Free(exec_ctx);
 	GraphContext_Release(gc);
@@ -275,7 +362,9 @@ static void _DelegateWriter(GraphQueryCtx *gq_ctx) {
 	gq_ctx->command_ctx->thread = EXEC_THREAD_WRITER;
 
 	// dispatch work to the writer thread
-	int res = ThreadPools_AddWorkWriter(_ExecuteQuery, gq_ctx);
+	// writes are grouped by graph, such that graphs share the writer fairly
+	int res = ThreadPools_AddWorkWriter(_ExecuteQuery, gq_ctx,
+			(uintptr_t)gq_ctx->graph_ctx);
 	ASSERT(res == 0);
 }
 
@@ -295,6 +384,10 @@ void _query(bool profile, void *args) {
 
 	QueryCtx_BeginTimer(); // Start query timing.
 
+	// time elapsed since the command was received, queued for a worker thread
+	QueryCtx_SetStageTime(QueryStage_WAITING,
+			simple_toc(command_ctx->timer) * 1000);
+
 	// parse query parameters and build an execution plan or retrieve it from the cache
 	exec_ctx = ExecutionCtx_FromQuery(command_ctx->query);
 	if(exec_ctx == NULL) goto cleanup;
@@ -316,20 +409,20 @@ void _query(bool profile, void *args) {
 		goto cleanup;
 	}
 
-	CronTaskHandle timeout_task = 0;
+	// populate the container struct for invoking _ExecuteQuery.
+	GraphQueryCtx *gq_ctx = GraphQueryCtx_New(gc, ctx, exec_ctx, command_ctx,
+											  readonly, profile, 0);
 
 	// set the query timeout if one was specified
 	if(command_ctx->timeout != 0) {
 		// disallow timeouts on write operations to avoid leaving the graph in an inconsistent state
 		if(readonly) {
-			timeout_task = Query_SetTimeOut(command_ctx->timeout,
-					exec_ctx->plan);
+			gq_ctx->timeout = Query_SetTimeOut(command_ctx->timeout, gq_ctx);
 		}
 	}
 
-	// populate the container struct for invoking _ExecuteQuery.
-	GraphQueryCtx *gq_ctx = GraphQueryCtx_New(gc, ctx, exec_ctx, command_ctx,
-											  readonly, profile, timeout_task);
+	// waiting for the writer thread is accounted as waiting for the graph lock
+	QueryCtx_AdvanceStage(QueryStage_LOCKING);
 
 	// if 'thread' is redis main thread, continue running
 	// if readonly is true we're executing on a worker thread from
@@ -0,0 +1,35 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include <strings.h>
+
+#include "cmd_context.h"
+#include "../query_stats/query_stats.h"
+
+void Graph_QueryStats(void *args) {
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+	const char *subcommand = command_ctx->query;
+
+	CommandCtx_TrackCtx(command_ctx);
+
+	QueryStats *query_stats = GraphContext_GetQueryStats(gc);
+	if(subcommand == NULL) {
+		QueryStats_Replay(query_stats, ctx);
+	} else if(strcasecmp(subcommand, "LATENCY") == 0) {
+		QueryStats_ReplayStages(query_stats, ctx);
+	} else if(strcasecmp(subcommand, "RESET") == 0) {
+		QueryStats_Reset(query_stats);
+		RedisModule_ReplyWithSimpleString(ctx, "OK");
+	} else {
+		RedisModule_ReplyWithError(ctx, "Unknown subcommand, expecting LATENCY or RESET");
+	}
+
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+}
+
@@ -24,7 +24,10 @@ typedef enum {
 	CMD_PROFILE        = 6,
 	CMD_BULK_INSERT    = 7,
 	CMD_SLOWLOG        = 8,
-	CMD_LIST           = 9
+	CMD_LIST           = 9,
+	CMD_OPSTATS        = 10,
+	CMD_QUERYSTATS     = 11,
+	CMD_EXPORT         = 12
 } GRAPH_Commands;
 
 //------------------------------------------------------------------------------
@@ -33,10 +36,14 @@ typedef enum {
 
 void Graph_Query(void *args);
 void Graph_Slowlog(void *args);
+void Graph_OpStats(void *args);
+void Graph_QueryStats(void *args);
+void Graph_Export(void *args);
 void Graph_Profile(void *args);
 void Graph_Explain(void *args);
 int Graph_List(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Debug(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Delete(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+int Graph_Effect(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Config(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
@@ -8,6 +8,8 @@
 #include "RG.h"
 #include "../errors.h"
 #include "../query_ctx.h"
+#include "../util/arr.h"
+#include "../configuration/config.h"
 #include "../execution_plan/execution_plan_clone.h"
 
 static ExecutionType _GetExecutionTypeFromAST(AST *ast) {
@@ -29,9 +31,70 @@ static ExecutionCtx *_ExecutionCtx_New(AST *ast, ExecutionPlan *plan,
 	exec_ctx->cached    = false;
 	exec_ctx->exec_type = exec_type;
 
+	exec_ctx->spare_plans = array_new(ExecutionPlan *, 0);
+	pthread_mutex_init(&exec_ctx->spare_lock, NULL);
+
 	return exec_ctx;
 }
 
+// pop a spare plan, returns NULL if there are no spare plans
+static ExecutionPlan *_ExecutionCtx_PopSparePlan(ExecutionCtx *ctx) {
+	ExecutionPlan *plan = NULL;
+
+	pthread_mutex_lock(&ctx->spare_lock);
+	if(array_len(ctx->spare_plans) > 0) plan = array_pop(ctx->spare_plans);
+	pthread_mutex_unlock(&ctx->spare_lock);
+
+	return plan;
+}
+
+// clone an additional spare plan for a cached execution context
+// invoked by the cache while holding its read lock
+// spares in excess of the configured pool size are freed
+static void _ExecutionCtx_AddSparePlan(void *value, void *pdata) {
+	ExecutionCtx *ctx = (ExecutionCtx *)value;
+	if(ctx->spare_plans == NULL) return;
+
+	uint64_t max_spares;
+	Config_Option_get(Config_SPARE_PLANS, &max_spares);
+
+	ExecutionPlan *excess = NULL;
+	pthread_mutex_lock(&ctx->spare_lock);
+	uint spare_count = array_len(ctx->spare_plans);
+	// pool size got reduced, drop one spare per execution
+	if(spare_count > max_spares) excess = array_pop(ctx->spare_plans);
+	pthread_mutex_unlock(&ctx->spare_lock);
+
+	if(excess != NULL) {
+		ExecutionPlan_Free(excess);
+		return;
+	}
+	if(spare_count >= max_spares) return;
+
+	// clone outside of the lock, cloning is safe under the cache read lock
+	ExecutionPlan *plan = ExecutionPlan_Clone(ctx->plan);
+
+	pthread_mutex_lock(&ctx->spare_lock);
+	if(array_len(ctx->spare_plans) < max_spares) {
+		array_append(ctx->spare_plans, plan);
+		plan = NULL;
+	}
+	pthread_mutex_unlock(&ctx->spare_lock);
+
+	// pool filled up concurrently, discard clone
+	if(plan != NULL) ExecutionPlan_Free(plan);
+}
+
+// count spare plans of a cached execution context
+static void _ExecutionCtx_CountSparePlans(void *value, void *pdata) {
+	ExecutionCtx *ctx = (ExecutionCtx *)value;
+	uint *count = (uint *)pdata;
+
+	pthread_mutex_lock(&ctx->spare_lock);
+	*count = array_len(ctx->spare_plans);
+	pthread_mutex_unlock(&ctx->spare_lock);
+}
+
 ExecutionCtx *ExecutionCtx_Clone(ExecutionCtx *orig) {
 	ExecutionCtx *execution_ctx = rm_malloc(sizeof(ExecutionCtx));
 
@@ -39,16 +102,33 @@ ExecutionCtx *ExecutionCtx_Clone(ExecutionCtx *orig) {
 	// set the AST copy in thread local storage
 	QueryCtx_SetAST(execution_ctx->ast);
 
-	execution_ctx->plan      = ExecutionPlan_Clone(orig->plan);
-	execution_ctx->cached    = orig->cached;
-	execution_ctx->exec_type = orig->exec_type;
+	// prefer a spare plan, cloned ahead of time, over cloning now
+	execution_ctx->plan = _ExecutionCtx_PopSparePlan(orig);
+	if(execution_ctx->plan == NULL) {
+		execution_ctx->plan = ExecutionPlan_Clone(orig->plan);
+	}
+
+	execution_ctx->cached      = orig->cached;
+	execution_ctx->exec_type   = orig->exec_type;
+	execution_ctx->spare_plans = NULL;
 
 	return execution_ctx;
 }
 
-static AST *_ExecutionCtx_ParseAST(const char *query_string,
+static AST *_ExecutionCtx_ParseAST(const char **query_string,
+								   const char *original_query,
 								   cypher_parse_result_t *params_parse_result) {
-	cypher_parse_result_t *query_parse_result = parse_query(query_string);
+	cypher_parse_result_t *query_parse_result = parse_query(*query_string);
+	// literals are parameterized by scanning the query's tokens, which doesn't
+	// validate it, on failure parse the query as it was issued
+	// such that reported errors refer to the original query text
+	if(!query_parse_result && *query_string != original_query) {
+		ErrorCtx_Clear();
+		QueryCtx *ctx = QueryCtx_GetQueryCtx();
+		ctx->query_data.query_no_params = original_query;
+		*query_string = original_query;
+		query_parse_result = parse_query(original_query);
+	}
 	// If no output from the parser, the query is not valid.
 	if(!query_parse_result) {
 		parse_result_free(params_parse_result);
@@ -79,9 +159,23 @@ ExecutionCtx *ExecutionCtx_FromQuery(const char *query) {
 	// Parameter parsing failed, return NULL.
 	if(params_parse_result == NULL) return NULL;
 
+	// replace literals with parameters, such that queries which differ only
+	// by their literal values share a single cached execution plan
+	// literals of different types yield different cache keys
+	const char *original_query = query_string;
+	char *normalized = AST_ParameterizeLiterals(query_string);
+	if(normalized != NULL) {
+		ctx->query_data.query_normalized = normalized;
+		ctx->query_data.query_no_params = normalized;
+		query_string = normalized;
+	}
+
 	GraphContext *gc = QueryCtx_GetGraphCtx();
 	Cache *cache = GraphContext_GetCache(gc);
 
+	// retrieving a cached execution plan is accounted as planning
+	QueryCtx_AdvanceStage(QueryStage_PLANNING);
+
 	// Check the cache to see if we already have a cached context for this query.
 	ret = Cache_GetValue(cache, query_string);
 	if(ret) {
@@ -92,7 +186,9 @@ ExecutionCtx *ExecutionCtx_FromQuery(const char *query) {
 	}
 
 	// No cached execution plan, try to parse the query.
-	AST *ast = _ExecutionCtx_ParseAST(query_string, params_parse_result);
+	QueryCtx_AdvanceStage(QueryStage_PARSING);
+	AST *ast = _ExecutionCtx_ParseAST(&query_string, original_query,
+			params_parse_result);
 	// if query parsing failed, return NULL
 	if(!ast) {
 		// if no error has been set, emit one now
@@ -102,6 +198,8 @@ ExecutionCtx *ExecutionCtx_FromQuery(const char *query) {
 		return NULL;
 	}
 
+	QueryCtx_AdvanceStage(QueryStage_PLANNING);
+
 	ExecutionType exec_type = _GetExecutionTypeFromAST(ast);
 	// In case of valid query, create execution plan, and cache it and the AST.
 	if(exec_type == EXECUTION_TYPE_QUERY) {
@@ -128,11 +226,38 @@ ExecutionCtx *ExecutionCtx_FromQuery(const char *query) {
 	}
 }
 
+void ExecutionCtx_AddSparePlan(void) {
+	QueryCtx *ctx = QueryCtx_GetQueryCtx();
+	const char *query_string = ctx->query_data.query_no_params;
+	if(query_string == NULL) return;
+
+	Cache *cache = GraphContext_GetCache(QueryCtx_GetGraphCtx());
+	Cache_Visit(cache, query_string, _ExecutionCtx_AddSparePlan, NULL);
+}
+
+uint ExecutionCtx_SparePlanCount(Cache *cache, const char *query) {
+	ASSERT(query != NULL);
+	ASSERT(cache != NULL);
+
+	uint count = 0;
+	Cache_Visit(cache, query, _ExecutionCtx_CountSparePlans, &count);
+	return count;
+}
+
 void ExecutionCtx_Free(ExecutionCtx *ctx) {
 	if(ctx == NULL) return;
 	if(ctx->plan != NULL) ExecutionPlan_Free(ctx->plan);
 	if(ctx->ast != NULL) AST_Free(ctx->ast);
 
+	if(ctx->spare_plans != NULL) {
+		uint spare_count = array_len(ctx->spare_plans);
+		for(uint i = 0; i < spare_count; i++) {
+			ExecutionPlan_Free(ctx->spare_plans[i]);
+		}
+		array_free(ctx->spare_plans);
+		pthread_mutex_destroy(&ctx->spare_lock);
+	}
+
 	rm_free(ctx);
 }
 
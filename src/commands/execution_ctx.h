@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <pthread.h>
 #include "../ast/ast.h"
 #include "../execution_plan/execution_plan.h"
 
@@ -20,12 +21,17 @@ typedef enum {
 
 /**
  * @brief  A struct for saving execution objects in cache.
+ * @note   Cached contexts hold a small pool of spare plans cloned ahead
+ *         of time, which are handed out on cache hits instead of cloning,
+ *         the pool's size is set by the SPARE_PLANS configuration.
  */
 typedef struct {
-	AST *ast;                   // AST
-	bool cached;                // cache hit/miss
-	ExecutionPlan *plan;        // execution plan
-	ExecutionType exec_type;    // execution type: query, index create/delete
+	AST *ast;                        // AST
+	bool cached;                     // cache hit/miss
+	ExecutionPlan *plan;             // execution plan
+	ExecutionType exec_type;         // execution type: query, index create/delete
+	ExecutionPlan **spare_plans;     // plans cloned ahead of their execution
+	pthread_mutex_t spare_lock;      // protects access to spare plans
 } ExecutionCtx;
 
 /**
@@ -42,6 +48,20 @@ ExecutionCtx *ExecutionCtx_FromQuery(const char *query);
  */
 ExecutionCtx *ExecutionCtx_Clone(ExecutionCtx *ctx);
 
+/**
+ * @brief  Clone a spare plan for the next execution of the current query,
+ *         to be called once the current query has replied.
+ */
+void ExecutionCtx_AddSparePlan(void);
+
+/**
+ * @brief  Returns the number of spare plans held for a cached query.
+ * @param  *cache: graph's execution plan cache.
+ * @param  *query: cache key, query string without parameters.
+ * @retval number of spare plans, 0 if the query isn't cached.
+ */
+uint ExecutionCtx_SparePlanCount(Cache *cache, const char *query);
+
 /**
  * @brief  Free an ExecutionCTX struct and its inner fields.
  * @param  *ctx: ExecutionCTX struct
@@ -10,6 +10,8 @@
 #include <string.h>
 #include <limits.h>
 #include <errno.h>
+#include <sys/stat.h>
+#include "util/rmalloc.h"
 #include "util/redis_version.h"
 #include "../deps/GraphBLAS/Include/GraphBLAS.h"
 
@@ -49,6 +51,24 @@
 // size of node creation buffer
 #define NODE_CREATION_BUFFER "NODE_CREATION_BUFFER"
 
+// interval in ms between background flushes of pending matrix changes
+#define DELTA_FLUSH_INTERVAL "DELTA_FLUSH_INTERVAL"
+
+// whether new exact-match node indices are backed by a native index
+#define NATIVE_INDEX "NATIVE_INDEX"
+
+// whether write queries are replicated by their effects
+#define EFFECTS_REPLICATION "EFFECTS_REPLICATION"
+
+// config param, max number of queued and running queries per graph
+#define MAX_QUERIES_PER_GRAPH "MAX_QUERIES_PER_GRAPH"
+
+// config param, number of plans cloned ahead of time per cached query
+#define SPARE_PLANS "SPARE_PLANS"
+
+// config param, directory GRAPH.EXPORT writes into
+#define EXPORT_DIR "EXPORT_DIR"
+
 //------------------------------------------------------------------------------
 // Configuration defaults
 //------------------------------------------------------------------------------
@@ -70,6 +90,12 @@ typedef struct {
 	int64_t query_mem_capacity;        // Max mem(bytes) that query/thread can utilize at any given time
 	uint64_t node_creation_buffer;     // Number of extra node creations to buffer as margin in matrices
 	int64_t delta_max_pending_changes; // number of pending changed befor RG_Matrix flushed
+	uint64_t delta_flush_interval;     // ms between background RG_Matrix flushes, 0 disables
+	bool native_index;                 // if true, new exact-match node indices are native
+	bool effects_replication;          // if true, replicate effects rather than queries
+	uint64_t max_queries_per_graph;    // max number of admitted queries per graph, 0 unlimited
+	uint64_t spare_plans;              // plans cloned ahead of time per cached query, 0 disables
+	char *export_dir;                  // directory GRAPH.EXPORT writes into, NULL disables
 	Config_on_change cb;               // callback function which being called when config param changed
 } RG_Config;
 
@@ -266,6 +292,79 @@ uint64_t Config_node_creation_buffer_get(void) {
 	return config.node_creation_buffer;
 }
 
+//------------------------------------------------------------------------------
+// delta flush interval
+//------------------------------------------------------------------------------
+
+void Config_delta_flush_interval_set(uint64_t interval) {
+	config.delta_flush_interval = interval;
+}
+
+uint64_t Config_delta_flush_interval_get(void) {
+	return config.delta_flush_interval;
+}
+
+//------------------------------------------------------------------------------
+// native index
+//------------------------------------------------------------------------------
+
+void Config_native_index_set(bool native_index) {
+	config.native_index = native_index;
+}
+
+bool Config_native_index_get(void) {
+	return config.native_index;
+}
+
+//------------------------------------------------------------------------------
+// effects replication
+//------------------------------------------------------------------------------
+
+void Config_effects_replication_set(bool effects_replication) {
+	config.effects_replication = effects_replication;
+}
+
+bool Config_effects_replication_get(void) {
+	return config.effects_replication;
+}
+
+//------------------------------------------------------------------------------
+// max queries per graph
+//------------------------------------------------------------------------------
+
+void Config_max_queries_per_graph_set(uint64_t max_queries) {
+	config.max_queries_per_graph = max_queries;
+}
+
+uint64_t Config_max_queries_per_graph_get(void) {
+	return config.max_queries_per_graph;
+}
+
+//------------------------------------------------------------------------------
+// spare plans
+//------------------------------------------------------------------------------
+
+void Config_spare_plans_set(uint64_t spare_plans) {
+	config.spare_plans = spare_plans;
+}
+
+uint64_t Config_spare_plans_get(void) {
+	return config.spare_plans;
+}
+
+//------------------------------------------------------------------------------
+// export directory
+//------------------------------------------------------------------------------
+
+void Config_export_dir_set(const char *export_dir) {
+	if(config.export_dir != NULL) rm_free(config.export_dir);
+	config.export_dir = rm_strdup(export_dir);
+}
+
+const char *Config_export_dir_get(void) {
+	return config.export_dir;
+}
+
 bool Config_Contains_field(const char *field_str, Config_Option_Field *field) {
 	ASSERT(field_str != NULL);
 
@@ -291,6 +390,18 @@ bool Config_Contains_field(const char *field_str, Config_Option_Field *field) {
 		f = Config_DELTA_MAX_PENDING_CHANGES;
 	} else if(!(strcasecmp(field_str, NODE_CREATION_BUFFER))) {
 		f = Config_NODE_CREATION_BUFFER;
+	} else if(!(strcasecmp(field_str, DELTA_FLUSH_INTERVAL))) {
+		f = Config_DELTA_FLUSH_INTERVAL;
+	} else if(!(strcasecmp(field_str, NATIVE_INDEX))) {
+		f = Config_NATIVE_INDEX;
+	} else if(!(strcasecmp(field_str, EFFECTS_REPLICATION))) {
+		f = Config_EFFECTS_REPLICATION;
+	} else if(!(strcasecmp(field_str, MAX_QUERIES_PER_GRAPH))) {
+		f = Config_MAX_QUERIES_PER_GRAPH;
+	} else if(!(strcasecmp(field_str, SPARE_PLANS))) {
+		f = Config_SPARE_PLANS;
+	} else if(!(strcasecmp(field_str, EXPORT_DIR))) {
+		f = Config_EXPORT_DIR;
 	} else {
 		return false;
 	}
@@ -346,6 +457,30 @@ const char *Config_Field_name(Config_Option_Field field) {
 			name = NODE_CREATION_BUFFER;
 			break;
 
+		case Config_DELTA_FLUSH_INTERVAL:
+			name = DELTA_FLUSH_INTERVAL;
+			break;
+
+		case Config_NATIVE_INDEX:
+			name = NATIVE_INDEX;
+			break;
+
+		case Config_EFFECTS_REPLICATION:
+			name = EFFECTS_REPLICATION;
+			break;
+
+		case Config_MAX_QUERIES_PER_GRAPH:
+			name = MAX_QUERIES_PER_GRAPH;
+			break;
+
+		case Config_SPARE_PLANS:
+			name = SPARE_PLANS;
+			break;
+
+		case Config_EXPORT_DIR:
+			name = EXPORT_DIR;
+			break;
+
 		//----------------------------------------------------------------------
 		// invalid option
 		//----------------------------------------------------------------------
@@ -398,6 +533,24 @@ void _Config_SetToDefaults(void) {
 
 	// the amount of empty space to reserve for node creations in matrices
 	config.node_creation_buffer = NODE_CREATION_BUFFER_DEFAULT;
+
+	// interval between background flushes of pending matrix changes
+	config.delta_flush_interval = DELTA_FLUSH_INTERVAL_DEFAULT;
+
+	// exact-match indices are backed by RediSearch by default
+	config.native_index = false;
+
+	// write queries are replicated verbatim by default
+	config.effects_replication = false;
+
+	// no limit on number of queries per graph by default
+	config.max_queries_per_graph = QUERIES_PER_GRAPH_UNLIMITED;
+
+	// cached queries hold a few plans cloned ahead of time by default
+	config.spare_plans = SPARE_PLANS_DEFAULT;
+
+	// GRAPH.EXPORT is disabled unless an export directory is configured
+	config.export_dir = NULL;
 }
 
 int Config_Init(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
@@ -605,6 +758,90 @@ bool Config_Option_get(Config_Option_Field field, ...) {
 		}
 		break;
 
+		//----------------------------------------------------------------------
+		// interval between background flushes of pending matrix changes
+		//----------------------------------------------------------------------
+
+		case Config_DELTA_FLUSH_INTERVAL: {
+			va_start(ap, field);
+			uint64_t *delta_flush_interval = va_arg(ap, uint64_t *);
+			va_end(ap);
+
+			ASSERT(delta_flush_interval != NULL);
+			(*delta_flush_interval) = Config_delta_flush_interval_get();
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// native exact-match indices
+		//----------------------------------------------------------------------
+
+		case Config_NATIVE_INDEX: {
+			va_start(ap, field);
+			bool *native_index = va_arg(ap, bool *);
+			va_end(ap);
+
+			ASSERT(native_index != NULL);
+			(*native_index) = Config_native_index_get();
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// effects replication
+		//----------------------------------------------------------------------
+
+		case Config_EFFECTS_REPLICATION: {
+			va_start(ap, field);
+			bool *effects_replication = va_arg(ap, bool *);
+			va_end(ap);
+
+			ASSERT(effects_replication != NULL);
+			(*effects_replication) = Config_effects_replication_get();
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// max queries per graph
+		//----------------------------------------------------------------------
+
+		case Config_MAX_QUERIES_PER_GRAPH: {
+			va_start(ap, field);
+			uint64_t *max_queries_per_graph = va_arg(ap, uint64_t *);
+			va_end(ap);
+
+			ASSERT(max_queries_per_graph != NULL);
+			(*max_queries_per_graph) = Config_max_queries_per_graph_get();
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// spare plans
+		//----------------------------------------------------------------------
+
+		case Config_SPARE_PLANS: {
+			va_start(ap, field);
+			uint64_t *spare_plans = va_arg(ap, uint64_t *);
+			va_end(ap);
+
+			ASSERT(spare_plans != NULL);
+			(*spare_plans) = Config_spare_plans_get();
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// export directory
+		//----------------------------------------------------------------------
+
+		case Config_EXPORT_DIR: {
+			va_start(ap, field);
+			const char **export_dir = va_arg(ap, const char **);
+			va_end(ap);
+
+			ASSERT(export_dir != NULL);
+			(*export_dir) = Config_export_dir_get();
+		}
+		break;
+
 		//----------------------------------------------------------------------
 		// invalid option
 		//----------------------------------------------------------------------
@@ -768,6 +1005,82 @@ bool Config_Option_set(Config_Option_Field field, const char *val) {
 		}
 		break;
 
+		//----------------------------------------------------------------------
+		// interval between background flushes of pending matrix changes
+		//----------------------------------------------------------------------
+
+		case Config_DELTA_FLUSH_INTERVAL: {
+			long long delta_flush_interval;
+			if(!_Config_ParseNonNegativeInteger(val, &delta_flush_interval)) return false;
+
+			Config_delta_flush_interval_set(delta_flush_interval);
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// native exact-match indices
+		//----------------------------------------------------------------------
+
+		case Config_NATIVE_INDEX: {
+			bool native_index;
+			if(!_Config_ParseYesNo(val, &native_index)) return false;
+
+			Config_native_index_set(native_index);
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// effects replication
+		//----------------------------------------------------------------------
+
+		case Config_EFFECTS_REPLICATION: {
+			bool effects_replication;
+			if(!_Config_ParseYesNo(val, &effects_replication)) return false;
+
+			Config_effects_replication_set(effects_replication);
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// max queries per graph
+		//----------------------------------------------------------------------
+
+		case Config_MAX_QUERIES_PER_GRAPH: {
+			long long max_queries_per_graph;
+			if(!_Config_ParseNonNegativeInteger(val, &max_queries_per_graph)) {
+				return false;
+			}
+			Config_max_queries_per_graph_set(max_queries_per_graph);
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// spare plans
+		//----------------------------------------------------------------------
+
+		case Config_SPARE_PLANS: {
+			long long spare_plans;
+			if(!_Config_ParseNonNegativeInteger(val, &spare_plans)) {
+				return false;
+			}
+			Config_spare_plans_set(spare_plans);
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// export directory
+		//----------------------------------------------------------------------
+
+		case Config_EXPORT_DIR: {
+			// must be an absolute path to an existing directory
+			struct stat st;
+			if(val[0] != '/' || stat(val, &st) != 0 || !S_ISDIR(st.st_mode)) {
+				return false;
+			}
+			Config_export_dir_set(val);
+		}
+		break;
+
 		//----------------------------------------------------------------------
 		// invalid option
 		//----------------------------------------------------------------------
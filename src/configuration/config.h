@@ -14,7 +14,10 @@
 #define CONFIG_TIMEOUT_NO_TIMEOUT          0
 #define VKEY_ENTITY_COUNT_UNLIMITED        UINT64_MAX
 #define DELTA_MAX_PENDING_CHANGES_DEFAULT  10000
+#define DELTA_FLUSH_INTERVAL_DEFAULT       1000
 #define NODE_CREATION_BUFFER_DEFAULT       16384
+#define QUERIES_PER_GRAPH_UNLIMITED        0
+#define SPARE_PLANS_DEFAULT                4
 
 typedef enum {
 	Config_TIMEOUT                   = 0,     // timeout value for queries
@@ -28,7 +31,13 @@ typedef enum {
 	Config_QUERY_MEM_CAPACITY        = 8,     // max mem(bytes) that query/thread can utilize at any given time
 	Config_DELTA_MAX_PENDING_CHANGES = 9,     // number of pending changes before RG_Matrix flushed
 	Config_NODE_CREATION_BUFFER      = 10,    // size of buffer to maintain as margin in matrices
-	Config_END_MARKER                = 11
+	Config_DELTA_FLUSH_INTERVAL      = 11,    // ms between background flushes of RG_Matrix deltas
+	Config_NATIVE_INDEX              = 12,    // back new exact-match node indices by a native index
+	Config_EFFECTS_REPLICATION       = 13,    // replicate write queries by their effects
+	Config_MAX_QUERIES_PER_GRAPH     = 14,    // max number of admitted queries per graph
+	Config_SPARE_PLANS               = 15,    // number of plans cloned ahead per cached query
+	Config_EXPORT_DIR                = 16,    // directory GRAPH.EXPORT writes into
+	Config_END_MARKER                = 17
 } Config_Option_Field;
 
 // callback function, invoked once configuration changes as a result of
@@ -36,14 +45,19 @@ typedef enum {
 typedef void (*Config_on_change)(Config_Option_Field type);
 
 // Run-time configurable fields
-#define RUNTIME_CONFIG_COUNT 6
+#define RUNTIME_CONFIG_COUNT 11
 static const Config_Option_Field RUNTIME_CONFIGS[] = {
 	Config_RESULTSET_MAX_SIZE,
 	Config_TIMEOUT,
 	Config_MAX_QUEUED_QUERIES,
 	Config_QUERY_MEM_CAPACITY,
 	Config_DELTA_MAX_PENDING_CHANGES,
-	Config_VKEY_MAX_ENTITY_COUNT
+	Config_VKEY_MAX_ENTITY_COUNT,
+	Config_DELTA_FLUSH_INTERVAL,
+	Config_NATIVE_INDEX,
+	Config_EFFECTS_REPLICATION,
+	Config_MAX_QUERIES_PER_GRAPH,
+	Config_SPARE_PLANS
 };
 
 // Set module-level configurations to defaults or to user arguments where provided.
@@ -10,9 +10,12 @@
 #include <sys/types.h>
 #include "RG.h"
 #include "util/thpool/pools.h"
+#include "graph/graphcontext.h"
 #include "commands/cmd_context.h"
+#include "op_metrics/op_metrics.h"
 
 extern CommandCtx **command_ctxs;
+extern GraphContext **graphs_in_keyspace;
 
 static struct sigaction old_act;
 
@@ -37,9 +40,26 @@ static void logCommands(void) {
 	}
 }
 
+// reports sampled operation statistics aggregated across all graphs
+static void _InfoOpMetrics(RedisModuleInfoCtx *ctx) {
+	OpMetrics *aggregated = OpMetrics_New();
+
+	uint graph_count = array_len(graphs_in_keyspace);
+	for(uint i = 0; i < graph_count; i++) {
+		OpMetrics_Merge(aggregated, GraphContext_GetOpMetrics(graphs_in_keyspace[i]));
+	}
+
+	RedisModule_InfoAddSection(ctx, "operators");
+	OpMetrics_Info(aggregated, ctx);
+
+	OpMetrics_Free(aggregated);
+}
+
 void InfoFunc(RedisModuleInfoCtx *ctx, int for_crash_report) {
-	// make sure information is requested for crash report
-	if(!for_crash_report) return;
+	if(!for_crash_report) {
+		_InfoOpMetrics(ctx);
+		return;
+	}
 
 	// pause all working threads
 	// NOTE: pausing is not an atomic action;
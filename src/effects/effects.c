@@ -0,0 +1,1206 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "effects.h"
+#include "RG.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../schema/schema.h"
+#include "../datatypes/array.h"
+
+//------------------------------------------------------------------------------
+// encoding
+//------------------------------------------------------------------------------
+
+// append 'len' bytes to buffer
+static inline void _Write
+(
+	EffectsBuffer *buff,
+	const void *v,
+	size_t len
+) {
+	buff->buffer = sdscatlen(buff->buffer, v, len);
+}
+
+#define WRITE(buff, type, v) { type _v = (v); _Write((buff), &_v, sizeof(type)); }
+
+// strings are encoded as length followed by a NULL terminated string
+static void _WriteString
+(
+	EffectsBuffer *buff,
+	const char *s
+) {
+	uint32_t len = strlen(s) + 1;
+	WRITE(buff, uint32_t, len);
+	_Write(buff, s, len);
+}
+
+static void _WriteValue
+(
+	EffectsBuffer *buff,
+	SIValue v
+) {
+	// format:
+	// value type
+	// value
+	WRITE(buff, uint32_t, SI_TYPE(v));
+
+	switch(SI_TYPE(v)) {
+		case T_BOOL:
+		case T_INT64:
+			WRITE(buff, int64_t, v.longval);
+			break;
+		case T_DOUBLE:
+			WRITE(buff, double, v.doubleval);
+			break;
+		case T_STRING:
+			_WriteString(buff, v.stringval);
+			break;
+		case T_ARRAY: {
+			uint32_t len = SIArray_Length(v);
+			WRITE(buff, uint32_t, len);
+			for(uint32_t i = 0; i < len; i++) {
+				_WriteValue(buff, SIArray_Get(v, i));
+			}
+			break;
+		}
+		case T_POINT:
+			WRITE(buff, float, v.point.latitude);
+			WRITE(buff, float, v.point.longitude);
+			break;
+		case T_NULL:
+			// no data beyond the type needs to be encoded for a NULL value
+			break;
+		default:
+			// temporal values can't be replicated by effect
+			buff->complete = false;
+			break;
+	}
+}
+
+// returns true if ID has already been defined within buffer
+// marks ID as defined
+static bool _Defined
+(
+	bool **defined,
+	uint id
+) {
+	while(array_len(*defined) <= id) array_append(*defined, false);
+
+	bool res = (*defined)[id];
+	(*defined)[id] = true;
+	return res;
+}
+
+// introduce schema name the first time its ID is referred to
+static void _DefineSchema
+(
+	EffectsBuffer *buff,
+	int id,
+	SchemaType t
+) {
+	bool **defined = (t == SCHEMA_NODE) ? &buff->labels : &buff->relations;
+	if(_Defined(defined, id)) return;
+
+	Schema *s = GraphContext_GetSchemaByID(buff->gc, id, t);
+	ASSERT(s != NULL);
+
+	uint8_t type = (t == SCHEMA_NODE) ?
+		EFFECT_DEFINE_LABEL : EFFECT_DEFINE_RELATION;
+	WRITE(buff, uint8_t, type);
+	WRITE(buff, int32_t, id);
+	_WriteString(buff, Schema_GetName(s));
+}
+
+// introduce attribute name the first time its ID is referred to
+static void _DefineAttribute
+(
+	EffectsBuffer *buff,
+	Attribute_ID attr
+) {
+	if(_Defined(&buff->attributes, attr)) return;
+
+	WRITE(buff, uint8_t, EFFECT_DEFINE_ATTRIBUTE);
+	WRITE(buff, Attribute_ID, attr);
+	_WriteString(buff, GraphContext_GetAttributeString(buff->gc, attr));
+}
+
+static void _DefineAttributes
+(
+	EffectsBuffer *buff,
+	const GraphEntity *ge
+) {
+	int prop_count = ENTITY_PROP_COUNT(ge);
+	for(int i = 0; i < prop_count; i++) {
+		_DefineAttribute(buff, ENTITY_PROPS(ge)[i].id);
+	}
+}
+
+static void _WriteAttributes
+(
+	EffectsBuffer *buff,
+	const GraphEntity *ge
+) {
+	// format:
+	// #attributes N
+	// (attribute ID, value) X N
+	uint32_t prop_count = ENTITY_PROP_COUNT(ge);
+	WRITE(buff, uint32_t, prop_count);
+
+	for(uint32_t i = 0; i < prop_count; i++) {
+		EntityProperty *prop = ENTITY_PROPS(ge) + i;
+		WRITE(buff, Attribute_ID, prop->id);
+		_WriteValue(buff, prop->value);
+	}
+}
+
+// edges are identified by their ID, relationship type and endpoints
+static void _WriteEdge
+(
+	EffectsBuffer *buff,
+	Edge *e
+) {
+	WRITE(buff, EdgeID, ENTITY_GET_ID(e));
+	WRITE(buff, int32_t, EDGE_GET_RELATION_ID(e, buff->gc->g));
+	WRITE(buff, NodeID, Edge_GetSrcNodeID(e));
+	WRITE(buff, NodeID, Edge_GetDestNodeID(e));
+}
+
+EffectsBuffer *EffectsBuffer_New
+(
+	GraphContext *gc
+) {
+	ASSERT(gc != NULL);
+
+	EffectsBuffer *buff = rm_malloc(sizeof(EffectsBuffer));
+
+	buff->gc          =  gc;
+	buff->buffer      =  sdsempty();
+	buff->labels      =  array_new(bool, 0);
+	buff->relations   =  array_new(bool, 0);
+	buff->attributes  =  array_new(bool, 0);
+	buff->complete    =  true;
+
+	WRITE(buff, uint8_t, EFFECTS_VERSION);
+
+	return buff;
+}
+
+void EffectsBuffer_AddCreateNode
+(
+	EffectsBuffer *buff,
+	const Node *n,
+	const int *labels,
+	uint label_count
+) {
+	ASSERT(n    != NULL);
+	ASSERT(buff != NULL);
+
+	// format:
+	// node ID
+	// #labels N
+	// label ID X N
+	// attributes
+
+	for(uint i = 0; i < label_count; i++) {
+		_DefineSchema(buff, labels[i], SCHEMA_NODE);
+	}
+	_DefineAttributes(buff, (const GraphEntity *)n);
+
+	WRITE(buff, uint8_t, EFFECT_CREATE_NODE);
+	WRITE(buff, NodeID, ENTITY_GET_ID(n));
+	WRITE(buff, uint32_t, label_count);
+	for(uint i = 0; i < label_count; i++) {
+		WRITE(buff, int32_t, labels[i]);
+	}
+	_WriteAttributes(buff, (const GraphEntity *)n);
+}
+
+void EffectsBuffer_AddCreateEdge
+(
+	EffectsBuffer *buff,
+	const Edge *e
+) {
+	ASSERT(e    != NULL);
+	ASSERT(buff != NULL);
+
+	// format:
+	// edge ID, relationship type ID, source ID, destination ID
+	// attributes
+
+	_DefineSchema(buff, e->relationID, SCHEMA_EDGE);
+	_DefineAttributes(buff, (const GraphEntity *)e);
+
+	WRITE(buff, uint8_t, EFFECT_CREATE_EDGE);
+	_WriteEdge(buff, (Edge *)e);
+	_WriteAttributes(buff, (const GraphEntity *)e);
+}
+
+void EffectsBuffer_AddDelete
+(
+	EffectsBuffer *buff,
+	Node *nodes,
+	uint node_count,
+	Edge *edges,
+	uint edge_count
+) {
+	ASSERT(buff != NULL);
+
+	// format:
+	// #nodes N
+	// node ID X N
+	// #edges M
+	// edge X M
+
+	WRITE(buff, uint8_t, EFFECT_DELETE);
+
+	// entities deleted by a previous operation are skipped
+	// counts are patched once all entities been inspected
+	size_t offset = sdslen(buff->buffer);
+	uint32_t count = 0;
+	WRITE(buff, uint32_t, count);
+
+	for(uint i = 0; i < node_count; i++) {
+		Node *n = nodes + i;
+		if(GraphEntity_IsDeleted((GraphEntity *)n)) continue;
+		WRITE(buff, NodeID, ENTITY_GET_ID(n));
+		count++;
+	}
+	memcpy(buff->buffer + offset, &count, sizeof(uint32_t));
+
+	offset = sdslen(buff->buffer);
+	count = 0;
+	WRITE(buff, uint32_t, count);
+
+	for(uint i = 0; i < edge_count; i++) {
+		Edge *e = edges + i;
+		if(GraphEntity_IsDeleted((GraphEntity *)e)) continue;
+		_WriteEdge(buff, e);
+		count++;
+	}
+	memcpy(buff->buffer + offset, &count, sizeof(uint32_t));
+}
+
+void EffectsBuffer_AddUpdate
+(
+	EffectsBuffer *buff,
+	GraphEntity *ge,
+	SchemaType t,
+	Attribute_ID attr
+) {
+	ASSERT(ge   != NULL);
+	ASSERT(buff != NULL);
+
+	// format:
+	// entity type
+	// node ID or edge
+	// attribute ID
+	// value, omitted when all attributes are removed
+
+	if(attr != ATTRIBUTE_ALL) _DefineAttribute(buff, attr);
+
+	WRITE(buff, uint8_t, EFFECT_UPDATE);
+	WRITE(buff, uint8_t, t);
+	if(t == SCHEMA_NODE) {
+		WRITE(buff, NodeID, ENTITY_GET_ID(ge));
+	} else {
+		_WriteEdge(buff, (Edge *)ge);
+	}
+	WRITE(buff, Attribute_ID, attr);
+
+	if(attr == ATTRIBUTE_ALL) return;
+
+	// a removed attribute is encoded as NULL
+	SIValue *v = GraphEntity_GetProperty(ge, attr);
+	_WriteValue(buff, (v == PROPERTY_NOTFOUND) ? SI_NullVal() : *v);
+}
+
+void EffectsBuffer_AddCreateIndex
+(
+	EffectsBuffer *buff,
+	SchemaType t,
+	const char *label,
+	const char **fields,
+	uint field_count,
+	IndexProvider p
+) {
+	ASSERT(buff   != NULL);
+	ASSERT(label  != NULL);
+	ASSERT(fields != NULL);
+
+	// format:
+	// schema type
+	// index provider
+	// label
+	// #fields N
+	// field X N
+
+	WRITE(buff, uint8_t, EFFECT_CREATE_INDEX);
+	WRITE(buff, uint8_t, t);
+	WRITE(buff, uint8_t, p);
+	_WriteString(buff, label);
+	WRITE(buff, uint32_t, field_count);
+	for(uint i = 0; i < field_count; i++) _WriteString(buff, fields[i]);
+}
+
+void EffectsBuffer_AddDropIndex
+(
+	EffectsBuffer *buff,
+	SchemaType t,
+	const char *label,
+	const char *field
+) {
+	ASSERT(buff  != NULL);
+	ASSERT(label != NULL);
+	ASSERT(field != NULL);
+
+	// format:
+	// schema type
+	// label
+	// field
+
+	WRITE(buff, uint8_t, EFFECT_DROP_INDEX);
+	WRITE(buff, uint8_t, t);
+	_WriteString(buff, label);
+	_WriteString(buff, field);
+}
+
+void EffectsBuffer_SetIncomplete
+(
+	EffectsBuffer *buff
+) {
+	ASSERT(buff != NULL);
+	buff->complete = false;
+}
+
+bool EffectsBuffer_Complete
+(
+	const EffectsBuffer *buff
+) {
+	ASSERT(buff != NULL);
+	return buff->complete;
+}
+
+const char *EffectsBuffer_Data
+(
+	const EffectsBuffer *buff
+) {
+	ASSERT(buff != NULL);
+	return buff->buffer;
+}
+
+size_t EffectsBuffer_Length
+(
+	const EffectsBuffer *buff
+) {
+	ASSERT(buff != NULL);
+	return sdslen(buff->buffer);
+}
+
+void EffectsBuffer_Free
+(
+	EffectsBuffer *buff
+) {
+	if(buff == NULL) return;
+
+	sdsfree(buff->buffer);
+	array_free(buff->labels);
+	array_free(buff->relations);
+	array_free(buff->attributes);
+	rm_free(buff);
+}
+
+//------------------------------------------------------------------------------
+// decoding
+//------------------------------------------------------------------------------
+
+typedef struct {
+	GraphContext *gc;          // graph to apply effects to
+	const char *data;          // encoded effects
+	size_t len;                // length of encoded effects
+	size_t offset;             // read position
+	int *labels;               // primary label ID to local label ID
+	int *relations;            // primary relationship ID to local relationship ID
+	Attribute_ID *attributes;  // primary attribute ID to local attribute ID
+	GraphEntity *updated;      // last updated entity, pending reindex
+	Node updated_node;         // storage for last updated node
+	Edge updated_edge;         // storage for last updated edge
+	SchemaType updated_type;   // type of last updated entity
+	bool reindex;              // last updated entity requires reindexing
+	bool validate;             // parse effects without applying them
+} EffectsReader;
+
+// read 'len' bytes, returns false if data is exhausted
+static bool _Read
+(
+	EffectsReader *r,
+	void *v,
+	size_t len
+) {
+	if(r->len - r->offset < len) return false;
+
+	memcpy(v, r->data + r->offset, len);
+	r->offset += len;
+	return true;
+}
+
+#define READ(r, v) _Read((r), &(v), sizeof(v))
+
+// read a NULL terminated string, string isn't copied
+static bool _ReadString
+(
+	EffectsReader *r,
+	const char **s
+) {
+	uint32_t len;
+	if(!READ(r, len)) return false;
+	if(len == 0 || r->len - r->offset < len) return false;
+
+	const char *str = r->data + r->offset;
+	if(str[len - 1] != '\0') return false;
+
+	*s = str;
+	r->offset += len;
+	return true;
+}
+
+static bool _ReadValue
+(
+	EffectsReader *r,
+	SIValue *v
+) {
+	uint32_t t;
+	if(!READ(r, t)) return false;
+
+	switch(t) {
+		case T_BOOL:
+		case T_INT64: {
+			int64_t l;
+			if(!READ(r, l)) return false;
+			*v = (t == T_BOOL) ? SI_BoolVal(l) : SI_LongVal(l);
+			return true;
+		}
+		case T_DOUBLE: {
+			double d;
+			if(!READ(r, d)) return false;
+			*v = SI_DoubleVal(d);
+			return true;
+		}
+		case T_STRING: {
+			const char *s;
+			if(!_ReadString(r, &s)) return false;
+			*v = SI_ConstStringVal((char *)s);
+			return true;
+		}
+		case T_ARRAY: {
+			uint32_t len;
+			if(!READ(r, len)) return false;
+
+			SIValue arr = SI_Array(0);
+			for(uint32_t i = 0; i < len; i++) {
+				SIValue elem;
+				if(!_ReadValue(r, &elem)) {
+					SIValue_Free(arr);
+					return false;
+				}
+				// array clones element
+				SIArray_Append(&arr, elem);
+				SIValue_Free(elem);
+			}
+			*v = arr;
+			return true;
+		}
+		case T_POINT: {
+			float lat;
+			float lon;
+			if(!READ(r, lat) || !READ(r, lon)) return false;
+			*v = SI_Point(lat, lon);
+			return true;
+		}
+		case T_NULL:
+			*v = SI_NullVal();
+			return true;
+		default:
+			return false;
+	}
+}
+
+// map primary ID to local ID, returns false if ID wasn't defined
+static bool _ReadSchema
+(
+	EffectsReader *r,
+	SchemaType t,
+	int *id
+) {
+	int32_t primary_id;
+	if(!READ(r, primary_id)) return false;
+
+	int *mapping = (t == SCHEMA_NODE) ? r->labels : r->relations;
+	if(primary_id < 0 || primary_id >= array_len(mapping)) return false;
+	if(mapping[primary_id] == -1) return false;
+
+	*id = mapping[primary_id];
+	return true;
+}
+
+static bool _MapAttribute
+(
+	EffectsReader *r,
+	Attribute_ID primary_id,
+	Attribute_ID *attr
+) {
+	if(primary_id >= array_len(r->attributes)) return false;
+	if(r->attributes[primary_id] == ATTRIBUTE_NOTFOUND) return false;
+
+	*attr = r->attributes[primary_id];
+	return true;
+}
+
+static bool _ReadAttribute
+(
+	EffectsReader *r,
+	Attribute_ID *attr
+) {
+	Attribute_ID primary_id;
+	if(!READ(r, primary_id)) return false;
+
+	return _MapAttribute(r, primary_id, attr);
+}
+
+// read attributes into 'attrs' and 'values'
+static bool _ReadAttributes
+(
+	EffectsReader *r,
+	Attribute_ID **attrs,
+	SIValue **values
+) {
+	uint32_t prop_count;
+	if(!READ(r, prop_count)) return false;
+
+	for(uint32_t i = 0; i < prop_count; i++) {
+		SIValue v;
+		Attribute_ID attr;
+		if(!_ReadAttribute(r, &attr) || !_ReadValue(r, &v)) return false;
+
+		array_append(*attrs, attr);
+		array_append(*values, v);
+	}
+
+	return true;
+}
+
+static void _FreeAttributes
+(
+	Attribute_ID *attrs,
+	SIValue *values
+) {
+	uint count = array_len(values);
+	for(uint i = 0; i < count; i++) SIValue_Free(values[i]);
+
+	array_free(attrs);
+	array_free(values);
+}
+
+static bool _GetNode
+(
+	Graph *g,
+	NodeID id,
+	Node *n
+) {
+	*n = GE_NEW_NODE();
+	return Graph_GetNode(g, id, n);
+}
+
+static bool _ReadEdge
+(
+	EffectsReader *r,
+	Edge *e
+) {
+	EdgeID   id;
+	int      rel;
+	NodeID   src;
+	NodeID   dest;
+
+	if(!READ(r, id)          ||
+	   !_ReadSchema(r, SCHEMA_EDGE, &rel) ||
+	   !READ(r, src)         ||
+	   !READ(r, dest)) {
+		return false;
+	}
+
+	*e = GE_NEW_EDGE();
+
+	// edges might be introduced by preceding effects
+	if(r->validate) return true;
+
+	Graph *g = r->gc->g;
+	if(id >= Graph_EdgeCount(g) + Graph_DeletedEdgeCount(g)) return false;
+	if(!Graph_GetEdge(g, id, e)) return false;
+
+	e->relationID  =  rel;
+	e->srcNodeID   =  src;
+	e->destNodeID  =  dest;
+	return true;
+}
+
+static bool _ApplyDefineSchema
+(
+	EffectsReader *r,
+	SchemaType t
+) {
+	int32_t primary_id;
+	const char *name;
+	if(!READ(r, primary_id) || !_ReadString(r, &name)) return false;
+	if(primary_id < 0) return false;
+
+	int **mapping = (t == SCHEMA_NODE) ? &r->labels : &r->relations;
+	while(array_len(*mapping) <= primary_id) array_append(*mapping, -1);
+
+	// mark ID as defined, schema is introduced once effects are applied
+	if(r->validate) {
+		(*mapping)[primary_id] = 0;
+		return true;
+	}
+
+	Schema *s = GraphContext_GetSchema(r->gc, name, t);
+	if(s == NULL) s = GraphContext_AddSchema(r->gc, name, t);
+	(*mapping)[primary_id] = Schema_GetID(s);
+
+	return true;
+}
+
+static bool _ApplyDefineAttribute
+(
+	EffectsReader *r
+) {
+	Attribute_ID primary_id;
+	const char *name;
+	if(!READ(r, primary_id) || !_ReadString(r, &name)) return false;
+
+	while(array_len(r->attributes) <= primary_id) {
+		array_append(r->attributes, ATTRIBUTE_NOTFOUND);
+	}
+
+	// mark ID as defined, attribute is introduced once effects are applied
+	r->attributes[primary_id] = (r->validate) ? 0 :
+		GraphContext_FindOrAddAttribute(r->gc, name);
+
+	return true;
+}
+
+static void _SetAttributes
+(
+	GraphEntity *ge,
+	Attribute_ID *attrs,
+	SIValue *values
+) {
+	GraphEntity_AddProperties(ge, attrs, values, array_len(attrs));
+}
+
+static bool _ApplyCreateNode
+(
+	EffectsReader *r
+) {
+	NodeID id;
+	uint32_t label_count;
+	if(!READ(r, id) || !READ(r, label_count)) return false;
+
+	bool          res     =  false;
+	Graph         *g      =  r->gc->g;
+	int           *labels =  array_new(int, label_count);
+	Attribute_ID  *attrs  =  array_new(Attribute_ID, 0);
+	SIValue       *values =  array_new(SIValue, 0);
+
+	for(uint32_t i = 0; i < label_count; i++) {
+		int label;
+		if(!_ReadSchema(r, SCHEMA_NODE, &label)) goto cleanup;
+		array_append(labels, label);
+	}
+
+	if(!_ReadAttributes(r, &attrs, &values)) goto cleanup;
+
+	if(r->validate) {
+		res = true;
+		goto cleanup;
+	}
+
+	// replica diverged from primary
+	if(Graph_NextNodeID(g) != id) goto cleanup;
+
+	// make sure matrices are of the right dimensions
+	// same as the primary does when committing nodes
+	Graph_AllocateNodes(g, 1);
+	Graph_SetMatrixPolicy(g, SYNC_POLICY_RESIZE);
+	for(uint32_t i = 0; i < label_count; i++) Graph_GetLabelMatrix(g, labels[i]);
+	if(label_count > 0) Graph_GetNodeLabelMatrix(g);
+	Graph_SetMatrixPolicy(g, SYNC_POLICY_NOP);
+
+	Node n = GE_NEW_NODE();
+	Graph_CreateNode(g, &n, labels, label_count);
+	Graph_SetMatrixPolicy(g, SYNC_POLICY_FLUSH_RESIZE);
+
+	_SetAttributes((GraphEntity *)&n, attrs, values);
+
+	for(uint32_t i = 0; i < label_count; i++) {
+		Schema *s = GraphContext_GetSchemaByID(r->gc, labels[i], SCHEMA_NODE);
+		ASSERT(s != NULL);
+
+		Schema_AddNodeToAttributeStats(s, &n);
+		if(Schema_HasIndices(s)) Schema_AddNodeToIndices(s, &n);
+	}
+
+	res = true;
+
+cleanup:
+	array_free(labels);
+	_FreeAttributes(attrs, values);
+	return res;
+}
+
+static bool _ApplyCreateEdge
+(
+	EffectsReader *r
+) {
+	EdgeID   id;
+	int      rel;
+	NodeID   src;
+	NodeID   dest;
+	Node     n;
+
+	if(!READ(r, id)          ||
+	   !_ReadSchema(r, SCHEMA_EDGE, &rel) ||
+	   !READ(r, src)         ||
+	   !READ(r, dest)) {
+		return false;
+	}
+
+	// endpoints might be introduced by preceding effects
+	Graph *g = r->gc->g;
+	if(!r->validate &&
+	   (!_GetNode(g, src, &n) || !_GetNode(g, dest, &n))) {
+		return false;
+	}
+
+	Attribute_ID *attrs  = array_new(Attribute_ID, 0);
+	SIValue      *values = array_new(SIValue, 0);
+	if(!_ReadAttributes(r, &attrs, &values)) {
+		_FreeAttributes(attrs, values);
+		return false;
+	}
+
+	// replica diverged from primary
+	if(r->validate || Graph_NextEdgeID(g) != id) {
+		_FreeAttributes(attrs, values);
+		return r->validate;
+	}
+
+	// make sure matrices are of the right dimensions
+	// same as the primary does when committing edges
+	Graph_AllocateEdges(g, 1);
+	Graph_SetMatrixPolicy(g, SYNC_POLICY_RESIZE);
+	Graph_GetRelationMatrix(g, rel, false);
+	Graph_GetAdjacencyMatrix(g, false);
+	Graph_SetMatrixPolicy(g, SYNC_POLICY_NOP);
+
+	Edge e = GE_NEW_EDGE();
+	Graph_CreateEdge(g, src, dest, rel, &e);
+	Graph_SetMatrixPolicy(g, SYNC_POLICY_FLUSH_RESIZE);
+
+	_SetAttributes((GraphEntity *)&e, attrs, values);
+
+	Schema *s = GraphContext_GetSchemaByID(r->gc, rel, SCHEMA_EDGE);
+	ASSERT(s != NULL);
+	if(Schema_HasIndices(s)) Schema_AddEdgeToIndices(s, &e);
+
+	_FreeAttributes(attrs, values);
+	return true;
+}
+
+static bool _ApplyDelete
+(
+	EffectsReader *r
+) {
+	bool      res         =  false;
+	Graph     *g          =  r->gc->g;
+	Node      *nodes      =  array_new(Node, 0);
+	Edge      *edges      =  array_new(Edge, 0);
+	uint32_t  node_count  =  0;
+	uint32_t  edge_count  =  0;
+
+	if(!READ(r, node_count)) goto cleanup;
+	for(uint32_t i = 0; i < node_count; i++) {
+		Node n;
+		NodeID id;
+		if(!READ(r, id)) goto cleanup;
+		if(r->validate) continue;
+		if(!_GetNode(g, id, &n)) goto cleanup;
+		array_append(nodes, n);
+	}
+
+	if(!READ(r, edge_count)) goto cleanup;
+	for(uint32_t i = 0; i < edge_count; i++) {
+		Edge e;
+		if(!_ReadEdge(r, &e)) goto cleanup;
+		array_append(edges, e);
+	}
+
+	if(r->validate) {
+		res = true;
+		goto cleanup;
+	}
+
+	// delete entities the same way the primary did
+	GraphContext_DeleteNodesFromAttributeStats(r->gc, nodes, node_count);
+
+	if(GraphContext_HasIndices(r->gc)) {
+		for(uint i = 0; i < node_count; i++) {
+			GraphContext_DeleteNodeFromIndices(r->gc, nodes + i);
+		}
+		for(uint i = 0; i < edge_count; i++) {
+			GraphContext_DeleteEdgeFromIndices(r->gc, edges + i);
+		}
+	}
+
+	uint node_deleted = 0;
+	uint edge_deleted = 0;
+
+	if(edge_count <= EDGE_BULK_DELETE_THRESHOLD) {
+		for(uint i = 0; i < edge_count; i++) {
+			Graph_DeleteEdge(g, edges + i);
+		}
+		edge_count = 0;
+	}
+
+	Graph_BulkDelete(g, nodes, node_count, edges, edge_count, &node_deleted,
+			&edge_deleted);
+
+	res = true;
+
+cleanup:
+	array_free(nodes);
+	array_free(edges);
+	return res;
+}
+
+// reindex last updated entity
+static void _Reindex
+(
+	EffectsReader *r
+) {
+	if(r->updated == NULL) return;
+
+	GraphContext *gc = r->gc;
+	if(r->reindex) {
+		if(r->updated_type == SCHEMA_NODE) {
+			Node *n = &r->updated_node;
+			uint label_count;
+			NODE_GET_LABELS(gc->g, n, label_count);
+			for(uint i = 0; i < label_count; i++) {
+				Schema *s = GraphContext_GetSchemaByID(gc, labels[i],
+						SCHEMA_NODE);
+				ASSERT(s != NULL);
+				Schema_AddNodeToIndices(s, n);
+			}
+		} else {
+			Edge *e = &r->updated_edge;
+			Schema *s = GraphContext_GetSchemaByID(gc, e->relationID,
+					SCHEMA_EDGE);
+			ASSERT(s != NULL);
+			Schema_AddEdgeToIndices(s, e);
+		}
+	}
+
+	r->updated = NULL;
+	r->reindex = false;
+}
+
+// returns true if updating 'attr' requires reindexing entity
+static bool _RequiresReindex
+(
+	EffectsReader *r,
+	GraphEntity *ge,
+	SchemaType t,
+	Attribute_ID attr
+) {
+	GraphContext *gc = r->gc;
+
+	if(t == SCHEMA_NODE) {
+		uint label_count;
+		NODE_GET_LABELS(gc->g, (Node *)ge, label_count);
+		if(attr == ATTRIBUTE_ALL) return label_count > 0;
+
+		for(uint i = 0; i < label_count; i++) {
+			if(GraphContext_GetIndexByID(gc, labels[i], &attr, IDX_ANY,
+						SCHEMA_NODE) != NULL) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	if(attr == ATTRIBUTE_ALL) return true;
+
+	Edge *e = (Edge *)ge;
+	return GraphContext_GetIndexByID(gc, e->relationID, &attr, IDX_ANY,
+			SCHEMA_EDGE) != NULL;
+}
+
+static bool _ApplyUpdate
+(
+	EffectsReader *r
+) {
+	uint8_t t;
+	if(!READ(r, t)) return false;
+	if(t != SCHEMA_NODE && t != SCHEMA_EDGE) return false;
+
+	Node n;
+	Edge e;
+	GraphEntity *ge;
+
+	if(t == SCHEMA_NODE) {
+		NodeID id;
+		if(!READ(r, id)) return false;
+		if(!r->validate && !_GetNode(r->gc->g, id, &n)) return false;
+		ge = (GraphEntity *)&n;
+	} else {
+		if(!_ReadEdge(r, &e)) return false;
+		ge = (GraphEntity *)&e;
+	}
+
+	Attribute_ID attr;
+	Attribute_ID primary_attr;
+	SIValue v = SI_NullVal();
+
+	if(!READ(r, primary_attr)) return false;
+	if(primary_attr == ATTRIBUTE_ALL) {
+		attr = ATTRIBUTE_ALL;
+	} else if(!_MapAttribute(r, primary_attr, &attr) || !_ReadValue(r, &v)) {
+		return false;
+	}
+
+	if(r->validate) {
+		SIValue_Free(v);
+		return true;
+	}
+
+	// updates to a new entity, reindex previous one
+	if(r->updated == NULL || r->updated_type != t ||
+	   ENTITY_GET_ID(r->updated) != ENTITY_GET_ID(ge)) {
+		_Reindex(r);
+
+		r->updated_type = t;
+		if(t == SCHEMA_NODE) {
+			r->updated_node = n;
+			r->updated = (GraphEntity *)&r->updated_node;
+		} else {
+			r->updated_edge = e;
+			r->updated = (GraphEntity *)&r->updated_edge;
+		}
+	}
+	ge = r->updated;
+
+	// apply update, same as the primary did
+	int updated = 0;
+	if(attr == ATTRIBUTE_ALL) {
+		if(t == SCHEMA_NODE) {
+			GraphContext_DeleteNodesFromAttributeStats(r->gc, (Node *)ge, 1);
+		}
+		updated = GraphEntity_ClearProperties(ge);
+	} else {
+		SIValue *old_value = GraphEntity_GetProperty(ge, attr);
+		bool exists = old_value != PROPERTY_NOTFOUND;
+
+		if(t == SCHEMA_NODE && (exists || SI_TYPE(v) != T_NULL)) {
+			GraphContext_UpdateNodeAttributeStats(r->gc, (Node *)ge, attr,
+					exists ? *old_value : SI_NullVal(), v);
+		}
+
+		if(exists) {
+			updated = GraphEntity_SetProperty(ge, attr, v);
+		} else if(SI_TYPE(v) != T_NULL) {
+			updated = GraphEntity_AddProperty(ge, attr, v);
+		}
+	}
+	SIValue_Free(v);
+
+	if(updated) r->reindex |= _RequiresReindex(r, ge, t, attr);
+
+	return true;
+}
+
+static bool _ApplyCreateIndex
+(
+	EffectsReader *r
+) {
+	uint8_t t;
+	uint8_t p;
+	const char *label;
+	uint32_t field_count;
+
+	if(!READ(r, t) || !READ(r, p) || !_ReadString(r, &label) ||
+	   !READ(r, field_count)) {
+		return false;
+	}
+	if(t != SCHEMA_NODE && t != SCHEMA_EDGE) return false;
+	if(p != IDX_PROVIDER_REDISEARCH && p != IDX_PROVIDER_NATIVE) return false;
+
+	if(r->validate) {
+		for(uint32_t i = 0; i < field_count; i++) {
+			const char *field;
+			if(!_ReadString(r, &field)) return false;
+		}
+		return true;
+	}
+
+	Index *idx = NULL;
+	bool index_added = false;
+	const char **fields = array_new(const char *, field_count);
+	for(uint32_t i = 0; i < field_count; i++) {
+		const char *field;
+		bool read = _ReadString(r, &field);
+		ASSERT(read == true);
+		array_append(fields, field);
+
+		index_added |= (GraphContext_AddExactMatchIndex(&idx, r->gc, t, label,
+					field, p) == INDEX_OK);
+	}
+
+	// an index statement over multiple properties declares a composite key
+	bool composite_set = false;
+	if(field_count > 1) {
+		if(idx == NULL) {
+			idx = GraphContext_GetIndex(r->gc, label, NULL, IDX_EXACT_MATCH, t);
+		}
+		composite_set = (idx != NULL &&
+				Index_SetComposite(idx, fields, field_count));
+	}
+	array_free(fields);
+
+	// populate the index only when at least one attribute was introduced
+	// or a composite key was declared
+	if(index_added || composite_set) Index_Construct(idx);
+
+	return true;
+}
+
+static bool _ApplyDropIndex
+(
+	EffectsReader *r
+) {
+	uint8_t t;
+	const char *label;
+	const char *field;
+
+	if(!READ(r, t) || !_ReadString(r, &label) || !_ReadString(r, &field)) {
+		return false;
+	}
+	if(t != SCHEMA_NODE && t != SCHEMA_EDGE) return false;
+	if(r->validate) return true;
+
+	GraphContext_DeleteIndex(r->gc, t, label, field, IDX_EXACT_MATCH);
+	return true;
+}
+
+// read effects one by one, applying each unless reader is validating
+// returns false if an effect is malformed or can't be applied
+static bool _Effects_Process
+(
+	GraphContext *gc,
+	const char *data,
+	size_t len,
+	bool validate
+) {
+	EffectsReader r = {
+		.gc          =  gc,
+		.data        =  data,
+		.len         =  len,
+		.offset      =  0,
+		.labels      =  array_new(int, 0),
+		.relations   =  array_new(int, 0),
+		.attributes  =  array_new(Attribute_ID, 0),
+		.updated     =  NULL,
+		.reindex     =  false,
+		.validate    =  validate,
+	};
+
+	bool res = false;
+
+	uint8_t version;
+	if(!READ(&r, version) || version != EFFECTS_VERSION) goto cleanup;
+
+	while(r.offset < r.len) {
+		uint8_t t;
+		READ(&r, t);
+
+		// consecutive updates to the same entity are reindexed once
+		if(t != EFFECT_UPDATE && t != EFFECT_DEFINE_ATTRIBUTE) _Reindex(&r);
+
+		bool applied = false;
+		switch(t) {
+			case EFFECT_DEFINE_LABEL:
+				applied = _ApplyDefineSchema(&r, SCHEMA_NODE);
+				break;
+			case EFFECT_DEFINE_RELATION:
+				applied = _ApplyDefineSchema(&r, SCHEMA_EDGE);
+				break;
+			case EFFECT_DEFINE_ATTRIBUTE:
+				applied = _ApplyDefineAttribute(&r);
+				break;
+			case EFFECT_CREATE_NODE:
+				applied = _ApplyCreateNode(&r);
+				break;
+			case EFFECT_CREATE_EDGE:
+				applied = _ApplyCreateEdge(&r);
+				break;
+			case EFFECT_DELETE:
+				applied = _ApplyDelete(&r);
+				break;
+			case EFFECT_UPDATE:
+				applied = _ApplyUpdate(&r);
+				break;
+			case EFFECT_CREATE_INDEX:
+				applied = _ApplyCreateIndex(&r);
+				break;
+			case EFFECT_DROP_INDEX:
+				applied = _ApplyDropIndex(&r);
+				break;
+			default:
+				break;
+		}
+
+		if(!applied) goto cleanup;
+	}
+
+	res = true;
+
+cleanup:
+	_Reindex(&r);
+
+	array_free(r.labels);
+	array_free(r.relations);
+	array_free(r.attributes);
+
+	return res;
+}
+
+EffectsStatus Effects_Apply
+(
+	GraphContext *gc,
+	const char *data,
+	size_t len
+) {
+	ASSERT(gc   != NULL);
+	ASSERT(data != NULL);
+
+	// parse the entire changelog before modifying the graph
+	if(!_Effects_Process(gc, data, len, true)) return EFFECTS_MALFORMED;
+
+	// a well formed effect fails to apply only if it refers to entities
+	// the graph doesn't hold or creates an entity under a different ID
+	if(!_Effects_Process(gc, data, len, false)) return EFFECTS_DIVERGED;
+
+	return EFFECTS_APPLIED;
+}
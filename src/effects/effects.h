@@ -0,0 +1,161 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../util/sds/sds.h"
+#include "../graph/graphcontext.h"
+
+// effects describe the changes a write query introduced to a graph
+// rather than replicating the query itself, which replicas would have to
+// re-plan and re-execute, the primary replicates the query's effects
+// as a compact binary changelog which replicas apply directly to the graph
+//
+// changelog format:
+// version
+// (effect type, effect payload) X N
+//
+// labels, relationship types and attributes are referred to by the primary's
+// IDs, the first time an ID is used within a changelog it is preceded by
+// a definition effect mapping it to its name, replicas map names to their own IDs
+
+#define EFFECTS_VERSION 1
+
+// effect types
+typedef enum {
+	EFFECT_DEFINE_LABEL     = 1,  // map label ID to name
+	EFFECT_DEFINE_RELATION  = 2,  // map relationship type ID to name
+	EFFECT_DEFINE_ATTRIBUTE = 3,  // map attribute ID to name
+	EFFECT_CREATE_NODE      = 4,  // node creation
+	EFFECT_CREATE_EDGE      = 5,  // edge creation
+	EFFECT_DELETE           = 6,  // node and edge deletion
+	EFFECT_UPDATE           = 7,  // entity property update
+	EFFECT_CREATE_INDEX     = 8,  // exact-match index creation
+	EFFECT_DROP_INDEX       = 9   // exact-match index removal
+} EffectType;
+
+typedef struct {
+	GraphContext *gc;       // graph effects are collected for
+	sds buffer;             // encoded effects
+	bool *labels;           // label IDs defined within buffer
+	bool *relations;        // relationship type IDs defined within buffer
+	bool *attributes;       // attribute IDs defined within buffer
+	bool complete;          // false if an effect could not be encoded
+} EffectsBuffer;
+
+// create a new effects buffer
+EffectsBuffer *EffectsBuffer_New
+(
+	GraphContext *gc  // graph effects are collected for
+);
+
+// record the creation of a node, including its labels and attributes
+void EffectsBuffer_AddCreateNode
+(
+	EffectsBuffer *buff,  // effects buffer
+	const Node *n,        // created node
+	const int *labels,    // node labels
+	uint label_count      // number of labels
+);
+
+// record the creation of an edge, including its attributes
+void EffectsBuffer_AddCreateEdge
+(
+	EffectsBuffer *buff,  // effects buffer
+	const Edge *e         // created edge
+);
+
+// record the deletion of nodes and edges
+// must be called before entities are removed from the graph
+void EffectsBuffer_AddDelete
+(
+	EffectsBuffer *buff,  // effects buffer
+	Node *nodes,          // nodes to delete
+	uint node_count,      // number of nodes to delete
+	Edge *edges,          // edges to delete
+	uint edge_count       // number of edges to delete
+);
+
+// record an update to an entity's attribute
+// the attribute's current value is recorded, a missing attribute
+// is recorded as removed, ATTRIBUTE_ALL records the removal of all attributes
+void EffectsBuffer_AddUpdate
+(
+	EffectsBuffer *buff,  // effects buffer
+	GraphEntity *ge,      // updated entity
+	SchemaType t,         // entity type
+	Attribute_ID attr     // updated attribute
+);
+
+// record the creation of an exact-match index
+void EffectsBuffer_AddCreateIndex
+(
+	EffectsBuffer *buff,  // effects buffer
+	SchemaType t,         // schema type
+	const char *label,    // indexed label or relationship type
+	const char **fields,  // indexed attributes
+	uint field_count,     // number of indexed attributes
+	IndexProvider p       // index backing store
+);
+
+// record the removal of an exact-match index
+void EffectsBuffer_AddDropIndex
+(
+	EffectsBuffer *buff,  // effects buffer
+	SchemaType t,         // schema type
+	const char *label,    // indexed label or relationship type
+	const char *field     // indexed attribute
+);
+
+// mark buffer as incomplete
+// the query introducing a change which can't be described by effects
+// is replicated as is
+void EffectsBuffer_SetIncomplete
+(
+	EffectsBuffer *buff  // effects buffer
+);
+
+// returns true if buffer describes all changes made by the query
+bool EffectsBuffer_Complete
+(
+	const EffectsBuffer *buff  // effects buffer
+);
+
+// returns buffer's encoded effects
+const char *EffectsBuffer_Data
+(
+	const EffectsBuffer *buff  // effects buffer
+);
+
+// returns the length of buffer's encoded effects
+size_t EffectsBuffer_Length
+(
+	const EffectsBuffer *buff  // effects buffer
+);
+
+// free effects buffer
+void EffectsBuffer_Free
+(
+	EffectsBuffer *buff  // effects buffer to free
+);
+
+// outcome of applying effects
+typedef enum {
+	EFFECTS_APPLIED   = 0,  // all effects were applied
+	EFFECTS_MALFORMED = 1,  // effects are malformed, graph is left untouched
+	EFFECTS_DIVERGED  = 2   // graph doesn't match the primary's graph
+} EffectsStatus;
+
+// apply encoded effects to graph
+// expecting the caller to hold the graph's write lock
+// the entire changelog is validated before any effect is applied
+// effects preceding a divergence remain applied
+EffectsStatus Effects_Apply
+(
+	GraphContext *gc,  // graph to apply effects to
+	const char *data,  // encoded effects
+	size_t len         // length of encoded effects
+);
@@ -372,12 +372,23 @@ Record ExecutionPlan_BorrowRecord(ExecutionPlan *plan) {
 	Record r = ObjectPool_NewItem(plan->record_pool);
 	r->owner = plan;
 	r->mapping = mapping;
+	r->parent = NULL;
+	r->ref_count = 1;
 	return r;
 }
 
 void ExecutionPlan_ReturnRecord(ExecutionPlan *plan, Record r) {
 	ASSERT(plan && r);
+	ASSERT(r->ref_count > 0);
+
+	// Records sharing r's entries keep it alive.
+	if(--r->ref_count > 0) return;
+
+	Record parent = r->parent;
 	ObjectPool_DeleteItem(plan->record_pool, r);
+
+	// Release the record r shared entries with.
+	if(parent) ExecutionPlan_ReturnRecord(parent->owner, parent);
 }
 
 //------------------------------------------------------------------------------
@@ -420,14 +431,22 @@ ResultSet *ExecutionPlan_Execute(ExecutionPlan *plan) {
 	int encountered_error = SET_EXCEPTION_HANDLER();
 
 	// Encountered a run-time error - return immediately.
-	if(encountered_error) return QueryCtx_GetResultSet();
+	if(encountered_error) {
+		Arena_SetActive(NULL);
+		return QueryCtx_GetResultSet();
+	}
 
 	ExecutionPlan_Init(plan);
 
+	// intermediate values produced during execution are drawn from the query's arena
+	Arena_SetActive(QueryCtx_GetArena());
+
 	Record r = NULL;
 	// Execute the root operation and free the processed Record until the data stream is depleted.
 	while((r = OpBase_Consume(plan->root)) != NULL) ExecutionPlan_ReturnRecord(r->owner, r);
 
+	Arena_SetActive(NULL);
+
 	return QueryCtx_GetResultSet();
 }
 
@@ -166,6 +166,12 @@ Record OpBase_CloneRecord(Record r) {
 	return clone;
 }
 
+Record OpBase_ShareRecord(Record r) {
+	Record clone = ExecutionPlan_BorrowRecord((struct ExecutionPlan *)r->owner);
+	Record_Share(r, clone);
+	return clone;
+}
+
 inline OPType OpBase_Type(const OpBase *op) {
 	ASSERT(op != NULL);
 	return op->type;
@@ -20,6 +20,7 @@ typedef enum {
 	OPType_ALL_NODE_SCAN,
 	OPType_NODE_BY_LABEL_SCAN,
 	OPType_NODE_BY_INDEX_SCAN,
+	OPType_NODE_BY_ORDERED_INDEX_SCAN,
 	OPType_EDGE_BY_INDEX_SCAN,
 	OPType_NODE_BY_ID_SEEK,
 	OPType_NODE_BY_LABEL_AND_ID_SCAN,
@@ -183,6 +184,10 @@ Record OpBase_CreateRecord(const OpBase *op);
 // Clones given record.
 Record OpBase_CloneRecord(Record r);
 
+// Creates a new record sharing the entries of the given record
+// the given record must not be modified while shared.
+Record OpBase_ShareRecord(Record r);
+
 // Release record.
 void OpBase_DeleteRecord(Record r);
 
@@ -70,8 +70,8 @@ static Record ApplyConsume(OpBase *opBase) {
 			continue;
 		}
 
-		// Clone the bound Record and merge the RHS Record into it.
-		Record r = OpBase_CloneRecord(op->r);
+		// Share the bound Record and merge the RHS Record into it.
+		Record r = OpBase_ShareRecord(op->r);
 		Record_Merge(r, rhs_record);
 		// Delete the RHS record, as it has been merged into r.
 		OpBase_DeleteRecord(rhs_record);
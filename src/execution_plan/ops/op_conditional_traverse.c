@@ -20,7 +20,13 @@ static OpBase *CondTraverseClone(const ExecutionPlan *plan, const OpBase *opBase
 static void CondTraverseFree(OpBase *opBase);
 
 static void CondTraverseToString(const OpBase *ctx, sds *buf) {
-	TraversalToString(ctx, buf, ((const OpCondTraverse *)ctx)->ae);
+	const OpCondTraverse *op = (const OpCondTraverse *)ctx;
+	TraversalToString(ctx, buf, op->ae);
+
+	// report destination index
+	if(op->dest_filter != NULL) {
+		*buf = sdscatprintf(*buf, " | Index :%s", op->dest_label);
+	}
 }
 
 static void _populate_filter_matrix(OpCondTraverse *op) {
@@ -38,6 +44,35 @@ static void _populate_filter_matrix(OpCondTraverse *op) {
 	GrB_Matrix_wait(FM, GrB_MATERIALIZE);
 }
 
+// replace destination label operand with a diagonal matrix
+// holding the nodes reported by the destination index
+static void _apply_dest_index(OpCondTraverse *op) {
+	AlgebraicExpression *operand = NULL;
+	const char *dest = AlgebraicExpression_Dest(op->ae);
+
+	bool found = AlgebraicExpression_LocateOperand(op->ae, &operand, NULL,
+			dest, dest, NULL, op->dest_label);
+	if(!found || operand->operand.matrix != NULL) return;
+
+	// estimate again now that parameters are known, the plan might be
+	// cached and the data might have changed since it was built
+	// if many nodes match, the label matrix remains in place
+	if(IndexScan_EstimateSelectivity(op->dest_idx, op->dest_filter, true) >
+	   INDEX_SCAN_DEST_MAX_SELECTIVITY) {
+		return;
+	}
+
+	IndexScanIter it;
+	IndexScanIter_Init(&it, op->dest_idx);
+	IndexScanIter_Build(&it, op->dest_filter, NULL);
+
+	size_t required_dim = Graph_RequiredMatrixDim(op->graph);
+	operand->operand.matrix = IndexScanIter_ToDiagonal(&it, required_dim);
+	operand->operand.bfree = true;
+
+	IndexScanIter_Free(&it);
+}
+
 /* Evaluate algebraic expression:
  * prepends filter matrix as the left most operand
  * perform multiplications
@@ -53,6 +88,9 @@ void _traverse(OpCondTraverse *op) {
 		RG_Matrix_new(&op->M, GrB_BOOL, op->record_cap, required_dim);
 		RG_Matrix_new(&op->F, GrB_BOOL, op->record_cap, required_dim);
 
+		// restrict destination nodes prior to populating operands
+		if(op->dest_filter != NULL) _apply_dest_index(op);
+
 		// Prepend the filter matrix to algebraic expression as the leftmost operand.
 		AlgebraicExpression_MultiplyToTheLeft(&op->ae, op->F);
 
@@ -85,6 +123,9 @@ OpBase *NewCondTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicExpressi
 	op->record_count = 0;
 	op->edge_ctx = NULL;
 	op->record_cap = BATCH_SIZE;
+	op->dest_idx = NULL;
+	op->dest_label = NULL;
+	op->dest_filter = NULL;
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_CONDITIONAL_TRAVERSE, "Conditional Traverse", CondTraverseInit,
@@ -110,6 +151,24 @@ OpBase *NewCondTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicExpressi
 	return (OpBase *)op;
 }
 
+void CondTraverseOp_SetDestIndex
+(
+	OpCondTraverse *op,
+	Index *idx,
+	const char *label,
+	FT_FilterNode *filter
+) {
+	ASSERT(op     != NULL);
+	ASSERT(idx    != NULL);
+	ASSERT(label  != NULL);
+	ASSERT(filter != NULL);
+	ASSERT(op->dest_filter == NULL);
+
+	op->dest_idx     =  idx;
+	op->dest_label   =  label;
+	op->dest_filter  =  filter;
+}
+
 static OpResult CondTraverseInit(OpBase *opBase) {
 	OpCondTraverse *op = (OpCondTraverse *)opBase;
 	// Create 'records' with this Init function as 'record_cap'
@@ -152,6 +211,11 @@ static Record CondTraverseConsume(OpBase *opBase) {
 		 * Free old records. */
 		op->r = NULL;
 		for(uint i = 0; i < op->record_count; i++) OpBase_DeleteRecord(op->records[i]);
+		op->record_count = 0;
+
+		// the child might produce many records without a single traversal
+		// result, stop refreshing once the query timed out
+		if(QueryCtx_TimedOut()) return NULL;
 
 		// Ask child operations for data.
 		for(op->record_count = 0; op->record_count < op->record_cap; op->record_count++) {
@@ -216,7 +280,15 @@ static OpResult CondTraverseReset(OpBase *ctx) {
 static inline OpBase *CondTraverseClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	ASSERT(opBase->type == OPType_CONDITIONAL_TRAVERSE);
 	OpCondTraverse *op = (OpCondTraverse *)opBase;
-	return NewCondTraverseOp(plan, QueryCtx_GetGraph(), AlgebraicExpression_Clone(op->ae));
+	OpCondTraverse *clone = (OpCondTraverse *)NewCondTraverseOp(plan,
+			QueryCtx_GetGraph(), AlgebraicExpression_Clone(op->ae));
+
+	if(op->dest_filter != NULL) {
+		CondTraverseOp_SetDestIndex(clone, op->dest_idx, op->dest_label,
+				FilterTree_Clone(op->dest_filter));
+	}
+
+	return (OpBase *)clone;
 }
 
 /* Frees CondTraverse */
@@ -247,6 +319,11 @@ static void CondTraverseFree(OpBase *ctx) {
 		op->edge_ctx = NULL;
 	}
 
+	if(op->dest_filter) {
+		FilterTree_Free(op->dest_filter);
+		op->dest_filter = NULL;
+	}
+
 	if(op->records) {
 		for(uint i = 0; i < op->record_count; i++) OpBase_DeleteRecord(op->records[i]);
 		rm_free(op->records);
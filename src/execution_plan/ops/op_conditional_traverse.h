@@ -9,6 +9,7 @@
 #include "op.h"
 #include "../execution_plan.h"
 #include "shared/traverse_functions.h"
+#include "shared/index_scan_functions.h"
 #include "../../graph/rg_matrix/rg_matrix_iter.h"
 #include "../../arithmetic/algebraic_expression.h"
 #include "../../../deps/GraphBLAS/Include/GraphBLAS.h"
@@ -28,8 +29,22 @@ typedef struct {
 	uint record_cap;            // Max number of records to process.
 	Record *records;            // Array of records.
 	Record r;                   // Currently selected record.
+	Index *dest_idx;            // [optional] index restricting destination nodes
+	const char *dest_label;     // label of indexed destination nodes
+	FT_FilterNode *dest_filter; // destination filter resolved by dest_idx
 } OpCondTraverse;
 
 /* Creates a new Traverse operation */
 OpBase *NewCondTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicExpression *ae);
 
+// restrict destination nodes to those reported by an index query
+// the index results replace the destination's label matrix
+// with a diagonal matrix, filters are not removed from the plan
+void CondTraverseOp_SetDestIndex
+(
+	OpCondTraverse *op,     // traverse operation
+	Index *idx,             // index over destination label
+	const char *label,      // destination label
+	FT_FilterNode *filter   // filter to query index with, op takes ownership
+);
+
@@ -30,6 +30,15 @@ void _DeleteEntities(OpDelete *op) {
 	// lock everything
 	QueryCtx_LockForCommit();
 
+	EffectsBuffer *effects = QueryCtx_GetEffectsBuffer();
+	if(effects != NULL) {
+		EffectsBuffer_AddDelete(effects, op->deleted_nodes, node_count,
+				op->deleted_edges, edge_count);
+	}
+
+	GraphContext_DeleteNodesFromAttributeStats(op->gc, op->deleted_nodes,
+			node_count);
+
 	if(GraphContext_HasIndices(op->gc)) {
 		for(int i = 0; i < node_count; i++) {
 			Node *n = op->deleted_nodes + i;
@@ -273,6 +273,10 @@ static Record ExpandIntoConsume
 		ASSERT(op->r == NULL);
 		ASSERT(op->record_count == 0);
 
+		// the child might produce many records without a single connected
+		// pair, stop refreshing once the query timed out
+		if(QueryCtx_TimedOut()) return NULL;
+
 		//----------------------------------------------------------------------
 		// get data
 		//----------------------------------------------------------------------
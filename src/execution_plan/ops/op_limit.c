@@ -10,30 +10,42 @@
 #include "../../arithmetic/arithmetic_expression.h"
 
 /* Forward declarations. */
+static OpResult LimitInit(OpBase *opBase);
 static Record LimitConsume(OpBase *opBase);
 static OpResult LimitReset(OpBase *opBase);
 static void LimitFree(OpBase *opBase);
 static OpBase *LimitClone(const ExecutionPlan *plan, const OpBase *opBase);
 
-static void _eval_limit(OpLimit *op, AR_ExpNode *limit_exp) {
-	/* Store a copy of the original expression.
-	 * This is required in the case of a parameterized limit: "LIMIT $L"
-	 * Evaluating the expression will modify it, replacing the parameter with a constant.
-	 * As a result, clones of this operation would invalidly resolve to an outdated constant. */
-	op->limit_exp = AR_EXP_Clone(limit_exp);
+bool LimitOp_Evaluate(OpLimit *op) {
+	ASSERT(op != NULL);
 
-	// Evaluate using the input expression, leaving the stored expression untouched.
-	SIValue l = AR_EXP_Evaluate(limit_exp, NULL);
+	// evaluate a copy, evaluating a parameter replaces it with a constant
+	AR_ExpNode *exp = AR_EXP_Clone(op->limit_exp);
+	SIValue l = AR_EXP_Evaluate(exp, NULL);
+	AR_EXP_Free(exp);
 
-	// Validate that the limit value is numeric and non-negative.
+	// validate that the limit value is numeric and non-negative
 	if(SI_TYPE(l) != T_INT64 || SI_GET_NUMERIC(l) < 0) {
 		ErrorCtx_SetError("Limit operates only on non-negative integers");
+		return false;
 	}
 
 	op->limit = SI_GET_NUMERIC(l);
+	return true;
+}
+
+// create a Limit operation without evaluating its expression
+static OpLimit *_NewLimitOp(const ExecutionPlan *plan, AR_ExpNode *limit_exp) {
+	OpLimit *op = rm_malloc(sizeof(OpLimit));
+	op->limit = 0;
+	op->consumed = 0;
+	op->limit_exp = limit_exp;
 
-	// Free the expression we've evaluated.
-	AR_EXP_Free(limit_exp);
+	// set operations
+	OpBase_Init((OpBase *)op, OPType_LIMIT, "Limit", LimitInit, LimitConsume,
+			LimitReset, NULL, LimitClone, LimitFree, false, plan);
+
+	return op;
 }
 
 OpBase *NewLimitOp(const ExecutionPlan *plan, AR_ExpNode *limit_exp) {
@@ -41,20 +53,24 @@ OpBase *NewLimitOp(const ExecutionPlan *plan, AR_ExpNode *limit_exp) {
 	ASSERT(plan != NULL);
 	ASSERT(limit_exp != NULL);
 
-	OpLimit *op = rm_malloc(sizeof(OpLimit));
-	op->limit = 0;
-	op->consumed = 0;
-	op->limit_exp = NULL;
-
-	_eval_limit(op, limit_exp);
+	OpLimit *op = _NewLimitOp(plan, limit_exp);
 
-	// set operations
-	OpBase_Init((OpBase *)op, OPType_LIMIT, "Limit", NULL, LimitConsume, LimitReset, NULL,
-				LimitClone, LimitFree, false, plan);
+	// evaluate at construction time to report an invalid limit early on
+	LimitOp_Evaluate(op);
 
 	return (OpBase *)op;
 }
 
+// re-evaluate limit on every execution, as parameter values change
+// between executions of a cached plan
+static OpResult LimitInit(OpBase *opBase) {
+	OpLimit *op = (OpLimit *)opBase;
+
+	if(!LimitOp_Evaluate(op)) ErrorCtx_RaiseRuntimeException(NULL);
+
+	return OP_OK;
+}
+
 static Record LimitConsume(OpBase *opBase) {
 	OpLimit *op = (OpLimit *)opBase;
 
@@ -77,11 +93,9 @@ static inline OpBase *LimitClone(const ExecutionPlan *plan, const OpBase *opBase
 	ASSERT(opBase->type == OPType_LIMIT);
 
 	OpLimit *op = (OpLimit *)opBase;
-	/* Clone the limit expression stored on the ExecutionPlan,
-	 * as we don't want to modify the templated ExecutionPlan
-	 * (which may occur if this expression is a parameter). */
+	// the limit expression is evaluated once the clone is initialized
 	AR_ExpNode *limit_exp = AR_EXP_Clone(op->limit_exp);
-	return NewLimitOp(plan, limit_exp);
+	return (OpBase *)_NewLimitOp(plan, limit_exp);
 }
 
 static void LimitFree(OpBase *opBase) {
@@ -19,3 +19,8 @@ typedef struct {
 // Limits number of produced records
 OpBase *NewLimitOp(const ExecutionPlan *plan, AR_ExpNode *limit_exp);
 
+// evaluates the limit expression against the current query's parameters
+// clones defer evaluation, as they might be created ahead of the
+// execution they serve
+// sets an error and returns false if limit isn't a non-negative integer
+bool LimitOp_Evaluate(OpLimit *op);
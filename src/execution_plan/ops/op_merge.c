@@ -209,6 +209,10 @@ static Record MergeConsume(OpBase *opBase) {
 	uint  match_count          =  0;
 	bool  reading_matches      =  true;
 	bool  must_create_records  =  false;
+	// scalars might reference properties which are about to be updated
+	// by either ON MATCH or ON CREATE, as matched and created records
+	// can refer to the same entities
+	bool  detach_scalars       =  op->on_match || op->on_create;
 	// match mode: attempt to resolve the pattern for every record from
 	// the bound variable stream, or once if we have no bound variables
 	while(reading_matches) {
@@ -234,6 +238,7 @@ static Record MergeConsume(OpBase *opBase) {
 		while((rhs_record = _pullFromStream(op->match_stream))) {
 			// pattern was successfully matched
 			should_create_pattern = false;
+			if(detach_scalars) Record_DetachScalars(rhs_record);
 			array_append(op->output_records, rhs_record);
 			match_count++;
 		}
@@ -244,7 +249,8 @@ static Record MergeConsume(OpBase *opBase) {
 			 * but we must make sure its elements are access-safe, as the input stream will be freed
 			 * before entities are created */
 			if(lhs_record) {
-				Record_PersistScalars(lhs_record);
+				if(detach_scalars) Record_DetachScalars(lhs_record);
+				else Record_PersistScalars(lhs_record);
 				Argument_AddRecord(op->create_argument_tap, lhs_record);
 				lhs_record = NULL;
 			}
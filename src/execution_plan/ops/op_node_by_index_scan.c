@@ -7,7 +7,6 @@
 #include "op_node_by_index_scan.h"
 #include "../../query_ctx.h"
 #include "shared/print_functions.h"
-#include "../../filter_tree/ft_to_rsq.h"
 
 // forward declarations
 static OpResult IndexScanInit(OpBase *opBase);
@@ -22,7 +21,7 @@ static void IndexScanToString(const OpBase *ctx, sds *buf) {
 }
 
 OpBase *NewIndexScanOp(const ExecutionPlan *plan, Graph *g, NodeScanCtx n,
-		RSIndex *idx, FT_FilterNode *filter) {
+		Index *idx, FT_FilterNode *filter) {
 	// validate inputs
 	ASSERT(g      != NULL);
 	ASSERT(idx    != NULL);
@@ -32,13 +31,13 @@ OpBase *NewIndexScanOp(const ExecutionPlan *plan, Graph *g, NodeScanCtx n,
 	IndexScan *op = rm_malloc(sizeof(IndexScan));
 	op->g                    =  g;
 	op->n                    =  n;
-	op->idx                  =  idx;
-	op->iter                 =  NULL;
 	op->filter               =  filter;
 	op->child_record         =  NULL;
 	op->unresolved_filters   =  NULL;
 	op->rebuild_index_query  =  false;
 
+	IndexScanIter_Init(&op->iter, idx);
+
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_NODE_BY_INDEX_SCAN, "Node By Index Scan", IndexScanInit, IndexScanConsume,
 				IndexScanReset, IndexScanToString, NULL, IndexScanFree, false, plan);
@@ -89,18 +88,17 @@ static inline bool _PassUnresolvedFilters(const IndexScan *op, Record r) {
 
 static Record IndexScanConsumeFromChild(OpBase *opBase) {
 	IndexScan *op = (IndexScan *)opBase;
-	const EntityID *nodeId = NULL;
+	EntityID nodeId;
 
 pull_index:
 	//--------------------------------------------------------------------------
 	// pull from index
 	//--------------------------------------------------------------------------
 
-	if(op->iter != NULL && op->child_record != NULL) {
-		while((nodeId = RediSearch_ResultsIteratorNext(op->iter, op->idx, NULL))
-				!= NULL) {
+	if(IndexScanIter_IsSet(&op->iter) && op->child_record != NULL) {
+		while(IndexScanIter_Next(&op->iter, &nodeId)) {
 			// populate record with node
-			_UpdateRecord(op, op->child_record, *nodeId);
+			_UpdateRecord(op, op->child_record, nodeId);
 			// apply unresolved filters
 			if(_PassUnresolvedFilters(op, op->child_record)) {
 				// clone the held Record, as it will be freed upstream
@@ -132,10 +130,7 @@ pull_index:
 
 	if(op->rebuild_index_query) {
 		// free previous iterator
-		if(op->iter != NULL) {
-			RediSearch_ResultsIteratorFree(op->iter);
-			op->iter = NULL;
-		}
+		IndexScanIter_Free(&op->iter);
 
 		// free previous unresolved filters
 		if(op->unresolved_filters != NULL) {
@@ -157,25 +152,19 @@ pull_index:
 		}
 		#endif
 
-		// convert filter into a RediSearch query
-		RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters,
-				filter, op->idx);
+		// convert filter into an index query and create iterator
+		IndexScanIter_Build(&op->iter, filter, &op->unresolved_filters);
 		FilterTree_Free(filter);
-
-		// create iterator
-		ASSERT(rs_query_node != NULL);
-		op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
 	} else {
 		// build index query only once (first call)
 		// reset it if already initialized
-		if(op->iter == NULL) {
+		if(!IndexScanIter_IsSet(&op->iter)) {
 			// first call to consume, create query and iterator
-			RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters, op->filter, op->idx);
-			ASSERT(rs_query_node != NULL);
-			op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
+			IndexScanIter_Build(&op->iter, op->filter,
+					&op->unresolved_filters);
 		} else {
 			// reset existing iterator
-			RediSearch_ResultsIteratorReset(op->iter);
+			IndexScanIter_Reset(&op->iter);
 		}
 	}
 
@@ -187,21 +176,17 @@ static Record IndexScanConsume(OpBase *opBase) {
 	IndexScan *op = (IndexScan *)opBase;
 
 	// create iterator on first call
-	if(op->iter == NULL) {
-		RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters,
-				op->filter, op->idx);
-
-		op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
+	if(!IndexScanIter_IsSet(&op->iter)) {
+		IndexScanIter_Build(&op->iter, op->filter, &op->unresolved_filters);
 	}
 
-	const EntityID *nodeId = NULL;
+	EntityID nodeId;
 
 	// populate the Record with the actual node
 	Record r = OpBase_CreateRecord((OpBase *)op);
-	while((nodeId = RediSearch_ResultsIteratorNext(op->iter, op->idx, NULL))
-			!= NULL) {
+	while(IndexScanIter_Next(&op->iter, &nodeId)) {
 		// populate record with node
-		_UpdateRecord(op, r, *nodeId);
+		_UpdateRecord(op, r, nodeId);
 		// apply unresolved filters
 		if(_PassUnresolvedFilters(op, r)) {
 			return r;
@@ -217,14 +202,13 @@ static OpResult IndexScanReset(OpBase *opBase) {
 	IndexScan *op = (IndexScan *)opBase;
 
 	if(op->rebuild_index_query) {
-		RediSearch_ResultsIteratorFree(op->iter);
-		op->iter = NULL;
+		IndexScanIter_Free(&op->iter);
 		if(op->unresolved_filters) {
 			FilterTree_Free(op->unresolved_filters);
 			op->unresolved_filters = NULL;
 		}
-	} else {
-		RediSearch_ResultsIteratorReset(op->iter);
+	} else if(IndexScanIter_IsSet(&op->iter)) {
+		IndexScanIter_Reset(&op->iter);
 	}
 
 	return OP_OK;
@@ -236,10 +220,7 @@ static void IndexScanFree(OpBase *opBase) {
 	 * read locked, if this index scan operation is part of
 	 * a query which will modified this index we'll be stuck in
 	 * a dead lock, as we're unable to acquire index write lock. */
-	if(op->iter) {
-		RediSearch_ResultsIteratorFree(op->iter);
-		op->iter = NULL;
-	}
+	IndexScanIter_Free(&op->iter);
 
 	if(op->child_record) {
 		OpBase_DeleteRecord(op->child_record);
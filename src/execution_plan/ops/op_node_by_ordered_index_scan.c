@@ -0,0 +1,263 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "op_node_by_ordered_index_scan.h"
+#include "RG.h"
+#include "../../util/arr.h"
+#include "../../query_ctx.h"
+#include "../../util/qsort.h"
+#include "shared/print_functions.h"
+
+// forward declarations
+static OpResult OrderedIndexScanInit(OpBase *opBase);
+static Record OrderedIndexScanConsume(OpBase *opBase);
+static OpResult OrderedIndexScanReset(OpBase *opBase);
+static void OrderedIndexScanFree(OpBase *opBase);
+
+static void OrderedIndexScanToString(const OpBase *ctx, sds *buf) {
+	NodeByOrderedIndexScan *op = (NodeByOrderedIndexScan *)ctx;
+	ScanToString(ctx, buf, op->n.alias, op->n.label);
+}
+
+OpBase *NewNodeByOrderedIndexScanOp
+(
+	const ExecutionPlan *plan,
+	Graph *g,
+	NodeScanCtx n,
+	Index *idx,
+	Attribute_ID attr,
+	bool descending
+) {
+	ASSERT(g    != NULL);
+	ASSERT(idx  != NULL);
+	ASSERT(plan != NULL);
+	ASSERT(Index_IsNative(idx));
+
+	NodeByOrderedIndexScan *op = rm_malloc(sizeof(NodeByOrderedIndexScan));
+	op->g           =  g;
+	op->n           =  n;
+	op->idx         =  idx;
+	op->attr        =  attr;
+	op->descending  =  descending;
+	op->stage_idx   =  0;
+	op->stage_pos   =  0;
+	op->iter        =  NULL;
+	op->unordered   =  NULL;
+	op->split       =  0;
+	op->missing     =  0;
+	op->label_iter  =  NULL;
+
+	// set our op operations
+	OpBase_Init((OpBase *)op, OPType_NODE_BY_ORDERED_INDEX_SCAN,
+			"Node By Ordered Index Scan", OrderedIndexScanInit,
+			OrderedIndexScanConsume, OrderedIndexScanReset,
+			OrderedIndexScanToString, NULL, OrderedIndexScanFree, false, plan);
+
+	op->nodeRecIdx = OpBase_Modifies((OpBase *)op, n.alias);
+	return (OpBase *)op;
+}
+
+#define entry_lt(a, b) (SIValue_Compare((a)->v, (b)->v, NULL) < 0)
+
+// collect and sort nodes holding values which the index doesn't order
+static void _CollectUnordered
+(
+	NodeByOrderedIndexScan *op
+) {
+	op->unordered = array_new(OrderedScanEntry, 0);
+
+	// all unordered types share a single range
+	NativeIndexIterator *it = NativeIndexIterator_New(op->idx->native);
+	NativeIndexIterator_AddType(it, op->attr, T_ARRAY);
+
+	EntityID id;
+	while(NativeIndexIterator_Next(it, &id)) {
+		Node n = GE_NEW_NODE();
+		int res = Graph_GetNode(op->g, id, &n);
+		ASSERT(res != 0);
+
+		SIValue *v = GraphEntity_GetProperty((GraphEntity *)&n, op->attr);
+		ASSERT(v != PROPERTY_NOTFOUND);
+
+		OrderedScanEntry entry = {.id = id, .v = SI_ConstValue(v)};
+		array_append(op->unordered, entry);
+	}
+	NativeIndexIterator_Free(it);
+
+	uint n = array_len(op->unordered);
+	QSORT(OrderedScanEntry, op->unordered, n, entry_lt);
+
+	// values are sorted by type first
+	// values following NULL form a suffix
+	op->split = n;
+	while(op->split > 0 &&
+		  SI_TYPE(op->unordered[op->split - 1].v) > T_NULL) {
+		op->split--;
+	}
+}
+
+static OpResult OrderedIndexScanInit(OpBase *opBase) {
+	NodeByOrderedIndexScan *op = (NodeByOrderedIndexScan *)opBase;
+
+	// resolve label ID now if it is still unknown
+	if(op->n.label_id == GRAPH_UNKNOWN_LABEL) {
+		GraphContext *gc = QueryCtx_GetGraphCtx();
+		Schema *schema = GraphContext_GetSchema(gc, op->n.label, SCHEMA_NODE);
+		ASSERT(schema != NULL);
+		op->n.label_id = schema->id;
+	}
+
+	// strings, booleans and numerics in Cypher's order
+	NativeIndex *native = op->idx->native;
+	op->iter = NativeIndexIterator_New(native);
+	NativeIndexIterator_AddType(op->iter, op->attr, T_STRING);
+	NativeIndexIterator_AddType(op->iter, op->attr, T_BOOL);
+	NativeIndexIterator_AddType(op->iter, op->attr, T_INT64);
+	NativeIndexIterator_SetOrder(op->iter, op->descending);
+
+	_CollectUnordered(op);
+
+	// every labeled node holding the attribute is indexed
+	uint64_t labeled = Graph_LabeledNodeCount(op->g, op->n.label_id);
+	uint64_t holding = NativeIndex_AttributeCount(native, op->attr);
+	op->missing = (labeled > holding) ? labeled - holding : 0;
+
+	return OP_OK;
+}
+
+// report the next unordered value within [from, to)
+static bool _NextUnordered
+(
+	NodeByOrderedIndexScan *op,
+	uint from,
+	uint to,
+	EntityID *id
+) {
+	if(from + op->stage_pos >= to) return false;
+
+	uint pos = op->descending ? to - 1 - op->stage_pos : from + op->stage_pos;
+	*id = op->unordered[pos].id;
+	return true;
+}
+
+// report the next labeled node missing the attribute
+static bool _NextMissing
+(
+	NodeByOrderedIndexScan *op,
+	EntityID *id
+) {
+	// all missing nodes been reported
+	if(op->stage_pos >= op->missing) return false;
+
+	if(op->label_iter == NULL) {
+		RG_Matrix L = Graph_GetLabelMatrix(op->g, op->n.label_id);
+		GrB_Info info = RG_MatrixTupleIter_new(&op->label_iter, L);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	GrB_Index node_id;
+	bool depleted = false;
+	while(true) {
+		RG_MatrixTupleIter_next(op->label_iter, NULL, &node_id, NULL,
+				&depleted);
+		if(depleted) return false;
+
+		Node n = GE_NEW_NODE();
+		Graph_GetNode(op->g, node_id, &n);
+		if(GraphEntity_GetProperty((GraphEntity *)&n, op->attr) ==
+		   PROPERTY_NOTFOUND) {
+			*id = node_id;
+			return true;
+		}
+	}
+}
+
+static bool _NextNode
+(
+	NodeByOrderedIndexScan *op,
+	EntityID *id
+) {
+	while(op->stage_idx < ORDERED_SCAN_STAGE_COUNT) {
+		OrderedScanStage stage = op->descending ?
+			ORDERED_SCAN_STAGE_COUNT - 1 - op->stage_idx : op->stage_idx;
+
+		bool found = false;
+		switch(stage) {
+			case ORDERED_SCAN_LOW:
+				found = _NextUnordered(op, 0, op->split, id);
+				break;
+			case ORDERED_SCAN_INDEXED:
+				found = NativeIndexIterator_Next(op->iter, id);
+				break;
+			case ORDERED_SCAN_MISSING:
+				found = _NextMissing(op, id);
+				break;
+			case ORDERED_SCAN_HIGH:
+				found = _NextUnordered(op, op->split,
+						array_len(op->unordered), id);
+				break;
+			default:
+				ASSERT(false);
+				break;
+		}
+
+		if(found) {
+			op->stage_pos++;
+			return true;
+		}
+
+		// stage depleted, advance to the next one
+		op->stage_idx++;
+		op->stage_pos = 0;
+	}
+
+	return false;
+}
+
+static Record OrderedIndexScanConsume(OpBase *opBase) {
+	NodeByOrderedIndexScan *op = (NodeByOrderedIndexScan *)opBase;
+
+	EntityID id;
+	if(!_NextNode(op, &id)) return NULL;
+
+	// populate the Record with the actual node
+	Record r = OpBase_CreateRecord(opBase);
+	Node n = GE_NEW_NODE();
+	int res = Graph_GetNode(op->g, id, &n);
+	ASSERT(res != 0);
+	Record_AddNode(r, op->nodeRecIdx, n);
+
+	return r;
+}
+
+static OpResult OrderedIndexScanReset(OpBase *opBase) {
+	NodeByOrderedIndexScan *op = (NodeByOrderedIndexScan *)opBase;
+
+	op->stage_idx = 0;
+	op->stage_pos = 0;
+
+	if(op->iter != NULL) NativeIndexIterator_Reset(op->iter);
+	if(op->label_iter != NULL) RG_MatrixTupleIter_free(&op->label_iter);
+
+	return OP_OK;
+}
+
+static void OrderedIndexScanFree(OpBase *opBase) {
+	NodeByOrderedIndexScan *op = (NodeByOrderedIndexScan *)opBase;
+
+	if(op->iter != NULL) {
+		NativeIndexIterator_Free(op->iter);
+		op->iter = NULL;
+	}
+
+	if(op->unordered != NULL) {
+		array_free(op->unordered);
+		op->unordered = NULL;
+	}
+
+	if(op->label_iter != NULL) RG_MatrixTupleIter_free(&op->label_iter);
+}
+
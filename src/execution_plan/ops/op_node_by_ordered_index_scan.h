@@ -0,0 +1,70 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "op.h"
+#include "../execution_plan.h"
+#include "../../graph/graph.h"
+#include "../../index/index.h"
+#include "shared/scan_functions.h"
+#include "../../graph/rg_matrix/rg_matrix_iter.h"
+
+// NodeByOrderedIndexScan, scans a label's nodes ordered by an attribute
+// nodes are reported following Cypher's global sort order
+// which an ORDER BY on the attribute would have produced
+//
+// a native index orders strings, booleans and numerics
+// the remaining stages complete the order:
+// 1. values ordered before strings, e.g. arrays
+// 2. strings, booleans and numerics, read from the index
+// 3. nodes missing the attribute
+// 4. values ordered after NULL, e.g. points
+// in descending order the stages are visited last to first
+
+// ordered scan stages, in ascending order
+typedef enum {
+	ORDERED_SCAN_LOW,      // unordered values preceding strings
+	ORDERED_SCAN_INDEXED,  // values ordered by the index
+	ORDERED_SCAN_MISSING,  // nodes missing the attribute
+	ORDERED_SCAN_HIGH,     // unordered values following NULL
+	ORDERED_SCAN_STAGE_COUNT
+} OrderedScanStage;
+
+// node holding a value which isn't ordered by the index
+typedef struct {
+	EntityID id;  // node ID
+	SIValue v;    // attribute value
+} OrderedScanEntry;
+
+typedef struct {
+	OpBase op;
+	Graph *g;
+	NodeScanCtx n;                  // label data of node being scanned
+	uint nodeRecIdx;                // index of the node being scanned in the Record
+	Index *idx;                     // native index over attribute
+	Attribute_ID attr;              // attribute to order by
+	bool descending;                // report nodes in descending order
+	uint stage_idx;                 // current stage
+	uint stage_pos;                 // number of nodes reported by current stage
+	NativeIndexIterator *iter;      // iterator over indexed values
+	OrderedScanEntry *unordered;    // sorted nodes holding unordered values
+	uint split;                     // first unordered value following NULL
+	uint64_t missing;               // number of nodes missing the attribute
+	RG_MatrixTupleIter *label_iter; // iterator over label, locating missing nodes
+} NodeByOrderedIndexScan;
+
+// creates a new NodeByOrderedIndexScan operation
+OpBase *NewNodeByOrderedIndexScanOp
+(
+	const ExecutionPlan *plan,  // execution plan
+	Graph *g,                   // graph
+	NodeScanCtx n,              // node to scan
+	Index *idx,                 // native index over attribute
+	Attribute_ID attr,          // attribute to order by
+	bool descending             // order direction
+);
+
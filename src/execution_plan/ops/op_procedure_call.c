@@ -133,7 +133,13 @@ static Record ProcCallConsume(OpBase *opBase) {
 		// introduced
 
 		// lock if procedure can modify the graph
-		if(!Procedure_IsReadOnly(op->procedure)) QueryCtx_LockForCommit();
+		// changes made by procedures are not described by effects
+		// fallback to replicating the query
+		if(!Procedure_IsReadOnly(op->procedure)) {
+			QueryCtx_LockForCommit();
+			EffectsBuffer *effects = QueryCtx_GetEffectsBuffer();
+			if(effects != NULL) EffectsBuffer_SetIncomplete(effects);
+		}
 
 		ProcedureResult res = Proc_Invoke(op->procedure, op->args, op->output);
 
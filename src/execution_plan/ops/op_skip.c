@@ -10,47 +10,63 @@
 #include "../../arithmetic/arithmetic_expression.h"
 
 /* Forward declarations. */
+static OpResult SkipInit(OpBase *opBase);
 static Record SkipConsume(OpBase *opBase);
 static OpResult SkipReset(OpBase *opBase);
 static void SkipFree(OpBase *opBase);
 static OpBase *SkipClone(const ExecutionPlan *plan, const OpBase *opBase);
 
-static void _eval_skip(OpSkip *op, AR_ExpNode *skip_exp) {
-	/* Store a copy of the original expression.
-	 * This is required in the case of a parameterized skip: "SKIP $L"
-	 * Evaluating the expression will modify it, replacing the parameter with a constant.
-	 * As a result, clones of this operation would invalidly resolve to an outdated constant. */
-	op->skip_exp = AR_EXP_Clone(skip_exp);
+bool SkipOp_Evaluate(OpSkip *op) {
+	ASSERT(op != NULL);
 
-	// Evaluate using the input expression, leaving the stored expression untouched.
-	SIValue s = AR_EXP_Evaluate(skip_exp, NULL);
+	// evaluate a copy, evaluating a parameter replaces it with a constant
+	AR_ExpNode *exp = AR_EXP_Clone(op->skip_exp);
+	SIValue s = AR_EXP_Evaluate(exp, NULL);
+	AR_EXP_Free(exp);
 
-	// Validate that the skip value is numeric and non-negative.
+	// validate that the skip value is numeric and non-negative
 	if(SI_TYPE(s) != T_INT64 || SI_GET_NUMERIC(s) < 0) {
 		ErrorCtx_SetError("Skip operates only on non-negative integers");
+		return false;
 	}
 
 	op->skip = SI_GET_NUMERIC(s);
-
-	// Free the expression we've evaluated.
-	AR_EXP_Free(skip_exp);
+	return true;
 }
 
-OpBase *NewSkipOp(const ExecutionPlan *plan, AR_ExpNode *skip_exp) {
+// create a Skip operation without evaluating its expression
+static OpSkip *_NewSkipOp(const ExecutionPlan *plan, AR_ExpNode *skip_exp) {
 	OpSkip *op = rm_malloc(sizeof(OpSkip));
 	op->skip = 0;
 	op->skipped = 0;
-	op->skip_exp = NULL;
-
-	_eval_skip(op, skip_exp);
+	op->skip_exp = skip_exp;
 
 	// set operations
-	OpBase_Init((OpBase *)op, OPType_SKIP, "Skip", NULL, SkipConsume, SkipReset, NULL, SkipClone,
-				SkipFree, false, plan);
+	OpBase_Init((OpBase *)op, OPType_SKIP, "Skip", SkipInit, SkipConsume,
+			SkipReset, NULL, SkipClone, SkipFree, false, plan);
+
+	return op;
+}
+
+OpBase *NewSkipOp(const ExecutionPlan *plan, AR_ExpNode *skip_exp) {
+	OpSkip *op = _NewSkipOp(plan, skip_exp);
+
+	// evaluate at construction time to report an invalid skip early on
+	SkipOp_Evaluate(op);
 
 	return (OpBase *)op;
 }
 
+// re-evaluate skip on every execution, as parameter values change
+// between executions of a cached plan
+static OpResult SkipInit(OpBase *opBase) {
+	OpSkip *op = (OpSkip *)opBase;
+
+	if(!SkipOp_Evaluate(op)) ErrorCtx_RaiseRuntimeException(NULL);
+
+	return OP_OK;
+}
+
 static Record SkipConsume(OpBase *opBase) {
 	OpSkip *skip = (OpSkip *)opBase;
 	OpBase *child = skip->op.children[0];
@@ -82,11 +98,9 @@ static inline OpBase *SkipClone(const ExecutionPlan *plan, const OpBase *opBase)
 	ASSERT(opBase->type == OPType_SKIP);
 
 	OpSkip *op = (OpSkip *)opBase;
-	/* Clone the skip expression stored on the ExecutionPlan,
-	 * as we don't want to modify the templated ExecutionPlan
-	 * (which may occur if this expression is a parameter). */
+	// the skip expression is evaluated once the clone is initialized
 	AR_ExpNode *skip_exp = AR_EXP_Clone(op->skip_exp);
-	return NewSkipOp(plan, skip_exp);
+	return (OpBase *)_NewSkipOp(plan, skip_exp);
 }
 
 static void SkipFree(OpBase *opBase) {
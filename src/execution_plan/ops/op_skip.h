@@ -19,3 +19,8 @@ typedef struct {
 // Skips 'n' records.
 OpBase *NewSkipOp(const ExecutionPlan *plan, AR_ExpNode *skip_exp);
 
+// evaluates the skip expression against the current query's parameters
+// clones defer evaluation, as they might be created ahead of the
+// execution they serve
+// sets an error and returns false if skip isn't a non-negative integer
+bool SkipOp_Evaluate(OpSkip *op);
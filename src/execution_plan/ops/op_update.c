@@ -74,7 +74,8 @@ static Record UpdateConsume(OpBase *opBase) {
 	if(op->updates_committed) return _handoff(op);
 
 	while((r = OpBase_Consume(child))) {
-		Record_PersistScalars(r);
+		// scalars might reference properties which are about to be updated
+		Record_DetachScalars(r);
 
 		// evaluate update expressions
 		raxSeek(&op->it, "^", NULL, 0);
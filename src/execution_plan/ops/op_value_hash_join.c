@@ -242,8 +242,8 @@ static Record ValueHashJoinConsume(OpBase *opBase) {
 	Record l;
 	if(op->number_of_intersections > 0) {
 		while((l = _get_intersecting_record(op))) {
-			// Clone cached record before merging rhs.
-			Record c = OpBase_CloneRecord(l);
+			// Share cached record before merging rhs.
+			Record c = OpBase_ShareRecord(l);
 			Record_Merge(c, op->rhs_rec);
 			return c;
 		}
@@ -275,8 +275,8 @@ static Record ValueHashJoinConsume(OpBase *opBase) {
 		// Found atleast one intersecting record.
 		l = _get_intersecting_record(op);
 
-		// Clone cached record before merging rhs.
-		Record c = OpBase_CloneRecord(l);
+		// Share cached record before merging rhs.
+		Record c = OpBase_ShareRecord(l);
 		Record_Merge(c, op->rhs_rec);
 
 		return c;
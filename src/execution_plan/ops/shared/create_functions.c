@@ -14,13 +14,10 @@
 // Add properties to the GraphEntity.
 static inline void _AddProperties(ResultSetStatistics *stats, GraphEntity *ge,
 								  PendingProperties *props) {
-	int failed_updates = 0;
-	for(int i = 0; i < props->property_count; i++) {
-		bool updated = GraphEntity_AddProperty(ge, props->attr_keys[i], props->values[i]);
-		if(!updated) failed_updates++;
-	}
+	int added = GraphEntity_AddProperties(ge, props->attr_keys, props->values,
+			props->property_count);
 
-	if(stats) stats->properties_set += props->property_count - failed_updates;
+	if(stats) stats->properties_set += added;
 }
 
 // commit node blueprints
@@ -62,10 +59,11 @@ static void _CommitNodesBlueprint(PendingCreations *pending) {
 
 // commit nodes
 static void _CommitNodes(PendingCreations *pending) {
-	Node          *n          =  NULL;
-	GraphContext  *gc         =  QueryCtx_GetGraphCtx();
-	Graph         *g          =  gc->g;
-	uint          node_count  =  array_len(pending->created_nodes);
+	Node           *n          =  NULL;
+	GraphContext   *gc         =  QueryCtx_GetGraphCtx();
+	Graph          *g          =  gc->g;
+	EffectsBuffer  *effects    =  QueryCtx_GetEffectsBuffer();
+	uint           node_count  =  array_len(pending->created_nodes);
 
 	// sync policy should be set to NOP, no need to sync/resize
 	ASSERT(Graph_GetMatrixPolicy(g) == SYNC_POLICY_NOP);
@@ -88,8 +86,13 @@ static void _CommitNodes(PendingCreations *pending) {
 			Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
 			ASSERT(s);
 
+			Schema_AddNodeToAttributeStats(s, n);
 			if(Schema_HasIndices(s)) Schema_AddNodeToIndices(s, n);
 		}
+
+		if(effects != NULL) {
+			EffectsBuffer_AddCreateNode(effects, n, labels, label_count);
+		}
 	}
 }
 
@@ -125,10 +128,11 @@ static void _CommitEdgesBlueprint(EdgeCreateCtx *blueprints) {
 
 // commit edges
 static void _CommitEdges(PendingCreations *pending) {
-	Edge          *e          =  NULL;
-	GraphContext  *gc         =  QueryCtx_GetGraphCtx();
-	Graph         *g          =  gc->g;
-	uint          edge_count  =  array_len(pending->created_edges);
+	Edge           *e          =  NULL;
+	GraphContext   *gc         =  QueryCtx_GetGraphCtx();
+	Graph          *g          =  gc->g;
+	EffectsBuffer  *effects    =  QueryCtx_GetEffectsBuffer();
+	uint           edge_count  =  array_len(pending->created_edges);
 
 	// sync policy should be set to NOP, no need to sync/resize
 	ASSERT(Graph_GetMatrixPolicy(g) == SYNC_POLICY_NOP);
@@ -160,6 +164,8 @@ static void _CommitEdges(PendingCreations *pending) {
 		}
 
 		if(s && Schema_HasIndices(s)) Schema_AddEdgeToIndices(s, e);
+
+		if(effects != NULL) EffectsBuffer_AddCreateEdge(effects, e);
 	}
 }
 
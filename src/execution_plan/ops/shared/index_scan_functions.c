@@ -0,0 +1,340 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "index_scan_functions.h"
+#include "RG.h"
+#include "../../../util/arr.h"
+#include "../../../util/qsort.h"
+#include "../../../query_ctx.h"
+#include "../../../datatypes/array.h"
+#include "../../../filter_tree/ft_to_rsq.h"
+#include "../../../filter_tree/ft_to_native.h"
+#include "../../../filter_tree/filter_tree_utils.h"
+
+void IndexScanIter_Init
+(
+	IndexScanIter *it,
+	Index *idx
+) {
+	ASSERT(it  != NULL);
+	ASSERT(idx != NULL);
+
+	it->idx          =  idx;
+	it->rs_iter      =  NULL;
+	it->native_iter  =  NULL;
+}
+
+void IndexScanIter_Build
+(
+	IndexScanIter *it,
+	const FT_FilterNode *filter,
+	FT_FilterNode **unresolved
+) {
+	ASSERT(it     != NULL);
+	ASSERT(filter != NULL);
+	ASSERT(!IndexScanIter_IsSet(it));
+
+	FT_FilterNode *none_converted = NULL;
+
+	if(Index_IsNative(it->idx)) {
+		it->native_iter = NativeIndexIterator_New(it->idx->native);
+		FilterTreeToNativeRanges(it->native_iter, filter);
+		// seeks yield a superset of the matching entities
+		// re-apply entire filter
+		if(unresolved != NULL) none_converted = FilterTree_Clone(filter);
+	} else {
+		RSQNode *rs_query_node = FilterTreeToQueryNode(&none_converted,
+				filter, it->idx->idx);
+		ASSERT(rs_query_node != NULL);
+		it->rs_iter = RediSearch_GetResultsIterator(rs_query_node,
+				it->idx->idx);
+	}
+
+	if(unresolved != NULL) *unresolved = none_converted;
+	else if(none_converted != NULL) FilterTree_Free(none_converted);
+}
+
+bool IndexScanIter_IsSet
+(
+	const IndexScanIter *it
+) {
+	ASSERT(it != NULL);
+	return (it->rs_iter != NULL || it->native_iter != NULL);
+}
+
+bool IndexScanIter_Next
+(
+	IndexScanIter *it,
+	EntityID *id
+) {
+	ASSERT(it != NULL);
+	ASSERT(id != NULL);
+
+	if(it->native_iter != NULL) {
+		return NativeIndexIterator_Next(it->native_iter, id);
+	}
+
+	const EntityID *_id = RediSearch_ResultsIteratorNext(it->rs_iter,
+			it->idx->idx, NULL);
+	if(_id == NULL) return false;
+
+	*id = *_id;
+	return true;
+}
+
+void IndexScanIter_Reset
+(
+	IndexScanIter *it
+) {
+	ASSERT(IndexScanIter_IsSet(it));
+
+	if(it->native_iter != NULL) NativeIndexIterator_Reset(it->native_iter);
+	else RediSearch_ResultsIteratorReset(it->rs_iter);
+}
+
+GrB_Index *IndexScanIter_CollectIDs
+(
+	IndexScanIter *it
+) {
+	ASSERT(IndexScanIter_IsSet(it));
+
+	EntityID id;
+	GrB_Index *ids = array_new(GrB_Index, 0);
+	while(IndexScanIter_Next(it, &id)) array_append(ids, id);
+
+	// RediSearch reports entities in insertion order
+	uint n = array_len(ids);
+	if(n < 2) return ids;
+
+#define id_lt(a, b) (*(a) < *(b))
+	QSORT(GrB_Index, ids, n, id_lt);
+
+	// remove duplicates
+	uint j = 0;
+	for(uint i = 1; i < n; i++) {
+		if(ids[i] != ids[j]) ids[++j] = ids[i];
+	}
+
+	return array_trimm_len(ids, j + 1);
+}
+
+RG_Matrix IndexScanIter_ToDiagonal
+(
+	IndexScanIter *it,
+	GrB_Index dim
+) {
+	ASSERT(IndexScanIter_IsSet(it));
+
+	RG_Matrix D;
+	GrB_Info info = RG_Matrix_new(&D, GrB_BOOL, dim, dim);
+	ASSERT(info == GrB_SUCCESS);
+
+	GrB_Index *ids = IndexScanIter_CollectIDs(it);
+	GrB_Index n = array_len(ids);
+
+	// sorted IDs, the diagonal is built in a single pass
+	if(n > 0) {
+		info = RG_Matrix_build_BOOL(D, ids, ids, n);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	array_free(ids);
+	return D;
+}
+
+// resolve the value compared against an attribute
+// returns false if value is unknown
+static bool _EstimateValue
+(
+	AR_ExpNode *exp,      // compared expression
+	bool resolve_params,  // evaluate query parameters
+	SIValue *v            // [output] value
+) {
+	if(AR_EXP_IsConstant(exp)) {
+		*v = exp->operand.constant;
+		return true;
+	}
+
+	if(resolve_params && AR_EXP_IsParameter(exp)) {
+		*v = AR_EXP_Evaluate(exp, NULL);
+		return true;
+	}
+
+	return false;
+}
+
+// estimate number of entities holding 'v'
+static double _EstimateEqual
+(
+	const AttributeStats *stats,  // attribute statistics
+	const SIValue *v              // compared value, NULL if unknown
+) {
+	if(v != NULL) {
+		if(SI_TYPE(*v) == T_NULL) return 0;
+
+		// value lies outside of the attribute's range
+		int min_disjoint;
+		int max_disjoint;
+		int min_cmp = SIValue_Compare(*v, stats->min, &min_disjoint);
+		int max_cmp = SIValue_Compare(*v, stats->max, &max_disjoint);
+		if(min_disjoint == 0 && max_disjoint == 0 &&
+		   (min_cmp < 0 || max_cmp > 0)) {
+			return 0;
+		}
+	}
+
+	uint64_t distinct = AttributeStats_DistinctCount(stats);
+	return (double)stats->count / MAX(distinct, 1);
+}
+
+// estimate number of entities whose value satisfies 'value op v'
+static double _EstimateRange
+(
+	const AttributeStats *stats,  // attribute statistics
+	AST_Operator op,              // range operator
+	const SIValue *v              // compared value, NULL if unknown
+) {
+	// assume a narrow range, a single histogram bucket
+	if(v == NULL) return (double)stats->count / ATTRIBUTE_STATS_HISTOGRAM_BUCKETS;
+	if(SI_TYPE(*v) == T_NULL) return 0;
+
+	bool above = (op == OP_GT || op == OP_GE);
+
+	// count buckets overlapping the range
+	// values of a different type never satisfy a range
+	uint bucket_count = array_len(stats->bounds);
+	if(bucket_count > 0) {
+		uint matching = 0;
+		for(uint i = 0; i < bucket_count; i++) {
+			int disjoint;
+			const SIValue *bound = above ? stats->bounds + i :
+				(i == 0) ? &stats->min : stats->bounds + i - 1;
+			int cmp = SIValue_Compare(*bound, *v, &disjoint);
+			if(disjoint == 0 && (above ? cmp >= 0 : cmp <= 0)) matching++;
+		}
+		return MIN((double)matching * stats->depth, (double)stats->count);
+	}
+
+	// interpolate between min and max
+	if(SI_TYPE(*v) & SI_NUMERIC && SI_TYPE(stats->min) & SI_NUMERIC &&
+	   SI_TYPE(stats->max) & SI_NUMERIC) {
+		double min = SI_GET_NUMERIC(stats->min);
+		double max = SI_GET_NUMERIC(stats->max);
+		double x   = SI_GET_NUMERIC(*v);
+		if(max <= min) return (above ? x <= max : x >= min) ? stats->count : 0;
+
+		double fraction = above ? (max - x) / (max - min) : (x - min) / (max - min);
+		return MAX(0, MIN(1, fraction)) * stats->count;
+	}
+
+	// a third of the values
+	return (double)stats->count / 3;
+}
+
+// estimate number of entities matching 'filter'
+static double _EstimateMatches
+(
+	const Schema *s,              // indexed schema
+	const FT_FilterNode *filter,  // filter to estimate
+	double total,                 // number of entities in schema
+	bool resolve_params           // evaluate query parameters
+) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+
+	if(filter->t == FT_N_COND) {
+		double l = _EstimateMatches(s, filter->cond.left, total, resolve_params);
+		double r = _EstimateMatches(s, filter->cond.right, total, resolve_params);
+		return (filter->cond.op == OP_AND) ? MIN(l, r) : MIN(l + r, total);
+	}
+
+	// resolve filtered attribute and compared value
+	char *attr = NULL;
+	AR_ExpNode *value_exp = NULL;
+	AST_Operator op;
+
+	if(isInFilter(filter)) {
+		op = OP_IN;
+		AR_ExpNode *in = filter->exp.exp;
+		if(!AR_EXP_IsAttribute(in->op.children[0], &attr)) return total;
+		value_exp = in->op.children[1];
+	} else if(filter->t == FT_N_PRED) {
+		op = filter->pred.op;
+		if(!AR_EXP_IsAttribute(filter->pred.lhs, &attr)) return total;
+		value_exp = filter->pred.rhs;
+	} else {
+		// unsupported filter, e.g. distance
+		return total;
+	}
+
+	Attribute_ID attr_id = GraphContext_GetAttributeID(gc, attr);
+	const AttributeStats *stats = (attr_id == ATTRIBUTE_NOTFOUND) ? NULL :
+		Schema_GetAttributeStats(s, attr_id);
+	// no entity holds the attribute
+	if(stats == NULL || stats->count == 0) return 0;
+
+	SIValue v;
+	bool known = _EstimateValue(value_exp, resolve_params, &v);
+
+	switch(op) {
+		case OP_IN: {
+			if(!known) return _EstimateEqual(stats, NULL);
+			if(SI_TYPE(v) != T_ARRAY) return 0;
+			double matches = 0;
+			uint n = SIArray_Length(v);
+			for(uint i = 0; i < n; i++) {
+				SIValue elem = SIArray_Get(v, i);
+				matches += _EstimateEqual(stats, &elem);
+			}
+			return MIN(matches, total);
+		}
+		case OP_EQUAL:
+			return _EstimateEqual(stats, known ? &v : NULL);
+		case OP_LT:
+		case OP_LE:
+		case OP_GT:
+		case OP_GE:
+			return _EstimateRange(stats, op, known ? &v : NULL);
+		default:
+			return total;
+	}
+}
+
+double IndexScan_EstimateSelectivity
+(
+	const Index *idx,
+	const FT_FilterNode *filter,
+	bool resolve_params
+) {
+	ASSERT(idx    != NULL);
+	ASSERT(filter != NULL);
+	ASSERT(idx->entity_type == GETYPE_NODE);
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Schema *s = GraphContext_GetSchemaByID(gc, idx->label_id, SCHEMA_NODE);
+	ASSERT(s != NULL);
+
+	double total = Graph_LabeledNodeCount(gc->g, idx->label_id);
+	if(total == 0) return 0;
+
+	return _EstimateMatches(s, filter, total, resolve_params) / total;
+}
+
+void IndexScanIter_Free
+(
+	IndexScanIter *it
+) {
+	ASSERT(it != NULL);
+
+	if(it->rs_iter != NULL) {
+		RediSearch_ResultsIteratorFree(it->rs_iter);
+		it->rs_iter = NULL;
+	}
+
+	if(it->native_iter != NULL) {
+		NativeIndexIterator_Free(it->native_iter);
+		it->native_iter = NULL;
+	}
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include "../../../index/index.h"
+#include "../../../filter_tree/filter_tree.h"
+#include "../../../graph/rg_matrix/rg_matrix.h"
+
+// maximal fraction of a label's nodes an index may report for it to
+// restrict the destination nodes of a traversal, beyond which filtering
+// each traversed node is cheaper than querying the index
+#define INDEX_SCAN_DEST_MAX_SELECTIVITY 0.1
+
+// iterator over the entities matching an index query
+// backed by either a RediSearch or a native index
+typedef struct {
+	Index *idx;                        // queried index
+	RSResultsIterator *rs_iter;        // RediSearch iterator
+	NativeIndexIterator *native_iter;  // native index iterator
+} IndexScanIter;
+
+// initialize an unset iterator over index
+void IndexScanIter_Init
+(
+	IndexScanIter *it,  // iterator to initialize
+	Index *idx          // queried index
+);
+
+// query index, filters the index could not resolve are returned
+// via 'unresolved', these should be applied to every reported entity
+void IndexScanIter_Build
+(
+	IndexScanIter *it,            // iterator
+	const FT_FilterNode *filter,  // filter to convert into an index query
+	FT_FilterNode **unresolved    // [output] unresolved filters, might be NULL
+);
+
+// returns true if iterator been built
+bool IndexScanIter_IsSet
+(
+	const IndexScanIter *it
+);
+
+// advance iterator, returns false once depleted
+bool IndexScanIter_Next
+(
+	IndexScanIter *it,  // iterator
+	EntityID *id        // [output] entity ID
+);
+
+// restart iteration
+void IndexScanIter_Reset
+(
+	IndexScanIter *it
+);
+
+// collect all remaining IDs into a sorted array without duplicates
+GrB_Index *IndexScanIter_CollectIDs
+(
+	IndexScanIter *it
+);
+
+// build a diagonal matrix out of all remaining IDs
+// D[i,i] is set for every reported entity i
+RG_Matrix IndexScanIter_ToDiagonal
+(
+	IndexScanIter *it,  // iterator
+	GrB_Index dim       // matrix dimension
+);
+
+// estimate the fraction of the indexed label's nodes matching 'filter'
+// based on the label's attribute statistics
+// unless 'resolve_params' is set, parameters are considered unknown and
+// comparisons against unknown values are assumed to be selective
+double IndexScan_EstimateSelectivity
+(
+	const Index *idx,             // node index resolving 'filter'
+	const FT_FilterNode *filter,  // filter to estimate
+	bool resolve_params           // evaluate query parameters
+);
+
+// free iterator resources, iterator is unset
+void IndexScanIter_Free
+(
+	IndexScanIter *it
+);
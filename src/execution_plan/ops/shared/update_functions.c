@@ -15,15 +15,22 @@
  * if it is already present
  * for NULL values, the property will be deleted if present
  * and nothing will be done otherwise
+ * node attribute statistics are updated accordingly
  * returns 1 if a property was set or deleted */
-static int _UpdateEntity(PendingUpdateCtx *update) {
+static int _UpdateEntity(GraphContext *gc, PendingUpdateCtx *update,
+						 SchemaType t) {
 	int           res        =  0;
 	GraphEntity   *ge        =  update->ge;
 	Attribute_ID  attr_id    =  update->attr_id;
 	SIValue       new_value  =  update->new_value;
 
 	// handle the case in which we are deleting all properties
-	if(attr_id == ATTRIBUTE_ALL) return GraphEntity_ClearProperties(ge);
+	if(attr_id == ATTRIBUTE_ALL) {
+		if(t == SCHEMA_NODE) {
+			GraphContext_DeleteNodesFromAttributeStats(gc, (Node *)ge, 1);
+		}
+		return GraphEntity_ClearProperties(ge);
+	}
 
 	// try to get current property value
 	SIValue *old_value = GraphEntity_GetProperty(ge, attr_id);
@@ -31,10 +38,19 @@ static int _UpdateEntity(PendingUpdateCtx *update) {
 	if(old_value == PROPERTY_NOTFOUND) {
 		// adding a new property; do nothing if its value is NULL
 		if(SI_TYPE(new_value) != T_NULL) {
+			if(t == SCHEMA_NODE) {
+				GraphContext_UpdateNodeAttributeStats(gc, (Node *)ge, attr_id,
+						SI_NullVal(), new_value);
+			}
 			res = GraphEntity_AddProperty(ge, attr_id, new_value);
 		}
 	} else {
-		// update property
+		// update property, statistics are updated while the old value
+		// is still available
+		if(t == SCHEMA_NODE) {
+			GraphContext_UpdateNodeAttributeStats(gc, (Node *)ge, attr_id,
+					*old_value, new_value);
+		}
 		res = GraphEntity_SetProperty(ge, attr_id, new_value);
 	}
 
@@ -51,6 +67,11 @@ static PendingUpdateCtx _PreparePendingUpdate
 	SIValue new_value,
 	SchemaType t
 ) {
+	// updates are committed only once all updates have been computed
+	// by then 'new_value' might reference a property of an entity which has
+	// already been updated, make sure the value owns its allocation
+	if(new_value.allocation != M_SELF) new_value = SI_CloneValue(new_value);
+
 	//--------------------------------------------------------------------------
 	// validate value type
 	//--------------------------------------------------------------------------
@@ -107,11 +128,12 @@ void CommitUpdates(GraphContext *gc, ResultSetStatistics *stats,
 	ASSERT(updates != NULL);
 	ASSERT(type    != ENTITY_UNKNOWN);
 
-	uint       properties_set = 0;
-	Schema     *s             = NULL;
-	bool       reindex        = false;
-	uint       update_count   = array_len(updates);
-	SchemaType t              = type == ENTITY_NODE ? SCHEMA_NODE : SCHEMA_EDGE;
+	uint          properties_set = 0;
+	Schema        *s             = NULL;
+	bool          reindex        = false;
+	uint          update_count   = array_len(updates);
+	SchemaType    t              = type == ENTITY_NODE ? SCHEMA_NODE : SCHEMA_EDGE;
+	EffectsBuffer *effects       = QueryCtx_GetEffectsBuffer();
 
 	// return early if no updates are enqueued
 	if(update_count == 0) return;
@@ -154,8 +176,12 @@ void CommitUpdates(GraphContext *gc, ResultSetStatistics *stats,
 		if(GraphEntity_IsDeleted(ge)) continue;
 
 		// update the property on the graph entity
-		int updated = _UpdateEntity(update);
+		int updated = _UpdateEntity(gc, update, t);
 		properties_set += updated;
+
+		if(updated && effects != NULL) {
+			EffectsBuffer_AddUpdate(effects, ge, t, update->attr_id);
+		}
 		// reindex only if update performed
 		reindex |= update->update_index & (bool)updated;
 	}
@@ -279,6 +305,8 @@ void EvalEntityUpdates(GraphContext *gc, PendingUpdateCtx **node_updates,
 				// enqueue the current update
 				array_append(*updates, update);
 			}
+			// pending updates hold their own copies of the map's values
+			SIValue_Free(m);
 			continue;
 		} else if(SI_TYPE(new_value) & (T_NODE | T_EDGE)) {
 			// value is a node or edge; perform attribute set reassignment
@@ -291,7 +319,7 @@ void EvalEntityUpdates(GraphContext *gc, PendingUpdateCtx **node_updates,
 			uint property_count = ENTITY_PROP_COUNT(ge);
 			for(uint j = 0; j < property_count; j ++) {
 				Attribute_ID attr_id = ENTITY_PROPS(ge)[j].id;
-				SIValue value = ENTITY_PROPS(ge)[j].value;
+				SIValue value = SI_ConstValue(&ENTITY_PROPS(ge)[j].value);
 
 				update = _PreparePendingUpdate(gc, accepted_properties, entity,
 											   attr_id, value, st);
@@ -29,7 +29,8 @@ static void notify_limit(OpBase *op, uint limit) {
 			limit = UNLIMITED;
 			break;
 		case OPType_LIMIT:
-			// update limit
+			// update limit, cloned plans evaluate their limit on demand
+			LimitOp_Evaluate((OpLimit *)op);
 			limit = ((OpLimit *)op)->limit;
 			break;
 		case OPType_SORT:
@@ -19,7 +19,8 @@ static void notify_skip(OpBase *op, uint skip) {
 
 	switch(t) {
 		case OPType_SKIP:
-			// update skip
+			// update skip, cloned plans evaluate their skip on demand
+			SkipOp_Evaluate((OpSkip *)op);
 			skip = ((OpSkip *)op)->skip;
 			break;
 		case OPType_SORT:
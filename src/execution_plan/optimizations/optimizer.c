@@ -55,6 +55,9 @@ void optimizePlan(ExecutionPlan *plan) {
 	// try to reduce execution plan incase it perform node or edge counting
 	reduceCount(plan);
 
+	// try to replace a sorted label scan with an ordered index scan
+	reduceSort(plan);
+
 	// let operations know about specified limit(s)
 	applyLimit(plan);
 
@@ -0,0 +1,123 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "../ops/ops.h"
+#include "../../util/arr.h"
+#include "../../query_ctx.h"
+#include "../../ast/ast_build_op_contexts.h"
+#include "../execution_plan_build/execution_plan_modify.h"
+
+// the reduceSort optimization looks for a limited sort over a label scan
+// where the sort key is an attribute of the scanned node
+// e.g. MATCH (n:L) RETURN n ORDER BY n.v DESC LIMIT 10
+//
+// Limit
+//     Sort
+//         Project
+//             Node By Label Scan
+//
+// if the attribute is covered by a native index, the label scan is replaced
+// by an ordered index scan and the sort is dropped, such that the scan stops
+// once the limit is reached rather than sorting every labeled node
+//
+// Limit
+//     Project
+//         Node By Ordered Index Scan
+//
+// filters in between the projection and the scan are retained
+// as they do not affect the order of records
+// label scans restricted to an ID range are left as is
+
+// returns the label scan feeding sort, NULL if sort's input might be
+// reordered or extended by any other operation
+static NodeByLabelScan *_SortedScan
+(
+	OpSort *sort
+) {
+	OpBase *op = ((OpBase *)sort)->children[0];
+	if(op->type != OPType_PROJECT) return NULL;
+	op = op->children[0];
+
+	while(op->type == OPType_FILTER) op = op->children[0];
+
+	// scan must be a tap
+	if(op->type != OPType_NODE_BY_LABEL_SCAN || op->childCount != 0) {
+		return NULL;
+	}
+
+	return (NodeByLabelScan *)op;
+}
+
+static void _reduceSort
+(
+	ExecutionPlan *plan,
+	OpSort *sort
+) {
+	// sort must be limited
+	OpBase *parent = sort->op.parent;
+	if(parent != NULL && parent->type == OPType_SKIP) parent = parent->parent;
+	if(parent == NULL || parent->type != OPType_LIMIT) return;
+
+	// expecting a single sort key
+	if(array_len(sort->exps) != 1) return;
+
+	NodeByLabelScan *scan = _SortedScan(sort);
+	if(scan == NULL || scan->n.label_id == GRAPH_UNKNOWN_LABEL) return;
+
+	// an ordered index scan doesn't restrict node IDs
+	// e.g. MATCH (n:L) WHERE ID(n) > 5 RETURN n ORDER BY n.v LIMIT 3
+	if(scan->id_range != NULL) return;
+
+	// sort key must be an attribute of the scanned node
+	char *attr_name;
+	AR_ExpNode *exp = sort->exps[0];
+	if(!AR_EXP_IsAttribute(exp, &attr_name)) return;
+
+	AR_ExpNode *entity = exp->op.children[0];
+	if(!AR_EXP_IsVariadic(entity) ||
+	   strcmp(entity->operand.variadic.entity_alias, scan->n.alias) != 0) {
+		return;
+	}
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Attribute_ID attr = GraphContext_GetAttributeID(gc, attr_name);
+	if(attr == ATTRIBUTE_NOTFOUND) return;
+
+	// only native indices are ordered
+	Index *idx = GraphContext_GetIndexByID(gc, scan->n.label_id, &attr,
+			IDX_EXACT_MATCH, SCHEMA_NODE);
+	if(idx == NULL || !Index_IsNative(idx)) return;
+
+	bool descending = (sort->directions[0] == DIR_DESC);
+	OpBase *ordered = NewNodeByOrderedIndexScanOp(plan, scan->g, scan->n, idx,
+			attr, descending);
+
+	ExecutionPlan_ReplaceOp(plan, (OpBase *)scan, ordered);
+	OpBase_Free((OpBase *)scan);
+
+	ExecutionPlan_RemoveOp(plan, (OpBase *)sort);
+	OpBase_Free((OpBase *)sort);
+}
+
+void reduceSort
+(
+	ExecutionPlan *plan
+) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	// return immediately if the graph has no indices
+	if(!GraphContext_HasIndices(gc)) return;
+
+	OpBase **sorts = ExecutionPlan_CollectOps(plan->root, OPType_SORT);
+
+	uint sort_count = array_len(sorts);
+	for(uint i = 0; i < sort_count; i++) {
+		_reduceSort(plan, (OpSort *)sorts[i]);
+	}
+
+	array_free(sorts);
+}
+
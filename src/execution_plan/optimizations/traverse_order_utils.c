@@ -6,6 +6,7 @@
 
 #include "RG.h"
 #include "../../util/arr.h"
+#include "../../query_ctx.h"
 #include "../../util/strcmp.h"
 #include "traverse_order_utils.h"
 
@@ -28,6 +29,56 @@ static bool _AlgebraicExpression_IsVarLen
 	return QGEdge_VariableLength(e);
 }
 
+// estimate the number of nodes 'alias' can be bound to
+// based on the graph's label statistics
+static uint64_t _NodeCardinality
+(
+	const char *alias,
+	const QueryGraph *qg,
+	const Graph *g
+) {
+	QGNode *n = QueryGraph_GetNodeByAlias(qg, alias);
+	ASSERT(n != NULL);
+
+	// unlabeled node, any node in the graph is a candidate
+	uint label_count = QGNode_LabelCount(n);
+	if(label_count == 0) return Graph_NodeCount(g);
+
+	// labeled node, bound by its least populated label
+	// an unknown label has no nodes
+	uint64_t cardinality = UINT64_MAX;
+	for(uint i = 0; i < label_count; i++) {
+		int label_id = QGNode_GetLabelID(n, i);
+		cardinality = MIN(cardinality, Graph_LabeledNodeCount(g, label_id));
+	}
+
+	return cardinality;
+}
+
+// estimate the number of nodes an expression's evaluation starts from
+// the smaller of its source and destination cardinality
+// as the expression might get transposed
+static uint64_t _AlgebraicExpression_Cardinality
+(
+	AlgebraicExpression *exp,
+	const QueryGraph *qg,
+	const Graph *g
+) {
+	// variable length traversals are performed by dedicated expressions
+	// treat them as the most expensive starting point
+	if(_AlgebraicExpression_IsVarLen(exp, qg)) return Graph_NodeCount(g);
+
+	const char *src  = AlgebraicExpression_Src(exp);
+	const char *dest = AlgebraicExpression_Dest(exp);
+
+	uint64_t cardinality = _NodeCardinality(src, qg, g);
+	if(RG_STRCMP(src, dest) != 0) {
+		cardinality = MIN(cardinality, _NodeCardinality(dest, qg, g));
+	}
+
+	return cardinality;
+}
+
 //------------------------------------------------------------------------------
 // Scoring functions
 //------------------------------------------------------------------------------
@@ -216,21 +267,26 @@ void TraverseOrder_ScoreExpressions
 	rax *filtered_entities,      // map of filtered entities
 	const QueryGraph *qg         // query graph
 ) {
-	// scoring of algebraic expression is done according to 3 criterias
+	// scoring of algebraic expression is done according to 4 criterias
 	// ordered by strongest to weakest:
 	// 1. The source or destination are bound
 	// 2. Existence of filters on either source or destinaion
 	// 3. Label(s) on the expression source or destination
+	// 4. Estimated number of nodes the expression starts from
 	//
-	// the expressions will be evaluated in 3 phases, one for each criteria
+	// the expressions will be evaluated in 4 phases, one for each criteria
 	// (from weakest to strongest)
 	//
 	// the score given for each criteria is:
 	// (the maximum score given in the previous criteria) + (criteria scoring function)
 	// where the first criteria starts with (criteria scoring function)
 	//
+	// phase 0 - estimated cardinality
+	// expression scoring = number of expressions estimated to start
+	// from more nodes than the current expression
+	//
 	// phase 1 - check for labels on either source or destination
-	// expression scoring = _expression_labels_score
+	// expression scoring = (max(phase 0 scoring results) + 1) * _expression_labels_score
 	//
 	// phase 2 - check for existence of filters on either source or destinaion
 	// expression scoring = (max(phase 1 scoring results)) + _expression_filter_existence_score
@@ -244,22 +300,52 @@ void TraverseOrder_ScoreExpressions
 	int                  currmax      =  0;
 	AlgebraicExpression  *exp         =  NULL;
 	ScoredExp            *scored_exp  =  NULL;
+	const Graph          *g           =  QueryCtx_GetGraph();
 
 	//--------------------------------------------------------------------------
-	//  phase 1 score label
+	//  phase 0 score cardinality
 	//--------------------------------------------------------------------------
 
+	// expressions starting from fewer nodes rank higher
+	// expressions with equal estimates are scored the same
+	uint64_t cardinality[nexp];
+	for(uint i = 0; i < nexp; i ++) {
+		cardinality[i] = _AlgebraicExpression_Cardinality(exps[i], qg, g);
+	}
+
 	for(uint i = 0; i < nexp; i ++) {
-		exp = exps[i];
 		scored_exp = scored_exps + i;
 
-		score = TraverseOrder_LabelsScore(exp, qg);
-		scored_exp->exp = exp;
+		score = 0;
+		for(uint j = 0; j < nexp; j ++) {
+			if(cardinality[j] > cardinality[i]) score++;
+		}
+		scored_exp->exp = exps[i];
 		scored_exp->score = score;
 
 		max = MAX(max, score);
 	}
 
+	// update phase 0 maximum score
+	currmax = max;
+
+	//--------------------------------------------------------------------------
+	//  phase 1 score label
+	//--------------------------------------------------------------------------
+
+	for(uint i = 0; i < nexp; i ++) {
+		scored_exp = scored_exps + i;
+		exp = scored_exp->exp;
+
+		// cardinality only breaks ties between equally labeled expressions
+		score = TraverseOrder_LabelsScore(exp, qg);
+		if(score > 0) {
+			score *= (currmax + 1);
+			scored_exp->score += score;
+			max = MAX(max, scored_exp->score);
+		}
+	}
+
 	// update phase 1 maximum score
 	currmax = max;
 
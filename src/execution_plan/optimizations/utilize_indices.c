@@ -19,6 +19,7 @@
 #include "../ops/op_conditional_traverse.h"
 #include "../ops/op_conditional_traverse.h"
 #include "../../arithmetic/arithmetic_op.h"
+#include "../../filter_tree/ft_to_native.h"
 #include "../../filter_tree/filter_tree_utils.h"
 #include "../../arithmetic/algebraic_expression.h"
 #include "../../arithmetic/algebraic_expression/utils.h"
@@ -297,7 +298,7 @@ void reduce_scan_op
 	// that has the minimum NNZ entries
 	int         min_label_id;                 // tracks min label ID
 	uint64_t    min_nnz        = UINT64_MAX;  // tracks min entries
-	RSIndex     *rs_idx        = NULL;        // the index to be applied
+	Index       *min_idx       = NULL;        // the index to be applied
 	OpFilter    **filters      = NULL;        // tracks indexed filters to apply
 	uint        filters_count  = 0;           // number of matching filters
 	const char  *min_label_str = NULL;        // tracks min label name
@@ -323,7 +324,6 @@ void reduce_scan_op
 		if(idx == NULL) continue;
 
 		// get all applicable filter for index
-		RSIndex *cur_idx = idx->idx;
 		// TODO switch to reusable array
 		OpFilter **cur_filters = _applicableFilters((OpBase *)scan, scan->n.alias, idx);
 
@@ -337,9 +337,21 @@ void reduce_scan_op
 			continue;
 		}
 
+		// a native index requires a conjunct to seek by
+		if(Index_IsNative(idx)) {
+			bool seekable = false;
+			for(uint j = 0; j < cur_filters_count && !seekable; j++) {
+				seekable = FilterTree_NativeSeekable(cur_filters[j]->filterTree);
+			}
+			if(!seekable) {
+				array_free(cur_filters);
+				continue;
+			}
+		}
+
 		nnz = Graph_LabeledNodeCount(g, label_id);
 		if(min_nnz > nnz) {
-			rs_idx         =  cur_idx;
+			min_idx        =  idx;
 			min_nnz        =  nnz;
 			min_label_str  =  label;
 			min_label_id   =  label_id;
@@ -353,7 +365,7 @@ void reduce_scan_op
 	}
 
 	// no label possessed indexed and filtered attributes, return early
-	if(rs_idx == NULL) goto cleanup;
+	if(min_idx == NULL) goto cleanup;
 
 	// did we found a better label to utilize? if so swap
 	if(scan->n.label_id != min_label_id) {
@@ -387,7 +399,7 @@ void reduce_scan_op
 	}
 
 	FT_FilterNode *root = _Concat_Filters(filters);
-	OpBase *indexOp = NewIndexScanOp(scan->op.plan, scan->g, scan->n, rs_idx,
+	OpBase *indexOp = NewIndexScanOp(scan->op.plan, scan->g, scan->n, min_idx,
 			root);
 
 	// replace the redundant scan op with the newly-constructed Index Scan
@@ -410,18 +422,21 @@ cleanup:
 
 // try to replace given Conditional Traverse operation and a set of Filter operations with
 // a single Index Scan operation
-void reduce_cond_op(ExecutionPlan *plan, OpCondTraverse *cond) {
+// returns true if the traverse operation was replaced
+bool reduce_cond_op(ExecutionPlan *plan, OpCondTraverse *cond) {
+	bool reduced = false;
+
 	// make sure there's an index for scanned label
 	const char *edge = AlgebraicExpression_Edge(cond->ae);
-	if(!edge) return;
+	if(!edge) return false;
 	
 	QGEdge *e = QueryGraph_GetEdgeByAlias(cond->op.plan->query_graph, edge);
-	if(QGEdge_RelationCount(e) != 1) return;
+	if(QGEdge_RelationCount(e) != 1) return false;
 
 	const char *label = QGEdge_Relation(e, 0);
 	GraphContext *gc = QueryCtx_GetGraphCtx();
 	Index *idx = GraphContext_GetIndex(gc, label, NULL, IDX_EXACT_MATCH, SCHEMA_EDGE);
-	if(idx == NULL) return;
+	if(idx == NULL) return false;
 
 	// get all applicable filter for index
 	RSIndex *rs_idx = idx->idx;
@@ -431,6 +446,8 @@ void reduce_cond_op(ExecutionPlan *plan, OpCondTraverse *cond) {
 	uint filters_count = array_len(filters);
 	if(filters_count == 0) goto cleanup;
 
+	reduced = true;
+
 	FT_FilterNode *root = _Concat_Filters(filters);
 	OpBase *indexOp = NewEdgeIndexScanOp(cond->op.plan, cond->graph, e, rs_idx,
 			root);
@@ -494,6 +511,77 @@ void reduce_cond_op(ExecutionPlan *plan, OpCondTraverse *cond) {
 
 cleanup:
 	array_free(filters);
+	return reduced;
+}
+
+// try to restrict the destination nodes of a Conditional Traverse operation
+// to the nodes matching an indexed filter
+// the index results are intersected with the traversal as a diagonal matrix
+// rather than filtering each traversed node individually
+// applies only when attribute statistics estimate the filter to be selective
+void reduce_traverse_dest(OpCondTraverse *cond) {
+	GraphContext  *gc     =  QueryCtx_GetGraphCtx();
+	const char    *dest   =  AlgebraicExpression_Dest(cond->ae);
+	QGNode        *qn     =  QueryGraph_GetNodeByAlias(cond->op.plan->query_graph,
+			dest);
+	ASSERT(qn != NULL);
+
+	uint label_count = QGNode_LabelCount(qn);
+	for(uint i = 0; i < label_count; i++) {
+		int label_id = QGNode_GetLabelID(qn, i);
+		const char *label = QGNode_GetLabel(qn, i);
+
+		// unknown label
+		if(label_id == GRAPH_UNKNOWN_LABEL) continue;
+
+		Index *idx = GraphContext_GetIndexByID(gc, label_id, NULL,
+				IDX_EXACT_MATCH, SCHEMA_NODE);
+		if(idx == NULL) continue;
+
+		// label matrix must be part of the traversal
+		AlgebraicExpression *operand = NULL;
+		if(!AlgebraicExpression_LocateOperand(cond->ae, &operand, NULL, dest,
+					dest, NULL, label)) {
+			continue;
+		}
+
+		OpFilter **filters = _applicableFilters((OpBase *)cond, dest, idx);
+
+		// the index is queried once, filters may only refer to 'dest'
+		uint filters_count = array_len(filters);
+		for(uint j = 0; j < filters_count; j++) {
+			rax *entities = FilterTree_CollectModified(filters[j]->filterTree);
+			bool dest_only = raxSize(entities) == 1;
+			raxFree(entities);
+			if(!dest_only || (Index_IsNative(idx) &&
+				!FilterTree_NativeSeekable(filters[j]->filterTree))) {
+				array_del(filters, j);
+				j--;
+				filters_count--;
+			}
+		}
+
+		if(filters_count == 0) {
+			array_free(filters);
+			continue;
+		}
+
+		// filters remain in place
+		// the index restricts the traversal to a superset of their matches
+		FT_FilterNode *root = _Concat_Filters(filters);
+		array_free(filters);
+
+		// the index is worth querying only if it reports few nodes
+		// parameters are resolved at runtime, once their values are known
+		if(IndexScan_EstimateSelectivity(idx, root, false) >
+		   INDEX_SCAN_DEST_MAX_SELECTIVITY) {
+			FilterTree_Free(root);
+			continue;
+		}
+
+		CondTraverseOp_SetDestIndex(cond, idx, label, root);
+		return;
+	}
 }
 
 void utilizeIndices
@@ -531,7 +619,10 @@ void utilizeIndices
 	for(uint i = 0; i < condOpCount; i++) {
 		OpCondTraverse *condOp = (OpCondTraverse *)condOps[i];
 		// try to reduce conditional travers + filter(s) to a single IndexScan operation
-		reduce_cond_op(plan, condOp);
+		if(reduce_cond_op(plan, condOp)) continue;
+
+		// try to restrict traversed destination nodes using an index
+		reduce_traverse_dest(condOp);
 	}
 
 	// cleanup
@@ -9,10 +9,29 @@
 #include "../errors.h"
 #include "../util/rmalloc.h"
 
+/* Locate the Record holding the entry at the given index,
+ * following shared Records until the entry is found.
+ * Returns the last Record in the chain if the entry is not set. */
+static inline Record _RecordLocate(const Record r, uint idx) {
+	Record rec = r;
+	while(rec->entries[idx].type == REC_TYPE_UNKNOWN && rec->parent != NULL) {
+		rec = rec->parent;
+	}
+	return rec;
+}
+
 /* Migrate the entry at the given index in the source Record at the same index in the destination.
  * The source retains access to but not ownership of the entry if it is a heap allocation. */
 static void _RecordPropagateEntry(Record dest, Record src, uint idx) {
-	Entry e = src->entries[idx];
+	Record holder = _RecordLocate(src, idx);
+	Entry e = holder->entries[idx];
+	if(holder != src) {
+		/* The entry is shared with the source and may not outlive it,
+		 * the destination gets its own copy. */
+		if(e.type == REC_TYPE_SCALAR) e.value.s = SI_CloneValue(e.value.s);
+		dest->entries[idx] = e;
+		return;
+	}
 	dest->entries[idx] = e;
 	// If the entry is a scalar, make sure both Records don't believe they own the allocation.
 	if(e.type == REC_TYPE_SCALAR) SIValue_MakeVolatile(&src->entries[idx].value.s);
@@ -28,6 +47,7 @@ Record Record_New(rax *mapping) {
 
 	Record r = rm_calloc(1, rec_size);
 	r->mapping = mapping;
+	r->ref_count = 1;
 
 	return r;
 }
@@ -40,7 +60,7 @@ uint Record_length(const Record r) {
 
 bool Record_ContainsEntry(const Record r, uint idx) {
 	ASSERT(idx < Record_length(r));
-	return r->entries[idx].type != REC_TYPE_UNKNOWN;
+	return Record_GetType(r, idx) != REC_TYPE_UNKNOWN;
 }
 
 // Retrieve the offset into the Record of the given alias.
@@ -65,19 +85,33 @@ void Record_Clone(const Record r, Record clone) {
 	 * TODO: I wish we wouldn't have to perform this loop as it is a major performance hit
 	 * with the introduction of a garbage collection this should be removed. */
 	for(int i = 0; i < entry_count; i++) {
-		if(Record_GetType(clone, i) == REC_TYPE_SCALAR) {
+		// Copy entries the original record shares with another record.
+		if(clone->entries[i].type == REC_TYPE_UNKNOWN && r->parent != NULL) {
+			clone->entries[i] = _RecordLocate(r, i)->entries[i];
+		}
+		if(clone->entries[i].type == REC_TYPE_SCALAR) {
 			SIValue_MakeVolatile(&clone->entries[i].value.s);
 		}
 	}
 }
 
+void Record_Share(Record r, Record clone) {
+	ASSERT(r != clone);
+	ASSERT(r->owner == clone->owner);
+	ASSERT(clone->parent == NULL);
+
+	// Keep r alive for as long as clone references it.
+	clone->parent = r;
+	r->ref_count++;
+}
+
 void Record_Merge(Record a, const Record b) {
 	ASSERT(a->owner == b->owner);
 	uint len = Record_length(a);
 
 	for(uint i = 0; i < len; i++) {
-		RecordEntryType a_type = a->entries[i].type;
-		RecordEntryType b_type = b->entries[i].type;
+		RecordEntryType a_type = Record_GetType(a, i);
+		RecordEntryType b_type = Record_GetType(b, i);
 
 		if(a_type == REC_TYPE_UNKNOWN && b_type != REC_TYPE_UNKNOWN) {
 			_RecordPropagateEntry(a, b, i);
@@ -88,25 +122,26 @@ void Record_Merge(Record a, const Record b) {
 void Record_TransferEntries(Record *to, Record from) {
 	uint len = Record_length(from);
 	for(uint i = 0; i < len; i++) {
-		if(from->entries[i].type != REC_TYPE_UNKNOWN) {
+		if(Record_GetType(from, i) != REC_TYPE_UNKNOWN) {
 			_RecordPropagateEntry(*to, from, i);
 		}
 	}
 }
 
 RecordEntryType Record_GetType(const Record r, uint idx) {
-	return r->entries[idx].type;
+	return _RecordLocate(r, idx)->entries[idx].type;
 }
 
 Node *Record_GetNode(const Record r, uint idx) {
-	switch(r->entries[idx].type) {
+	Record holder = _RecordLocate(r, idx);
+	switch(holder->entries[idx].type) {
 		case REC_TYPE_NODE:
-			return &(r->entries[idx].value.n);
+			return &(holder->entries[idx].value.n);
 		case REC_TYPE_UNKNOWN:
 			return NULL;
 		case REC_TYPE_SCALAR:
 			// Null scalar values are expected here; otherwise fall through.
-			if(SIValue_IsNull(r->entries[idx].value.s)) return NULL;
+			if(SIValue_IsNull(holder->entries[idx].value.s)) return NULL;
 		default:
 			ErrorCtx_RaiseRuntimeException("encountered unexpected type in Record; expected Node");
 			return NULL;
@@ -114,14 +149,15 @@ Node *Record_GetNode(const Record r, uint idx) {
 }
 
 Edge *Record_GetEdge(const Record r, uint idx) {
-	switch(r->entries[idx].type) {
+	Record holder = _RecordLocate(r, idx);
+	switch(holder->entries[idx].type) {
 		case REC_TYPE_EDGE:
-			return &(r->entries[idx].value.e);
+			return &(holder->entries[idx].value.e);
 		case REC_TYPE_UNKNOWN:
 			return NULL;
 		case REC_TYPE_SCALAR:
 			// Null scalar values are expected here; otherwise fall through.
-			if(SIValue_IsNull(r->entries[idx].value.s)) return NULL;
+			if(SIValue_IsNull(holder->entries[idx].value.s)) return NULL;
 		default:
 			ErrorCtx_RaiseRuntimeException("encountered unexpected type in Record; expected Edge");
 			return NULL;
@@ -129,13 +165,16 @@ Edge *Record_GetEdge(const Record r, uint idx) {
 }
 
 SIValue Record_Get(Record r, uint idx) {
-	Entry e = r->entries[idx];
+	Record holder = _RecordLocate(r, idx);
+	Entry e = holder->entries[idx];
 	switch(e.type) {
 		case REC_TYPE_NODE:
-			return SI_Node(Record_GetNode(r, idx));
+			return SI_Node(Record_GetNode(holder, idx));
 		case REC_TYPE_EDGE:
-			return SI_Edge(Record_GetEdge(r, idx));
+			return SI_Edge(Record_GetEdge(holder, idx));
 		case REC_TYPE_SCALAR:
+			// A shared scalar is owned by the record sharing it.
+			if(holder != r) return SI_ShareValue(e.value.s);
 			return r->entries[idx].value.s;
 		case REC_TYPE_UNKNOWN:
 			return SI_NullVal();
@@ -150,8 +189,7 @@ void Record_Remove(Record r, uint idx) {
 }
 
 GraphEntity *Record_GetGraphEntity(const Record r, uint idx) {
-	Entry e = r->entries[idx];
-	switch(e.type) {
+	switch(Record_GetType(r, idx)) {
 		case REC_TYPE_NODE:
 			return (GraphEntity *)Record_GetNode(r, idx);
 		case REC_TYPE_EDGE:
@@ -198,7 +236,29 @@ Edge *Record_AddEdge(Record r, uint idx, Edge edge) {
 void Record_PersistScalars(Record r) {
 	uint len = Record_length(r);
 	for(uint i = 0; i < len; i++) {
-		if(r->entries[i].type == REC_TYPE_SCALAR) SIValue_Persist(&r->entries[i].value.s);
+		Record holder = _RecordLocate(r, i);
+		if(holder->entries[i].type != REC_TYPE_SCALAR) continue;
+
+		if(holder == r) {
+			SIValue_Persist(&r->entries[i].value.s);
+		} else if(holder->entries[i].value.s.allocation == M_VOLATILE) {
+			/* Shared records are kept alive by the records they are shared with,
+			 * but their volatile scalars are not, persist a local copy. */
+			Record_AddScalar(r, i, SI_CloneValue(holder->entries[i].value.s));
+		}
+	}
+}
+
+void Record_DetachScalars(Record r) {
+	uint len = Record_length(r);
+	for(uint i = 0; i < len; i++) {
+		Record holder = _RecordLocate(r, i);
+		if(holder->entries[i].type != REC_TYPE_SCALAR) continue;
+
+		SIValue v = holder->entries[i].value.s;
+		if(v.allocation == M_VOLATILE || v.allocation == M_CONST) {
+			Record_AddScalar(r, i, SI_CloneValue(v));
+		}
 	}
 }
 
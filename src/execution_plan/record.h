@@ -32,10 +32,12 @@ typedef struct {
 	RecordEntryType type;
 } Entry;
 
-typedef struct {
-	void *owner;        // Owner of record.
-	rax *mapping;       // Mapping between alias to record entry.
-	Entry entries[];    // Array of entries.
+typedef struct _Record {
+	void *owner;              // Owner of record.
+	rax *mapping;             // Mapping between alias to record entry.
+	struct _Record *parent;   // Record sharing its entries with this record, if any.
+	uint ref_count;           // Number of references to record, including shares.
+	Entry entries[];          // Array of entries.
 } _Record;
 
 typedef _Record *Record;
@@ -46,6 +48,11 @@ Record Record_New(rax *mapping);
 // Clones record.
 void Record_Clone(const Record r, Record clone);
 
+// Share record r's entries with clone, without copying them.
+// Entries not set on clone are looked up in r,
+// r must not be modified while shared and is kept alive as long as clone is.
+void Record_Share(Record r, Record clone);
+
 // Merge record b into a, sharing any nested references in b with a.
 void Record_Merge(Record a, const Record b);
 
@@ -74,6 +81,7 @@ Edge *Record_GetEdge(const Record r, uint idx);
 SIValue Record_Get(Record r, uint idx);
 
 // Remove item at position idx.
+// Entries shared with the record are not affected.
 void Record_Remove(Record r, uint idx);
 
 // Get a graph entity from record at position idx.
@@ -94,6 +102,10 @@ Edge *Record_AddEdge(Record r, uint idx, Edge edge);
 // Ensure that all scalar values in record are access-safe.
 void Record_PersistScalars(Record r);
 
+// Ensure that all scalar values in record own their allocations,
+// such that they remain valid when graph entity properties are updated.
+void Record_DetachScalars(Record r);
+
 // String representation of record.
 size_t Record_ToString(const Record r, char **buf, size_t *buf_cap);
 
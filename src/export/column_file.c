@@ -0,0 +1,354 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "column_file.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+
+#include <string.h>
+
+// a single column, buffering the values of the current row group
+typedef struct {
+	char *name;          // column name
+	ColumnType type;     // column type
+	uint64_t count;      // number of values in the current row group
+	uint8_t *validity;   // validity bitmap, a bit per row
+	void *values;        // fixed width value slots, a slot per row
+	uint64_t *lengths;   // variable width columns, data length of each row
+	uint64_t *offsets;   // variable width columns, offsets written to file
+	char *data;          // variable width columns, row data
+	uint64_t data_len;   // number of bytes in 'data'
+	uint64_t data_cap;   // capacity of 'data'
+} Column;
+
+struct ColumnFile {
+	FILE *stream;         // output stream
+	Column *columns;      // columns
+	uint64_t rows;        // number of rows in the current row group
+	uint64_t total_rows;  // number of rows written
+	uint64_t row_groups;  // number of row groups written
+	char *buf;            // scratch buffer for textual representations
+	size_t buf_len;       // size of 'buf'
+	bool failed;          // a write failed
+};
+
+// size of a value slot, 0 for variable width columns
+static size_t _ColumnType_Width
+(
+	ColumnType type
+) {
+	switch(type) {
+		case COLUMN_BOOL:
+			return sizeof(uint8_t);
+		case COLUMN_INT64:
+			return sizeof(int64_t);
+		case COLUMN_DOUBLE:
+			return sizeof(double);
+		case COLUMN_POINT:
+			return 2 * sizeof(float);
+		case COLUMN_STRING:
+		case COLUMN_ARRAY:
+			return 0;
+		default:
+			ASSERT(false);
+			return 0;
+	}
+}
+
+static void _ColumnFile_Write
+(
+	ColumnFile *f,
+	const void *src,
+	size_t size
+) {
+	if(size == 0 || f->failed) return;
+	if(fwrite(src, size, 1, f->stream) != 1) f->failed = true;
+}
+
+static inline Column *_ColumnFile_GetColumn
+(
+	ColumnFile *f,
+	int col
+) {
+	ASSERT(f->rows > 0);
+	ASSERT(col >= 0 && (uint)col < array_len(f->columns));
+
+	Column *c = f->columns + col;
+	uint64_t row = f->rows - 1;
+
+	// a value is set at most once per row
+	ASSERT(!(c->validity[row / 8] & (1 << (row % 8))));
+	c->validity[row / 8] |= 1 << (row % 8);
+	c->count++;
+
+	return c;
+}
+
+// append 'len' bytes of data to the current row of a variable width column
+static void _Column_AppendData
+(
+	Column *c,
+	uint64_t row,
+	const char *data,
+	uint64_t len
+) {
+	if(c->data_len + len > c->data_cap) {
+		c->data_cap = c->data_cap * 2;
+		if(c->data_cap < c->data_len + len) c->data_cap = c->data_len + len;
+		c->data = rm_realloc(c->data, c->data_cap);
+	}
+
+	memcpy(c->data + c->data_len, data, len);
+	c->data_len += len;
+	c->lengths[row] = len;
+}
+
+// write the current row group and reset columns
+static void _ColumnFile_FlushRowGroup
+(
+	ColumnFile *f
+) {
+	uint64_t rows = f->rows;
+	if(rows == 0) return;
+
+	uint32_t column_count = 0;
+	uint32_t n = array_len(f->columns);
+	for(uint32_t i = 0; i < n; i++) {
+		if(f->columns[i].count > 0) column_count++;
+	}
+
+	_ColumnFile_Write(f, &rows, sizeof(uint64_t));
+	_ColumnFile_Write(f, &column_count, sizeof(uint32_t));
+
+	for(uint32_t i = 0; i < n; i++) {
+		Column *c = f->columns + i;
+		if(c->count == 0) continue;
+
+		uint32_t name_len = strlen(c->name);
+		uint8_t type = c->type;
+		_ColumnFile_Write(f, &name_len, sizeof(uint32_t));
+		_ColumnFile_Write(f, c->name, name_len);
+		_ColumnFile_Write(f, &type, sizeof(uint8_t));
+		_ColumnFile_Write(f, c->validity, (rows + 7) / 8);
+
+		size_t width = _ColumnType_Width(c->type);
+		if(width > 0) {
+			_ColumnFile_Write(f, c->values, rows * width);
+			memset(c->values, 0, rows * width);
+		} else {
+			c->offsets[0] = 0;
+			for(uint64_t j = 0; j < rows; j++) {
+				c->offsets[j + 1] = c->offsets[j] + c->lengths[j];
+			}
+			_ColumnFile_Write(f, c->offsets, (rows + 1) * sizeof(uint64_t));
+			_ColumnFile_Write(f, c->data, c->data_len);
+			memset(c->lengths, 0, rows * sizeof(uint64_t));
+			c->data_len = 0;
+		}
+
+		memset(c->validity, 0, (rows + 7) / 8);
+		c->count = 0;
+	}
+
+	f->total_rows += rows;
+	f->row_groups++;
+	f->rows = 0;
+}
+
+ColumnType ColumnFile_TypeOf
+(
+	SIType t
+) {
+	switch(t) {
+		case T_BOOL:
+			return COLUMN_BOOL;
+		case T_INT64:
+			return COLUMN_INT64;
+		case T_DOUBLE:
+			return COLUMN_DOUBLE;
+		case T_STRING:
+			return COLUMN_STRING;
+		case T_POINT:
+			return COLUMN_POINT;
+		case T_ARRAY:
+			return COLUMN_ARRAY;
+		default:
+			return COLUMN_TYPE_COUNT;
+	}
+}
+
+ColumnFile *ColumnFile_New
+(
+	const char *path
+) {
+	ASSERT(path != NULL);
+
+	// fail rather than overwrite an existing file
+	FILE *stream = fopen(path, "wx");
+	if(stream == NULL) return NULL;
+
+	ColumnFile *f = rm_calloc(1, sizeof(ColumnFile));
+	f->stream = stream;
+	f->columns = array_new(Column, 8);
+
+	_ColumnFile_Write(f, COLUMN_FILE_MAGIC, strlen(COLUMN_FILE_MAGIC));
+
+	return f;
+}
+
+int ColumnFile_AddColumn
+(
+	ColumnFile *f,
+	const char *name,
+	ColumnType type
+) {
+	ASSERT(f != NULL);
+	ASSERT(name != NULL);
+	ASSERT(type < COLUMN_TYPE_COUNT);
+
+	Column c = {0};
+	c.name = rm_strdup(name);
+	c.type = type;
+	c.validity = rm_calloc(COLUMN_FILE_ROW_GROUP_SIZE / 8, sizeof(uint8_t));
+
+	size_t width = _ColumnType_Width(type);
+	if(width > 0) {
+		c.values = rm_calloc(COLUMN_FILE_ROW_GROUP_SIZE, width);
+	} else {
+		c.lengths = rm_calloc(COLUMN_FILE_ROW_GROUP_SIZE, sizeof(uint64_t));
+		c.offsets = rm_malloc((COLUMN_FILE_ROW_GROUP_SIZE + 1) *
+				sizeof(uint64_t));
+	}
+
+	array_append(f->columns, c);
+	return array_len(f->columns) - 1;
+}
+
+bool ColumnFile_AddRow
+(
+	ColumnFile *f
+) {
+	ASSERT(f != NULL);
+
+	if(f->rows == COLUMN_FILE_ROW_GROUP_SIZE) _ColumnFile_FlushRowGroup(f);
+	f->rows++;
+
+	return !f->failed;
+}
+
+void ColumnFile_SetInt64
+(
+	ColumnFile *f,
+	int col,
+	int64_t v
+) {
+	ASSERT(f != NULL);
+
+	Column *c = _ColumnFile_GetColumn(f, col);
+	ASSERT(c->type == COLUMN_INT64);
+
+	((int64_t *)c->values)[f->rows - 1] = v;
+}
+
+void ColumnFile_SetString
+(
+	ColumnFile *f,
+	int col,
+	const char *s
+) {
+	ASSERT(f != NULL);
+	ASSERT(s != NULL);
+
+	Column *c = _ColumnFile_GetColumn(f, col);
+	ASSERT(c->type == COLUMN_STRING);
+
+	_Column_AppendData(c, f->rows - 1, s, strlen(s));
+}
+
+void ColumnFile_SetValue
+(
+	ColumnFile *f,
+	int col,
+	SIValue v
+) {
+	ASSERT(f != NULL);
+
+	Column *c = _ColumnFile_GetColumn(f, col);
+	ASSERT(c->type == ColumnFile_TypeOf(SI_TYPE(v)));
+
+	uint64_t row = f->rows - 1;
+
+	switch(c->type) {
+		case COLUMN_BOOL:
+			((uint8_t *)c->values)[row] = v.longval ? 1 : 0;
+			break;
+		case COLUMN_INT64:
+			((int64_t *)c->values)[row] = v.longval;
+			break;
+		case COLUMN_DOUBLE:
+			((double *)c->values)[row] = v.doubleval;
+			break;
+		case COLUMN_POINT:
+			((float *)c->values)[row * 2]     = v.point.latitude;
+			((float *)c->values)[row * 2 + 1] = v.point.longitude;
+			break;
+		case COLUMN_STRING:
+			_Column_AppendData(c, row, v.stringval, strlen(v.stringval));
+			break;
+		case COLUMN_ARRAY: {
+			size_t written = 0;
+			SIValue_ToString(v, &f->buf, &f->buf_len, &written);
+			_Column_AppendData(c, row, f->buf, written);
+			break;
+		}
+		default:
+			ASSERT(false);
+	}
+}
+
+uint64_t ColumnFile_RowCount
+(
+	const ColumnFile *f
+) {
+	ASSERT(f != NULL);
+	return f->total_rows + f->rows;
+}
+
+bool ColumnFile_Close
+(
+	ColumnFile *f
+) {
+	ASSERT(f != NULL);
+
+	_ColumnFile_FlushRowGroup(f);
+
+	// end marker and footer
+	uint64_t end = 0;
+	_ColumnFile_Write(f, &end, sizeof(uint64_t));
+	_ColumnFile_Write(f, &f->total_rows, sizeof(uint64_t));
+	_ColumnFile_Write(f, &f->row_groups, sizeof(uint64_t));
+	_ColumnFile_Write(f, COLUMN_FILE_MAGIC, strlen(COLUMN_FILE_MAGIC));
+
+	if(fclose(f->stream) != 0) f->failed = true;
+	bool ok = !f->failed;
+
+	uint32_t n = array_len(f->columns);
+	for(uint32_t i = 0; i < n; i++) {
+		Column *c = f->columns + i;
+		rm_free(c->name);
+		rm_free(c->validity);
+		if(c->values)  rm_free(c->values);
+		if(c->lengths) rm_free(c->lengths);
+		if(c->offsets) rm_free(c->offsets);
+		if(c->data)    rm_free(c->data);
+	}
+	array_free(f->columns);
+	if(f->buf) rm_free(f->buf);
+	rm_free(f);
+
+	return ok;
+}
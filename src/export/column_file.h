@@ -0,0 +1,134 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../value.h"
+
+// ColumnFile, writes rows into a columnar file
+//
+// rows are buffered and written in row groups of COLUMN_FILE_ROW_GROUP_SIZE
+// rows, within a row group each column is stored contiguously
+// memory consumption is bounded by the row group size, regardless of the
+// number of rows written
+//
+// file layout, integers are in native byte order (little endian on all
+// supported platforms):
+//
+//   magic         "RGCOLS01"
+//   row group*    uint64 row count (> 0)
+//                 uint32 column count
+//                 column chunk*
+//   end marker    uint64 0
+//   footer        uint64 total row count
+//                 uint64 row group count
+//   magic         "RGCOLS01"
+//
+//   column chunk  uint32 name length, name
+//                 uint8  column type
+//                 validity bitmap, one bit per row, (row count + 7) / 8 bytes
+//                 values, a slot per row, slots of null rows are zeroed
+//
+//   values by type:
+//     BOOL        uint8 per row
+//     INT64       int64 per row
+//     DOUBLE      float64 per row
+//     POINT       float32 latitude, float32 longitude per row
+//     STRING      uint64 offsets[row count + 1], followed by
+//     ARRAY       offsets[row count] bytes of UTF-8 data
+//                 arrays are stored in their textual representation
+//
+// a column chunk is written only for columns holding at least one value
+// within the row group, a column missing from a row group is null in all
+// of the group's rows
+
+#define COLUMN_FILE_MAGIC "RGCOLS01"
+#define COLUMN_FILE_ROW_GROUP_SIZE 65536
+
+typedef enum {
+	COLUMN_BOOL    = 0,
+	COLUMN_INT64   = 1,
+	COLUMN_DOUBLE  = 2,
+	COLUMN_STRING  = 3,
+	COLUMN_POINT   = 4,
+	COLUMN_ARRAY   = 5,
+	COLUMN_TYPE_COUNT
+} ColumnType;
+
+typedef struct ColumnFile ColumnFile;
+
+// returns the column type used to store values of type 't'
+// returns COLUMN_TYPE_COUNT if values of type 't' can't be stored
+ColumnType ColumnFile_TypeOf
+(
+	SIType t
+);
+
+// create a new column file at 'path'
+// returns NULL if the file could not be created
+ColumnFile *ColumnFile_New
+(
+	const char *path  // file to create, must not exist
+);
+
+// add a column, returns the column's index
+// columns can be added at any point, earlier rows are null
+int ColumnFile_AddColumn
+(
+	ColumnFile *f,    // column file
+	const char *name, // column name
+	ColumnType type   // column type
+);
+
+// start a new row, all of its columns are null until set
+// returns false if writing a completed row group failed
+bool ColumnFile_AddRow
+(
+	ColumnFile *f  // column file
+);
+
+// set column 'col' of the current row to an integer
+void ColumnFile_SetInt64
+(
+	ColumnFile *f,  // column file
+	int col,        // INT64 column index
+	int64_t v       // value
+);
+
+// set column 'col' of the current row to a string
+void ColumnFile_SetString
+(
+	ColumnFile *f,  // column file
+	int col,        // STRING column index
+	const char *s   // value
+);
+
+// set column 'col' of the current row to a property value
+// 'col' must be of type ColumnFile_TypeOf(v.type)
+void ColumnFile_SetValue
+(
+	ColumnFile *f,  // column file
+	int col,        // column index
+	SIValue v       // value
+);
+
+// number of rows written
+uint64_t ColumnFile_RowCount
+(
+	const ColumnFile *f  // column file
+);
+
+// flush buffered rows, write the footer and close the file
+// returns false if any write failed
+// the column file is freed in either case
+bool ColumnFile_Close
+(
+	ColumnFile *f  // column file
+);
@@ -0,0 +1,425 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "export.h"
+#include "column_file.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../graph/rg_matrix/rg_matrix_iter.h"
+
+#include <stdio.h>
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+// number of node IDs, or matrix rows, exported per acquisition of the
+// graph's read lock
+#define EXPORT_CHUNK_SIZE 65536
+
+static const char *export_files[] = {
+	EXPORT_NODES_FILE,
+	EXPORT_LABELS_FILE,
+	EXPORT_EDGES_FILE
+};
+
+// maps entity attributes to the columns holding their values
+// columns are added the first time a value of an attribute and type
+// is encountered
+typedef struct {
+	GraphContext *gc;  // graph being exported
+	int *columns;      // column of each attribute and type, -1 if none
+	uint attr_cap;     // number of attributes 'columns' can map
+} PropertyColumns;
+
+static void _PropertyColumns_Init
+(
+	PropertyColumns *pc,
+	GraphContext *gc
+) {
+	pc->gc = gc;
+	pc->columns = NULL;
+	pc->attr_cap = 0;
+}
+
+static int _PropertyColumns_Get
+(
+	PropertyColumns *pc,
+	ColumnFile *f,
+	Attribute_ID attr,
+	ColumnType type
+) {
+	if(attr >= pc->attr_cap) {
+		uint cap = GraphContext_AttributeCount(pc->gc);
+		if(cap <= attr) cap = attr + 1;
+		pc->columns = rm_realloc(pc->columns,
+				sizeof(int) * cap * COLUMN_TYPE_COUNT);
+		for(uint i = pc->attr_cap * COLUMN_TYPE_COUNT;
+				i < cap * COLUMN_TYPE_COUNT; i++) {
+			pc->columns[i] = -1;
+		}
+		pc->attr_cap = cap;
+	}
+
+	int *col = pc->columns + attr * COLUMN_TYPE_COUNT + type;
+	if(*col == -1) {
+		const char *name = GraphContext_GetAttributeString(pc->gc, attr);
+		*col = ColumnFile_AddColumn(f, name, type);
+	}
+
+	return *col;
+}
+
+// set the properties of 'e' in the current row
+static void _Export_Properties
+(
+	ColumnFile *f,
+	PropertyColumns *pc,
+	const GraphEntity *e
+) {
+	int prop_count = ENTITY_PROP_COUNT(e);
+	EntityProperty *props = ENTITY_PROPS(e);
+
+	for(int i = 0; i < prop_count; i++) {
+		SIValue v = props[i].value;
+		ColumnType type = ColumnFile_TypeOf(SI_TYPE(v));
+		// skip values which can't be stored as properties
+		if(type == COLUMN_TYPE_COUNT) continue;
+
+		int col = _PropertyColumns_Get(pc, f, props[i].id, type);
+		ColumnFile_SetValue(f, col, v);
+	}
+}
+
+//------------------------------------------------------------------------------
+// export files
+//------------------------------------------------------------------------------
+
+// acquire graph's read lock for the duration of a single chunk
+static void _Export_Lock
+(
+	GraphContext *gc
+) {
+	Graph_AcquireReadLock(gc->g);
+	// make sure matrices are synced, as done for queries
+	Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_FLUSH_RESIZE);
+}
+
+// write every node and its properties
+static bool _Export_Nodes
+(
+	GraphContext *gc,
+	ColumnFile *f
+) {
+	PropertyColumns pc;
+	_PropertyColumns_Init(&pc, gc);
+
+	int id_col = ColumnFile_AddColumn(f, "_id", COLUMN_INT64);
+
+	bool ok = true;
+	for(NodeID start = 0; ok; start += EXPORT_CHUNK_SIZE) {
+		_Export_Lock(gc);
+
+		NodeID end = Graph_UncompactedNodeCount(gc->g);
+		if(start >= end) {
+			Graph_ReleaseLock(gc->g);
+			break;
+		}
+		if(end - start > EXPORT_CHUNK_SIZE) end = start + EXPORT_CHUNK_SIZE;
+
+		for(NodeID id = start; ok && id < end; id++) {
+			Node n;
+			// skip deleted nodes
+			if(!Graph_GetNode(gc->g, id, &n)) continue;
+
+			ok = ColumnFile_AddRow(f);
+			ColumnFile_SetInt64(f, id_col, id);
+			_Export_Properties(f, &pc, (GraphEntity *)&n);
+		}
+
+		Graph_ReleaseLock(gc->g);
+	}
+
+	if(pc.columns) rm_free(pc.columns);
+
+	return ok;
+}
+
+// write a row per labeled node and label
+static bool _Export_Labels
+(
+	GraphContext *gc,
+	ColumnFile *f
+) {
+	int id_col = ColumnFile_AddColumn(f, "_id", COLUMN_INT64);
+	int label_col = ColumnFile_AddColumn(f, "_label", COLUMN_STRING);
+
+	bool ok = true;
+	bool done = false;
+	for(unsigned short i = 0; ok && !done; i++) {
+		for(GrB_Index start = 0; ok; start += EXPORT_CHUNK_SIZE) {
+			_Export_Lock(gc);
+
+			// labels might be added while the lock isn't held
+			if(i >= GraphContext_SchemaCount(gc, SCHEMA_NODE)) {
+				Graph_ReleaseLock(gc->g);
+				done = true;
+				break;
+			}
+
+			Schema *s = GraphContext_GetSchemaByID(gc, i, SCHEMA_NODE);
+			const char *label = Schema_GetName(s);
+			RG_Matrix L = Graph_GetLabelMatrix(gc->g, Schema_GetID(s));
+
+			GrB_Index nrows;
+			GrB_Info info = RG_Matrix_nrows(&nrows, L);
+			ASSERT(info == GrB_SUCCESS);
+			if(start >= nrows) {
+				Graph_ReleaseLock(gc->g);
+				break;
+			}
+
+			GrB_Index end = nrows - 1;
+			if(end - start >= EXPORT_CHUNK_SIZE) end = start + EXPORT_CHUNK_SIZE - 1;
+
+			// label matrices are diagonal, L[id, id] is set for labeled nodes
+			RG_MatrixTupleIter *it;
+			info = RG_MatrixTupleIter_new(&it, L);
+			ASSERT(info == GrB_SUCCESS);
+			info = RG_MatrixTupleIter_iterate_range(it, start, end);
+			ASSERT(info == GrB_SUCCESS);
+
+			GrB_Index id;
+			bool depleted = false;
+			while(ok) {
+				RG_MatrixTupleIter_next(it, &id, NULL, NULL, &depleted);
+				if(depleted) break;
+
+				ok = ColumnFile_AddRow(f);
+				ColumnFile_SetInt64(f, id_col, id);
+				ColumnFile_SetString(f, label_col, label);
+			}
+
+			RG_MatrixTupleIter_free(&it);
+			Graph_ReleaseLock(gc->g);
+		}
+	}
+
+	return ok;
+}
+
+// write a single edge and its properties
+static bool _Export_Edge
+(
+	GraphContext *gc,
+	ColumnFile *f,
+	PropertyColumns *pc,
+	const int *cols,
+	const char *type,
+	NodeID src,
+	NodeID dest,
+	EdgeID id
+) {
+	Edge e;
+	Graph_GetEdge(gc->g, id, &e);
+
+	bool ok = ColumnFile_AddRow(f);
+	ColumnFile_SetInt64(f, cols[0], id);
+	ColumnFile_SetString(f, cols[1], type);
+	ColumnFile_SetInt64(f, cols[2], src);
+	ColumnFile_SetInt64(f, cols[3], dest);
+	_Export_Properties(f, pc, (GraphEntity *)&e);
+
+	return ok;
+}
+
+// write every edge, its endpoints and properties
+static bool _Export_Edges
+(
+	GraphContext *gc,
+	ColumnFile *f
+) {
+	PropertyColumns pc;
+	_PropertyColumns_Init(&pc, gc);
+
+	int cols[4];
+	cols[0] = ColumnFile_AddColumn(f, "_id", COLUMN_INT64);
+	cols[1] = ColumnFile_AddColumn(f, "_type", COLUMN_STRING);
+	cols[2] = ColumnFile_AddColumn(f, "_src", COLUMN_INT64);
+	cols[3] = ColumnFile_AddColumn(f, "_dest", COLUMN_INT64);
+
+	bool ok = true;
+	bool done = false;
+	for(unsigned short i = 0; ok && !done; i++) {
+		for(GrB_Index start = 0; ok; start += EXPORT_CHUNK_SIZE) {
+			_Export_Lock(gc);
+
+			// relationship types might be added while the lock isn't held
+			if(i >= GraphContext_SchemaCount(gc, SCHEMA_EDGE)) {
+				Graph_ReleaseLock(gc->g);
+				done = true;
+				break;
+			}
+
+			Schema *s = GraphContext_GetSchemaByID(gc, i, SCHEMA_EDGE);
+			const char *type = Schema_GetName(s);
+			RG_Matrix R = Graph_GetRelationMatrix(gc->g, Schema_GetID(s), false);
+
+			GrB_Index nrows;
+			GrB_Info info = RG_Matrix_nrows(&nrows, R);
+			ASSERT(info == GrB_SUCCESS);
+			if(start >= nrows) {
+				Graph_ReleaseLock(gc->g);
+				break;
+			}
+
+			GrB_Index end = nrows - 1;
+			if(end - start >= EXPORT_CHUNK_SIZE) end = start + EXPORT_CHUNK_SIZE - 1;
+
+			// R[src, dest] holds either an edge ID or an array of edge IDs
+			RG_MatrixTupleIter *it;
+			info = RG_MatrixTupleIter_new(&it, R);
+			ASSERT(info == GrB_SUCCESS);
+			info = RG_MatrixTupleIter_iterate_range(it, start, end);
+			ASSERT(info == GrB_SUCCESS);
+
+			NodeID src;
+			NodeID dest;
+			EdgeID edge_id;
+			bool depleted = false;
+			while(ok) {
+				RG_MatrixTupleIter_next(it, &src, &dest, &edge_id, &depleted);
+				if(depleted) break;
+
+				if(SINGLE_EDGE(edge_id)) {
+					ok = _Export_Edge(gc, f, &pc, cols, type, src, dest,
+							edge_id);
+					continue;
+				}
+
+				// multiple edges connecting src to dest
+				EdgeID *ids = (EdgeID *)(CLEAR_MSB(edge_id));
+				uint edge_count = array_len(ids);
+				for(uint j = 0; ok && j < edge_count; j++) {
+					ok = _Export_Edge(gc, f, &pc, cols, type, src, dest,
+							ids[j]);
+				}
+			}
+
+			RG_MatrixTupleIter_free(&it);
+			Graph_ReleaseLock(gc->g);
+		}
+	}
+
+	if(pc.columns) rm_free(pc.columns);
+
+	return ok;
+}
+
+//------------------------------------------------------------------------------
+// export
+//------------------------------------------------------------------------------
+
+// remove a partial export directory and its files
+static void _Export_RemovePartial
+(
+	const char *dir
+) {
+	char path[PATH_MAX];
+	for(uint i = 0; i < sizeof(export_files) / sizeof(export_files[0]); i++) {
+		snprintf(path, sizeof(path), "%s/%s", dir, export_files[i]);
+		unlink(path);
+	}
+	rmdir(dir);
+}
+
+// write a single export file using 'write_func'
+static bool _Export_File
+(
+	GraphContext *gc,
+	const char *dir,
+	const char *name,
+	bool (*write_func)(GraphContext *, ColumnFile *),
+	uint64_t *rows,
+	char **err
+) {
+	char path[PATH_MAX];
+	snprintf(path, sizeof(path), "%s/%s", dir, name);
+
+	ColumnFile *f = ColumnFile_New(path);
+	if(f == NULL) {
+		asprintf(err, "Failed to create export file '%s': %s", path,
+				strerror(errno));
+		return false;
+	}
+
+	bool ok = write_func(gc, f);
+	*rows = ColumnFile_RowCount(f);
+
+	// close the file even if writing failed, releasing its resources
+	ok = ColumnFile_Close(f) && ok;
+	if(!ok) {
+		asprintf(err, "Failed to write export file '%s': %s", path,
+				strerror(errno));
+	}
+
+	return ok;
+}
+
+bool Export_Graph
+(
+	GraphContext *gc,
+	const char *path,
+	ExportStats *stats,
+	char **err
+) {
+	ASSERT(gc    != NULL);
+	ASSERT(err   != NULL);
+	ASSERT(path  != NULL);
+	ASSERT(stats != NULL);
+
+	memset(stats, 0, sizeof(ExportStats));
+
+	// refuse to overwrite an existing export
+	struct stat st;
+	if(stat(path, &st) == 0) {
+		asprintf(err, "Export path '%s' already exists", path);
+		return false;
+	}
+
+	char partial[PATH_MAX];
+	if(snprintf(partial, sizeof(partial), "%s.partial", path) >=
+			(int)sizeof(partial)) {
+		asprintf(err, "Export path '%s' is too long", path);
+		return false;
+	}
+
+	if(mkdir(partial, 0755) != 0) {
+		asprintf(err, "Failed to create export directory '%s': %s", partial,
+				strerror(errno));
+		return false;
+	}
+
+	bool ok = _Export_File(gc, partial, EXPORT_NODES_FILE, _Export_Nodes,
+			&stats->nodes, err) &&
+		_Export_File(gc, partial, EXPORT_LABELS_FILE, _Export_Labels,
+			&stats->labels, err) &&
+		_Export_File(gc, partial, EXPORT_EDGES_FILE, _Export_Edges,
+			&stats->edges, err);
+
+	// publish the export
+	if(ok && rename(partial, path) != 0) {
+		asprintf(err, "Failed to rename export directory '%s': %s", partial,
+				strerror(errno));
+		ok = false;
+	}
+
+	if(!ok) _Export_RemovePartial(partial);
+
+	return ok;
+}
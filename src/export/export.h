@@ -0,0 +1,60 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../graph/graphcontext.h"
+
+// export a graph into a directory of columnar files, see column_file.h
+//
+//   nodes.rgc   _id, followed by a column per node attribute and type
+//   labels.rgc  _id, _label, a row per labeled node and label
+//   edges.rgc   _id, _type, _src, _dest, followed by a column per edge
+//               attribute and type
+//
+// an attribute holding values of different types yields a column per type
+// all columns sharing the attribute's name
+//
+// nodes are read by ID, labels and relationships by iterating the graph's
+// matrices a range of rows at a time, without copying them
+//
+// the graph's read lock is held for one chunk of EXPORT_CHUNK_SIZE node IDs
+// or matrix rows at a time, writers get to modify the graph in between
+// chunks, as such an export of a graph which is being modified does not
+// reflect a single point in time: entities created or deleted during the
+// export may or may not be included, and an edge might be exported while
+// one of its endpoints is not
+//
+// files are written into '<path>.partial' which is renamed to 'path'
+// once the export completes, such that 'path' only ever holds a complete
+// export
+
+#define EXPORT_NODES_FILE  "nodes.rgc"
+#define EXPORT_LABELS_FILE "labels.rgc"
+#define EXPORT_EDGES_FILE  "edges.rgc"
+
+// summary of a completed export
+typedef struct {
+	uint64_t nodes;   // number of exported nodes
+	uint64_t labels;  // number of exported node labels
+	uint64_t edges;   // number of exported edges
+} ExportStats;
+
+// export graph into directory 'path'
+// the caller must not hold the graph's lock, the lock is acquired and
+// released by the export as it goes
+// returns false on failure and sets 'err' to an error message
+// which the caller should free
+bool Export_Graph
+(
+	GraphContext *gc,    // graph to export
+	const char *path,    // directory to create, must not exist
+	ExportStats *stats,  // [output] export summary
+	char **err           // [output] error message
+);
@@ -0,0 +1,244 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "ft_to_native.h"
+#include "RG.h"
+#include "../query_ctx.h"
+#include "../util/arr.h"
+#include "filter_tree_utils.h"
+#include "../datatypes/array.h"
+
+// returns true if filter is a predicate the index can seek by
+static bool _SeekablePredicate
+(
+	const FT_FilterNode *filter
+) {
+	if(filter->t != FT_N_PRED) return false;
+	if(!AR_EXP_IsAttribute(filter->pred.lhs, NULL)) return false;
+
+	switch(filter->pred.op) {
+		case OP_EQUAL:
+		case OP_LT:
+		case OP_LE:
+		case OP_GT:
+		case OP_GE:
+			return true;
+		default:
+			return false;
+	}
+}
+
+// collect filter's top level conjuncts
+static void _CollectConjuncts
+(
+	const FT_FilterNode *tree,
+	const FT_FilterNode ***conjuncts
+) {
+	if(tree->t == FT_N_COND && tree->cond.op == OP_AND) {
+		_CollectConjuncts(tree->cond.left, conjuncts);
+		_CollectConjuncts(tree->cond.right, conjuncts);
+	} else if(_SeekablePredicate(tree) || isInFilter(tree)) {
+		array_append(*conjuncts, tree);
+	}
+}
+
+// returns the ID of the attribute accessed by 'exp'
+static Attribute_ID _AttributeID
+(
+	const AR_ExpNode *exp
+) {
+	char *attr = NULL;
+	bool attribute = AR_EXP_IsAttribute(exp, &attr);
+	ASSERT(attribute == true);
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	return GraphContext_GetAttributeID(gc, attr);
+}
+
+bool FilterTree_NativeSeekable
+(
+	const FT_FilterNode *tree
+) {
+	ASSERT(tree != NULL);
+
+	const FT_FilterNode **conjuncts = array_new(const FT_FilterNode *, 1);
+	_CollectConjuncts(tree, &conjuncts);
+	bool seekable = array_len(conjuncts) > 0;
+	array_free(conjuncts);
+
+	return seekable;
+}
+
+// reduce 'exp' to a constant, evaluating query parameters
+// e.g. $p, -$p or [$a, $b]
+// returns false if 'exp' can't be resolved ahead of scanning
+static bool _ReduceToConstant
+(
+	AR_ExpNode *exp  // expression to reduce in place
+) {
+	return AR_EXP_ReduceToScalar(exp, true, NULL) && AR_EXP_IsConstant(exp);
+}
+
+// returns true if filter compares an attribute against a constant
+// parameters compared against are reduced to constants
+static bool _ConstantPredicate
+(
+	const FT_FilterNode *f,  // filter
+	Attribute_ID *attr       // [output] compared attribute
+) {
+	if(isInFilter(f)) return false;
+	if(!_ReduceToConstant(f->pred.rhs)) return false;
+
+	*attr = _AttributeID(f->pred.lhs);
+	return true;
+}
+
+// find the tightest constant bounds on attribute
+// returns false if attribute isn't bound
+static bool _RangeBounds
+(
+	const FT_FilterNode **conjuncts,  // conjuncts to inspect
+	Attribute_ID attr,                // bound attribute
+	const SIValue **lo,               // [output] lower bound
+	const SIValue **hi                // [output] upper bound
+) {
+	*lo = NULL;
+	*hi = NULL;
+
+	uint n = array_len(conjuncts);
+	for(uint i = 0; i < n; i++) {
+		const FT_FilterNode *f = conjuncts[i];
+		Attribute_ID f_attr;
+		if(!_ConstantPredicate(f, &f_attr) || f_attr != attr) continue;
+		if(f->pred.op == OP_EQUAL) continue;
+
+		// strict bounds are inclusive here, the filter discards the edges
+		const SIValue *c = &f->pred.rhs->operand.constant;
+		if(f->pred.op == OP_GT || f->pred.op == OP_GE) {
+			if(*lo == NULL || SIValue_Compare(*c, **lo, NULL) > 0) *lo = c;
+		} else {
+			if(*hi == NULL || SIValue_Compare(*c, **hi, NULL) < 0) *hi = c;
+		}
+	}
+
+	return (*lo != NULL || *hi != NULL);
+}
+
+// seek by composite key, equality over the leftmost composite attributes
+// optionally followed by a range over the next attribute
+// returns false if the composite key doesn't constrain more than
+// a single attribute
+static bool _CompositeSeek
+(
+	NativeIndexIterator *it,
+	const FT_FilterNode **conjuncts
+) {
+	Attribute_ID *composite = it->idx->composite;
+	if(composite == NULL) return false;
+
+	uint n = array_len(conjuncts);
+	uint composite_len = array_len(composite);
+	SIValue prefix[composite_len];
+	uint prefix_len = 0;
+
+	// extend prefix while leading attributes are compared by equality
+	while(prefix_len < composite_len) {
+		bool found = false;
+		for(uint i = 0; i < n && !found; i++) {
+			const FT_FilterNode *f = conjuncts[i];
+			Attribute_ID attr;
+			if(!_ConstantPredicate(f, &attr)) continue;
+			if(attr != composite[prefix_len] || f->pred.op != OP_EQUAL) continue;
+			prefix[prefix_len] = f->pred.rhs->operand.constant;
+			found = true;
+		}
+		if(!found) break;
+		prefix_len++;
+	}
+
+	const SIValue *lo = NULL;
+	const SIValue *hi = NULL;
+	bool range = (prefix_len < composite_len &&
+		_RangeBounds(conjuncts, composite[prefix_len], &lo, &hi));
+
+	if(prefix_len + range < 2) return false;
+
+	NativeIndexIterator_AddCompositeRange(it, prefix, prefix_len, lo, hi);
+	return true;
+}
+
+void FilterTreeToNativeRanges
+(
+	NativeIndexIterator *it,
+	const FT_FilterNode *tree
+) {
+	ASSERT(it   != NULL);
+	ASSERT(tree != NULL);
+
+	const FT_FilterNode **conjuncts = array_new(const FT_FilterNode *, 1);
+	_CollectConjuncts(tree, &conjuncts);
+
+	uint n = array_len(conjuncts);
+	ASSERT(n > 0);
+
+	// prefer composite seeks, followed by equality, IN and lastly by ranges
+	// a single seek is sufficient as the filter is re-applied
+
+	if(_CompositeSeek(it, conjuncts)) goto cleanup;
+
+	for(uint i = 0; i < n; i++) {
+		const FT_FilterNode *f = conjuncts[i];
+		Attribute_ID attr;
+		if(!_ConstantPredicate(f, &attr) || f->pred.op != OP_EQUAL) continue;
+
+		// n.v = c
+		NativeIndexIterator_AddEquals(it, attr, f->pred.rhs->operand.constant);
+		goto cleanup;
+	}
+
+	for(uint i = 0; i < n; i++) {
+		const FT_FilterNode *f = conjuncts[i];
+		if(!isInFilter(f)) continue;
+
+		AR_ExpNode *in = f->exp.exp;
+		AR_ExpNode *list_exp = in->op.children[1];
+		if(!_ReduceToConstant(list_exp)) continue;
+
+		SIValue list = list_exp->operand.constant;
+		if(SI_TYPE(list) != T_ARRAY) continue;
+
+		// n.v IN [c0, c1, ...], overlapping ranges are merged by the iterator
+		Attribute_ID attr = _AttributeID(in->op.children[0]);
+		uint list_len = SIArray_Length(list);
+		for(uint j = 0; j < list_len; j++) {
+			NativeIndexIterator_AddEquals(it, attr, SIArray_Get(list, j));
+		}
+		goto cleanup;
+	}
+
+	// bound the first attribute compared against a constant
+	for(uint i = 0; i < n; i++) {
+		Attribute_ID attr;
+		if(!_ConstantPredicate(conjuncts[i], &attr)) continue;
+
+		const SIValue *lo;
+		const SIValue *hi;
+		bool bound = _RangeBounds(conjuncts, attr, &lo, &hi);
+		ASSERT(bound == true);
+
+		NativeIndexIterator_AddRange(it, attr, lo, hi);
+		goto cleanup;
+	}
+
+	// none of the conjuncts is compared against a constant
+	// entities lacking the attribute can't pass the filter
+	const FT_FilterNode *f = conjuncts[0];
+	AR_ExpNode *lhs = isInFilter(f) ? f->exp.exp->op.children[0] : f->pred.lhs;
+	NativeIndexIterator_AddAttribute(it, _AttributeID(lhs));
+
+cleanup:
+	array_free(conjuncts);
+}
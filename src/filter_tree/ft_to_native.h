@@ -0,0 +1,26 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "filter_tree.h"
+#include "../index/native_index.h"
+
+// returns true if filter tree holds a conjunct a native index can seek by
+// e.g. n.v = exp, n.v < exp or n.v IN list
+bool FilterTree_NativeSeekable
+(
+	const FT_FilterNode *tree  // normalized filter tree
+);
+
+// introduce seek ranges to a native index iterator
+// the ranges cover a superset of the entities passing the filter
+// as such the entire filter should still be applied to scanned entities
+void FilterTreeToNativeRanges
+(
+	NativeIndexIterator *it,   // iterator to populate
+	const FT_FilterNode *tree  // resolved filter tree
+);
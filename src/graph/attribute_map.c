@@ -0,0 +1,188 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "attribute_map.h"
+#include "../RG.h"
+#include "xxhash.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+
+#include <string.h>
+
+// initial number of hash table slots, must be a power of 2
+#define ATTRIBUTE_MAP_INITIAL_SLOTS 64
+
+// initial capacity of the names array
+#define ATTRIBUTE_MAP_INITIAL_NAMES 32
+
+// open addressing hash table, each slot holds an attribute ID + 1
+// where 0 marks an empty slot, the table is kept at most half full
+typedef struct {
+	uint mask;         // number of slots - 1
+	uint32_t slots[];  // slots, MUST BE LAST MEMBER OF THE STRUCT!
+} AttributeTable;
+
+struct AttributeMap {
+	AttributeTable *table;  // name -> ID hash table
+	char **names;           // ID -> name
+	uint cap;               // capacity of 'names'
+	uint count;             // number of attributes
+	void **retired;         // replaced tables and name arrays
+};
+
+static inline uint _AttributeMap_Hash
+(
+	const char *name
+) {
+	return (uint)XXH64(name, strlen(name), 0);
+}
+
+static AttributeTable *_AttributeTable_New
+(
+	uint slot_count
+) {
+	AttributeTable *table = rm_calloc(1,
+			sizeof(AttributeTable) + sizeof(uint32_t) * slot_count);
+	table->mask = slot_count - 1;
+	return table;
+}
+
+// returns the slot in which 'name' should be placed
+// the slot is not visible to readers until it is set
+static uint32_t *_AttributeTable_FreeSlot
+(
+	AttributeTable *table,
+	const char *name
+) {
+	uint i = _AttributeMap_Hash(name) & table->mask;
+	while(table->slots[i] != 0) i = (i + 1) & table->mask;
+	return table->slots + i;
+}
+
+AttributeMap *AttributeMap_New(void) {
+	AttributeMap *map = rm_malloc(sizeof(AttributeMap));
+
+	map->table   = _AttributeTable_New(ATTRIBUTE_MAP_INITIAL_SLOTS);
+	map->names   = rm_malloc(sizeof(char *) * ATTRIBUTE_MAP_INITIAL_NAMES);
+	map->cap     = ATTRIBUTE_MAP_INITIAL_NAMES;
+	map->count   = 0;
+	map->retired = array_new(void *, 0);
+
+	return map;
+}
+
+uint AttributeMap_Count
+(
+	const AttributeMap *map
+) {
+	ASSERT(map != NULL);
+	return __atomic_load_n(&map->count, __ATOMIC_ACQUIRE);
+}
+
+Attribute_ID AttributeMap_Find
+(
+	const AttributeMap *map,
+	const char *name
+) {
+	ASSERT(map  != NULL);
+	ASSERT(name != NULL);
+
+	AttributeTable *table = __atomic_load_n(&map->table, __ATOMIC_ACQUIRE);
+	uint i = _AttributeMap_Hash(name) & table->mask;
+
+	while(true) {
+		uint32_t slot = __atomic_load_n(table->slots + i, __ATOMIC_ACQUIRE);
+		if(slot == 0) return ATTRIBUTE_NOTFOUND;
+
+		// names array is published before the slot referring to it
+		char **names = __atomic_load_n(&map->names, __ATOMIC_ACQUIRE);
+		if(strcmp(names[slot - 1], name) == 0) return slot - 1;
+
+		i = (i + 1) & table->mask;
+	}
+}
+
+const char *AttributeMap_GetName
+(
+	const AttributeMap *map,
+	Attribute_ID id
+) {
+	ASSERT(map != NULL);
+	ASSERT(id < AttributeMap_Count(map));
+
+	char **names = __atomic_load_n(&map->names, __ATOMIC_ACQUIRE);
+	return names[id];
+}
+
+Attribute_ID AttributeMap_Add
+(
+	AttributeMap *map,
+	const char *name
+) {
+	ASSERT(map  != NULL);
+	ASSERT(name != NULL);
+	ASSERT(AttributeMap_Find(map, name) == ATTRIBUTE_NOTFOUND);
+
+	Attribute_ID id = map->count;
+	ASSERT(id < ATTRIBUTE_ALL);
+
+	//--------------------------------------------------------------------------
+	// store name
+	//--------------------------------------------------------------------------
+
+	if(id == map->cap) {
+		// names array is full, replace it with a larger copy
+		// readers might still be accessing the current array, retire it
+		char **names = rm_malloc(sizeof(char *) * map->cap * 2);
+		memcpy(names, map->names, sizeof(char *) * map->cap);
+		array_append(map->retired, map->names);
+		map->cap *= 2;
+		__atomic_store_n(&map->names, names, __ATOMIC_RELEASE);
+	}
+
+	map->names[id] = rm_strdup(name);
+	__atomic_store_n(&map->count, id + 1, __ATOMIC_RELEASE);
+
+	//--------------------------------------------------------------------------
+	// index name
+	//--------------------------------------------------------------------------
+
+	AttributeTable *table = map->table;
+	uint slot_count = table->mask + 1;
+
+	if((id + 1) * 2 > slot_count) {
+		// table is too loaded, rehash into a larger table and publish it
+		AttributeTable *grown = _AttributeTable_New(slot_count * 2);
+		for(uint i = 0; i <= id; i++) {
+			*_AttributeTable_FreeSlot(grown, map->names[i]) = i + 1;
+		}
+		array_append(map->retired, table);
+		__atomic_store_n(&map->table, grown, __ATOMIC_RELEASE);
+	} else {
+		uint32_t *slot = _AttributeTable_FreeSlot(table, name);
+		__atomic_store_n(slot, id + 1, __ATOMIC_RELEASE);
+	}
+
+	return id;
+}
+
+void AttributeMap_Free
+(
+	AttributeMap *map
+) {
+	ASSERT(map != NULL);
+
+	for(uint i = 0; i < map->count; i++) rm_free(map->names[i]);
+	rm_free(map->names);
+	rm_free(map->table);
+
+	uint retired_count = array_len(map->retired);
+	for(uint i = 0; i < retired_count; i++) rm_free(map->retired[i]);
+	array_free(map->retired);
+
+	rm_free(map);
+}
+
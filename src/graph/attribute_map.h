@@ -0,0 +1,59 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include "entities/graph_entity.h"
+
+// AttributeMap maps attribute names to attribute IDs and vice versa
+//
+// attributes are never removed and IDs are assigned sequentially
+// lookups are lock-free, readers never block and are never blocked
+// additions are published atomically, structures replaced by an addition
+// (when the map grows) are retired and kept alive until the map is freed
+//
+// the map supports a single writer at a time, concurrent calls to
+// AttributeMap_Add must be serialized by the caller
+
+typedef struct AttributeMap AttributeMap;
+
+// create a new attribute map
+AttributeMap *AttributeMap_New(void);
+
+// returns number of attributes in map
+uint AttributeMap_Count
+(
+	const AttributeMap *map  // attribute map
+);
+
+// returns the ID of 'name', ATTRIBUTE_NOTFOUND if 'name' is not in the map
+Attribute_ID AttributeMap_Find
+(
+	const AttributeMap *map,  // attribute map
+	const char *name          // attribute name
+);
+
+// returns the name of attribute 'id'
+const char *AttributeMap_GetName
+(
+	const AttributeMap *map,  // attribute map
+	Attribute_ID id           // attribute ID
+);
+
+// add attribute 'name' to the map, returns its ID
+// 'name' must not already be in the map
+Attribute_ID AttributeMap_Add
+(
+	AttributeMap *map,  // attribute map
+	const char *name    // attribute name
+);
+
+// free attribute map
+void AttributeMap_Free
+(
+	AttributeMap *map  // attribute map to free
+);
+
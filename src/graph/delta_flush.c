@@ -0,0 +1,145 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "delta_flush.h"
+#include "../RG.h"
+#include "graphcontext.h"
+#include "../util/arr.h"
+#include "../util/cron.h"
+#include "../util/thpool/pools.h"
+#include "../redismodule.h"
+#include "../configuration/config.h"
+
+// number of graphs being loaded or replicated
+extern uint aux_field_counter;
+
+static void _DeltaFlush_Task(void *pdata);
+
+// schedule next flush
+static void _DeltaFlush_Schedule(void) {
+	uint64_t interval;
+	Config_Option_get(Config_DELTA_FLUSH_INTERVAL, &interval);
+
+	// background flush is disabled, check back later in case
+	// the interval gets reconfigured
+	if(interval == 0) interval = DELTA_FLUSH_INTERVAL_DEFAULT;
+
+	Cron_AddTask(interval, _DeltaFlush_Task, NULL);
+}
+
+// retrieve the i-th matrix of graph 'g'
+// matrices are accessed directly, bypassing the graph's sync policy
+// returns NULL once 'i' exceeds the number of matrices
+static RG_Matrix _DeltaFlush_GetMatrix
+(
+	Graph *g,
+	uint i
+) {
+	if(i == 0) return g->adjacency_matrix;
+	if(i == 1) return g->node_labels;
+	i -= 2;
+
+	uint label_count = array_len(g->labels);
+	if(i < label_count) return g->labels[i];
+	i -= label_count;
+
+	if(i < array_len(g->relations)) return g->relations[i];
+
+	return NULL;
+}
+
+// flush pending changes of a single graph, runs on the writer thread
+// such that the flush is serialized with write queries rather than
+// competing with them for the graph's write lock
+// the write lock is held for one matrix at a time, readers get
+// to access the graph in between matrices
+static void _DeltaFlush_Graph
+(
+	void *pdata
+) {
+	GraphContext *gc = (GraphContext *)pdata;
+	Graph *g = gc->g;
+
+	for(uint i = 0; ; i++) {
+		Graph_AcquireWriteLock(g);
+
+		RG_Matrix M = _DeltaFlush_GetMatrix(g, i);
+		if(M != NULL) RG_Matrix_wait(M, true);
+
+		Graph_ReleaseLock(g);
+
+		if(M == NULL) break;
+	}
+
+	__atomic_store_n(&gc->flush_scheduled, false, __ATOMIC_RELAXED);
+	GraphContext_Release(gc);
+}
+
+// queue a flush of 'gc' on the writer thread
+// a graph has at most one queued flush at any given time
+// takes ownership of the caller's reference to 'gc'
+static void _DeltaFlush_ScheduleGraph
+(
+	GraphContext *gc
+) {
+	bool scheduled = false;
+	if(!__atomic_compare_exchange_n(&gc->flush_scheduled, &scheduled, true,
+				false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+		// a flush of this graph is already queued
+		GraphContext_Release(gc);
+		return;
+	}
+
+	// see if graph has anything to flush
+	// a graph accessed by a writer is skipped, the writer will either flush
+	// on its own once enough changes accumulate or on the next attempt
+	bool pending = false;
+	if(Graph_TryAcquireReadLock(gc->g)) {
+		pending = Graph_Pending(gc->g);
+		Graph_ReleaseLock(gc->g);
+	}
+
+	if(!pending || ThreadPools_AddWorkWriter(_DeltaFlush_Graph, gc,
+				(uintptr_t)gc) != 0) {
+		__atomic_store_n(&gc->flush_scheduled, false, __ATOMIC_RELAXED);
+		GraphContext_Release(gc);
+	}
+}
+
+static void _DeltaFlush_Task(void *pdata) {
+	UNUSED(pdata);
+
+	uint64_t interval;
+	Config_Option_get(Config_DELTA_FLUSH_INTERVAL, &interval);
+
+	if(interval > 0) {
+		// graphs_in_keyspace is modified by the main thread
+		// retain each graph while holding the GIL
+		RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(NULL);
+		RedisModule_ThreadSafeContextLock(ctx);
+
+		GraphContext **gcs = NULL;
+		// graphs are incomplete while being loaded or replicated
+		if(aux_field_counter == 0) gcs = GraphContext_RetrieveRegistered();
+
+		RedisModule_ThreadSafeContextUnlock(ctx);
+		RedisModule_FreeThreadSafeContext(ctx);
+
+		if(gcs != NULL) {
+			uint n = array_len(gcs);
+			for(uint i = 0; i < n; i++) {
+				_DeltaFlush_ScheduleGraph(gcs[i]);
+			}
+			array_free(gcs);
+		}
+	}
+
+	_DeltaFlush_Schedule();
+}
+
+void DeltaFlush_Start(void) {
+	_DeltaFlush_Schedule();
+}
@@ -0,0 +1,17 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+// background flushing of pending matrix changes
+// every DELTA_FLUSH_INTERVAL ms each graph with pending changes has a flush
+// queued on the writer thread, merging its RG_Matrix delta matrices into
+// their main matrices and moving the cost of the merge off the write path
+// the flush holds the graph's write lock one matrix at a time
+
+// schedule the first background flush, should be called once
+// after both CRON and the module configuration are initialized
+void DeltaFlush_Start(void);
@@ -18,6 +18,70 @@ SIValue *PROPERTY_NOTFOUND = &(SIValue) {
 	.longval = 0, .type = T_NULL
 };
 
+// strings shorter than this are stored within the entity's property bag
+#define PROPERTY_INLINE_STRING_MAX 64
+
+// an entity's properties reside in a single allocation, the property bag
+// the bag starts with the entity's EntityProperty array, followed by the
+// contents of every short string property, short strings are marked as M_CONST
+// and are released together with the bag
+//
+// |id|value|id|value|...|id|value|"str1\0"|"str2\0"|...|
+//
+// short strings are laid out in the order of the properties holding them
+
+// returns true if 'v' should be stored within the property bag
+static inline bool _GraphEntity_InlineString(SIValue v) {
+	return (SI_TYPE(v) == T_STRING &&
+			strnlen(v.stringval, PROPERTY_INLINE_STRING_MAX) < PROPERTY_INLINE_STRING_MAX);
+}
+
+// returns true if property value 'v' resides within the property bag
+static inline bool _GraphEntity_IsInlined(SIValue v) {
+	return (SI_TYPE(v) == T_STRING && v.allocation == M_CONST);
+}
+
+// prepare 'v' to be stored as a property
+// short strings are referenced, to be copied into the bag by _GraphEntity_Pack
+// other values are cloned
+static inline SIValue _GraphEntity_PropertyValue(SIValue v) {
+	if(_GraphEntity_InlineString(v)) return SI_ConstStringVal(v.stringval);
+	return SI_CloneValue(v);
+}
+
+// replace entity's property bag with a bag holding 'props'
+// referenced short strings are copied into the new bag
+// the old bag is freed only after its strings have been copied
+// 'props' may reside within the old bag
+static void _GraphEntity_Pack(Entity *e, const EntityProperty *props, int count) {
+	EntityProperty *bag = NULL;
+
+	if(count > 0) {
+		size_t size = sizeof(EntityProperty) * count;
+		for(int i = 0; i < count; i++) {
+			if(_GraphEntity_IsInlined(props[i].value)) {
+				size += strlen(props[i].value.stringval) + 1;
+			}
+		}
+
+		bag = rm_malloc(size);
+		char *tail = (char *)(bag + count);
+		for(int i = 0; i < count; i++) {
+			bag[i] = props[i];
+			if(!_GraphEntity_IsInlined(props[i].value)) continue;
+
+			size_t len = strlen(props[i].value.stringval) + 1;
+			memcpy(tail, props[i].value.stringval, len);
+			bag[i].value.stringval = tail;
+			tail += len;
+		}
+	}
+
+	rm_free(e->properties);
+	e->properties = bag;
+	e->prop_count = count;
+}
+
 /* Removes entity's property. */
 static bool _GraphEntity_RemoveProperty(const GraphEntity *e, Attribute_ID attr_id) {
 	// Quick return if attribute is missing.
@@ -25,22 +89,15 @@ static bool _GraphEntity_RemoveProperty(const GraphEntity *e, Attribute_ID attr_
 
 	// Locate attribute position.
 	int prop_count = e->entity->prop_count;
+	EntityProperty *props = e->entity->properties;
 	for(int i = 0; i < prop_count; i++) {
-		if(attr_id == e->entity->properties[i].id) {
-			SIValue_Free(e->entity->properties[i].value);
-			e->entity->prop_count--;
-
-			if(e->entity->prop_count == 0) {
-				/* Only attribute removed, free properties bag. */
-				rm_free(e->entity->properties);
-				e->entity->properties = NULL;
-			} else {
-				/* Overwrite deleted attribute with the last
-				 * attribute and shrink properties bag. */
-				e->entity->properties[i] = e->entity->properties[prop_count - 1];
-				e->entity->properties = rm_realloc(e->entity->properties,
-												   sizeof(EntityProperty) * e->entity->prop_count);
-			}
+		if(attr_id == props[i].id) {
+			SIValue_Free(props[i].value);
+
+			/* Overwrite deleted attribute with the last
+			 * attribute and shrink properties bag. */
+			props[i] = props[prop_count - 1];
+			_GraphEntity_Pack(e->entity, props, prop_count - 1);
 
 			return true;
 		}
@@ -68,22 +125,99 @@ int GraphEntity_ClearProperties(GraphEntity *e) {
 
 /* Add a new property to entity */
 bool GraphEntity_AddProperty(GraphEntity *e, Attribute_ID attr_id, SIValue value) {
+	return GraphEntity_AddProperties(e, &attr_id, &value, 1) == 1;
+}
+
+// returns true if 'ptr' points into the first 'size' bytes of 'bag'
+static inline bool _GraphEntity_InBag(const EntityProperty *bag, size_t size,
+		const char *ptr) {
+	uintptr_t start = (uintptr_t)bag;
+	return (uintptr_t)ptr >= start && (uintptr_t)ptr < start + size;
+}
+
+int GraphEntity_AddProperties(GraphEntity *e, const Attribute_ID *attr_ids,
+		const SIValue *values, uint count) {
 	ASSERT(e);
-	if(!(SI_TYPE(value) & SI_VALID_PROPERTY_VALUE)) return false;
+	ASSERT(count == 0 || (attr_ids != NULL && values != NULL));
 
-	if(e->entity->properties == NULL) {
-		e->entity->properties = rm_malloc(sizeof(EntityProperty));
+	Entity *en = e->entity;
+	int prop_count = en->prop_count;
+	EntityProperty *old = en->properties;
+
+	size_t array_size = sizeof(EntityProperty) * prop_count;
+	size_t strings_size = 0;
+	for(int i = 0; i < prop_count; i++) {
+		if(_GraphEntity_IsInlined(old[i].value)) {
+			strings_size += strlen(old[i].value.stringval) + 1;
+		}
+	}
+
+	// a value referring to the bag itself prevents growing it in place
+	uint added = 0;
+	bool aliased = false;
+	size_t added_strings_size = 0;
+	for(uint i = 0; i < count; i++) {
+		SIValue v = values[i];
+		if(!(SI_TYPE(v) & SI_VALID_PROPERTY_VALUE)) continue;
+
+		added++;
+		if(!_GraphEntity_InlineString(v)) continue;
+
+		added_strings_size += strlen(v.stringval) + 1;
+		aliased |= _GraphEntity_InBag(old, array_size + strings_size,
+				v.stringval);
+	}
+
+	if(added == 0) return 0;
+
+	size_t new_array_size = sizeof(EntityProperty) * (prop_count + added);
+	size_t size = new_array_size + strings_size + added_strings_size;
+
+	EntityProperty *bag;
+	if(aliased) {
+		bag = rm_malloc(size);
+		if(prop_count > 0) memcpy(bag, old, array_size + strings_size);
 	} else {
-		e->entity->properties = rm_realloc(e->entity->properties,
-										   sizeof(EntityProperty) * (e->entity->prop_count + 1));
+		// grow bag, in place if the allocator allows it
+		bag = rm_realloc(old, size);
 	}
 
-	int prop_idx = e->entity->prop_count;
-	e->entity->properties[prop_idx].id = attr_id;
-	e->entity->properties[prop_idx].value = SI_CloneValue(value);
-	e->entity->prop_count++;
+	// move short strings past the grown property array
+	// and point their properties at their new location
+	char *tail = (char *)bag + new_array_size;
+	if(strings_size > 0) {
+		memmove(tail, (char *)bag + array_size, strings_size);
+		for(int i = 0; i < prop_count; i++) {
+			if(!_GraphEntity_IsInlined(bag[i].value)) continue;
+			bag[i].value.stringval = tail;
+			tail += strlen(tail) + 1;
+		}
+	}
 
-	return true;
+	// append new properties
+	EntityProperty *prop = bag + prop_count;
+	for(uint i = 0; i < count; i++) {
+		SIValue v = values[i];
+		if(!(SI_TYPE(v) & SI_VALID_PROPERTY_VALUE)) continue;
+
+		prop->id = attr_ids[i];
+		if(_GraphEntity_InlineString(v)) {
+			size_t len = strlen(v.stringval) + 1;
+			memcpy(tail, v.stringval, len);
+			prop->value = SI_ConstStringVal(tail);
+			tail += len;
+		} else {
+			prop->value = SI_CloneValue(v);
+		}
+		prop++;
+	}
+
+	if(aliased) rm_free(old);
+
+	en->properties = bag;
+	en->prop_count = prop_count + added;
+
+	return added;
 }
 
 SIValue *GraphEntity_GetProperty(const GraphEntity *e, Attribute_ID attr_id) {
@@ -121,8 +255,18 @@ bool GraphEntity_SetProperty(const GraphEntity *e, Attribute_ID attr_id, SIValue
 	if(SIValue_Compare(*current, value, NULL) == 0) return false;
 
 	// value != current, update entity
+	if(!_GraphEntity_IsInlined(*current) && !_GraphEntity_InlineString(value)) {
+		// bag layout is unaffected, update in place
+		SIValue_Free(*current);
+		*current = SI_CloneValue(value);
+		return true;
+	}
+
+	// repack bag
 	SIValue_Free(*current);
-	*current = SI_CloneValue(value);
+	*current = _GraphEntity_PropertyValue(value);
+	_GraphEntity_Pack(e->entity, e->entity->properties, e->entity->prop_count);
+
 	return true;
 }
 
@@ -70,6 +70,12 @@ int GraphEntity_ClearProperties(GraphEntity *e);
  * returns - reference to newly added property. */
 bool GraphEntity_AddProperty(GraphEntity *e, Attribute_ID attr_id, SIValue value);
 
+// adds 'count' properties to entity at once, values are copied
+// invalid property values are skipped
+// returns the number of properties added
+int GraphEntity_AddProperties(GraphEntity *e, const Attribute_ID *attr_ids,
+		const SIValue *values, uint count);
+
 /* Retrieves entity's property
  * NOTE: If the key does not exist, we return the special
  * constant value PROPERTY_NOTFOUND. */
@@ -64,6 +64,12 @@ void Graph_AcquireWriteLock(Graph *g) {
 	g->_writelocked = true;
 }
 
+// Try to acquire a lock for non-exclusive access to this graph's data
+// without blocking, returns true if the lock was acquired
+bool Graph_TryAcquireReadLock(Graph *g) {
+	return pthread_rwlock_tryrdlock(&g->_rwlock) == 0;
+}
+
 // Release the held lock
 void Graph_ReleaseLock
 (
@@ -449,6 +455,16 @@ uint Graph_DeletedEdgeCount(const Graph *g) {
 	return DataBlock_DeletedItemsCount(g->edges);
 }
 
+NodeID Graph_NextNodeID(const Graph *g) {
+	ASSERT(g);
+	return DataBlock_NextItemIdx(g->nodes);
+}
+
+EdgeID Graph_NextEdgeID(const Graph *g) {
+	ASSERT(g);
+	return DataBlock_NextItemIdx(g->edges);
+}
+
 int Graph_RelationTypeCount(const Graph *g) {
 	return array_len(g->relations);
 }
@@ -693,6 +709,94 @@ void Graph_CreateEdge
 	Graph_FormConnection(g, src, dest, id, r);
 }
 
+void Graph_CreateEdges
+(
+	Graph *g,
+	int r,
+	const NodeID *srcs,
+	const NodeID *dests,
+	uint64_t n,
+	Edge *edges
+) {
+	ASSERT(g != NULL);
+	ASSERT(r < Graph_RelationTypeCount(g));
+	ASSERT(n == 0 || (srcs != NULL && dests != NULL && edges != NULL));
+
+	if(n == 0) return;
+
+	typedef struct {
+		NodeID src;
+		NodeID dest;
+		EdgeID id;
+	} EdgeTuple;
+
+	EdgeTuple *tuples = rm_malloc(sizeof(EdgeTuple) * n);
+
+	//--------------------------------------------------------------------------
+	// allocate edge entities
+	//--------------------------------------------------------------------------
+
+	for(uint64_t i = 0; i < n; i++) {
+		EdgeID id;
+		Edge   *e   = edges + i;
+		Entity *en  = DataBlock_AllocateItem(g->edges, &id);
+
+		e->id           =  id;
+		e->entity       =  en;
+		e->srcNodeID    =  srcs[i];
+		e->destNodeID   =  dests[i];
+		e->relationID   =  r;
+		en->prop_count  =  0;
+		en->properties  =  NULL;
+
+		tuples[i] = (EdgeTuple){srcs[i], dests[i], id};
+	}
+
+	//--------------------------------------------------------------------------
+	// sort tuples by source, destination and edge ID
+	//--------------------------------------------------------------------------
+
+	// GraphBLAS skips its own sort when handed sorted tuples
+#define is_tuple_lt(a, b) ((a)->src < (b)->src ||                       \
+		((a)->src == (b)->src && ((a)->dest < (b)->dest ||              \
+		((a)->dest == (b)->dest && (a)->id < (b)->id))))
+	QSORT(EdgeTuple, tuples, n, is_tuple_lt);
+#undef is_tuple_lt
+
+	GrB_Index *I = rm_malloc(sizeof(GrB_Index) * n);
+	GrB_Index *J = rm_malloc(sizeof(GrB_Index) * n);
+	uint64_t  *X = rm_malloc(sizeof(uint64_t) * n);
+
+	for(uint64_t i = 0; i < n; i++) {
+		I[i] = tuples[i].src;
+		J[i] = tuples[i].dest;
+		X[i] = tuples[i].id;
+	}
+	rm_free(tuples);
+
+	//--------------------------------------------------------------------------
+	// form connections
+	//--------------------------------------------------------------------------
+
+	GrB_Info info;
+	UNUSED(info);
+	RG_Matrix  M    =  Graph_GetRelationMatrix(g, r, false);
+	RG_Matrix  adj  =  Graph_GetAdjacencyMatrix(g, false);
+
+	info = RG_Matrix_build_UINT64(M, I, J, X, n);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = RG_Matrix_build_BOOL(adj, I, J, n);
+	ASSERT(info == GrB_SUCCESS);
+
+	// n edges of type r have just been created, update statistics
+	GraphStatistics_IncEdgeCount(&g->stats, r, n);
+
+	rm_free(I);
+	rm_free(J);
+	rm_free(X);
+}
+
 // retrieves all either incoming or outgoing edges
 // to/from given node N, depending on given direction
 void Graph_GetNodeEdges
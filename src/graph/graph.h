@@ -73,6 +73,13 @@ void Graph_AcquireWriteLock
 	Graph *g
 );
 
+// try to acquire a lock for non-exclusive access to this graph's data
+// returns false without blocking if the lock is exclusively held
+bool Graph_TryAcquireReadLock
+(
+	Graph *g
+);
+
 // release the held lock
 void Graph_ReleaseLock
 (
@@ -175,6 +182,19 @@ void Graph_CreateEdge
 	Edge *e
 );
 
+// creates 'n' edges of relation type 'r' where edges[i] connects
+// srcs[i] to dests[i], the relation and adjacency matrices are each
+// updated by a single build rather than per-edge insertion
+void Graph_CreateEdges
+(
+	Graph *g,               // graph on which to operate
+	int r,                  // edge type
+	const NodeID *srcs,     // source node IDs
+	const NodeID *dests,    // destination node IDs
+	uint64_t n,             // number of edges to create
+	Edge *edges             // [output] created edges
+);
+
 // removes node and all of its connections within the graph
 void Graph_DeleteNode
 (
@@ -272,6 +292,18 @@ uint Graph_DeletedEdgeCount
 	const Graph *g
 );
 
+// returns the ID the next created node will be assigned
+NodeID Graph_NextNodeID
+(
+	const Graph *g
+);
+
+// returns the ID the next created edge will be assigned
+EdgeID Graph_NextEdgeID
+(
+	const Graph *g
+);
+
 // returns number of different edge types
 int Graph_RelationTypeCount
 (
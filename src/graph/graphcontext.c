@@ -9,6 +9,7 @@
 #include "graphcontext.h"
 #include "../RG.h"
 #include "../util/arr.h"
+#include "../util/qsort.h"
 #include "../util/uuid.h"
 #include "../query_ctx.h"
 #include "../redismodule.h"
@@ -39,7 +40,7 @@ static inline void _GraphContext_DecreaseRefCount(GraphContext *gc) {
 
 		if(async_delete) {
 			// Async delete
-			ThreadPools_AddWorkWriter(_GraphContext_Free, gc);
+			ThreadPools_AddWorkWriter(_GraphContext_Free, gc, (uintptr_t)gc);
 		} else {
 			// Sync delete
 			_GraphContext_Free(gc);
@@ -60,10 +61,13 @@ GraphContext *GraphContext_New
 
 	gc->version          = 0;  // initial graph version
 	gc->slowlog          = SlowLog_New();
+	gc->op_metrics       = OpMetrics_New();
+	gc->query_stats      = QueryStats_New();
 	gc->ref_count        = 0;  // no refences
-	gc->attributes       = raxNew();
+	gc->admitted_queries = 0;  // no admitted queries
+	gc->flush_scheduled  = false;  // no background flush queued
+	gc->attributes       = AttributeMap_New();
 	gc->index_count      = 0;  // no indicies
-	gc->string_mapping   = array_new(char *, 64);
 	gc->encoding_context = GraphEncodeContext_New();
 	gc->decoding_context = GraphDecodeContext_New();
 
@@ -83,8 +87,8 @@ GraphContext *GraphContext_New
 	gc->node_schemas = array_new(Schema *, GRAPH_DEFAULT_LABEL_CAP);
 	gc->relation_schemas = array_new(Schema *, GRAPH_DEFAULT_RELATION_TYPE_CAP);
 
-	// initialize the read-write lock to protect access to the attributes rax
-	assert(pthread_rwlock_init(&gc->_attribute_rwlock, NULL) == 0);
+	// initialize the lock serializing attribute additions
+	assert(pthread_mutex_init(&gc->_attribute_lock, NULL) == 0);
 
 	// build the execution plans cache
 	uint64_t cache_size;
@@ -167,6 +171,37 @@ void GraphContext_Release(GraphContext *gc) {
 	_GraphContext_DecreaseRefCount(gc);
 }
 
+bool GraphContext_AdmitQuery
+(
+	GraphContext *gc,
+	uint64_t budget
+) {
+	ASSERT(gc != NULL);
+
+	uint admitted = __atomic_load_n(&gc->admitted_queries, __ATOMIC_RELAXED);
+	do {
+		if(budget != QUERIES_PER_GRAPH_UNLIMITED && admitted >= budget) {
+			return false;
+		}
+	} while(!__atomic_compare_exchange_n(&gc->admitted_queries, &admitted,
+				admitted + 1, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+	// admitted query keeps the graph alive until it is released
+	_GraphContext_IncreaseRefCount(gc);
+	return true;
+}
+
+void GraphContext_ReleaseQuery
+(
+	GraphContext *gc
+) {
+	ASSERT(gc != NULL);
+	ASSERT(gc->admitted_queries > 0);
+
+	__atomic_sub_fetch(&gc->admitted_queries, 1, __ATOMIC_RELAXED);
+	_GraphContext_DecreaseRefCount(gc);
+}
+
 void GraphContext_MarkWriter(RedisModuleCtx *ctx, GraphContext *gc) {
 	RedisModuleString *graphID = RedisModule_CreateString(ctx, gc->graph_name, strlen(gc->graph_name));
 
@@ -283,74 +318,114 @@ Schema *GraphContext_AddSchema(GraphContext *gc, const char *label, SchemaType t
 	return schema;
 }
 
+void GraphContext_RebuildAttributeStats(GraphContext *gc) {
+	ASSERT(gc != NULL);
+
+	uint schema_count = array_len(gc->node_schemas);
+	for(uint i = 0; i < schema_count; i++) {
+		Schema_RebuildAttributeStats(gc->node_schemas[i], gc->g);
+	}
+}
+
+void GraphContext_DeleteNodesFromAttributeStats
+(
+	GraphContext *gc,
+	Node *nodes,
+	uint node_count
+) {
+	ASSERT(gc != NULL);
+	ASSERT(nodes != NULL || node_count == 0);
+
+	if(node_count == 0) return;
+
+	// sort a copy, leaving the caller's nodes in place
+	Node **sorted = rm_malloc(sizeof(Node *) * node_count);
+	for(uint i = 0; i < node_count; i++) sorted[i] = nodes + i;
+
+#define is_node_lt(a, b) (ENTITY_GET_ID(*(a)) < ENTITY_GET_ID(*(b)))
+	QSORT(Node *, sorted, node_count, is_node_lt);
+
+	for(uint i = 0; i < node_count; i++) {
+		Node *n = sorted[i];
+
+		// skip duplicates and nodes which are already deleted
+		if(i > 0 && ENTITY_GET_ID(n) == ENTITY_GET_ID(sorted[i - 1])) continue;
+		if(GraphEntity_IsDeleted((GraphEntity *)n)) continue;
+
+		uint label_count;
+		NODE_GET_LABELS(gc->g, n, label_count);
+
+		for(uint j = 0; j < label_count; j++) {
+			Schema *s = GraphContext_GetSchemaByID(gc, labels[j], SCHEMA_NODE);
+			ASSERT(s != NULL);
+			Schema_RemoveNodeFromAttributeStats(s, n);
+		}
+	}
+
+	rm_free(sorted);
+}
+
+void GraphContext_UpdateNodeAttributeStats
+(
+	GraphContext *gc,
+	const Node *n,
+	Attribute_ID attr,
+	SIValue old_value,
+	SIValue new_value
+) {
+	ASSERT(n  != NULL);
+	ASSERT(gc != NULL);
+
+	uint label_count;
+	NODE_GET_LABELS(gc->g, n, label_count);
+
+	for(uint i = 0; i < label_count; i++) {
+		Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
+		ASSERT(s != NULL);
+		Schema_UpdateAttributeStats(s, attr, old_value, new_value);
+	}
+}
+
 const char *GraphContext_GetEdgeRelationType(const GraphContext *gc, Edge *e) {
 	int reltype_id = Graph_GetEdgeRelation(gc->g, e);
 	ASSERT(reltype_id != GRAPH_NO_RELATION);
 	return gc->relation_schemas[reltype_id]->name;
 }
 
+// attribute lookups are lock-free, see attribute_map.h
 uint GraphContext_AttributeCount(GraphContext *gc) {
-	pthread_rwlock_rdlock(&gc->_attribute_rwlock);
-	uint size = raxSize(gc->attributes);
-	pthread_rwlock_unlock(&gc->_attribute_rwlock);
-	return size;
+	return AttributeMap_Count(gc->attributes);
 }
 
 Attribute_ID GraphContext_FindOrAddAttribute(GraphContext *gc, const char *attribute) {
-	// Acquire a read lock for looking up the attribute.
-	pthread_rwlock_rdlock(&gc->_attribute_rwlock);
-
 	// See if attribute already exists.
-	void *attribute_id = raxFind(gc->attributes, (unsigned char *)attribute, strlen(attribute));
-
-	if(attribute_id == raxNotFound) {
-		// We are writing to the shared GraphContext; release the held lock and re-acquire as a writer.
-		pthread_rwlock_unlock(&gc->_attribute_rwlock);
-		pthread_rwlock_wrlock(&gc->_attribute_rwlock);
-
-		// Lookup the attribute again now that we are in a critical region.
-		attribute_id = raxFind(gc->attributes, (unsigned char *)attribute, strlen(attribute));
-		// If it has been set by another thread, use the retrieved value.
-		if(attribute_id == raxNotFound) {
-			// Otherwise, it will be assigned an ID equal to the current mapping size.
-			attribute_id = (void *)raxSize(gc->attributes);
-			// Insert the new attribute key and ID.
-			raxInsert(gc->attributes,
-					  (unsigned char *)attribute,
-					  strlen(attribute),
-					  attribute_id,
-					  NULL);
-			array_append(gc->string_mapping, rm_strdup(attribute));
-
-			// new attribute been added, update graph version
-			_GraphContext_UpdateVersion(gc, attribute);
-		}
+	Attribute_ID id = AttributeMap_Find(gc->attributes, attribute);
+	if(id != ATTRIBUTE_NOTFOUND) return id;
+
+	// We are writing to the shared GraphContext, serialize additions.
+	pthread_mutex_lock(&gc->_attribute_lock);
+
+	// Lookup the attribute again now that we are in a critical region.
+	// If it has been set by another thread, use the retrieved value.
+	id = AttributeMap_Find(gc->attributes, attribute);
+	if(id == ATTRIBUTE_NOTFOUND) {
+		// Otherwise, it will be assigned an ID equal to the current mapping size.
+		id = AttributeMap_Add(gc->attributes, attribute);
+
+		// new attribute been added, update graph version
+		_GraphContext_UpdateVersion(gc, attribute);
 	}
 
-	// Release the lock.
-	pthread_rwlock_unlock(&gc->_attribute_rwlock);
-	return (uintptr_t)attribute_id;
+	pthread_mutex_unlock(&gc->_attribute_lock);
+	return id;
 }
 
 const char *GraphContext_GetAttributeString(GraphContext *gc, Attribute_ID id) {
-	pthread_rwlock_rdlock(&gc->_attribute_rwlock);
-	ASSERT(id < array_len(gc->string_mapping));
-	const char *name = gc->string_mapping[id];
-	pthread_rwlock_unlock(&gc->_attribute_rwlock);
-	return name;
+	return AttributeMap_GetName(gc->attributes, id);
 }
 
 Attribute_ID GraphContext_GetAttributeID(GraphContext *gc, const char *attribute) {
-	// Acquire a read lock for looking up the attribute.
-	pthread_rwlock_rdlock(&gc->_attribute_rwlock);
-	// Look up the attribute ID.
-	void *id = raxFind(gc->attributes, (unsigned char *)attribute, strlen(attribute));
-	// Release the lock.
-	pthread_rwlock_unlock(&gc->_attribute_rwlock);
-
-	if(id == raxNotFound) return ATTRIBUTE_NOTFOUND;
-
-	return (uintptr_t)id;
+	return AttributeMap_Find(gc->attributes, attribute);
 }
 
 //------------------------------------------------------------------------------
@@ -403,7 +478,8 @@ int GraphContext_AddExactMatchIndex
 	GraphContext *gc,
 	SchemaType schema_type,
 	const char *label,
-	const char *field
+	const char *field,
+	IndexProvider provider
 ) {
 	ASSERT(idx    !=  NULL);
 	ASSERT(gc     !=  NULL);
@@ -418,7 +494,7 @@ int GraphContext_AddExactMatchIndex
 	IndexField_New(&idx_field, field, INDEX_FIELD_DEFAULT_WEIGHT,
 			INDEX_FIELD_DEFAULT_NOSTEM, INDEX_FIELD_DEFAULT_PHONETIC);
 
-	int res = Schema_AddIndex(idx, s, &idx_field, IDX_EXACT_MATCH);
+	int res = Schema_AddIndex(idx, s, &idx_field, IDX_EXACT_MATCH, provider);
 	if(res != INDEX_OK) {
 		IndexField_Free(&idx_field);
 	}
@@ -450,7 +526,8 @@ int GraphContext_AddFullTextIndex
 	if(s == NULL) s = GraphContext_AddSchema(gc, label, schema_type);
 	IndexField index_field;
 	IndexField_New(&index_field, field, weight, nostem, phonetic);
-	int res = Schema_AddIndex(idx, s, &index_field, IDX_FULLTEXT);
+	int res = Schema_AddIndex(idx, s, &index_field, IDX_FULLTEXT,
+			IDX_PROVIDER_REDISEARCH);
 	ResultSet *result_set = QueryCtx_GetResultSet();
 	ResultSet_IndexCreated(result_set, res);
 
@@ -557,6 +634,19 @@ GraphContext *GraphContext_GetRegisteredGraphContext(const char *graph_name) {
 	return gc;
 }
 
+// retrieve all registered GraphContexts
+// each GraphContext's reference count is increased
+GraphContext **GraphContext_RetrieveRegistered(void) {
+	uint graph_count = array_len(graphs_in_keyspace);
+	GraphContext **gcs = array_new(GraphContext *, graph_count);
+	for(uint i = 0; i < graph_count; i ++) {
+		GraphContext *gc = graphs_in_keyspace[i];
+		_GraphContext_IncreaseRefCount(gc);
+		array_append(gcs, gc);
+	}
+	return gcs;
+}
+
 // Delete a GraphContext reference from the global array
 void GraphContext_RemoveFromRegistry(GraphContext *gc) {
 	uint graph_count = array_len(graphs_in_keyspace);
@@ -578,6 +668,26 @@ SlowLog *GraphContext_GetSlowLog(const GraphContext *gc) {
 	return gc->slowlog;
 }
 
+//------------------------------------------------------------------------------
+// Op metrics API
+//------------------------------------------------------------------------------
+
+// return op metrics associated with graph context
+OpMetrics *GraphContext_GetOpMetrics(const GraphContext *gc) {
+	ASSERT(gc);
+	return gc->op_metrics;
+}
+
+//------------------------------------------------------------------------------
+// Query stats API
+//------------------------------------------------------------------------------
+
+// return query stats associated with graph context
+QueryStats *GraphContext_GetQueryStats(const GraphContext *gc) {
+	ASSERT(gc);
+	return gc->query_stats;
+}
+
 //------------------------------------------------------------------------------
 // Cache API
 //------------------------------------------------------------------------------
@@ -629,20 +739,14 @@ static void _GraphContext_Free(void *arg) {
 	// Free attribute mappings
 	//--------------------------------------------------------------------------
 
-	if(gc->attributes) raxFree(gc->attributes);
-
-	if(gc->string_mapping) {
-		len = array_len(gc->string_mapping);
-		for(uint32_t i = 0; i < len; i ++) {
-			rm_free(gc->string_mapping[i]);
-		}
-		array_free(gc->string_mapping);
-	}
+	if(gc->attributes) AttributeMap_Free(gc->attributes);
 
-	int res = pthread_rwlock_destroy(&gc->_attribute_rwlock);
+	int res = pthread_mutex_destroy(&gc->_attribute_lock);
 	ASSERT(res == 0);
 
 	if(gc->slowlog) SlowLog_Free(gc->slowlog);
+	if(gc->op_metrics) OpMetrics_Free(gc->op_metrics);
+	if(gc->query_stats) QueryStats_Free(gc->query_stats);
 
 	//--------------------------------------------------------------------------
 	// Clear cache
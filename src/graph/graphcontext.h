@@ -10,7 +10,10 @@
 #include "../index/index.h"
 #include "../schema/schema.h"
 #include "../slow_log/slow_log.h"
+#include "../op_metrics/op_metrics.h"
+#include "../query_stats/query_stats.h"
 #include "graph.h"
+#include "attribute_map.h"
 #include "../serializers/encode_context.h"
 #include "../serializers/decode_context.h"
 #include "../util/cache/cache.h"
@@ -28,14 +31,17 @@
 typedef struct {
 	Graph *g;                               // container for all matrices and entity properties
 	int ref_count;                          // number of active references
-	rax *attributes;                        // from strings to attribute IDs
-	pthread_rwlock_t _attribute_rwlock;     // read-write lock to protect access to the attribute maps
+	uint admitted_queries;                  // number of queued and running queries
+	bool flush_scheduled;                   // background delta flush is queued
+	AttributeMap *attributes;               // mapping between attribute names and IDs
+	pthread_mutex_t _attribute_lock;        // serializes attribute additions
 	char *graph_name;                       // string associated with graph
-	char **string_mapping;                  // from attribute IDs to strings
 	Schema **node_schemas;                  // array of schemas for each node label
 	Schema **relation_schemas;              // array of schemas for each relation type
 	unsigned short index_count;             // number of indicies
 	SlowLog *slowlog;                       // slowlog associated with graph
+	OpMetrics *op_metrics;                  // sampled per operation statistics
+	QueryStats *query_stats;                // per query fingerprint statistics
 	GraphEncodeContext *encoding_context;   // encode context of the graph
 	GraphDecodeContext *decoding_context;   // decode context of the graph
 	Cache *cache;                           // global cache of execution plans
@@ -68,6 +74,22 @@ void GraphContext_Release
 	GraphContext *gc
 );
 
+// admit a query against the graph if less than 'budget' queries are
+// currently queued or running, returns true if the query was admitted
+// an admitted query holds a reference to the graph until it is released
+// via GraphContext_ReleaseQuery
+bool GraphContext_AdmitQuery
+(
+	GraphContext *gc,
+	uint64_t budget  // max number of admitted queries, 0 for unlimited
+);
+
+// GraphContext_AdmitQuery counterpart, releases an admitted query
+void GraphContext_ReleaseQuery
+(
+	GraphContext *gc
+);
+
 // mark graph key as "dirty" for Redis to pick up on
 void GraphContext_MarkWriter
 (
@@ -136,6 +158,34 @@ Schema *GraphContext_AddSchema
 	SchemaType t
 );
 
+// recompute attribute statistics of every label
+void GraphContext_RebuildAttributeStats
+(
+	GraphContext *gc
+);
+
+// remove the attributes of nodes about to be deleted from the attribute
+// statistics of their labels, 'nodes' is left untouched and a node
+// appearing multiple times is only accounted for once
+void GraphContext_DeleteNodesFromAttributeStats
+(
+	GraphContext *gc,
+	Node *nodes,
+	uint node_count
+);
+
+// reflect a change of node attribute 'attr' from 'old_value' to 'new_value'
+// in the attribute statistics of its labels
+// a NULL value denotes a missing attribute
+void GraphContext_UpdateNodeAttributeStats
+(
+	GraphContext *gc,
+	const Node *n,
+	Attribute_ID attr,
+	SIValue old_value,
+	SIValue new_value
+);
+
 // retrieve the label string for a given Node object
 const char *GraphContext_GetNodeLabel
 (
@@ -208,13 +258,15 @@ Index *GraphContext_GetIndex
 );
 
 // create an exact match index for the given label and attribute
+// 'provider' is only considered when the index is created
 int GraphContext_AddExactMatchIndex
 (
 	Index **idx,
 	GraphContext *gc,
 	SchemaType schema_type,
 	const char *label,
-	const char *field
+	const char *field,
+	IndexProvider provider
 );
 
 // create a full text index for the given label and attribute
@@ -267,6 +319,12 @@ GraphContext *GraphContext_GetRegisteredGraphContext
 	const char *graph_name
 );
 
+// retrieve all GraphContexts from the global array
+// caller must hold the GIL, each returned GraphContext is retained
+// and should be released via GraphContext_Release, returned array
+// should be freed via array_free
+GraphContext **GraphContext_RetrieveRegistered(void);
+
 // remove GraphContext from global array
 void GraphContext_RemoveFromRegistry
 (
@@ -282,6 +340,24 @@ SlowLog *GraphContext_GetSlowLog
 	const GraphContext *gc
 );
 
+//------------------------------------------------------------------------------
+// Op metrics API
+//------------------------------------------------------------------------------
+
+OpMetrics *GraphContext_GetOpMetrics
+(
+	const GraphContext *gc
+);
+
+//------------------------------------------------------------------------------
+// Query stats API
+//------------------------------------------------------------------------------
+
+QueryStats *GraphContext_GetQueryStats
+(
+	const GraphContext *gc
+);
+
 //------------------------------------------------------------------------------
 // Cache API
 //------------------------------------------------------------------------------
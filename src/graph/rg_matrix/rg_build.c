@@ -0,0 +1,207 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "rg_utils.h"
+#include "rg_matrix.h"
+#include "../../util/arr.h"
+
+static GrB_BinaryOp _graph_edge_merge = NULL;
+
+// merge two edge entries, each of which is either a single edge ID
+// or a pointer to an array of edge IDs
+// the resulting entry reuses x's array when possible
+// y's array (if any) is consumed
+static void _edge_merge(void *_z, const void *_x, const void *_y) {
+	uint64_t       *z  =  (uint64_t *)        _z;
+	const uint64_t *x  =  (const uint64_t *)  _x;
+	const uint64_t *y  =  (const uint64_t *)  _y;
+
+	uint64_t *ids;
+
+	if(SINGLE_EDGE(*x)) {
+		ids = array_new(uint64_t, 2);
+		array_append(ids, *x);
+	} else {
+		ids = (uint64_t *)(CLEAR_MSB(*x));
+	}
+
+	if(SINGLE_EDGE(*y)) {
+		array_append(ids, *y);
+	} else {
+		uint64_t *y_ids = (uint64_t *)(CLEAR_MSB(*y));
+		uint n = array_len(y_ids);
+		for(uint i = 0; i < n; i++) array_append(ids, y_ids[i]);
+		array_free(y_ids);
+	}
+
+	*z = (uint64_t)SET_MSB(ids);
+}
+
+// flush pending changes, built entries are merged directly into 'm'
+// which requires both delta-plus and delta-minus to be empty
+static void _RG_Matrix_flush
+(
+	RG_Matrix C
+) {
+	GrB_Info info = RG_Matrix_wait(C, true);
+	ASSERT(info == GrB_SUCCESS);
+
+#if RG_DEBUG
+	GrB_Index nvals;
+	GrB_Matrix_nvals(&nvals, RG_MATRIX_DELTA_PLUS(C));
+	ASSERT(nvals == 0);
+	GrB_Matrix_nvals(&nvals, RG_MATRIX_DELTA_MINUS(C));
+	ASSERT(nvals == 0);
+#endif
+}
+
+static GrB_Info _RG_Matrix_build_BOOL
+(
+	RG_Matrix C,
+	const GrB_Index *I,
+	const GrB_Index *J,
+	GrB_Index nvals
+) {
+	GrB_Info    info;
+	GrB_Index   nrows;
+	GrB_Index   ncols;
+	GrB_Scalar  s;
+	GrB_Matrix  T  =  NULL;
+	GrB_Matrix  m  =  RG_MATRIX_M(C);
+
+	info = GrB_Matrix_nrows(&nrows, m);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_ncols(&ncols, m);
+	ASSERT(info == GrB_SUCCESS);
+
+	// build T as an iso matrix, duplicates collapse into a single entry
+	info = GrB_Scalar_new(&s, GrB_BOOL);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Scalar_setElement_BOOL(s, true);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_Matrix_new(&T, GrB_BOOL, nrows, ncols);
+	ASSERT(info == GrB_SUCCESS);
+	info = GxB_Matrix_build_Scalar(T, I, J, s, nvals);
+	ASSERT(info == GrB_SUCCESS);
+
+	// m = m + T
+	info = GrB_Matrix_eWiseAdd_Semiring(m, NULL, NULL, GxB_ANY_PAIR_BOOL, m,
+			T, NULL);
+	ASSERT(info == GrB_SUCCESS);
+
+	GrB_free(&s);
+	GrB_Matrix_free(&T);
+
+	return info;
+}
+
+static GrB_Info _RG_Matrix_build_UINT64
+(
+	RG_Matrix C,
+	const GrB_Index *I,
+	const GrB_Index *J,
+	const uint64_t *X,
+	GrB_Index nvals
+) {
+	GrB_Info    info;
+	GrB_Index   nrows;
+	GrB_Index   ncols;
+	GrB_Matrix  T  =  NULL;
+	GrB_Matrix  m  =  RG_MATRIX_M(C);
+
+	// create edge merge binary function
+	if(!_graph_edge_merge) {
+		info = GrB_BinaryOp_new(&_graph_edge_merge, _edge_merge, GrB_UINT64,
+				GrB_UINT64, GrB_UINT64);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	info = GrB_Matrix_nrows(&nrows, m);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_ncols(&ncols, m);
+	ASSERT(info == GrB_SUCCESS);
+
+	// duplicate tuples are assembled into multi-edge entries
+	info = GrB_Matrix_new(&T, GrB_UINT64, nrows, ncols);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_build_UINT64(T, I, J, X, nvals, _graph_edge_merge);
+	ASSERT(info == GrB_SUCCESS);
+
+	// m = m + T
+	// entries present in both m and T are merged into a multi-edge entry
+	// ownership of T's multi-edge arrays moves to m
+	info = GrB_Matrix_eWiseAdd_BinaryOp(m, NULL, NULL, _graph_edge_merge, m,
+			T, NULL);
+	ASSERT(info == GrB_SUCCESS);
+
+	GrB_Matrix_free(&T);
+
+	return info;
+}
+
+GrB_Info RG_Matrix_build_BOOL     // C += (I,J) tuples
+(
+	RG_Matrix C,                  // matrix to modify
+	const GrB_Index *I,           // array of row indices
+	const GrB_Index *J,           // array of column indices
+	GrB_Index nvals               // number of tuples
+) {
+	ASSERT(C != NULL);
+	ASSERT(!RG_MATRIX_MULTI_EDGE(C));
+	ASSERT(nvals == 0 || (I != NULL && J != NULL));
+
+	GrB_Info info = GrB_SUCCESS;
+	if(nvals == 0) return info;
+
+	_RG_Matrix_flush(C);
+
+	info = _RG_Matrix_build_BOOL(C, I, J, nvals);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(RG_MATRIX_MAINTAIN_TRANSPOSE(C)) {
+		info = _RG_Matrix_build_BOOL(C->transposed, J, I, nvals);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	// M might hold pending work, have it completed on the next sync
+	RG_Matrix_setDirty(C);
+
+	return info;
+}
+
+GrB_Info RG_Matrix_build_UINT64   // C += (I,J,X) tuples
+(
+	RG_Matrix C,                  // matrix to modify
+	const GrB_Index *I,           // array of row indices
+	const GrB_Index *J,           // array of column indices
+	const uint64_t *X,            // array of values
+	GrB_Index nvals               // number of tuples
+) {
+	ASSERT(C != NULL);
+	ASSERT(RG_MATRIX_MULTI_EDGE(C));
+	ASSERT(nvals == 0 || (I != NULL && J != NULL && X != NULL));
+
+	GrB_Info info = GrB_SUCCESS;
+	if(nvals == 0) return info;
+
+	_RG_Matrix_flush(C);
+
+	info = _RG_Matrix_build_UINT64(C, I, J, X, nvals);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(RG_MATRIX_MAINTAIN_TRANSPOSE(C)) {
+		info = _RG_Matrix_build_BOOL(C->transposed, J, I, nvals);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	// M might hold pending work, have it completed on the next sync
+	RG_Matrix_setDirty(C);
+
+	return info;
+}
+
@@ -210,6 +210,29 @@ GrB_Info RG_Matrix_setElement_UINT64      // C (i,j) = x
 	GrB_Index j                         // column index
 );
 
+// add a batch of (I,J) tuples to C using a single GraphBLAS build
+// pending changes are flushed prior to merging the batch
+// I and J are expected to be sorted by row then column
+GrB_Info RG_Matrix_build_BOOL     // C += (I,J) tuples
+(
+	RG_Matrix C,                  // matrix to modify
+	const GrB_Index *I,           // array of row indices
+	const GrB_Index *J,           // array of column indices
+	GrB_Index nvals               // number of tuples
+);
+
+// add a batch of (I,J,X) tuples to C using a single GraphBLAS build
+// duplicate tuples and tuples colliding with existing entries
+// are merged into multi-edge entries
+GrB_Info RG_Matrix_build_UINT64   // C += (I,J,X) tuples
+(
+	RG_Matrix C,                  // matrix to modify
+	const GrB_Index *I,           // array of row indices
+	const GrB_Index *J,           // array of column indices
+	const uint64_t *X,            // array of values
+	GrB_Index nvals               // number of tuples
+);
+
 GrB_Info RG_Matrix_extractElement_BOOL     // x = A(i,j)
 (
 	bool *x,                               // extracted scalar
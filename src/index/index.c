@@ -11,6 +11,7 @@
 #include "../query_ctx.h"
 #include "../util/rmalloc.h"
 #include "../datatypes/point.h"
+#include "../configuration/config.h"
 #include "../graph/graphcontext.h"
 #include "../graph/entities/node.h"
 #include "../graph/rg_matrix/rg_matrix_iter.h"
@@ -159,15 +160,24 @@ void IndexField_Free
 // create a new index
 Index *Index_New
 (
-	const char *label,           // indexed label
-	int label_id,                // indexed label id
-	IndexType type,              // exact match or full text
-	GraphEntityType entity_type  // entity type been indexed
+	const char *label,            // indexed label
+	int label_id,                 // indexed label id
+	IndexType type,               // exact match or full text
+	GraphEntityType entity_type,  // entity type been indexed
+	IndexProvider provider        // index backing store
 ) {
 	Index *idx = rm_malloc(sizeof(Index));
 
+	// only exact-match node indices may be backed by a native index
+	if(type != IDX_EXACT_MATCH || entity_type != GETYPE_NODE) {
+		provider = IDX_PROVIDER_REDISEARCH;
+	}
+
 	idx->idx           =  NULL;
 	idx->type          =  type;
+	idx->native        =  NULL;
+	idx->provider      =  provider;
+	idx->composite     =  NULL;
 	idx->label         =  rm_strdup(label);
 	idx->fields        =  array_new(IndexField, 1);
 	idx->label_id      =  label_id;
@@ -178,6 +188,13 @@ Index *Index_New
 	return idx;
 }
 
+IndexProvider Index_ConfiguredProvider(void) {
+	bool native = false;
+	Config_Option_get(Config_NATIVE_INDEX, &native);
+
+	return native ? IDX_PROVIDER_NATIVE : IDX_PROVIDER_REDISEARCH;
+}
+
 // adds field to index
 void Index_AddField
 (
@@ -209,12 +226,64 @@ void Index_RemoveField
 	for(uint i = 0; i < fields_count; i++) {
 		IndexField *field = idx->fields + i;
 		if(field->id == attribute_id) {
-			// free field
+			// free field, keep remaining fields in declaration order
 			IndexField_Free(field);
-			array_del_fast(idx->fields, i);
+			array_del(idx->fields, i);
 			break;
 		}
 	}
+
+	// drop composite key spanning the removed field
+	if(idx->composite == NULL) return;
+	uint composite_len = array_len(idx->composite);
+	for(uint i = 0; i < composite_len; i++) {
+		if(idx->composite[i] == attribute_id) {
+			array_free(idx->composite);
+			idx->composite = NULL;
+			break;
+		}
+	}
+}
+
+bool Index_SetComposite
+(
+	Index *idx,
+	const char **fields,
+	uint n
+) {
+	ASSERT(idx != NULL);
+	ASSERT(fields != NULL || n == 0);
+
+	if(idx->provider != IDX_PROVIDER_NATIVE) return false;
+	if(idx->composite != NULL || n < 2) return false;
+
+	// resolve fields against the index's fields
+	Attribute_ID *composite = array_new(Attribute_ID, n);
+	uint fields_count = array_len(idx->fields);
+	for(uint i = 0; i < n; i++) {
+		Attribute_ID id = ATTRIBUTE_NOTFOUND;
+		for(uint j = 0; j < fields_count; j++) {
+			if(strcmp(idx->fields[j].name, fields[i]) == 0) {
+				id = idx->fields[j].id;
+				break;
+			}
+		}
+
+		// unknown or repeated field
+		bool repeated = false;
+		for(uint j = 0; j < i && !repeated; j++) {
+			repeated = (composite[j] == id);
+		}
+		if(id == ATTRIBUTE_NOTFOUND || repeated) {
+			array_free(composite);
+			return false;
+		}
+
+		array_append(composite, id);
+	}
+
+	idx->composite = composite;
+	return true;
 }
 
 // constructs index
@@ -224,6 +293,21 @@ void Index_Construct
 ) {
 	ASSERT(idx != NULL);
 
+	if(idx->provider == IDX_PROVIDER_NATIVE) {
+		// native index already exists, re-construct
+		if(idx->native) NativeIndex_Free(idx->native);
+		idx->native = NativeIndex_New();
+
+		// composite key, if declared
+		if(idx->composite != NULL) {
+			NativeIndex_SetComposite(idx->native, idx->composite,
+					array_len(idx->composite));
+		}
+
+		populateNodeIndex(idx);
+		return;
+	}
+
 	// RediSearch index already exists, re-construct
 	if(idx->idx) {
 		RediSearch_DropIndex(idx->idx);
@@ -292,6 +376,15 @@ void Index_Construct
 	else populateEdgeIndex(idx);
 }
 
+bool Index_IsNative
+(
+	const Index *idx
+) {
+	ASSERT(idx != NULL);
+
+	return idx->provider == IDX_PROVIDER_NATIVE;
+}
+
 // query index
 RSResultsIterator *Index_Query
 (
@@ -301,6 +394,7 @@ RSResultsIterator *Index_Query
 ) {
 	ASSERT(idx   != NULL);
 	ASSERT(query != NULL);
+	ASSERT(!Index_IsNative(idx));
 
 	return RediSearch_IterateQuery(idx->idx, query, strlen(query), err);
 }
@@ -356,6 +450,8 @@ const char *Index_GetLanguage
 (
 	const Index *idx
 ) {
+	// native indices are language agnostic, report RediSearch's default
+	if(Index_IsNative(idx)) return "english";
 	return RediSearch_IndexGetLanguage(idx->idx);
 }
 
@@ -401,6 +497,8 @@ void Index_Free(Index *idx) {
 	ASSERT(idx != NULL);
 
 	if(idx->idx) RediSearch_DropIndex(idx->idx);
+	if(idx->native) NativeIndex_Free(idx->native);
+	if(idx->composite) array_free(idx->composite);
 
 	if(idx->language) rm_free(idx->language);
 
@@ -9,6 +9,7 @@
 #include "../graph/entities/node.h"
 #include "../graph/entities/edge.h"
 #include "../graph/entities/graph_entity.h"
+#include "native_index.h"
 #include "redisearch_api.h"
 
 #define INDEX_OK 1
@@ -36,6 +37,12 @@ typedef enum {
 	IDX_FULLTEXT     =  2,
 } IndexType;
 
+// index backing store
+typedef enum {
+	IDX_PROVIDER_REDISEARCH  =  0,
+	IDX_PROVIDER_NATIVE      =  1,
+} IndexProvider;
+
 typedef struct {
 	EntityID src_id;
 	EntityID dest_id;
@@ -58,7 +65,10 @@ typedef struct {
 	char **stopwords;             // stopwords
 	GraphEntityType entity_type;  // entity type (node/edge) indexed
 	IndexType type;               // index type exact-match / fulltext
+	IndexProvider provider;       // index backing store
+	Attribute_ID *composite;      // declared composite key, NULL if none
 	RSIndex *idx;                 // rediSearch index
+	NativeIndex *native;          // native index
 } Index;
 
 // create new index field
@@ -77,14 +87,21 @@ void IndexField_Free
 );
 
 // create a new index
+// only exact-match node indices can be backed by a native index
+// any other index is backed by RediSearch regardless of 'provider'
 Index *Index_New
 (
-	const char *label,           // indexed label
-	int label_id,                // indexed label id
-	IndexType type,              // exact match or full text
-	GraphEntityType entity_type  // entity type been indexed
+	const char *label,            // indexed label
+	int label_id,                 // indexed label id
+	IndexType type,               // exact match or full text
+	GraphEntityType entity_type,  // entity type been indexed
+	IndexProvider provider        // index backing store
 );
 
+// returns the backing store of newly created indices
+// as determined by the NATIVE_INDEX configuration
+IndexProvider Index_ConfiguredProvider(void);
+
 // constructs index
 void Index_Construct
 (
@@ -99,12 +116,25 @@ void Index_AddField
 );
 
 // removes field from index
+// a composite key spanning the field is dropped
 void Index_RemoveField
 (
 	Index *idx,
 	const char *field  // field to remove
 );
 
+// declare a composite key over indexed fields, in the given order
+// only native indices hold a composite key, spanning at least 2 fields
+// an index holds a single composite key, later declarations are ignored
+// returns true if the composite key was set, in which case the index
+// must be constructed for it to take effect
+bool Index_SetComposite
+(
+	Index *idx,
+	const char **fields,  // composite key fields, in order
+	uint n                // number of fields
+);
+
 // index node
 void Index_IndexNode
 (
@@ -131,6 +161,12 @@ void Index_RemoveEdge
 	const Edge *e  // edge to remove from index
 );
 
+// returns true if index is backed by a native index
+bool Index_IsNative
+(
+	const Index *idx
+);
+
 // query an index
 RSResultsIterator *Index_Query
 (
@@ -7,6 +7,7 @@
 #include "RG.h"
 #include "index.h"
 #include "../value.h"
+#include "../util/arr.h"
 #include "../query_ctx.h"
 #include "../graph/graphcontext.h"
 #include "../graph/rg_matrix/rg_matrix_iter.h"
@@ -22,6 +23,37 @@ void Index_IndexNode
 	ASSERT(idx  !=  NULL);
 	ASSERT(n    !=  NULL);
 
+	if(Index_IsNative(idx)) {
+		// replace node's entries
+		EntityID id = ENTITY_GET_ID(n);
+		NativeIndex_Remove(idx->native, id);
+
+		uint field_count = array_len(idx->fields);
+		for(uint i = 0; i < field_count; i++) {
+			Attribute_ID attr = idx->fields[i].id;
+			SIValue *v = GraphEntity_GetProperty((const GraphEntity *)n, attr);
+			if(v == PROPERTY_NOTFOUND) continue;
+			NativeIndex_Add(idx->native, id, attr, *v);
+		}
+
+		// composite key, missing attributes are represented by NULLs
+		Attribute_ID *composite = idx->native->composite;
+		if(composite == NULL) return;
+
+		bool indexed = false;
+		uint composite_len = array_len(composite);
+		SIValue values[composite_len];
+		for(uint i = 0; i < composite_len; i++) {
+			SIValue *v = GraphEntity_GetProperty((const GraphEntity *)n,
+					composite[i]);
+			values[i] = (v == PROPERTY_NOTFOUND) ? SI_NullVal() : *v;
+			indexed |= (v != PROPERTY_NOTFOUND);
+		}
+
+		if(indexed) NativeIndex_AddComposite(idx->native, id, values);
+		return;
+	}
+
 	RSIndex   *rsIdx           =  idx->idx;
 	EntityID  key              =  ENTITY_GET_ID(n);
 	size_t    key_len          =  sizeof(EntityID);
@@ -79,6 +111,7 @@ void Index_RemoveNode
 	ASSERT(idx != NULL);
 
 	EntityID id = ENTITY_GET_ID(n);
-	RediSearch_DeleteDocument(idx->idx, &id, sizeof(EntityID));
+	if(Index_IsNative(idx)) NativeIndex_Remove(idx->native, id);
+	else RediSearch_DeleteDocument(idx->idx, &id, sizeof(EntityID));
 }
 
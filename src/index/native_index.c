@@ -0,0 +1,687 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "native_index.h"
+#include "../util/arr.h"
+#include "../util/qsort.h"
+#include "../util/rmalloc.h"
+#include <string.h>
+
+// value type tags, values of different types never compare as equal
+#define TAG_BOOL     0x01
+#define TAG_NUMERIC  0x02
+#define TAG_STRING   0x03
+#define TAG_OTHER    0x04  // values which are not ordered by the index
+#define TAG_MISSING  0x05  // composite key attribute missing
+
+// attribute ID under which composite keys are stored
+#define COMPOSITE_ATTR ATTRIBUTE_NOTFOUND
+
+#define ENTITY_ID_LEN sizeof(EntityID)
+
+// write 'n' as a big-endian integer of 'len' bytes
+static void _WriteBigEndian
+(
+	unsigned char *buf,
+	uint64_t n,
+	uint len
+) {
+	for(int i = len - 1; i >= 0; i--) {
+		buf[i] = n & 0xFF;
+		n >>= 8;
+	}
+}
+
+// append 'n' as a big-endian integer of 'len' bytes
+static sds _AppendBigEndian
+(
+	sds key,
+	uint64_t n,
+	uint len
+) {
+	unsigned char buf[8];
+	_WriteBigEndian(buf, n, len);
+	return sdscatlen(key, buf, len);
+}
+
+// entity IDs are encoded big-endian, such that keys are ordered by ID
+static inline void _EncodeEntityID
+(
+	unsigned char *buf,
+	EntityID id
+) {
+	_WriteBigEndian(buf, id, ENTITY_ID_LEN);
+}
+
+// returns type tag of values of type 't'
+static unsigned char _TypeTag
+(
+	SIType t
+) {
+	switch(t) {
+		case T_BOOL:
+			return TAG_BOOL;
+		case T_INT64:
+		case T_DOUBLE:
+			return TAG_NUMERIC;
+		case T_STRING:
+			return TAG_STRING;
+		default:
+			return TAG_OTHER;
+	}
+}
+
+// returns type tag of value
+static inline unsigned char _ValueTag
+(
+	SIValue v
+) {
+	return _TypeTag(SI_TYPE(v));
+}
+
+// append attribute ID and value type tag
+static sds _EncodePrefix
+(
+	sds key,
+	Attribute_ID attr,
+	unsigned char tag
+) {
+	key = _AppendBigEndian(key, attr, sizeof(Attribute_ID));
+	return sdscatlen(key, &tag, 1);
+}
+
+// append value such that the byte order of encoded values
+// matches the order of the values
+static sds _EncodeValue
+(
+	sds key,
+	SIValue v
+) {
+	unsigned char tag = _ValueTag(v);
+
+	if(tag == TAG_BOOL) {
+		unsigned char b = (v.longval != 0);
+		return sdscatlen(key, &b, 1);
+	}
+
+	if(tag == TAG_NUMERIC) {
+		// integers and floating points share a single order
+		double d = SI_GET_NUMERIC(v);
+		if(d == 0) d = 0; // -0.0 equals 0.0
+
+		// flip the sign bit of positive values and all bits of negative ones
+		uint64_t bits;
+		memcpy(&bits, &d, sizeof(bits));
+		bits = (bits & (1ULL << 63)) ? ~bits : bits | (1ULL << 63);
+		return _AppendBigEndian(key, bits, sizeof(bits));
+	}
+
+	if(tag == TAG_STRING) {
+		// include the terminator, a string precedes its extensions
+		return sdscatlen(key, v.stringval, strlen(v.stringval) + 1);
+	}
+
+	// remaining types are grouped together
+	return key;
+}
+
+// append type tag followed by value
+// NULL values are tagged as missing
+static sds _EncodeTagged
+(
+	sds key,
+	SIValue v
+) {
+	unsigned char tag = (SI_TYPE(v) == T_NULL) ? TAG_MISSING : _ValueTag(v);
+	key = sdscatlen(key, &tag, 1);
+	if(tag == TAG_MISSING) return key;
+	return _EncodeValue(key, v);
+}
+
+// returns the smallest key which is greater than every key
+// prefixed by 'prefix', NULL if there's no such key
+static sds _PrefixSuccessor
+(
+	const sds prefix
+) {
+	sds succ = sdsdup(prefix);
+	size_t len = sdslen(succ);
+
+	while(len > 0) {
+		unsigned char c = succ[len - 1];
+		if(c != 0xFF) {
+			succ[len - 1] = c + 1;
+			sdsrange(succ, 0, len - 1);
+			return succ;
+		}
+		len--;
+	}
+
+	sdsfree(succ);
+	return NULL;
+}
+
+static void _FreeKeys
+(
+	void *keys
+) {
+	sds *_keys = (sds *)keys;
+	uint n = array_len(_keys);
+	for(uint i = 0; i < n; i++) sdsfree(_keys[i]);
+	array_free(_keys);
+}
+
+// returns attribute ID encoded at the beginning of key
+static inline Attribute_ID _KeyAttribute
+(
+	const unsigned char *key
+) {
+	return ((Attribute_ID)key[0] << 8) | key[1];
+}
+
+// update the number of entities holding key's attribute
+static void _UpdateAttributeCount
+(
+	NativeIndex *idx,
+	const sds key,
+	int delta
+) {
+	Attribute_ID attr = _KeyAttribute((const unsigned char *)key);
+	if(attr == COMPOSITE_ATTR) {
+		idx->composite_count += delta;
+		return;
+	}
+
+	while(array_len(idx->attr_counts) <= attr) {
+		array_append(idx->attr_counts, 0);
+	}
+	idx->attr_counts[attr] += delta;
+}
+
+// append entity ID to key and insert it into index
+// index takes ownership of key
+static void _InsertKey
+(
+	NativeIndex *idx,
+	EntityID id,
+	sds key
+) {
+	key = _AppendBigEndian(key, id, ENTITY_ID_LEN);
+
+	if(!raxTryInsert(idx->entries, (unsigned char *)key, sdslen(key), NULL,
+				NULL)) {
+		// entry already exists
+		sdsfree(key);
+		return;
+	}
+
+	idx->version++;
+	_UpdateAttributeCount(idx, key, 1);
+
+	// track key, such that entity can be removed later on
+	unsigned char entity_key[ENTITY_ID_LEN];
+	_EncodeEntityID(entity_key, id);
+
+	sds *keys = raxFind(idx->entities, entity_key, ENTITY_ID_LEN);
+	if(keys == raxNotFound) keys = array_new(sds, 1);
+
+	// array might be reallocated, update entity's entry
+	array_append(keys, key);
+	raxInsert(idx->entities, entity_key, ENTITY_ID_LEN, keys, NULL);
+}
+
+NativeIndex *NativeIndex_New(void) {
+	NativeIndex *idx = rm_malloc(sizeof(NativeIndex));
+
+	idx->entries          =  raxNew();
+	idx->entities         =  raxNew();
+	idx->version          =  0;
+	idx->composite        =  NULL;
+	idx->composite_count  =  0;
+	idx->attr_counts      =  array_new(uint64_t, 0);
+
+	return idx;
+}
+
+void NativeIndex_Add
+(
+	NativeIndex *idx,
+	EntityID id,
+	Attribute_ID attr,
+	SIValue v
+) {
+	ASSERT(idx != NULL);
+	ASSERT(SI_TYPE(v) != T_NULL);
+
+	sds key = sdsempty();
+	key = _EncodePrefix(key, attr, _ValueTag(v));
+	key = _EncodeValue(key, v);
+
+	_InsertKey(idx, id, key);
+}
+
+void NativeIndex_SetComposite
+(
+	NativeIndex *idx,
+	const Attribute_ID *attrs,
+	uint n
+) {
+	ASSERT(idx != NULL);
+	ASSERT(idx->composite == NULL);
+	ASSERT(NativeIndex_EntryCount(idx) == 0);
+
+	// a single attribute is already covered by its own entries
+	if(n < 2) return;
+
+	idx->composite = array_new(Attribute_ID, n);
+	for(uint i = 0; i < n; i++) array_append(idx->composite, attrs[i]);
+}
+
+void NativeIndex_AddComposite
+(
+	NativeIndex *idx,
+	EntityID id,
+	const SIValue *values
+) {
+	ASSERT(idx != NULL);
+	ASSERT(values != NULL);
+	ASSERT(idx->composite != NULL);
+
+	sds key = _AppendBigEndian(sdsempty(), COMPOSITE_ATTR,
+			sizeof(Attribute_ID));
+
+	uint n = array_len(idx->composite);
+	for(uint i = 0; i < n; i++) key = _EncodeTagged(key, values[i]);
+
+	_InsertKey(idx, id, key);
+}
+
+void NativeIndex_Remove
+(
+	NativeIndex *idx,
+	EntityID id
+) {
+	ASSERT(idx != NULL);
+
+	unsigned char entity_key[ENTITY_ID_LEN];
+	_EncodeEntityID(entity_key, id);
+
+	sds *keys;
+	if(!raxRemove(idx->entities, entity_key, ENTITY_ID_LEN, (void **)&keys)) {
+		// entity isn't indexed
+		return;
+	}
+
+	idx->version++;
+
+	uint n = array_len(keys);
+	for(uint i = 0; i < n; i++) {
+		raxRemove(idx->entries, (unsigned char *)keys[i], sdslen(keys[i]),
+				NULL);
+		_UpdateAttributeCount(idx, keys[i], -1);
+	}
+
+	_FreeKeys(keys);
+}
+
+uint64_t NativeIndex_EntryCount
+(
+	const NativeIndex *idx
+) {
+	ASSERT(idx != NULL);
+
+	// composite keys duplicate their entity's attribute entries
+	return raxSize(idx->entries) - idx->composite_count;
+}
+
+uint64_t NativeIndex_AttributeCount
+(
+	const NativeIndex *idx,
+	Attribute_ID attr
+) {
+	ASSERT(idx != NULL);
+
+	if(attr >= array_len(idx->attr_counts)) return 0;
+	return idx->attr_counts[attr];
+}
+
+void NativeIndex_Free
+(
+	NativeIndex *idx
+) {
+	ASSERT(idx != NULL);
+
+	raxFree(idx->entries);
+	array_free(idx->attr_counts);
+	raxFreeWithCallback(idx->entities, _FreeKeys);
+	if(idx->composite != NULL) array_free(idx->composite);
+	rm_free(idx);
+}
+
+//------------------------------------------------------------------------------
+// iterator
+//------------------------------------------------------------------------------
+
+NativeIndexIterator *NativeIndexIterator_New
+(
+	const NativeIndex *idx
+) {
+	ASSERT(idx != NULL);
+
+	NativeIndexIterator *it = rm_malloc(sizeof(NativeIndexIterator));
+
+	it->idx        =  idx;
+	it->version    =  idx->version;
+	it->ranges     =  array_new(NativeIndexRange, 1);
+	it->range_idx  =  0;
+	it->seeked     =  false;
+	it->ordered    =  false;
+	it->prepared   =  false;
+	it->descending =  false;
+
+	raxStart(&it->it, idx->entries);
+
+	return it;
+}
+
+// scan keys composed of 'base' followed by a value within [lo, hi]
+// NULL bounds are unbounded, at least one bound must be specified
+static void _AddValueRange
+(
+	NativeIndexIterator *it,
+	const sds base,
+	const SIValue *lo,
+	const SIValue *hi
+) {
+	ASSERT(lo != NULL || hi != NULL);
+
+	// nothing compares to NULL
+	if(lo != NULL && SI_TYPE(*lo) == T_NULL) return;
+	if(hi != NULL && SI_TYPE(*hi) == T_NULL) return;
+
+	// values of different types are not comparable, range is empty
+	unsigned char tag = (lo != NULL) ? _ValueTag(*lo) : _ValueTag(*hi);
+	if(lo != NULL && hi != NULL && _ValueTag(*hi) != tag) return;
+
+	sds prefix = sdscatlen(sdsdup(base), &tag, 1);
+
+	sds min = sdsdup(prefix);
+	if(lo != NULL) min = _EncodeValue(min, *lo);
+
+	sds max = NULL;
+	if(hi != NULL) {
+		sds upper = _EncodeValue(sdsdup(prefix), *hi);
+		max = _PrefixSuccessor(upper);
+		sdsfree(upper);
+	} else {
+		max = _PrefixSuccessor(prefix);
+	}
+
+	sdsfree(prefix);
+
+	NativeIndexRange range = {.min = min, .max = max};
+	array_append(it->ranges, range);
+}
+
+void NativeIndexIterator_AddEquals
+(
+	NativeIndexIterator *it,
+	Attribute_ID attr,
+	SIValue v
+) {
+	NativeIndexIterator_AddRange(it, attr, &v, &v);
+}
+
+void NativeIndexIterator_AddRange
+(
+	NativeIndexIterator *it,
+	Attribute_ID attr,
+	const SIValue *lo,
+	const SIValue *hi
+) {
+	ASSERT(it != NULL);
+	ASSERT(!it->prepared);
+
+	sds base = _AppendBigEndian(sdsempty(), attr, sizeof(Attribute_ID));
+	_AddValueRange(it, base, lo, hi);
+	sdsfree(base);
+}
+
+void NativeIndexIterator_AddCompositeRange
+(
+	NativeIndexIterator *it,
+	const SIValue *prefix,
+	uint prefix_len,
+	const SIValue *lo,
+	const SIValue *hi
+) {
+	ASSERT(it != NULL);
+	ASSERT(!it->prepared);
+	ASSERT(it->idx->composite != NULL);
+	ASSERT(prefix_len > 0 || lo != NULL || hi != NULL);
+
+	uint n = array_len(it->idx->composite);
+	ASSERT(prefix_len + (lo != NULL || hi != NULL) <= n);
+
+	sds base = _AppendBigEndian(sdsempty(), COMPOSITE_ATTR,
+			sizeof(Attribute_ID));
+
+	for(uint i = 0; i < prefix_len; i++) {
+		// nothing equals NULL
+		if(SI_TYPE(prefix[i]) == T_NULL) {
+			sdsfree(base);
+			return;
+		}
+		base = _EncodeTagged(base, prefix[i]);
+	}
+
+	if(lo == NULL && hi == NULL) {
+		// prefix only, range takes ownership of base
+		NativeIndexRange range = {.min = base, .max = _PrefixSuccessor(base)};
+		array_append(it->ranges, range);
+		return;
+	}
+
+	_AddValueRange(it, base, lo, hi);
+	sdsfree(base);
+}
+
+void NativeIndexIterator_AddAttribute
+(
+	NativeIndexIterator *it,
+	Attribute_ID attr
+) {
+	ASSERT(it != NULL);
+	ASSERT(!it->prepared);
+
+	sds min = _AppendBigEndian(sdsempty(), attr, sizeof(Attribute_ID));
+
+	NativeIndexRange range = {.min = min, .max = _PrefixSuccessor(min)};
+	array_append(it->ranges, range);
+}
+
+void NativeIndexIterator_AddType
+(
+	NativeIndexIterator *it,
+	Attribute_ID attr,
+	SIType t
+) {
+	ASSERT(it != NULL);
+	ASSERT(!it->prepared);
+	ASSERT(t != T_NULL);
+
+	sds min = _EncodePrefix(sdsempty(), attr, _TypeTag(t));
+
+	NativeIndexRange range = {.min = min, .max = _PrefixSuccessor(min)};
+	array_append(it->ranges, range);
+}
+
+void NativeIndexIterator_SetOrder
+(
+	NativeIndexIterator *it,
+	bool descending
+) {
+	ASSERT(it != NULL);
+	ASSERT(!it->prepared);
+
+	it->ordered     =  true;
+	it->descending  =  descending;
+}
+
+// compare a key against a range bound
+static int _CompareKeys
+(
+	const unsigned char *key,
+	size_t key_len,
+	const sds bound
+) {
+	size_t bound_len = sdslen(bound);
+	int res = memcmp(key, bound, MIN(key_len, bound_len));
+	if(res != 0) return res;
+	return (key_len > bound_len) - (key_len < bound_len);
+}
+
+// sort ranges and merge overlapping ones
+// such that each entity is reported at most once
+static void _PrepareRanges
+(
+	NativeIndexIterator *it
+) {
+	NativeIndexRange *ranges = it->ranges;
+	uint n = array_len(ranges);
+	if(n < 2) return;
+
+#define range_lt(a, b) \
+	(_CompareKeys((unsigned char *)(a)->min, sdslen((a)->min), (b)->min) < 0)
+	QSORT(NativeIndexRange, ranges, n, range_lt);
+
+	uint j = 0;
+	for(uint i = 1; i < n; i++) {
+		NativeIndexRange *cur = ranges + j;
+		NativeIndexRange *next = ranges + i;
+
+		bool overlap = (cur->max == NULL ||
+			_CompareKeys((unsigned char *)next->min, sdslen(next->min),
+				cur->max) < 0);
+
+		if(overlap) {
+			// extend current range
+			if(cur->max != NULL && (next->max == NULL ||
+				_CompareKeys((unsigned char *)next->max, sdslen(next->max),
+					cur->max) > 0)) {
+				sdsfree(cur->max);
+				cur->max = next->max;
+				next->max = NULL;
+			}
+			sdsfree(next->min);
+			if(next->max != NULL) sdsfree(next->max);
+		} else {
+			ranges[++j] = *next;
+		}
+	}
+
+	it->ranges = array_trimm_len(it->ranges, j + 1);
+}
+
+bool NativeIndexIterator_Next
+(
+	NativeIndexIterator *it,
+	EntityID *id
+) {
+	ASSERT(it != NULL);
+	ASSERT(id != NULL);
+
+	if(!it->prepared) {
+		// ordered iterators scan ranges as introduced
+		if(!it->ordered) _PrepareRanges(it);
+		it->prepared = true;
+	}
+
+	uint range_count = array_len(it->ranges);
+	while(it->range_idx < range_count) {
+		uint pos = it->descending ? range_count - 1 - it->range_idx :
+			it->range_idx;
+		NativeIndexRange *range = it->ranges + pos;
+
+		if(!it->seeked) {
+			if(!it->descending) {
+				raxSeek(&it->it, ">=", (unsigned char *)range->min,
+						sdslen(range->min));
+			} else if(range->max != NULL) {
+				raxSeek(&it->it, "<", (unsigned char *)range->max,
+						sdslen(range->max));
+			} else {
+				raxSeek(&it->it, "$", NULL, 0);
+			}
+			it->seeked   =  true;
+			it->version  =  it->idx->version;
+		} else if(it->version != it->idx->version) {
+			// index modified since last call, reposition after last key
+			size_t len = it->it.key_len;
+			unsigned char last[len];
+			memcpy(last, it->it.key, len);
+			raxSeek(&it->it, it->descending ? "<" : ">", last, len);
+			it->version = it->idx->version;
+		}
+
+		bool within;
+		if(it->descending) {
+			within = raxPrev(&it->it) &&
+				_CompareKeys(it->it.key, it->it.key_len, range->min) >= 0;
+		} else {
+			within = raxNext(&it->it) &&
+				(range->max == NULL ||
+				 _CompareKeys(it->it.key, it->it.key_len, range->max) < 0);
+		}
+
+		if(within) {
+			// entity ID is encoded at the end of the key
+			ASSERT(it->it.key_len >= ENTITY_ID_LEN);
+			const unsigned char *k = it->it.key + it->it.key_len -
+				ENTITY_ID_LEN;
+			EntityID _id = 0;
+			for(uint i = 0; i < ENTITY_ID_LEN; i++) _id = (_id << 8) | k[i];
+			*id = _id;
+			return true;
+		}
+
+		// range depleted, advance to the next one
+		it->range_idx++;
+		it->seeked = false;
+	}
+
+	return false;
+}
+
+void NativeIndexIterator_Reset
+(
+	NativeIndexIterator *it
+) {
+	ASSERT(it != NULL);
+
+	it->range_idx  =  0;
+	it->seeked     =  false;
+}
+
+void NativeIndexIterator_Free
+(
+	NativeIndexIterator *it
+) {
+	ASSERT(it != NULL);
+
+	raxStop(&it->it);
+
+	uint n = array_len(it->ranges);
+	for(uint i = 0; i < n; i++) {
+		sdsfree(it->ranges[i].min);
+		if(it->ranges[i].max != NULL) sdsfree(it->ranges[i].max);
+	}
+	array_free(it->ranges);
+
+	rm_free(it);
+}
+
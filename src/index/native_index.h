@@ -0,0 +1,198 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "rax.h"
+#include "../value.h"
+#include "../util/sds/sds.h"
+#include "../graph/entities/graph_entity.h"
+
+// native exact-match index
+// an ordered radix tree whose keys are composed of:
+// attribute ID, type tagged value and entity ID
+// all entities sharing an attribute value are stored consecutively
+// ordered by their ID, such that a lookup yields a sorted run of IDs
+//
+// an index over multiple attributes additionally holds a composite key
+// per entity, made of all attribute values in order, such that equality
+// on a leftmost prefix of the attributes followed by a range over the
+// next attribute is resolved by a single seek
+typedef struct {
+	rax *entries;             // ordered (attribute, value, entity ID) keys
+	rax *entities;            // entity ID to its keys within 'entries'
+	uint64_t version;         // incremented on every modification
+	Attribute_ID *composite;  // composite key attributes, NULL if none
+	uint64_t composite_count; // number of composite keys within 'entries'
+	uint64_t *attr_counts;    // number of entities holding each attribute
+} NativeIndex;
+
+// range of keys to scan, [min, max)
+typedef struct {
+	sds min;  // inclusive lower bound
+	sds max;  // exclusive upper bound, NULL if unbounded
+} NativeIndexRange;
+
+// iterator over a set of key ranges
+// the iterator tolerates index modifications in between calls to Next
+// in which case it repositions itself right after the last reported key
+//
+// an ordered iterator scans its ranges in the order they were introduced
+// rather than by key, and reports keys in descending order if requested
+typedef struct {
+	const NativeIndex *idx;    // iterated index
+	raxIterator it;            // current position
+	uint64_t version;          // index version at last reposition
+	NativeIndexRange *ranges;  // ranges to scan
+	uint range_idx;            // current range
+	bool seeked;               // current range been seeked
+	bool prepared;             // ranges been sorted and merged
+	bool ordered;              // scan ranges in the order they were added
+	bool descending;           // scan ranges and keys in descending order
+} NativeIndexIterator;
+
+// create a new native index
+NativeIndex *NativeIndex_New(void);
+
+// add entity's attribute value to index
+void NativeIndex_Add
+(
+	NativeIndex *idx,   // index to update
+	EntityID id,        // entity ID
+	Attribute_ID attr,  // attribute ID
+	SIValue v           // attribute value
+);
+
+// set composite key attributes, in order
+// must be called while the index is empty, ignored for a single attribute
+void NativeIndex_SetComposite
+(
+	NativeIndex *idx,           // index to update
+	const Attribute_ID *attrs,  // composite key attributes
+	uint n                      // number of attributes
+);
+
+// add entity's composite key to index
+// 'values' is aligned with the composite attributes
+// missing attributes are represented by NULL values
+void NativeIndex_AddComposite
+(
+	NativeIndex *idx,       // index to update
+	EntityID id,            // entity ID
+	const SIValue *values   // composite attributes values
+);
+
+// remove all of entity's entries from index
+void NativeIndex_Remove
+(
+	NativeIndex *idx,  // index to update
+	EntityID id        // entity ID
+);
+
+// returns number of entries in index, composite keys excluded
+uint64_t NativeIndex_EntryCount
+(
+	const NativeIndex *idx
+);
+
+// returns number of entities holding attribute
+uint64_t NativeIndex_AttributeCount
+(
+	const NativeIndex *idx,
+	Attribute_ID attr
+);
+
+// free native index
+void NativeIndex_Free
+(
+	NativeIndex *idx
+);
+
+// create a new iterator over index
+// the iterator yields nothing until ranges are introduced
+NativeIndexIterator *NativeIndexIterator_New
+(
+	const NativeIndex *idx
+);
+
+// scan entities whose attribute equals 'v'
+void NativeIndexIterator_AddEquals
+(
+	NativeIndexIterator *it,  // iterator
+	Attribute_ID attr,        // attribute ID
+	SIValue v                 // value to match
+);
+
+// scan entities whose attribute is within [lo, hi]
+// NULL bounds are unbounded, at least one bound must be specified
+// values are only compared against values of the same type
+void NativeIndexIterator_AddRange
+(
+	NativeIndexIterator *it,  // iterator
+	Attribute_ID attr,        // attribute ID
+	const SIValue *lo,        // [optional] lower bound
+	const SIValue *hi         // [optional] upper bound
+);
+
+// scan entities whose leading composite attributes equal 'prefix'
+// and whose following composite attribute is within [lo, hi]
+// NULL bounds are unbounded, if both are NULL only the prefix is matched
+void NativeIndexIterator_AddCompositeRange
+(
+	NativeIndexIterator *it,  // iterator
+	const SIValue *prefix,    // values of leading composite attributes
+	uint prefix_len,          // number of prefix values
+	const SIValue *lo,        // [optional] lower bound
+	const SIValue *hi         // [optional] upper bound
+);
+
+// scan entities holding attribute, regardless of its value
+void NativeIndexIterator_AddAttribute
+(
+	NativeIndexIterator *it,  // iterator
+	Attribute_ID attr         // attribute ID
+);
+
+// scan entities whose attribute is of type 't'
+// integers and floating points are scanned together, ordered by value
+// values of types other than numerics, booleans and strings
+// are scanned together and are not ordered by value
+void NativeIndexIterator_AddType
+(
+	NativeIndexIterator *it,  // iterator
+	Attribute_ID attr,        // attribute ID
+	SIType t                  // value type
+);
+
+// scan ranges in the order they were introduced
+// ranges are expected to be disjoint
+// if 'descending' is set, ranges are scanned last to first
+// each from its last key to its first
+void NativeIndexIterator_SetOrder
+(
+	NativeIndexIterator *it,  // iterator
+	bool descending           // scan in descending order
+);
+
+// advance iterator, returns false once depleted
+bool NativeIndexIterator_Next
+(
+	NativeIndexIterator *it,  // iterator
+	EntityID *id              // [output] entity ID
+);
+
+// restart iteration from the first range
+void NativeIndexIterator_Reset
+(
+	NativeIndexIterator *it
+);
+
+// free iterator
+void NativeIndexIterator_Free
+(
+	NativeIndexIterator *it
+);
+
@@ -0,0 +1,195 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include <stdio.h>
+#include <ctype.h>
+#include <string.h>
+
+#include "./op_metrics.h"
+#include "../RG.h"
+#include "../util/reply.h"
+#include "../util/rmalloc.h"
+#include "../execution_plan/ops/op.h"
+
+// number of operation types
+#define OP_TYPE_COUNT (OPType_OPTIONAL + 1)
+
+#define LOAD(x) __atomic_load_n(&(x), __ATOMIC_RELAXED)
+#define ADD(x, v) __atomic_add_fetch(&(x), (v), __ATOMIC_RELAXED)
+
+// accumulated statistics of a single operation type
+typedef struct {
+	const char *name;      // operation name
+	uint64_t count;        // number of sampled operations
+	uint64_t records_in;   // number of records consumed from child operations
+	uint64_t records_out;  // number of records produced
+	uint64_t time_us;      // execution time in microseconds, excluding children
+} OpMetric;
+
+struct OpMetrics {
+	uint64_t executions;          // number of query executions
+	uint64_t sampled;             // number of sampled query executions
+	OpMetric ops[OP_TYPE_COUNT];  // statistics of each operation type
+};
+
+// returns the name of an operation type, NULL if it was never sampled
+static inline const char *_OpMetric_Name(const OpMetric *m) {
+	// name is published before the first count update
+	if(__atomic_load_n(&m->count, __ATOMIC_ACQUIRE) == 0) return NULL;
+	return m->name;
+}
+
+static void _OpMetric_Add
+(
+	OpMetric *m,
+	const char *name,
+	uint64_t count,
+	uint64_t records_in,
+	uint64_t records_out,
+	uint64_t time_us
+) {
+	ADD(m->records_in, records_in);
+	ADD(m->records_out, records_out);
+	ADD(m->time_us, time_us);
+
+	// operation names are static strings, racing writers store the same value
+	if(LOAD(m->name) == NULL) __atomic_store_n(&m->name, name, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&m->count, count, __ATOMIC_RELEASE);
+}
+
+OpMetrics *OpMetrics_New(void) {
+	return rm_calloc(1, sizeof(OpMetrics));
+}
+
+bool OpMetrics_Sample
+(
+	OpMetrics *metrics
+) {
+	ASSERT(metrics != NULL);
+
+	uint64_t n = ADD(metrics->executions, 1);
+	if(n % OP_METRICS_SAMPLE_RATE != 0) return false;
+
+	ADD(metrics->sampled, 1);
+	return true;
+}
+
+void OpMetrics_Collect
+(
+	OpMetrics *metrics,
+	const OpBase *root
+) {
+	ASSERT(root != NULL);
+	ASSERT(metrics != NULL);
+	ASSERT(root->stats != NULL);
+
+	uint64_t records_in = 0;
+	for(int i = 0; i < root->childCount; i++) {
+		const OpBase *child = root->children[i];
+		records_in += child->stats->profileRecordCount;
+		OpMetrics_Collect(metrics, child);
+	}
+
+	// profiled execution time is in milliseconds, excluding children time
+	// which might leave a slightly negative value due to rounding
+	double time_ms = root->stats->profileExecTime;
+	uint64_t time_us = (time_ms > 0) ? time_ms * 1000 : 0;
+	_OpMetric_Add(metrics->ops + root->type, root->name, 1, records_in,
+			root->stats->profileRecordCount, time_us);
+}
+
+void OpMetrics_Merge
+(
+	OpMetrics *dest,
+	const OpMetrics *src
+) {
+	ASSERT(src != NULL);
+	ASSERT(dest != NULL);
+
+	ADD(dest->executions, LOAD(src->executions));
+	ADD(dest->sampled, LOAD(src->sampled));
+
+	for(int i = 0; i < OP_TYPE_COUNT; i++) {
+		const OpMetric *m = src->ops + i;
+		const char *name = _OpMetric_Name(m);
+		if(name == NULL) continue;
+
+		_OpMetric_Add(dest->ops + i, name, LOAD(m->count), LOAD(m->records_in),
+				LOAD(m->records_out), LOAD(m->time_us));
+	}
+}
+
+void OpMetrics_Replay
+(
+	const OpMetrics *metrics,
+	RedisModuleCtx *ctx
+) {
+	ASSERT(ctx != NULL);
+	ASSERT(metrics != NULL);
+
+	uint n = 0;
+	RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
+
+	for(int i = 0; i < OP_TYPE_COUNT; i++) {
+		const OpMetric *m = metrics->ops + i;
+		const char *name = _OpMetric_Name(m);
+		if(name == NULL) continue;
+
+		RedisModule_ReplyWithArray(ctx, 5);
+		RedisModule_ReplyWithStringBuffer(ctx, name, strlen(name));
+		RedisModule_ReplyWithLongLong(ctx, LOAD(m->count));
+		RedisModule_ReplyWithLongLong(ctx, LOAD(m->records_in));
+		RedisModule_ReplyWithLongLong(ctx, LOAD(m->records_out));
+		Reply_WithRoundedDouble(ctx, LOAD(m->time_us) / 1000.0);
+		n++;
+	}
+
+	RedisModule_ReplySetArrayLength(ctx, n);
+}
+
+void OpMetrics_Info
+(
+	const OpMetrics *metrics,
+	RedisModuleInfoCtx *ctx
+) {
+	ASSERT(ctx != NULL);
+	ASSERT(metrics != NULL);
+
+	RedisModule_InfoAddFieldULongLong(ctx, "executions",
+			LOAD(metrics->executions));
+	RedisModule_InfoAddFieldULongLong(ctx, "sampled_executions",
+			LOAD(metrics->sampled));
+
+	for(int i = 0; i < OP_TYPE_COUNT; i++) {
+		const OpMetric *m = metrics->ops + i;
+		const char *name = _OpMetric_Name(m);
+		if(name == NULL) continue;
+
+		// field names can't contain spaces, "Node By Label Scan" is reported
+		// as "op_node_by_label_scan"
+		char field[128];
+		int len = snprintf(field, sizeof(field), "op_%s", name);
+		for(int j = 0; j < len && field[j] != '\0'; j++) {
+			field[j] = (field[j] == ' ') ? '_' : tolower(field[j]);
+		}
+
+		RedisModule_InfoBeginDictField(ctx, field);
+		RedisModule_InfoAddFieldULongLong(ctx, "count", LOAD(m->count));
+		RedisModule_InfoAddFieldULongLong(ctx, "records_in", LOAD(m->records_in));
+		RedisModule_InfoAddFieldULongLong(ctx, "records_out", LOAD(m->records_out));
+		RedisModule_InfoAddFieldDouble(ctx, "time_ms", LOAD(m->time_us) / 1000.0);
+		RedisModule_InfoEndDictField(ctx);
+	}
+}
+
+void OpMetrics_Free
+(
+	OpMetrics *metrics
+) {
+	ASSERT(metrics != NULL);
+	rm_free(metrics);
+}
+
@@ -0,0 +1,66 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../redismodule.h"
+
+// one out of every OP_METRICS_SAMPLE_RATE query executions is profiled
+// and its per-operation statistics are accumulated
+#define OP_METRICS_SAMPLE_RATE 16
+
+// per operation type statistics gathered from sampled executions
+// metrics are updated and read concurrently using atomic operations
+typedef struct OpMetrics OpMetrics;
+
+struct OpBase;
+
+// create a new op metrics
+OpMetrics *OpMetrics_New(void);
+
+// count a query execution, returns true if the execution should be sampled
+bool OpMetrics_Sample
+(
+	OpMetrics *metrics  // metrics to update
+);
+
+// accumulate statistics of a profiled execution plan
+void OpMetrics_Collect
+(
+	OpMetrics *metrics,        // metrics to update
+	const struct OpBase *root  // root of a profiled plan which finished executing
+);
+
+// add the statistics of 'src' to 'dest'
+void OpMetrics_Merge
+(
+	OpMetrics *dest,      // metrics to update
+	const OpMetrics *src  // metrics to add
+);
+
+// replies with op metrics content
+void OpMetrics_Replay
+(
+	const OpMetrics *metrics,
+	RedisModuleCtx *ctx
+);
+
+// adds op metrics content to an INFO section
+void OpMetrics_Info
+(
+	const OpMetrics *metrics,
+	RedisModuleInfoCtx *ctx
+);
+
+// free op metrics
+void OpMetrics_Free
+(
+	OpMetrics *metrics
+);
+
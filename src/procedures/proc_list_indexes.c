@@ -182,7 +182,13 @@ static bool _EmitIndex
 		rm_free(stopwords);
 	}
 
-	if(ctx->yield_info) {
+	if(ctx->yield_info && Index_IsNative(idx)) {
+		SIValue map = SI_Map(2);
+		Map_Add(&map, SI_ConstStringVal("provider"), SI_ConstStringVal("native"));
+		Map_Add(&map, SI_ConstStringVal("numRecords"),
+				SI_LongVal(NativeIndex_EntryCount(idx->native)));
+		*ctx->yield_info = map;
+	} else if(ctx->yield_info) {
 		RSIdxInfo info = { .version = RS_INFO_CURRENT_VERSION };
 		
 		RediSearch_IndexInfo(idx->idx, &info);
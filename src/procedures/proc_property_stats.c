@@ -0,0 +1,334 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_property_stats.h"
+#include "RG.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../schema/schema.h"
+#include "../datatypes/array.h"
+#include "../graph/graphcontext.h"
+
+// CALL db.propertyStats()
+// CALL db.propertyStats.rebuild()
+
+typedef struct {
+	SIValue *out;                   // outputs
+	uint schema_id;                 // current node schema ID
+	uint stats_idx;                 // current attribute statistics index
+	GraphContext *gc;               // graph context
+	SIValue *yield_label;           // yield label
+	SIValue *yield_property;        // yield property
+	SIValue *yield_count;           // yield number of entities holding property
+	SIValue *yield_null_fraction;   // yield fraction of entities missing property
+	SIValue *yield_distinct;        // yield estimated distinct values count
+	SIValue *yield_min;             // yield minimum value
+	SIValue *yield_max;             // yield maximum value
+	SIValue *yield_histogram;       // yield histogram buckets upper bounds
+} PropertyStatsContext;
+
+static void _process_yield
+(
+	PropertyStatsContext *ctx,
+	const char **yield
+) {
+	ctx->yield_label          =  NULL;
+	ctx->yield_property       =  NULL;
+	ctx->yield_count          =  NULL;
+	ctx->yield_null_fraction  =  NULL;
+	ctx->yield_distinct       =  NULL;
+	ctx->yield_min            =  NULL;
+	ctx->yield_max            =  NULL;
+	ctx->yield_histogram      =  NULL;
+
+	int idx = 0;
+	for(uint i = 0; i < array_len(yield); i++) {
+		if(strcasecmp("label", yield[i]) == 0) {
+			ctx->yield_label = ctx->out + idx;
+			idx++;
+			continue;
+		}
+
+		if(strcasecmp("property", yield[i]) == 0) {
+			ctx->yield_property = ctx->out + idx;
+			idx++;
+			continue;
+		}
+
+		if(strcasecmp("count", yield[i]) == 0) {
+			ctx->yield_count = ctx->out + idx;
+			idx++;
+			continue;
+		}
+
+		if(strcasecmp("nullFraction", yield[i]) == 0) {
+			ctx->yield_null_fraction = ctx->out + idx;
+			idx++;
+			continue;
+		}
+
+		if(strcasecmp("distinct", yield[i]) == 0) {
+			ctx->yield_distinct = ctx->out + idx;
+			idx++;
+			continue;
+		}
+
+		if(strcasecmp("min", yield[i]) == 0) {
+			ctx->yield_min = ctx->out + idx;
+			idx++;
+			continue;
+		}
+
+		if(strcasecmp("max", yield[i]) == 0) {
+			ctx->yield_max = ctx->out + idx;
+			idx++;
+			continue;
+		}
+
+		if(strcasecmp("histogram", yield[i]) == 0) {
+			ctx->yield_histogram = ctx->out + idx;
+			idx++;
+			continue;
+		}
+	}
+}
+
+ProcedureResult Proc_PropertyStatsInvoke
+(
+	ProcedureCtx *ctx,
+	const SIValue *args,
+	const char **yield
+) {
+	ASSERT(ctx   != NULL);
+	ASSERT(args  != NULL);
+	ASSERT(yield != NULL);
+
+	if(array_len((SIValue *)args) != 0) return PROCEDURE_ERR;
+
+	PropertyStatsContext *pdata = rm_malloc(sizeof(PropertyStatsContext));
+
+	pdata->gc         =  QueryCtx_GetGraphCtx();
+	pdata->out        =  array_new(SIValue, 8);
+	pdata->schema_id  =  0;
+	pdata->stats_idx  =  0;
+
+	_process_yield(pdata, yield);
+
+	ctx->privateData = pdata;
+	return PROCEDURE_OK;
+}
+
+static void _EmitStats
+(
+	PropertyStatsContext *ctx,
+	const Schema *s,
+	const AttributeStats *stats
+) {
+	if(ctx->yield_label) {
+		*ctx->yield_label = SI_ConstStringVal((char *)Schema_GetName(s));
+	}
+
+	if(ctx->yield_property) {
+		const char *attr = GraphContext_GetAttributeString(ctx->gc, stats->id);
+		*ctx->yield_property = SI_ConstStringVal((char *)attr);
+	}
+
+	if(ctx->yield_count) {
+		*ctx->yield_count = SI_LongVal(stats->count);
+	}
+
+	if(ctx->yield_null_fraction) {
+		// fraction of labeled nodes missing the attribute
+		double null_fraction = 0;
+		uint64_t node_count = Graph_LabeledNodeCount(ctx->gc->g, s->id);
+		if(node_count > stats->count) {
+			null_fraction = (double)(node_count - stats->count) / node_count;
+		}
+		*ctx->yield_null_fraction = SI_DoubleVal(null_fraction);
+	}
+
+	if(ctx->yield_distinct) {
+		*ctx->yield_distinct = SI_LongVal(AttributeStats_DistinctCount(stats));
+	}
+
+	if(ctx->yield_min) {
+		*ctx->yield_min = SI_ConstValue(&stats->min);
+	}
+
+	if(ctx->yield_max) {
+		*ctx->yield_max = SI_ConstValue(&stats->max);
+	}
+
+	if(ctx->yield_histogram) {
+		if(stats->bounds == NULL) {
+			// histogram is computed on rebuild
+			*ctx->yield_histogram = SI_NullVal();
+		} else {
+			uint bucket_count = array_len(stats->bounds);
+			*ctx->yield_histogram = SI_Array(bucket_count);
+			for(uint i = 0; i < bucket_count; i++) {
+				SIArray_Append(ctx->yield_histogram, stats->bounds[i]);
+			}
+		}
+	}
+}
+
+SIValue *Proc_PropertyStatsStep
+(
+	ProcedureCtx *ctx
+) {
+	ASSERT(ctx->privateData != NULL);
+
+	PropertyStatsContext *pdata = (PropertyStatsContext *)ctx->privateData;
+	uint schema_count = GraphContext_SchemaCount(pdata->gc, SCHEMA_NODE);
+
+	while(pdata->schema_id < schema_count) {
+		Schema *s = GraphContext_GetSchemaByID(pdata->gc, pdata->schema_id,
+				SCHEMA_NODE);
+
+		// advance to next schema once all attributes have been emitted
+		if(pdata->stats_idx >= Schema_AttributeStatsCount(s)) {
+			pdata->schema_id++;
+			pdata->stats_idx = 0;
+			continue;
+		}
+
+		const AttributeStats *stats =
+			Schema_GetAttributeStatsByIdx(s, pdata->stats_idx++);
+		_EmitStats(pdata, s, stats);
+		return pdata->out;
+	}
+
+	return NULL;
+}
+
+ProcedureResult Proc_PropertyStatsFree
+(
+	ProcedureCtx *ctx
+) {
+	// clean up
+	if(ctx->privateData) {
+		PropertyStatsContext *pdata = ctx->privateData;
+		array_free(pdata->out);
+		rm_free(pdata);
+	}
+
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_PropertyStatsCtx() {
+	void *privateData = NULL;
+	ProcedureOutput output;
+	ProcedureOutput *outputs = array_new(ProcedureOutput, 8);
+
+	// label
+	output = (ProcedureOutput) {
+		.name = "label", .type = T_STRING
+	};
+	array_append(outputs, output);
+
+	// property name
+	output = (ProcedureOutput) {
+		.name = "property", .type = T_STRING
+	};
+	array_append(outputs, output);
+
+	// number of nodes holding property
+	output = (ProcedureOutput) {
+		.name = "count", .type = T_INT64
+	};
+	array_append(outputs, output);
+
+	// fraction of labeled nodes missing property
+	output = (ProcedureOutput) {
+		.name = "nullFraction", .type = T_DOUBLE
+	};
+	array_append(outputs, output);
+
+	// estimated number of distinct values
+	output = (ProcedureOutput) {
+		.name = "distinct", .type = T_INT64
+	};
+	array_append(outputs, output);
+
+	// minimum value
+	output = (ProcedureOutput) {
+		.name = "min", .type = SI_VALID_PROPERTY_VALUE
+	};
+	array_append(outputs, output);
+
+	// maximum value
+	output = (ProcedureOutput) {
+		.name = "max", .type = SI_VALID_PROPERTY_VALUE
+	};
+	array_append(outputs, output);
+
+	// equi-depth histogram buckets upper bounds
+	output = (ProcedureOutput) {
+		.name = "histogram", .type = T_ARRAY | T_NULL
+	};
+	array_append(outputs, output);
+
+	ProcedureCtx *ctx = ProcCtxNew("db.propertyStats",
+								   0,
+								   outputs,
+								   Proc_PropertyStatsStep,
+								   Proc_PropertyStatsInvoke,
+								   Proc_PropertyStatsFree,
+								   privateData,
+								   true);
+	return ctx;
+}
+
+//------------------------------------------------------------------------------
+// rebuild
+//------------------------------------------------------------------------------
+
+ProcedureResult Proc_PropertyStatsRebuildInvoke
+(
+	ProcedureCtx *ctx,
+	const SIValue *args,
+	const char **yield
+) {
+	if(array_len((SIValue *)args) != 0) return PROCEDURE_ERR;
+
+	// invoked while holding the graph's write lock
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	GraphContext_RebuildAttributeStats(gc);
+
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_PropertyStatsRebuildStep
+(
+	ProcedureCtx *ctx
+) {
+	return NULL;
+}
+
+ProcedureResult Proc_PropertyStatsRebuildFree
+(
+	ProcedureCtx *ctx
+) {
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_PropertyStatsRebuildCtx() {
+	void *privateData = NULL;
+	ProcedureOutput *outputs = array_new(ProcedureOutput, 0);
+	ProcedureCtx *ctx = ProcCtxNew("db.propertyStats.rebuild",
+								   0,
+								   outputs,
+								   Proc_PropertyStatsRebuildStep,
+								   Proc_PropertyStatsRebuildInvoke,
+								   Proc_PropertyStatsRebuildFree,
+								   privateData,
+								   false);
+	return ctx;
+}
+
@@ -0,0 +1,15 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "proc_ctx.h"
+
+// lists attribute statistics of every label
+ProcedureCtx *Proc_PropertyStatsCtx();
+
+// recomputes attribute statistics of every label
+ProcedureCtx *Proc_PropertyStatsRebuildCtx();
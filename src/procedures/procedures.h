@@ -13,6 +13,7 @@
 #include "proc_procedures.h"
 #include "proc_list_indexes.h"
 #include "proc_property_keys.h"
+#include "proc_property_stats.h"
 #include "proc_fulltext_query.h"
 #include "proc_fulltext_drop_index.h"
 #include "proc_fulltext_create_index.h"
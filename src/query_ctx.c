@@ -8,6 +8,7 @@
 #include "RG.h"
 #include "errors.h"
 #include "util/simple_timer.h"
+#include "configuration/config.h"
 #include "arithmetic/arithmetic_expression.h"
 #include "serializers/graphcontext_type.h"
 
@@ -16,6 +17,9 @@ extern RedisModuleType *GraphContextRedisModuleType;
 
 pthread_key_t _tlsQueryCtxKey;  // Thread local storage query context key.
 
+// size of the query's arena chunks
+#define QUERY_ARENA_CHUNK_SIZE 16384
+
 // retrieve or instantiate new QueryCtx
 static inline QueryCtx *_QueryCtx_GetCreateCtx(void) {
 	QueryCtx *ctx = pthread_getspecific(_tlsQueryCtxKey);
@@ -57,6 +61,39 @@ inline void QueryCtx_RemoveFromTLS() {
 void QueryCtx_BeginTimer(void) {
 	QueryCtx *ctx = _QueryCtx_GetCreateCtx(); // Attempt to retrieve the QueryCtx.
 	simple_tic(ctx->internal_exec_ctx.timer); // Start the execution timer.
+
+	// query execution begins with parsing
+	memset(ctx->internal_exec_ctx.stage_time, 0,
+			sizeof(ctx->internal_exec_ctx.stage_time));
+	ctx->internal_exec_ctx.stage = QueryStage_PARSING;
+	simple_tic(ctx->internal_exec_ctx.stage_timer);
+}
+
+void QueryCtx_AdvanceStage(QueryStage stage) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	ASSERT(ctx != NULL);
+	QueryCtx_InternalExecCtx *exec_ctx = &ctx->internal_exec_ctx;
+
+	if(exec_ctx->stage != QueryStage_DONE) {
+		exec_ctx->stage_time[exec_ctx->stage] +=
+			simple_toc(exec_ctx->stage_timer) * 1000;
+	}
+
+	exec_ctx->stage = stage;
+	simple_tic(exec_ctx->stage_timer);
+}
+
+void QueryCtx_SetStageTime(QueryStage stage, double ms) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	ASSERT(ctx != NULL);
+	ASSERT(stage < QUERY_STAGE_COUNT);
+	ctx->internal_exec_ctx.stage_time[stage] = ms;
+}
+
+const double *QueryCtx_GetStageTimes(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	ASSERT(ctx != NULL);
+	return ctx->internal_exec_ctx.stage_time;
 }
 
 void QueryCtx_SetGlobalExecutionCtx(CommandCtx *cmd_ctx) {
@@ -136,6 +173,31 @@ ResultSetStatistics *QueryCtx_GetResultSetStatistics(void) {
 	return stats;
 }
 
+EffectsBuffer *QueryCtx_GetEffectsBuffer(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	if(!ctx) return NULL;
+	return ctx->internal_exec_ctx.effects;
+}
+
+Arena *QueryCtx_GetArena(void) {
+	QueryCtx *ctx = _QueryCtx_GetCreateCtx();
+	if(ctx->internal_exec_ctx.arena == NULL) {
+		ctx->internal_exec_ctx.arena = Arena_New(QUERY_ARENA_CHUNK_SIZE);
+	}
+	return ctx->internal_exec_ctx.arena;
+}
+
+void QueryCtx_SetTimedOut(QueryCtx *ctx) {
+	ASSERT(ctx != NULL);
+	__atomic_store_n(&ctx->internal_exec_ctx.timed_out, true, __ATOMIC_RELEASE);
+}
+
+bool QueryCtx_TimedOut(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	if(!ctx) return false;
+	return __atomic_load_n(&ctx->internal_exec_ctx.timed_out, __ATOMIC_ACQUIRE);
+}
+
 void QueryCtx_PrintQuery(void) {
 	QueryCtx *ctx = _QueryCtx_GetCreateCtx();
 	printf("%s\n", ctx->query_data.query);
@@ -179,6 +241,13 @@ bool QueryCtx_LockForCommit(void) {
 	Graph_AcquireWriteLock(gc->g);
 	ctx->internal_exec_ctx.locked_for_commit = true;
 
+	// collect effects if write queries are replicated by their effects
+	bool effects_replication;
+	Config_Option_get(Config_EFFECTS_REPLICATION, &effects_replication);
+	if(effects_replication && ctx->internal_exec_ctx.effects == NULL) {
+		ctx->internal_exec_ctx.effects = EffectsBuffer_New(gc);
+	}
+
 	return true;
 
 clean_up:
@@ -196,12 +265,23 @@ static void _QueryCtx_UnlockCommit(QueryCtx *ctx) {
 	GraphContext *gc = ctx->gc;
 	RedisModuleCtx *redis_ctx = ctx->global_exec_ctx.redis_ctx;
 
+	EffectsBuffer *effects = ctx->internal_exec_ctx.effects;
+
 	if(ResultSetStat_IndicateModification(ctx->internal_exec_ctx.result_set->stats)) {
 		// Replicate only in case of changes.
-		RedisModule_Replicate(redis_ctx, ctx->global_exec_ctx.command_name, "cc!", gc->graph_name,
-							  ctx->query_data.query);
+		if(effects != NULL && EffectsBuffer_Complete(effects)) {
+			// replicate the query's effects rather than the query itself
+			RedisModule_Replicate(redis_ctx, "GRAPH.EFFECT", "cb!", gc->graph_name,
+								  EffectsBuffer_Data(effects), EffectsBuffer_Length(effects));
+		} else {
+			RedisModule_Replicate(redis_ctx, ctx->global_exec_ctx.command_name, "cc!", gc->graph_name,
+								  ctx->query_data.query);
+		}
 	}
 
+	EffectsBuffer_Free(effects);
+	ctx->internal_exec_ctx.effects = NULL;
+
 	ctx->internal_exec_ctx.locked_for_commit = false;
 	// Release graph R/W lock.
 	Graph_ReleaseLock(gc->g);
@@ -256,6 +336,21 @@ void QueryCtx_Free(void) {
 		ctx->query_data.params = NULL;
 	}
 
+	if(ctx->query_data.query_normalized) {
+		rm_free(ctx->query_data.query_normalized);
+		ctx->query_data.query_normalized = NULL;
+	}
+
+	if(ctx->internal_exec_ctx.effects) {
+		EffectsBuffer_Free(ctx->internal_exec_ctx.effects);
+		ctx->internal_exec_ctx.effects = NULL;
+	}
+
+	if(ctx->internal_exec_ctx.arena) {
+		Arena_Free(ctx->internal_exec_ctx.arena);
+		ctx->internal_exec_ctx.arena = NULL;
+	}
+
 	rm_free(ctx);
 	// NULL-set the context for reuse the next time this thread receives a query
 	QueryCtx_RemoveFromTLS();
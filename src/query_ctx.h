@@ -8,8 +8,10 @@
 
 #include "ast/ast.h"
 #include "redismodule.h"
+#include "util/arena.h"
 #include "util/rmalloc.h"
 #include "graph/graphcontext.h"
+#include "effects/effects.h"
 #include "commands/cmd_context.h"
 #include "resultset/resultset.h"
 #include "execution_plan/ops/op.h"
@@ -22,6 +24,7 @@ typedef struct {
 	rax *params;                  // Query parameters.
 	const char *query;            // Query string.
 	const char *query_no_params;  // Query string without parameters part.
+	char *query_normalized;       // Query string with literals replaced by parameters.
 } QueryCtx_QueryData;
 
 typedef struct {
@@ -30,6 +33,12 @@ typedef struct {
 	ResultSet *result_set;      // Save the execution result set.
 	bool locked_for_commit;     // Indicates if a call for QueryCtx_LockForCommit issued before.
 	OpBase *last_writer;        // The last writer operation which indicates the need for commit.
+	EffectsBuffer *effects;     // Effects of the query, replicated in place of the query.
+	Arena *arena;               // Arena holding intermediate values produced during execution.
+	bool timed_out;             // Set once the query exceeded its timeout.
+	QueryStage stage;           // Current query stage.
+	double stage_timer[2];      // Current query stage time tracking.
+	double stage_time[QUERY_STAGE_COUNT];  // Time spent in each query stage in ms.
 } QueryCtx_InternalExecCtx;
 
 typedef struct {
@@ -60,6 +69,13 @@ void QueryCtx_RemoveFromTLS();
 /* Start timing query execution. */
 void QueryCtx_BeginTimer(void);
 
+/* Close the current query stage and begin timing 'stage'. */
+void QueryCtx_AdvanceStage(QueryStage stage);
+/* Set the time spent in 'stage', for stages which are not timed by the QueryCtx. */
+void QueryCtx_SetStageTime(QueryStage stage, double ms);
+/* Retrieve the time spent in each query stage in ms. */
+const double *QueryCtx_GetStageTimes(void);
+
 /* Setters */
 /* Sets the global execution context */
 void QueryCtx_SetGlobalExecutionCtx(CommandCtx *cmd_ctx);
@@ -89,6 +105,16 @@ RedisModuleCtx *QueryCtx_GetRedisModuleCtx(void);
 ResultSet *QueryCtx_GetResultSet(void);
 /* Retrive the resultset statistics. */
 ResultSetStatistics *QueryCtx_GetResultSetStatistics(void);
+/* Retrieve the effects buffer, NULL if effects are not replicated. */
+EffectsBuffer *QueryCtx_GetEffectsBuffer(void);
+/* Retrieve the query's arena, created on first access. */
+Arena *QueryCtx_GetArena(void);
+
+/* Mark the query as timed out, may be called from any thread. */
+void QueryCtx_SetTimedOut(QueryCtx *ctx);
+/* Returns true if the current query exceeded its timeout,
+ * long running operations poll this to stop early. */
+bool QueryCtx_TimedOut(void);
 
 /* Print the current query. */
 void QueryCtx_PrintQuery(void);
@@ -110,7 +136,7 @@ bool QueryCtx_LockForCommit(void);
  * The method get an OpBase and compares it to the last writer, if they are equal then the commit
  * and unlock flow will start.
  * Unlocking flow is:
- * 1. Replicate.
+ * 1. Replicate, either the query or its effects.
  * 2. Unlock graph R/W lock
  * 3. Close key
  * 4. Unlock GIL */
@@ -0,0 +1,277 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "./query_stats.h"
+#include "../RG.h"
+#include "../util/arr.h"
+#include "../util/qsort.h"
+#include "../util/reply.h"
+#include "../util/rmalloc.h"
+
+// latency percentile reported for each fingerprint
+#define QUERY_STATS_PERCENTILE 99
+
+// usage accounting, similar to pg_stat_statements
+// each execution adds to a fingerprint's usage, all usages decay
+// on eviction such that fingerprints which are no longer called age out
+#define USAGE_INIT            1.0   // usage of a new fingerprint
+#define USAGE_EXEC            1.0   // usage added per execution
+#define USAGE_DECAY           0.99  // usage decay factor per eviction
+#define USAGE_EVICT_PERCENT   5     // percentage of fingerprints evicted at once
+#define USAGE_EVICT_MIN       10    // minimal number of fingerprints evicted
+
+// percentiles reported for each query stage
+static const double _stage_percentiles[] = {50, 99, 99.9};
+
+static const char *_stage_names[QUERY_STAGE_COUNT] = {
+	[QueryStage_WAITING]   = "wait",
+	[QueryStage_PARSING]   = "parse",
+	[QueryStage_PLANNING]  = "plan",
+	[QueryStage_LOCKING]   = "lock",
+	[QueryStage_EXECUTING] = "execute",
+	[QueryStage_REPLYING]  = "reply",
+};
+
+static QueryStatsItem *_QueryStatsItem_New
+(
+	const char *fingerprint
+) {
+	QueryStatsItem *item = rm_calloc(1, sizeof(QueryStatsItem));
+	item->fingerprint = rm_strdup(fingerprint);
+	return item;
+}
+
+static void _QueryStatsItem_Free
+(
+	void *item
+) {
+	ASSERT(item != NULL);
+	rm_free(((QueryStatsItem *)item)->fingerprint);
+	rm_free(item);
+}
+
+// remove the least used items to make room for new fingerprints
+// evicting a batch at a time amortizes the cost of ranking items
+// across many misses, usages decay such that a fingerprint which was
+// popular in the past does not outlive current ones
+static void _QueryStats_Evict
+(
+	QueryStats *stats
+) {
+	uint64_t n = raxSize(stats->lookup);
+	QueryStatsItem **items = array_new(QueryStatsItem *, n);
+
+	raxIterator iter;
+	raxStart(&iter, stats->lookup);
+	raxSeek(&iter, "^", NULL, 0);
+	while(raxNext(&iter)) {
+		QueryStatsItem *item = iter.data;
+		item->usage *= USAGE_DECAY;
+		array_append(items, item);
+	}
+	raxStop(&iter);
+
+	ASSERT(n > 0);
+
+	// least used first, ties are broken by recency, least recent first
+#define item_lt(a, b) ((*a)->usage < (*b)->usage ||                \
+		((*a)->usage == (*b)->usage && (*a)->last_call < (*b)->last_call))
+	QSORT(QueryStatsItem *, items, n, item_lt);
+#undef item_lt
+
+	// new fingerprints start at the median usage, such that they are not
+	// evicted ahead of getting a chance to accumulate executions
+	stats->median_usage = items[n / 2]->usage;
+
+	uint64_t evict = n * USAGE_EVICT_PERCENT / 100;
+	if(evict < USAGE_EVICT_MIN) evict = USAGE_EVICT_MIN;
+	if(evict > n) evict = n;
+
+	for(uint64_t i = 0; i < evict; i++) {
+		QueryStatsItem *victim = items[i];
+		int removed = raxRemove(stats->lookup,
+				(unsigned char *)victim->fingerprint,
+				strlen(victim->fingerprint), NULL);
+		ASSERT(removed == 1);
+		_QueryStatsItem_Free(victim);
+	}
+
+	array_free(items);
+}
+
+QueryStats *QueryStats_New(void) {
+	QueryStats *stats = rm_calloc(1, sizeof(QueryStats));
+	stats->lookup = raxNew();
+
+	int res = pthread_mutex_init(&stats->lock, NULL);
+	ASSERT(res == 0);
+
+	return stats;
+}
+
+void QueryStats_Add
+(
+	QueryStats *stats,
+	const char *fingerprint,
+	double latency,
+	uint64_t rows,
+	bool cached
+) {
+	ASSERT(stats != NULL);
+	ASSERT(fingerprint != NULL);
+
+	size_t len = strlen(fingerprint);
+
+	pthread_mutex_lock(&stats->lock);
+	{
+		QueryStatsItem *item = raxFind(stats->lookup,
+				(unsigned char *)fingerprint, len);
+
+		if(item == raxNotFound) {
+			if(raxSize(stats->lookup) >= QUERY_STATS_SIZE) _QueryStats_Evict(stats);
+			item = _QueryStatsItem_New(fingerprint);
+			item->min_time = latency;
+			item->usage = (stats->median_usage > USAGE_INIT) ?
+				stats->median_usage : USAGE_INIT;
+			raxInsert(stats->lookup, (unsigned char *)fingerprint, len, item, NULL);
+		}
+
+		item->calls++;
+		item->usage      += USAGE_EXEC;
+		item->last_call   = ++stats->call_seq;
+		item->rows       += rows;
+		item->cache_hits += cached;
+		item->total_time += latency;
+		if(latency < item->min_time) item->min_time = latency;
+		if(latency > item->max_time) item->max_time = latency;
+		Histogram_Record(&item->latency, latency);
+	}
+	pthread_mutex_unlock(&stats->lock);
+}
+
+void QueryStats_AddStages
+(
+	QueryStats *stats,
+	const double *durations
+) {
+	ASSERT(stats != NULL);
+	ASSERT(durations != NULL);
+
+	for(int i = 0; i < QUERY_STAGE_COUNT; i++) {
+		Histogram_Record(stats->stages + i, durations[i]);
+	}
+}
+
+const char *QueryStats_StageName
+(
+	QueryStage stage
+) {
+	ASSERT(stage < QUERY_STAGE_COUNT);
+	return _stage_names[stage];
+}
+
+void QueryStats_ReplayStages
+(
+	QueryStats *stats,
+	RedisModuleCtx *ctx
+) {
+	ASSERT(ctx != NULL);
+	ASSERT(stats != NULL);
+
+	int percentile_count = sizeof(_stage_percentiles) / sizeof(double);
+
+	RedisModule_ReplyWithArray(ctx, QUERY_STAGE_COUNT);
+	for(int i = 0; i < QUERY_STAGE_COUNT; i++) {
+		const Histogram *h = stats->stages + i;
+		RedisModule_ReplyWithArray(ctx, 2 + percentile_count);
+		RedisModule_ReplyWithCString(ctx, _stage_names[i]);
+		RedisModule_ReplyWithLongLong(ctx,
+				__atomic_load_n(&h->count, __ATOMIC_RELAXED));
+		for(int j = 0; j < percentile_count; j++) {
+			Reply_WithRoundedDouble(ctx,
+					Histogram_Percentile(h, _stage_percentiles[j]));
+		}
+	}
+}
+
+void QueryStats_Replay
+(
+	QueryStats *stats,
+	RedisModuleCtx *ctx
+) {
+	ASSERT(ctx != NULL);
+	ASSERT(stats != NULL);
+
+	pthread_mutex_lock(&stats->lock);
+	{
+		uint64_t n = raxSize(stats->lookup);
+		QueryStatsItem **items = array_new(QueryStatsItem *, n);
+
+		raxIterator iter;
+		raxStart(&iter, stats->lookup);
+		raxSeek(&iter, "^", NULL, 0);
+		while(raxNext(&iter)) array_append(items, iter.data);
+		raxStop(&iter);
+
+		// order by total execution time, most expensive fingerprint first
+#define item_gt(a, b) ((*a)->total_time > (*b)->total_time)
+		QSORT(QueryStatsItem *, items, n, item_gt);
+#undef item_gt
+
+		RedisModule_ReplyWithArray(ctx, n);
+		for(uint64_t i = 0; i < n; i++) {
+			QueryStatsItem *item = items[i];
+			RedisModule_ReplyWithArray(ctx, 8);
+			RedisModule_ReplyWithStringBuffer(ctx, item->fingerprint,
+					strlen(item->fingerprint));
+			RedisModule_ReplyWithLongLong(ctx, item->calls);
+			Reply_WithRoundedDouble(ctx, item->total_time);
+			Reply_WithRoundedDouble(ctx, item->min_time);
+			Reply_WithRoundedDouble(ctx, item->max_time);
+			// percentile is bucketed, never report above the slowest execution
+			double p = Histogram_Percentile(&item->latency,
+					QUERY_STATS_PERCENTILE);
+			Reply_WithRoundedDouble(ctx, (p < item->max_time) ? p : item->max_time);
+			RedisModule_ReplyWithLongLong(ctx, item->rows);
+			Reply_WithRoundedDouble(ctx, (double)item->cache_hits / item->calls);
+		}
+
+		array_free(items);
+	}
+	pthread_mutex_unlock(&stats->lock);
+}
+
+void QueryStats_Reset
+(
+	QueryStats *stats
+) {
+	ASSERT(stats != NULL);
+
+	pthread_mutex_lock(&stats->lock);
+	{
+		raxFreeWithCallback(stats->lookup, _QueryStatsItem_Free);
+		stats->lookup = raxNew();
+		stats->median_usage = 0;
+		memset(stats->stages, 0, sizeof(stats->stages));
+	}
+	pthread_mutex_unlock(&stats->lock);
+}
+
+void QueryStats_Free
+(
+	QueryStats *stats
+) {
+	ASSERT(stats != NULL);
+
+	raxFreeWithCallback(stats->lookup, _QueryStatsItem_Free);
+	int res = pthread_mutex_destroy(&stats->lock);
+	ASSERT(res == 0);
+	rm_free(stats);
+}
+
@@ -0,0 +1,109 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "../redismodule.h"
+#include "../util/histogram.h"
+#include "../../deps/rax/rax.h"
+
+// maximum number of tracked query fingerprints
+// once reached, the least used fingerprints are evicted to make room
+#define QUERY_STATS_SIZE 1000
+
+// stages a query goes through, each stage is timed separately
+typedef enum {
+	QueryStage_WAITING,    // queued, waiting for a worker thread
+	QueryStage_PARSING,    // parsing query parameters and normalizing literals
+	QueryStage_PLANNING,   // building an execution plan or cloning a cached one
+	QueryStage_LOCKING,    // waiting for the writer thread and graph lock
+	QueryStage_EXECUTING,  // executing the plan
+	QueryStage_REPLYING,   // emitting the result-set
+	QueryStage_DONE,       // query completed, not timed
+} QueryStage;
+
+#define QUERY_STAGE_COUNT QueryStage_DONE
+
+// accumulated statistics of a single query fingerprint
+typedef struct {
+	char *fingerprint;   // query with literals replaced by parameters
+	uint64_t calls;      // number of executions
+	uint64_t rows;       // number of rows returned
+	uint64_t cache_hits; // number of executions using a cached plan
+	double usage;        // decaying execution count, drives eviction
+	uint64_t last_call;  // sequence number of the latest execution
+	double total_time;   // total execution time in ms
+	double min_time;     // fastest execution time in ms
+	double max_time;     // slowest execution time in ms
+	Histogram latency;   // execution time distribution
+} QueryStatsItem;
+
+// QueryStats, accumulates execution statistics by query fingerprint
+typedef struct {
+	rax *lookup;                          // fingerprint to item lookup table
+	pthread_mutex_t lock;                 // guards lookup and items
+	double median_usage;                  // median usage at last eviction
+	uint64_t call_seq;                    // number of accounted executions
+	Histogram stages[QUERY_STAGE_COUNT];  // time spent in each query stage
+} QueryStats;
+
+// create a new query stats
+QueryStats *QueryStats_New(void);
+
+// account for a single query execution
+void QueryStats_Add
+(
+	QueryStats *stats,        // query stats to update
+	const char *fingerprint,  // normalized query
+	double latency,           // execution time in ms
+	uint64_t rows,            // number of rows returned
+	bool cached               // whether a cached plan was used
+);
+
+// account for the time a query spent in each stage
+// stage histograms are updated without taking the query stats lock
+void QueryStats_AddStages
+(
+	QueryStats *stats,       // query stats to update
+	const double *durations  // time spent in each stage in ms
+);
+
+// returns the name of a query stage
+const char *QueryStats_StageName
+(
+	QueryStage stage
+);
+
+// replies with the latency distribution of each query stage
+void QueryStats_ReplayStages
+(
+	QueryStats *stats,
+	RedisModuleCtx *ctx
+);
+
+// replies with query stats content, ordered by total execution time
+void QueryStats_Replay
+(
+	QueryStats *stats,
+	RedisModuleCtx *ctx
+);
+
+// clear all accumulated statistics
+void QueryStats_Reset
+(
+	QueryStats *stats
+);
+
+// free query stats
+void QueryStats_Free
+(
+	QueryStats *stats
+);
+
@@ -0,0 +1,173 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "attribute_stats.h"
+#include "RG.h"
+#include "../util/arr.h"
+#include "../util/qsort.h"
+#include <math.h>
+#include <string.h>
+
+void AttributeStats_Init
+(
+	AttributeStats *stats,
+	Attribute_ID id
+) {
+	ASSERT(stats != NULL);
+
+	stats->id      =  id;
+	stats->count   =  0;
+	stats->min     =  SI_NullVal();
+	stats->max     =  SI_NullVal();
+	stats->bounds  =  NULL;
+	stats->depth   =  0;
+	memset(stats->hll, 0, sizeof(stats->hll));
+}
+
+// add hash to HyperLogLog registers
+// the top bits select a register, which keeps the longest run
+// of leading zeros observed in the remaining bits
+static void _HLL_Add
+(
+	uint8_t *registers,
+	uint64_t hash
+) {
+	uint idx = hash >> (64 - ATTRIBUTE_STATS_HLL_BITS);
+	// guard bit limits rank to the number of remaining bits
+	uint64_t w = (hash << ATTRIBUTE_STATS_HLL_BITS) |
+		(1ULL << (ATTRIBUTE_STATS_HLL_BITS - 1));
+	uint8_t rank = __builtin_clzll(w) + 1;
+
+	if(rank > registers[idx]) registers[idx] = rank;
+}
+
+void AttributeStats_Add
+(
+	AttributeStats *stats,
+	SIValue v
+) {
+	ASSERT(stats != NULL);
+	ASSERT(SI_TYPE(v) != T_NULL);
+
+	stats->count++;
+	_HLL_Add(stats->hll, SIValue_HashCode(v));
+
+	if(SI_TYPE(stats->min) == T_NULL ||
+	   SIValue_Compare(v, stats->min, NULL) < 0) {
+		SIValue_Free(stats->min);
+		stats->min = SI_CloneValue(v);
+	}
+
+	if(SI_TYPE(stats->max) == T_NULL ||
+	   SIValue_Compare(v, stats->max, NULL) > 0) {
+		SIValue_Free(stats->max);
+		stats->max = SI_CloneValue(v);
+	}
+}
+
+void AttributeStats_Remove
+(
+	AttributeStats *stats,
+	SIValue v
+) {
+	ASSERT(stats != NULL);
+	ASSERT(SI_TYPE(v) != T_NULL);
+
+	// statistics are approximate, never wrap the count
+	if(stats->count == 0) return;
+
+	stats->count--;
+
+	// the attribute is no longer held by any entity, start over
+	if(stats->count == 0) {
+		Attribute_ID id = stats->id;
+		AttributeStats_Free(stats);
+		AttributeStats_Init(stats, id);
+	}
+}
+
+void AttributeStats_BuildHistogram
+(
+	AttributeStats *stats,
+	SIValue *values,
+	uint64_t n
+) {
+	ASSERT(stats != NULL);
+	ASSERT(n == 0 || values != NULL);
+
+	// discard previous histogram
+	if(stats->bounds != NULL) {
+		uint bucket_count = array_len(stats->bounds);
+		for(uint i = 0; i < bucket_count; i++) SIValue_Free(stats->bounds[i]);
+		array_free(stats->bounds);
+		stats->bounds = NULL;
+	}
+
+	stats->depth = 0;
+	if(n == 0) return;
+
+#define value_lt(a, b) (SIValue_Compare(*(a), *(b), NULL) < 0)
+	QSORT(SIValue, values, n, value_lt);
+
+	// each bucket holds 'depth' values, the last one might hold less
+	uint64_t depth = (n + ATTRIBUTE_STATS_HISTOGRAM_BUCKETS - 1) /
+		ATTRIBUTE_STATS_HISTOGRAM_BUCKETS;
+	stats->depth = depth;
+	stats->bounds = array_new(SIValue, ATTRIBUTE_STATS_HISTOGRAM_BUCKETS);
+
+	for(uint64_t i = depth - 1; i < n; i += depth) {
+		array_append(stats->bounds, SI_CloneValue(values[i]));
+	}
+
+	// last bucket upper bound is the maximum value
+	if((n % depth) != 0) {
+		array_append(stats->bounds, SI_CloneValue(values[n - 1]));
+	}
+}
+
+uint64_t AttributeStats_DistinctCount
+(
+	const AttributeStats *stats
+) {
+	ASSERT(stats != NULL);
+
+	double m      =  ATTRIBUTE_STATS_HLL_REGISTERS;
+	double alpha  =  0.7213 / (1 + 1.079 / m);
+	double sum    =  0;
+	uint   zeros  =  0;
+
+	for(uint i = 0; i < ATTRIBUTE_STATS_HLL_REGISTERS; i++) {
+		uint8_t r = stats->hll[i];
+		sum += 1.0 / (double)(1ULL << r);
+		if(r == 0) zeros++;
+	}
+
+	double estimate = alpha * m * m / sum;
+
+	// small cardinality correction
+	if(estimate <= 2.5 * m && zeros > 0) estimate = m * log(m / zeros);
+
+	// there can't be more distinct values than values
+	uint64_t distinct = (uint64_t)(estimate + 0.5);
+	return MIN(distinct, stats->count);
+}
+
+void AttributeStats_Free
+(
+	AttributeStats *stats
+) {
+	ASSERT(stats != NULL);
+
+	SIValue_Free(stats->min);
+	SIValue_Free(stats->max);
+
+	if(stats->bounds != NULL) {
+		uint bucket_count = array_len(stats->bounds);
+		for(uint i = 0; i < bucket_count; i++) SIValue_Free(stats->bounds[i]);
+		array_free(stats->bounds);
+	}
+}
+
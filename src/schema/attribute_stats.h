@@ -0,0 +1,73 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "../value.h"
+#include "../graph/entities/graph_entity.h"
+
+#define ATTRIBUTE_STATS_HLL_BITS 10  // HyperLogLog precision
+#define ATTRIBUTE_STATS_HLL_REGISTERS (1 << ATTRIBUTE_STATS_HLL_BITS)
+#define ATTRIBUTE_STATS_HISTOGRAM_BUCKETS 16  // number of histogram buckets
+
+// statistics of a single attribute within a schema
+// count is kept exact as values are introduced and removed
+// min, max and the distinct-count sketch only ever widen, removed values
+// are dropped from them, and the equi-depth histogram is computed,
+// when statistics are rebuilt
+typedef struct {
+	Attribute_ID id;         // attribute ID
+	uint64_t count;          // number of entities holding the attribute
+	SIValue min;             // minimum value encountered
+	SIValue max;             // maximum value encountered
+	SIValue *bounds;         // histogram buckets upper bounds, NULL if not built
+	uint64_t depth;          // number of values in each histogram bucket
+	uint8_t hll[ATTRIBUTE_STATS_HLL_REGISTERS];  // distinct-count sketch
+} AttributeStats;
+
+// initialize attribute statistics
+void AttributeStats_Init
+(
+	AttributeStats *stats,  // statistics to initialize
+	Attribute_ID id         // attribute ID
+);
+
+// introduce a value to attribute statistics
+void AttributeStats_Add
+(
+	AttributeStats *stats,  // statistics to update
+	SIValue v               // value held by an entity
+);
+
+// remove a value from attribute statistics, the count never drops below 0
+void AttributeStats_Remove
+(
+	AttributeStats *stats,  // statistics to update
+	SIValue v               // value no longer held by an entity
+);
+
+// compute the equi-depth histogram out of the attribute's values
+// 'values' are reordered
+void AttributeStats_BuildHistogram
+(
+	AttributeStats *stats,  // statistics to update
+	SIValue *values,        // all values of the attribute
+	uint64_t n              // number of values
+);
+
+// estimated number of distinct values
+uint64_t AttributeStats_DistinctCount
+(
+	const AttributeStats *stats
+);
+
+// free attribute statistics internals
+void AttributeStats_Free
+(
+	AttributeStats *stats
+);
+
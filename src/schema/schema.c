@@ -9,6 +9,7 @@
 #include "../query_ctx.h"
 #include "../util/rmalloc.h"
 #include "../graph/graphcontext.h"
+#include "../graph/rg_matrix/rg_matrix_iter.h"
 
 Schema *Schema_New
 (
@@ -25,6 +26,7 @@ Schema *Schema_New
 	s->index        =  NULL;
 	s->fulltextIdx  =  NULL;
 	s->name         =  rm_strdup(name);
+	s->attr_stats   =  array_new(AttributeStats, 0);
 
 	return s;
 }
@@ -116,7 +118,8 @@ int Schema_AddIndex
 	Index **idx,
 	Schema *s,
 	IndexField *field,
-	IndexType type
+	IndexType type,
+	IndexProvider provider
 ) {
 	ASSERT(s != NULL);
 	ASSERT(idx != NULL);
@@ -134,7 +137,7 @@ int Schema_AddIndex
 		if(s->type == SCHEMA_NODE) entity_type = GETYPE_NODE;
 		else entity_type = GETYPE_EDGE;
 
-		_idx = Index_New(s->name, s->id, type, entity_type);
+		_idx = Index_New(s->name, s->id, type, entity_type, provider);
 		if(type == IDX_FULLTEXT) s->fulltextIdx = _idx;
 		else s->index = _idx;
 
@@ -248,6 +251,182 @@ void Schema_AddEdgeToIndices
 	if(idx) Index_IndexEdge(idx, e);
 }
 
+// discard all attribute statistics
+static void _Schema_ClearAttributeStats
+(
+	Schema *s
+) {
+	uint n = array_len(s->attr_stats);
+	for(uint i = 0; i < n; i++) AttributeStats_Free(s->attr_stats + i);
+	array_clear(s->attr_stats);
+}
+
+// returns position of attribute statistics, introducing it if missing
+static uint _Schema_AttributeStatsIdx
+(
+	Schema *s,
+	Attribute_ID id
+) {
+	uint n = array_len(s->attr_stats);
+	for(uint i = 0; i < n; i++) {
+		if(s->attr_stats[i].id == id) return i;
+	}
+
+	AttributeStats stats;
+	AttributeStats_Init(&stats, id);
+	array_append(s->attr_stats, stats);
+
+	return n;
+}
+
+void Schema_AddNodeToAttributeStats
+(
+	Schema *s,
+	const Node *n
+) {
+	ASSERT(s != NULL);
+	ASSERT(n != NULL);
+
+	uint prop_count = ENTITY_PROP_COUNT(n);
+	EntityProperty *props = ENTITY_PROPS(n);
+
+	for(uint i = 0; i < prop_count; i++) {
+		uint idx = _Schema_AttributeStatsIdx(s, props[i].id);
+		AttributeStats_Add(s->attr_stats + idx, props[i].value);
+	}
+}
+
+void Schema_RemoveNodeFromAttributeStats
+(
+	Schema *s,
+	const Node *n
+) {
+	ASSERT(s != NULL);
+	ASSERT(n != NULL);
+
+	uint prop_count = ENTITY_PROP_COUNT(n);
+	EntityProperty *props = ENTITY_PROPS(n);
+
+	for(uint i = 0; i < prop_count; i++) {
+		uint idx = _Schema_AttributeStatsIdx(s, props[i].id);
+		AttributeStats_Remove(s->attr_stats + idx, props[i].value);
+	}
+}
+
+void Schema_UpdateAttributeStats
+(
+	Schema *s,
+	Attribute_ID id,
+	SIValue old_value,
+	SIValue new_value
+) {
+	ASSERT(s != NULL);
+
+	uint idx = _Schema_AttributeStatsIdx(s, id);
+	if(SI_TYPE(old_value) != T_NULL) {
+		AttributeStats_Remove(s->attr_stats + idx, old_value);
+	}
+	if(SI_TYPE(new_value) != T_NULL) {
+		AttributeStats_Add(s->attr_stats + idx, new_value);
+	}
+}
+
+AttributeStats *Schema_AddAttributeStats
+(
+	Schema *s,
+	Attribute_ID id
+) {
+	ASSERT(s != NULL);
+	ASSERT(Schema_GetAttributeStats(s, id) == NULL);
+
+	return s->attr_stats + _Schema_AttributeStatsIdx(s, id);
+}
+
+const AttributeStats *Schema_GetAttributeStats
+(
+	const Schema *s,
+	Attribute_ID id
+) {
+	ASSERT(s != NULL);
+
+	uint n = array_len(s->attr_stats);
+	for(uint i = 0; i < n; i++) {
+		if(s->attr_stats[i].id == id) return s->attr_stats + i;
+	}
+
+	return NULL;
+}
+
+uint Schema_AttributeStatsCount
+(
+	const Schema *s
+) {
+	ASSERT(s != NULL);
+	return array_len(s->attr_stats);
+}
+
+const AttributeStats *Schema_GetAttributeStatsByIdx
+(
+	const Schema *s,
+	uint idx
+) {
+	ASSERT(s != NULL);
+	ASSERT(idx < array_len(s->attr_stats));
+
+	return s->attr_stats + idx;
+}
+
+void Schema_RebuildAttributeStats
+(
+	Schema *s,
+	const Graph *g
+) {
+	ASSERT(s != NULL);
+	ASSERT(g != NULL);
+	ASSERT(s->type == SCHEMA_NODE);
+
+	_Schema_ClearAttributeStats(s);
+
+	// values of each attribute, positioned as s->attr_stats
+	// values are shared with the graph entities
+	SIValue **values = array_new(SIValue *, 0);
+
+	GrB_Index           id;
+	bool                depleted  =  false;
+	RG_MatrixTupleIter  *it       =  NULL;
+	RG_Matrix           L         =  Graph_GetLabelMatrix(g, s->id);
+
+	RG_MatrixTupleIter_new(&it, L);
+	while(true) {
+		RG_MatrixTupleIter_next(it, &id, NULL, NULL, &depleted);
+		if(depleted) break;
+
+		Node n;
+		Graph_GetNode(g, id, &n);
+
+		uint prop_count = ENTITY_PROP_COUNT(&n);
+		EntityProperty *props = ENTITY_PROPS(&n);
+		for(uint i = 0; i < prop_count; i++) {
+			uint idx = _Schema_AttributeStatsIdx(s, props[i].id);
+			AttributeStats_Add(s->attr_stats + idx, props[i].value);
+
+			if(idx == array_len(values)) {
+				array_append(values, array_new(SIValue, 1));
+			}
+			array_append(values[idx], props[i].value);
+		}
+	}
+	RG_MatrixTupleIter_free(&it);
+
+	uint n = array_len(values);
+	for(uint i = 0; i < n; i++) {
+		AttributeStats_BuildHistogram(s->attr_stats + i, values[i],
+				array_len(values[i]));
+		array_free(values[i]);
+	}
+	array_free(values);
+}
+
 void Schema_Free
 (
 	Schema *s
@@ -256,6 +435,9 @@ void Schema_Free
 
 	if(s->name) rm_free(s->name);
 
+	_Schema_ClearAttributeStats(s);
+	array_free(s->attr_stats);
+
 	// Free indicies.
 	if(s->index) Index_Free(s->index);
 	if(s->fulltextIdx) Index_Free(s->fulltextIdx);
@@ -8,7 +8,9 @@
 
 #include "../redismodule.h"
 #include "../index/index.h"
+#include "../graph/graph.h"
 #include "rax.h"
+#include "attribute_stats.h"
 #include "redisearch_api.h"
 #include "../graph/entities/graph_entity.h"
 
@@ -26,6 +28,7 @@ typedef struct {
 	SchemaType type;      // schema type (node/edge)
 	Index *index;         // exact match index
 	Index *fulltextIdx;   // full-text index
+	AttributeStats *attr_stats;  // per attribute statistics
 } Schema;
 
 // creates a new schema
@@ -70,12 +73,14 @@ Index *Schema_GetIndex
 
 // assign a new index to attribute
 // attribute must already exists and not associated with an index
+// 'provider' is only considered when the index is created
 int Schema_AddIndex
 (
 	Index **idx,
 	Schema *s,
 	IndexField *field,
-	IndexType type
+	IndexType type,
+	IndexProvider provider
 );
 
 // removes index
@@ -100,6 +105,66 @@ void Schema_AddEdgeToIndices
 	const Edge *e
 );
 
+// introduce node attributes to schema attribute statistics
+void Schema_AddNodeToAttributeStats
+(
+	Schema *s,
+	const Node *n
+);
+
+// remove node attributes from schema attribute statistics
+void Schema_RemoveNodeFromAttributeStats
+(
+	Schema *s,
+	const Node *n
+);
+
+// reflect a change of attribute 'id' from 'old_value' to 'new_value'
+// in schema attribute statistics, a NULL value denotes a missing attribute
+void Schema_UpdateAttributeStats
+(
+	Schema *s,
+	Attribute_ID id,
+	SIValue old_value,
+	SIValue new_value
+);
+
+// introduce empty statistics for attribute 'id'
+// used when decoding statistics
+AttributeStats *Schema_AddAttributeStats
+(
+	Schema *s,
+	Attribute_ID id
+);
+
+// retrieves attribute statistics
+// returns NULL if attribute was never encountered
+const AttributeStats *Schema_GetAttributeStats
+(
+	const Schema *s,
+	Attribute_ID id
+);
+
+// returns number of attributes with statistics
+uint Schema_AttributeStatsCount
+(
+	const Schema *s
+);
+
+// retrieves attribute statistics by position
+const AttributeStats *Schema_GetAttributeStatsByIdx
+(
+	const Schema *s,
+	uint idx
+);
+
+// recompute attribute statistics from all nodes holding schema's label
+void Schema_RebuildAttributeStats
+(
+	Schema *s,
+	const Graph *g
+);
+
 // Free schema
 void Schema_Free
 (
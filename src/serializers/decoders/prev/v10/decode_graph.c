@@ -202,6 +202,9 @@ GraphContext *RdbLoadGraphContext_v10(RedisModuleIO *rdb) {
 			GraphStatistics_IncNodeCount(&g->stats, i, nvals);
 		}
 
+		// attribute statistics are not encoded prior to v12, compute them
+		GraphContext_RebuildAttributeStats(gc);
+
 		// make sure graph doesn't contains may pending changes
 		ASSERT(Graph_Pending(g) == false);
 
@@ -42,7 +42,8 @@ static void _RdbLoadFullTextIndex
 		if(!already_loaded) {
 			IndexField field;
 			IndexField_New(&field, field_name, weight, nostem, phonetic);
-			Schema_AddIndex(&idx, s, &field, IDX_FULLTEXT);
+			Schema_AddIndex(&idx, s, &field, IDX_FULLTEXT,
+					IDX_PROVIDER_REDISEARCH);
 		}
 
 		RedisModule_Free(field_name);
@@ -82,7 +83,9 @@ static void _RdbLoadExactMatchIndex
 			IndexField_New(&field, field_name, INDEX_FIELD_DEFAULT_WEIGHT,
 				INDEX_FIELD_DEFAULT_NOSTEM, INDEX_FIELD_DEFAULT_PHONETIC);
 
-			Schema_AddIndex(&idx, s, &field, IDX_EXACT_MATCH);
+			// index providers are not encoded prior to v12
+			Schema_AddIndex(&idx, s, &field, IDX_EXACT_MATCH,
+					Index_ConfiguredProvider());
 		}
 		RedisModule_Free(field_name);
 	}
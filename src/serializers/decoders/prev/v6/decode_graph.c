@@ -58,15 +58,23 @@ static void _RdbLoadEntity(RedisModuleIO *rdb, GraphContext *gc, GraphEntity *e)
 	uint64_t propCount = RedisModule_LoadUnsigned(rdb);
 	if(!propCount) return;
 
-	for(int i = 0; i < propCount; i++) {
+	// load all properties, then attach them to the entity at once
+	Attribute_ID *attr_ids = rm_malloc(sizeof(Attribute_ID) * propCount);
+	SIValue *attr_values = rm_malloc(sizeof(SIValue) * propCount);
+
+	for(uint64_t i = 0; i < propCount; i++) {
 		char *attr_name = RedisModule_LoadStringBuffer(rdb, NULL);
-		SIValue attr_value = _RdbLoadSIValue(rdb);
-		Attribute_ID attr_id = GraphContext_GetAttributeID(gc, attr_name);
-		ASSERT(attr_id != ATTRIBUTE_NOTFOUND);
-		GraphEntity_AddProperty(e, attr_id, attr_value);
-		SIValue_Free(attr_value);
+		attr_values[i] = _RdbLoadSIValue(rdb);
+		attr_ids[i] = GraphContext_GetAttributeID(gc, attr_name);
+		ASSERT(attr_ids[i] != ATTRIBUTE_NOTFOUND);
 		RedisModule_Free(attr_name);
 	}
+
+	GraphEntity_AddProperties(e, attr_ids, attr_values, propCount);
+
+	for(uint64_t i = 0; i < propCount; i++) SIValue_Free(attr_values[i]);
+	rm_free(attr_ids);
+	rm_free(attr_values);
 }
 
 static void _RdbLoadNodes(RedisModuleIO *rdb, GraphContext *gc) {
@@ -167,6 +175,9 @@ void RdbLoadGraph_v6(RedisModuleIO *rdb, GraphContext *gc) {
 		GraphStatistics_IncNodeCount(&g->stats, i, nvals);
 	}
 
+	// attribute statistics are not encoded prior to v12, compute them
+	GraphContext_RebuildAttributeStats(gc);
+
 	// make sure graph doesn't contains may pending changes
 	ASSERT(Graph_Pending(g) == false);
 }
@@ -169,6 +169,9 @@ GraphContext *RdbLoadGraphContext_v7(RedisModuleIO *rdb) {
 			if(s->fulltextIdx) Index_Construct(s->fulltextIdx);
 		}
 
+		// attribute statistics are not encoded prior to v12, compute them
+		GraphContext_RebuildAttributeStats(gc);
+
 		// make sure graph doesn't contains may pending changes
 		ASSERT(Graph_Pending(g) == false);
 
@@ -56,13 +56,22 @@ static void _RdbLoadEntity(RedisModuleIO *rdb, GraphContext *gc, GraphEntity *e)
 	 * (name, value type, value) X N
 	*/
 	uint64_t propCount = RedisModule_LoadUnsigned(rdb);
+	if(propCount == 0) return;
 
-	for(int i = 0; i < propCount; i++) {
-		Attribute_ID attr_id = RedisModule_LoadUnsigned(rdb);
-		SIValue attr_value = _RdbLoadSIValue(rdb);
-		GraphEntity_AddProperty(e, attr_id, attr_value);
-		SIValue_Free(attr_value);
+	// load all properties, then attach them to the entity at once
+	Attribute_ID *attr_ids = rm_malloc(sizeof(Attribute_ID) * propCount);
+	SIValue *attr_values = rm_malloc(sizeof(SIValue) * propCount);
+
+	for(uint64_t i = 0; i < propCount; i++) {
+		attr_ids[i] = RedisModule_LoadUnsigned(rdb);
+		attr_values[i] = _RdbLoadSIValue(rdb);
 	}
+
+	GraphEntity_AddProperties(e, attr_ids, attr_values, propCount);
+
+	for(uint64_t i = 0; i < propCount; i++) SIValue_Free(attr_values[i]);
+	rm_free(attr_ids);
+	rm_free(attr_values);
 }
 
 
@@ -46,7 +46,9 @@ static Schema *_RdbLoadSchema(RedisModuleIO *rdb, SchemaType type) {
 		IndexField field;
 		IndexField_New(&field, fields[i], INDEX_FIELD_DEFAULT_WEIGHT,
 				INDEX_FIELD_DEFAULT_NOSTEM, INDEX_FIELD_DEFAULT_PHONETIC);
-		Schema_AddIndex(&idx, s, &field, types[i]);
+		// index providers are not encoded prior to v12
+		Schema_AddIndex(&idx, s, &field, types[i],
+				Index_ConfiguredProvider());
 		RedisModule_Free(fields[i]);
 	}
 
@@ -26,7 +26,9 @@ static Schema *_RdbLoadSchema(RedisModuleIO *rdb, SchemaType type) {
 		IndexField field;
 		IndexField_New(&field, field_name, INDEX_FIELD_DEFAULT_WEIGHT,
 				INDEX_FIELD_DEFAULT_NOSTEM, INDEX_FIELD_DEFAULT_PHONETIC);
-		Schema_AddIndex(&idx, s, &field, type);
+		// index providers are not encoded prior to v12
+		Schema_AddIndex(&idx, s, &field, type,
+				Index_ConfiguredProvider());
 		RedisModule_Free(field_name);
 	}
 
@@ -4,7 +4,7 @@
 * This file is available under the Redis Labs Source Available License Agreement
 */
 
-#include "encode_v11.h"
+#include "encode_v12.h"
 
 extern bool process_is_child; // Global variable declared in module.c
 
@@ -58,7 +58,7 @@ static void _RdbSaveHeader
 	RedisModule_SaveUnsigned(rdb, header->key_count);
 
 	// save graph schemas
-	RdbSaveGraphSchema_v11(rdb, gc);
+	RdbSaveGraphSchema_v12(rdb, gc);
 }
 
 // returns a state information regarding the number of entities required
@@ -161,7 +161,7 @@ static PayloadInfo *_RdbSaveKeySchema
 	return payloads;
 }
 
-void RdbSaveGraph_v11
+void RdbSaveGraph_v12
 (
 	RedisModuleIO *rdb,
 	void *value
@@ -214,16 +214,16 @@ void RdbSaveGraph_v11
 		PayloadInfo payload = key_schema[i];
 		switch(payload.state) {
 		case ENCODE_STATE_NODES:
-			RdbSaveNodes_v11(rdb, gc, payload.entities_count);
+			RdbSaveNodes_v12(rdb, gc, payload.entities_count);
 			break;
 		case ENCODE_STATE_DELETED_NODES:
-			RdbSaveDeletedNodes_v11(rdb, gc, payload.entities_count);
+			RdbSaveDeletedNodes_v12(rdb, gc, payload.entities_count);
 			break;
 		case ENCODE_STATE_EDGES:
-			RdbSaveEdges_v11(rdb, gc, payload.entities_count);
+			RdbSaveEdges_v12(rdb, gc, payload.entities_count);
 			break;
 		case ENCODE_STATE_DELETED_EDGES:
-			RdbSaveDeletedEdges_v11(rdb, gc, payload.entities_count);
+			RdbSaveDeletedEdges_v12(rdb, gc, payload.entities_count);
 			break;
 		case ENCODE_STATE_GRAPH_SCHEMA:
 			// skip, handled in _RdbSaveHeader
@@ -4,16 +4,9 @@
 * This file is available under the Redis Labs Source Available License Agreement
 */
 
-#include "encode_v11.h"
+#include "encode_v12.h"
 #include "../../../datatypes/datatypes.h"
 
-// forword decleration
-static void _RdbSaveSIValue
-(
-	RedisModuleIO *rdb,
-	const SIValue *v
-);
-
 static void _RdbSaveSIArray
 (
 	RedisModuleIO *rdb,
@@ -31,11 +24,11 @@ static void _RdbSaveSIArray
 	RedisModule_SaveUnsigned(rdb, arrayLen);
 	for(uint i = 0; i < arrayLen; i ++) {
 		SIValue value = SIArray_Get(list, i);
-		_RdbSaveSIValue(rdb, &value);
+		RdbSaveSIValue_v12(rdb, &value);
 	}
 }
 
-static void _RdbSaveSIValue
+void RdbSaveSIValue_v12
 (
 	RedisModuleIO *rdb,
 	const SIValue *v
@@ -82,7 +75,7 @@ static void _RdbSaveEntity
 	for(int i = 0; i < e->prop_count; i++) {
 		EntityProperty attr = e->properties[i];
 		RedisModule_SaveUnsigned(rdb, attr.id);
-		_RdbSaveSIValue(rdb, &attr.value);
+		RdbSaveSIValue_v12(rdb, &attr.value);
 	}
 }
 
@@ -116,7 +109,7 @@ static void _RdbSaveEdge
 	_RdbSaveEntity(rdb, e->entity);
 }
 
-static void _RdbSaveNode_v11
+static void _RdbSaveNode_v12
 (
 	RedisModuleIO *rdb,
 	GraphContext *gc,
@@ -146,7 +139,7 @@ static void _RdbSaveNode_v11
 	_RdbSaveEntity(rdb, n->entity);
 }
 
-static void _RdbSaveDeletedEntities_v11
+static void _RdbSaveDeletedEntities_v12
 (
 	RedisModuleIO *rdb,
 	GraphContext *gc,
@@ -162,7 +155,7 @@ static void _RdbSaveDeletedEntities_v11
 	}
 }
 
-void RdbSaveDeletedNodes_v11
+void RdbSaveDeletedNodes_v12
 (
 	RedisModuleIO *rdb,
 	GraphContext *gc,
@@ -174,10 +167,10 @@ void RdbSaveDeletedNodes_v11
 	if(deleted_nodes_to_encode == 0) return;
 	// get deleted nodes list
 	uint64_t *deleted_nodes_list = Serializer_Graph_GetDeletedNodesList(gc->g);
-	_RdbSaveDeletedEntities_v11(rdb, gc, deleted_nodes_to_encode, deleted_nodes_list);
+	_RdbSaveDeletedEntities_v12(rdb, gc, deleted_nodes_to_encode, deleted_nodes_list);
 }
 
-void RdbSaveDeletedEdges_v11
+void RdbSaveDeletedEdges_v12
 (
 	RedisModuleIO *rdb,
 	GraphContext *gc,
@@ -190,10 +183,10 @@ void RdbSaveDeletedEdges_v11
 
 	// get deleted edges list
 	uint64_t *deleted_edges_list = Serializer_Graph_GetDeletedEdgesList(gc->g);
-	_RdbSaveDeletedEntities_v11(rdb, gc, deleted_edges_to_encode, deleted_edges_list);
+	_RdbSaveDeletedEntities_v12(rdb, gc, deleted_edges_to_encode, deleted_edges_list);
 }
 
-void RdbSaveNodes_v11
+void RdbSaveNodes_v12
 (
 	RedisModuleIO *rdb,
 	GraphContext *gc,
@@ -224,7 +217,7 @@ void RdbSaveNodes_v11
 	for(uint64_t i = 0; i < nodes_to_encode; i++) {
 		GraphEntity e;
 		e.entity = (Entity *)DataBlockIterator_Next(iter, &e.id);
-		_RdbSaveNode_v11(rdb, gc, &e);
+		_RdbSaveNode_v12(rdb, gc, &e);
 	}
 
 	// check if done encodeing nodes
@@ -273,7 +266,7 @@ static void _RdbSaveMultipleEdges
 	*multiple_edges_current_index = i;
 }
 
-void RdbSaveEdges_v11
+void RdbSaveEdges_v12
 (
 	RedisModuleIO *rdb,
 	GraphContext *gc,
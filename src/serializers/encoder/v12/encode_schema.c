@@ -4,7 +4,7 @@
 * This file is available under the Redis Labs Source Available License Agreement
 */
 
-#include "encode_v11.h"
+#include "encode_v12.h"
 
 static void _RdbSaveAttributeKeys
 (
@@ -19,7 +19,7 @@ static void _RdbSaveAttributeKeys
 	uint count = GraphContext_AttributeCount(gc);
 	RedisModule_SaveUnsigned(rdb, count);
 	for(uint i = 0; i < count; i ++) {
-		char *key = gc->string_mapping[i];
+		const char *key = GraphContext_GetAttributeString(gc, i);
 		RedisModule_SaveStringBuffer(rdb, key, strlen(key) + 1);
 	}
 }
@@ -71,8 +71,11 @@ static inline void _RdbSaveExactMatchIndex
 	Index *idx
 ) {
 	/* Format:
+	 * provider
 	 * #properties - M
-	 * M * property */
+	 * M * property
+	 * #composite key properties - C
+	 * C * property */
 
 	uint fields_count = Index_FieldsCount(idx);
 
@@ -81,6 +84,9 @@ static inline void _RdbSaveExactMatchIndex
 	uint encode_fields_count =
 		type == SCHEMA_EDGE ? fields_count - 2 : fields_count;
 
+	// encode index provider
+	RedisModule_SaveUnsigned(rdb, idx->provider);
+
 	// encode field count
 	RedisModule_SaveUnsigned(rdb, encode_fields_count);
 	for(uint i = 0; i < fields_count; i++) {
@@ -96,6 +102,19 @@ static inline void _RdbSaveExactMatchIndex
 		// encode field
 		RedisModule_SaveStringBuffer(rdb, field_name, strlen(field_name) + 1);
 	}
+
+	// encode composite key, in declared order
+	Attribute_ID *composite = idx->composite;
+	uint composite_len = (composite == NULL) ? 0 : array_len(composite);
+	RedisModule_SaveUnsigned(rdb, composite_len);
+	for(uint i = 0; i < composite_len; i++) {
+		for(uint j = 0; j < fields_count; j++) {
+			if(idx->fields[j].id != composite[i]) continue;
+			char *field_name = idx->fields[j].name;
+			RedisModule_SaveStringBuffer(rdb, field_name, strlen(field_name) + 1);
+			break;
+		}
+	}
 }
 
 static inline void _RdbSaveIndexData
@@ -117,12 +136,47 @@ static inline void _RdbSaveIndexData
 	else _RdbSaveExactMatchIndex(rdb, type, idx);
 }
 
+static void _RdbSaveAttributeStats
+(
+	RedisModuleIO *rdb,
+	Schema *s
+) {
+	/* Format:
+	 * #attribute statistics - N
+	 * N * {attribute id, count, min, max, histogram depth,
+	 *      #histogram buckets - M, M * bucket upper bound,
+	 *      distinct-count sketch} */
+
+	uint stats_count = Schema_AttributeStatsCount(s);
+	RedisModule_SaveUnsigned(rdb, stats_count);
+
+	for(uint i = 0; i < stats_count; i++) {
+		const AttributeStats *stats = Schema_GetAttributeStatsByIdx(s, i);
+
+		RedisModule_SaveUnsigned(rdb, stats->id);
+		RedisModule_SaveUnsigned(rdb, stats->count);
+		RdbSaveSIValue_v12(rdb, &stats->min);
+		RdbSaveSIValue_v12(rdb, &stats->max);
+		RedisModule_SaveUnsigned(rdb, stats->depth);
+
+		uint bucket_count = stats->bounds ? array_len(stats->bounds) : 0;
+		RedisModule_SaveUnsigned(rdb, bucket_count);
+		for(uint j = 0; j < bucket_count; j++) {
+			RdbSaveSIValue_v12(rdb, stats->bounds + j);
+		}
+
+		RedisModule_SaveStringBuffer(rdb, (const char *)stats->hll,
+				sizeof(stats->hll));
+	}
+}
+
 static void _RdbSaveSchema(RedisModuleIO *rdb, Schema *s) {
 	/* Format:
 	 * id
 	 * name
 	 * #indices
-	 * (index type, indexed property) X M */
+	 * (index type, indexed property) X M
+	 * attribute statistics */
 
 	// Schema ID.
 	RedisModule_SaveUnsigned(rdb, s->id);
@@ -138,9 +192,12 @@ static void _RdbSaveSchema(RedisModuleIO *rdb, Schema *s) {
 
 	// Fulltext indices.
 	_RdbSaveIndexData(rdb, s->type, s->fulltextIdx);
+
+	// Attribute statistics.
+	_RdbSaveAttributeStats(rdb, s);
 }
 
-void RdbSaveGraphSchema_v11(RedisModuleIO *rdb, GraphContext *gc) {
+void RdbSaveGraphSchema_v12(RedisModuleIO *rdb, GraphContext *gc) {
 	/* Format:
 	 * attribute keys (unified schema)
 	 * #node schemas
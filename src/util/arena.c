@@ -0,0 +1,143 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "arena.h"
+#include "RG.h"
+#include "arr.h"
+#include "rmalloc.h"
+
+// allocations are aligned to 8 bytes
+#define ARENA_ALIGN(size) (((size) + 7) & ~((size_t)7))
+
+struct ArenaChunk {
+	size_t cap;             // chunk capacity in bytes
+	size_t used;            // number of bytes allocated
+	unsigned char data[];   // chunk data, MUST BE LAST MEMBER OF THE STRUCT!
+};
+
+// calling thread's active arena
+static __thread Arena *active_arena = NULL;
+
+static ArenaChunk *_ArenaChunk_New(size_t cap) {
+	ArenaChunk *chunk = rm_malloc(sizeof(ArenaChunk) + cap);
+	chunk->cap  = cap;
+	chunk->used = 0;
+	return chunk;
+}
+
+Arena *Arena_New
+(
+	size_t chunk_size
+) {
+	ASSERT(chunk_size > 0);
+
+	Arena *a = rm_malloc(sizeof(Arena));
+	a->chunks     = array_new(ArenaChunk *, 1);
+	a->current    = 0;
+	a->chunk_size = ARENA_ALIGN(chunk_size);
+
+	array_append(a->chunks, _ArenaChunk_New(a->chunk_size));
+
+	return a;
+}
+
+void *Arena_Alloc
+(
+	Arena *a,
+	size_t size
+) {
+	ASSERT(a != NULL);
+
+	size = ARENA_ALIGN(size);
+	ArenaChunk *chunk = a->chunks[a->current];
+
+	if(chunk->cap - chunk->used < size) {
+		// current chunk is exhausted, move to the next chunk
+		a->current++;
+		size_t cap = (size > a->chunk_size) ? size : a->chunk_size;
+
+		if(a->current == array_len(a->chunks)) {
+			array_append(a->chunks, _ArenaChunk_New(cap));
+		} else if(a->chunks[a->current]->cap < size) {
+			// spare chunk is too small for this allocation, replace it
+			rm_free(a->chunks[a->current]);
+			a->chunks[a->current] = _ArenaChunk_New(cap);
+		}
+
+		chunk = a->chunks[a->current];
+		chunk->used = 0;
+	}
+
+	void *ptr = chunk->data + chunk->used;
+	chunk->used += size;
+	return ptr;
+}
+
+ArenaMark Arena_Mark
+(
+	const Arena *a
+) {
+	ASSERT(a != NULL);
+
+	return (ArenaMark) {
+		.chunk = a->current, .offset = a->chunks[a->current]->used
+	};
+}
+
+void Arena_Rewind
+(
+	Arena *a,
+	ArenaMark mark
+) {
+	ASSERT(a != NULL);
+	ASSERT(mark.chunk <= a->current);
+
+	// chunks past the mark are kept for reuse
+	a->current = mark.chunk;
+	a->chunks[a->current]->used = mark.offset;
+}
+
+bool Arena_Contains
+(
+	const Arena *a,
+	const void *ptr
+) {
+	ASSERT(a != NULL);
+
+	const unsigned char *p = ptr;
+	for(uint i = 0; i <= a->current; i++) {
+		const ArenaChunk *chunk = a->chunks[i];
+		if(p >= chunk->data && p < chunk->data + chunk->used) return true;
+	}
+
+	return false;
+}
+
+void Arena_Free
+(
+	Arena *a
+) {
+	ASSERT(a != NULL);
+
+	if(active_arena == a) active_arena = NULL;
+
+	uint chunk_count = array_len(a->chunks);
+	for(uint i = 0; i < chunk_count; i++) rm_free(a->chunks[i]);
+	array_free(a->chunks);
+	rm_free(a);
+}
+
+void Arena_SetActive
+(
+	Arena *a
+) {
+	active_arena = a;
+}
+
+Arena *Arena_GetActive(void) {
+	return active_arena;
+}
+
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+// the Arena is a region allocator serving short-lived allocations
+// allocations are carved out of large chunks by bumping an offset
+// and are never freed individually, instead the arena is rewound to a mark
+// releasing every allocation made since the mark was taken
+//
+// chunks are obtained from rm_malloc, as such the query memory limit
+// is accounted once per chunk rather than once per allocation
+
+typedef struct ArenaChunk ArenaChunk;
+
+typedef struct {
+	ArenaChunk **chunks;  // chunks, chunks past 'current' are kept for reuse
+	uint current;         // index of chunk allocations are served from
+	size_t chunk_size;    // default chunk size
+} Arena;
+
+// position within an arena to rewind to
+typedef struct {
+	uint chunk;     // chunk index
+	size_t offset;  // offset within chunk
+} ArenaMark;
+
+// create a new arena
+Arena *Arena_New
+(
+	size_t chunk_size  // default chunk size
+);
+
+// allocate 'size' bytes from the arena
+void *Arena_Alloc
+(
+	Arena *a,    // arena
+	size_t size  // number of bytes to allocate
+);
+
+// returns the arena's current position
+ArenaMark Arena_Mark
+(
+	const Arena *a  // arena
+);
+
+// release all allocations made after 'mark' was taken
+void Arena_Rewind
+(
+	Arena *a,       // arena
+	ArenaMark mark  // position to rewind to
+);
+
+// returns true if 'ptr' points to a live allocation within the arena
+bool Arena_Contains
+(
+	const Arena *a,  // arena
+	const void *ptr  // pointer to look up
+);
+
+// free arena and all of its allocations
+void Arena_Free
+(
+	Arena *a  // arena to free
+);
+
+// set the calling thread's active arena
+// transient values created by this thread are allocated from the active arena
+// NULL deactivates the arena, allocations fall back to the heap
+void Arena_SetActive
+(
+	Arena *a  // arena to activate, NULL to deactivate
+);
+
+// returns the calling thread's active arena, NULL if there's none
+Arena *Arena_GetActive(void);
+
@@ -103,6 +103,26 @@ cleanup:
 	return item;
 }
 
+bool Cache_Visit(Cache *cache, const char *key, CacheEntryVisitFunc func,
+		void *pdata) {
+	ASSERT(key   != NULL);
+	ASSERT(func  != NULL);
+	ASSERT(cache != NULL);
+
+	int res = pthread_rwlock_rdlock(&cache->_cache_rwlock);
+	UNUSED(res);
+	ASSERT(res == 0);
+
+	// holding the read lock prevents the entry from being evicted
+	CacheEntry *entry = raxFind(cache->lookup, (unsigned char *)key, strlen(key));
+	bool found = (entry != raxNotFound);
+	if(found) func(entry->value, pdata);
+
+	res = pthread_rwlock_unlock(&cache->_cache_rwlock);
+	ASSERT(res == 0);
+	return found;
+}
+
 void Cache_SetValue(Cache *cache, const char *key, void *value) {
 	ASSERT(key != NULL);
 	ASSERT(cache != NULL);
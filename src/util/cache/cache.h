@@ -41,6 +41,19 @@ Cache *Cache_New(uint size, CacheEntryFreeFunc freeFunc, CacheEntryCopyFunc copy
  */
 void *Cache_GetValue(Cache *cache, const char *key);
 
+/**
+ * @brief  Invokes func on the value stored under key, if it is cached.
+ * @note   The value remains cached at least until func returns,
+ *         func may be invoked concurrently by multiple threads.
+ * @param  *cache: cache pointer.
+ * @param  *key: Key to look for.
+ * @param  func: callback invoked with the cached value.
+ * @param  *pdata: private data passed on to func.
+ * @retval  true if key is cached, false otherwise.
+ */
+bool Cache_Visit(Cache *cache, const char *key, CacheEntryVisitFunc func,
+		void *pdata);
+
 /**
  * @brief  Stores value under key within the cache.
  * @note   In case the cache is full, this operation causes a cache eviction.
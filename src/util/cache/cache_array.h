@@ -21,6 +21,9 @@ typedef void (*CacheEntryFreeFunc)(void *);
 // cache entry duplicate function
 typedef void *(*CacheEntryCopyFunc)(void *);
 
+// cache entry visit function
+typedef void (*CacheEntryVisitFunc)(void *value, void *pdata);
+
 /**
  * @brief  A struct for an entry in cache array with a key and value.
  */
@@ -1,12 +1,32 @@
 #include "cron.h"
-#include "heap.h"
+#include "arr.h"
 #include "rmalloc.h"
 #include "../RG.h"
 #include <time.h>
 #include <pthread.h>
 #include <stdbool.h>
 
-#define MAX(a,b) ((a) >= (b)) ? (a) : (b)
+//------------------------------------------------------------------------------
+// Timing wheel dimensions
+//------------------------------------------------------------------------------
+
+// each tick is 1ms, level 'l' slots span 64^l ticks
+// the wheel covers 64^4 ms (~4.6 hours) tasks due later than that are
+// placed at the last level and re-positioned as the wheel turns
+#define WHEEL_LEVELS 4
+#define WHEEL_BITS   6
+#define WHEEL_SLOTS  (1 << WHEEL_BITS)
+#define WHEEL_MASK   (WHEEL_SLOTS - 1)
+#define WHEEL_SPAN   ((uint64_t)1 << (WHEEL_BITS * WHEEL_LEVELS))
+
+// slot index of 'tick' at wheel level 'level'
+#define WHEEL_INDEX(tick, level) (((tick) >> (WHEEL_BITS * (level))) & WHEEL_MASK)
+
+// a task handle encodes the task's position in the tasks table (high 32 bits)
+// and a generation number (low 32 bits) which tells apart tasks sharing
+// the same position over time
+#define HANDLE_POSITION(h) ((uint32_t)((h) >> 32) - 1)
+#define HANDLE_GENERATION(h) ((uint32_t)(h))
 
 //------------------------------------------------------------------------------
 // Data structures
@@ -20,99 +40,180 @@ typedef enum {
 } CRON_TASK_STATE;
 
 // CRON task
-typedef struct {
-	struct timespec due;    // absolute time for when task should run
-	CronTaskCB cb;          // callback to call when task is due
-	void *pdata;            // [optional] private data passed to callback
-	CRON_TASK_STATE state;  // state in which task is at
+typedef struct CRON_TASK {
+	struct CRON_TASK *prev;  // previous task in slot
+	struct CRON_TASK *next;  // next task in slot
+	struct CRON_TASK **slot; // slot holding task, NULL if not in wheel
+	uint64_t due;            // tick at which task should run
+	CronTaskCB cb;           // callback to call when task is due
+	void *pdata;             // [optional] private data passed to callback
+	CRON_TASK_STATE state;   // state in which task is at
+	CronTaskHandle handle;   // task handle
 } CRON_TASK;
 
 // CRON object
 typedef struct {
-	bool alive;                   // indicates cron is active
-	heap_t *tasks;                // min heap of cron tasks
-	pthread_mutex_t mutex;        // mutex control access to tasks
-	pthread_mutex_t condv_mutex;  // mutex control access to condv
-	pthread_cond_t condv;         // conditional variable
-	pthread_t thread;             // thread running cron main loop
+	bool alive;                                       // indicates cron is active
+	CRON_TASK *wheel[WHEEL_LEVELS][WHEEL_SLOTS];      // timing wheel
+	uint64_t current;                                 // next tick to process
+	uint64_t wake;                                    // tick cron will wake at
+	struct timespec start;                            // time of tick 0
+	CRON_TASK **tasks;                                // tasks by handle position
+	uint32_t *free_positions;                         // unused table positions
+	uint32_t generation;                              // last issued generation
+	uint task_count;                                  // number of tasks in wheel
+	pthread_mutex_t mutex;                            // mutex control access to tasks
+	pthread_cond_t condv;                             // conditional variable
+	pthread_t thread;                                 // thread running cron main loop
 } CRON;
 
 // single static CRON instance, initialized at CRON_Start
 static CRON *cron = NULL;
 
-// compares two time objects
-static int cmp_timespec(struct timespec a, struct timespec b) {
-	if(a.tv_sec == b.tv_sec) {
-		return a.tv_nsec - b.tv_nsec;
-	} else {
-		return a.tv_sec - b.tv_sec;
-	}
-}
-
-// minimum heap sort function
-static int CRON_JobCmp(const void *a, const void *b, const void *udata) {
-	CRON_TASK *_a = (CRON_TASK*)a;
-	CRON_TASK *_b = (CRON_TASK*)b;
-	return cmp_timespec(_b->due, _a->due);
-}
-
 //------------------------------------------------------------------------------
 // Utility functions
 //------------------------------------------------------------------------------
 
-// compute now + ms
-static struct timespec due_in_ms(uint ms) {
+// number of ms elapsed since cron started
+static uint64_t CRON_Now(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (now.tv_sec - cron->start.tv_sec) * 1000 +
+		(now.tv_nsec - cron->start.tv_nsec) / 1000000;
+}
+
+// compute absolute time 'ms' from now
+static struct timespec due_in_ms(uint64_t ms) {
 	struct timespec due;
-    clock_gettime(CLOCK_REALTIME, &due);
+	clock_gettime(CLOCK_REALTIME, &due);
 
 	due.tv_sec += ms / 1000;
-    due.tv_nsec += (ms % 1000) * 1000000;
+	due.tv_nsec += (ms % 1000) * 1000000;
+	if(due.tv_nsec >= 1000000000) {
+		due.tv_sec++;
+		due.tv_nsec -= 1000000000;
+	}
 
 	return due;
 }
 
-static void CRON_WakeUp(void) {
-	// Set conditional variable to wake up CRON thread
-	pthread_mutex_lock(&cron->condv_mutex);
-	pthread_cond_signal(&cron->condv);
-	pthread_mutex_unlock(&cron->condv_mutex);
+// place task in the wheel slot matching its due tick
+// caller must hold cron's mutex
+static void CRON_LinkTask(CRON_TASK *t) {
+	uint64_t due = t->due;
+	if(due < cron->current) due = cron->current;
+
+	// tasks due beyond the wheel's span are placed at its farthest slot
+	uint64_t delta = due - cron->current;
+	if(delta >= WHEEL_SPAN) {
+		delta = WHEEL_SPAN - 1;
+		due = cron->current + delta;
+	}
+
+	int level = 0;
+	while(delta >= ((uint64_t)1 << (WHEEL_BITS * (level + 1)))) level++;
+
+	CRON_TASK **slot = &cron->wheel[level][WHEEL_INDEX(due, level)];
+	t->slot = slot;
+	t->prev = NULL;
+	t->next = *slot;
+	if(*slot != NULL) (*slot)->prev = t;
+	*slot = t;
 }
 
-// determines if task is due
-static bool CRON_TaskDue(const CRON_TASK *t) {
-	ASSERT(t != NULL);
+// remove task from its wheel slot
+// caller must hold cron's mutex
+static void CRON_UnlinkTask(CRON_TASK *t) {
+	ASSERT(t->slot != NULL);
 
-	struct timespec now;
-    clock_gettime(CLOCK_REALTIME, &now);
-	return cmp_timespec(now, t->due) >= 0;
+	if(t->prev != NULL) t->prev->next = t->next;
+	else *t->slot = t->next;
+	if(t->next != NULL) t->next->prev = t->prev;
+
+	t->slot = NULL;
+	t->prev = NULL;
+	t->next = NULL;
 }
 
-static CRON_TASK *CRON_Peek() {
-	pthread_mutex_lock(&cron->mutex);
-	CRON_TASK *task = Heap_peek(cron->tasks);
-	pthread_mutex_unlock(&cron->mutex);
-	return task;
+// detach and return slot's task list
+// caller must hold cron's mutex
+static CRON_TASK *CRON_DetachSlot(CRON_TASK **slot) {
+	CRON_TASK *list = *slot;
+	*slot = NULL;
+	for(CRON_TASK *t = list; t != NULL; t = t->next) t->slot = NULL;
+	return list;
 }
 
-static void CRON_RemoveTask(const CRON_TASK *t) {
-	ASSERT(t != NULL);
-	pthread_mutex_lock(&cron->mutex);
-	Heap_remove_item(cron->tasks, t);
-	pthread_mutex_unlock(&cron->mutex);
+// re-position tasks of a higher level slot in the wheel
+// returns the slot's index
+// caller must hold cron's mutex
+static int CRON_Cascade(int level) {
+	int idx = WHEEL_INDEX(cron->current, level);
+	CRON_TASK *t = CRON_DetachSlot(&cron->wheel[level][idx]);
+	while(t != NULL) {
+		CRON_TASK *next = t->next;
+		CRON_LinkTask(t);
+		t = next;
+	}
+	return idx;
 }
 
-static void CRON_InsertTask(CRON_TASK *t) {
-	ASSERT(t != NULL);
-	pthread_mutex_lock(&cron->mutex);
-	Heap_offer(&cron->tasks, t);
-	pthread_mutex_unlock(&cron->mutex);
+// returns the tick cron should wake at
+// caller must hold cron's mutex
+static uint64_t CRON_NextWake(void) {
+	if(cron->task_count == 0) return UINT64_MAX;
+
+	// look for the first non empty slot before the lowest level wraps
+	uint64_t tick = cron->current;
+	do {
+		if(cron->wheel[0][tick & WHEEL_MASK] != NULL) return tick;
+		tick++;
+	} while(tick & WHEEL_MASK);
+
+	// pending tasks reside in higher levels, wake up for the next cascade
+	return tick;
+}
+
+// register task in tasks table and assign it a handle
+// caller must hold cron's mutex
+static void CRON_RegisterTask(CRON_TASK *t) {
+	uint32_t pos;
+	if(array_len(cron->free_positions) > 0) {
+		pos = array_pop(cron->free_positions);
+		cron->tasks[pos] = t;
+	} else {
+		pos = array_len(cron->tasks);
+		array_append(cron->tasks, t);
+	}
+
+	uint32_t generation = ++cron->generation;
+	t->handle = ((CronTaskHandle)(pos + 1) << 32) | generation;
+}
+
+// returns the task associated with handle, NULL if there's no such task
+// caller must hold cron's mutex
+static CRON_TASK *CRON_LookupTask(CronTaskHandle h) {
+	uint32_t pos = HANDLE_POSITION(h);
+	if(pos >= array_len(cron->tasks)) return NULL;
 
-	CRON_WakeUp();
+	CRON_TASK *t = cron->tasks[pos];
+	if(t == NULL || t->handle != h) return NULL;
+	return t;
 }
 
-static void CRON_PerformTask(CRON_TASK *t) {
+// remove task from tasks table and free it
+// caller must hold cron's mutex
+static void CRON_FreeTask(CRON_TASK *t) {
 	ASSERT(t);
-	t->cb(t->pdata);
+	ASSERT(t->slot == NULL);
+
+	uint32_t pos = HANDLE_POSITION(t->handle);
+	cron->tasks[pos] = NULL;
+	array_append(cron->free_positions, pos);
+	cron->task_count--;
+
+	rm_free(t);
 }
 
 // try to advance task state from current_state to next_state
@@ -134,15 +235,29 @@ static bool CRON_TaskAdvanceState
 			false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
 }
 
-static void CRON_FreeTask(CRON_TASK *t) {
-	ASSERT(t);
-	rm_free(t);
-}
+// execute a list of due tasks, tasks are executed without holding the mutex
+// caller must hold cron's mutex
+static void CRON_PerformTasks(CRON_TASK *list) {
+	if(list == NULL) return;
+
+	pthread_mutex_unlock(&cron->mutex);
 
-static void clear_tasks() {
-	CRON_TASK *task = NULL;
-	while((task = Heap_poll(cron->tasks))) {
-		CRON_FreeTask(task);
+	for(CRON_TASK *t = list; t != NULL; t = t->next) {
+		// advance from pending to executing, fails if task was aborted
+		if(CRON_TaskAdvanceState(t, TASK_PENDING, TASK_EXECUTING)) {
+			t->cb(t->pdata);
+			// set state to completed
+			// frees any threads waiting on task to complete
+			__atomic_store_n(&t->state, TASK_COMPLETED, __ATOMIC_RELEASE);
+		}
+	}
+
+	pthread_mutex_lock(&cron->mutex);
+
+	while(list != NULL) {
+		CRON_TASK *next = list->next;
+		CRON_FreeTask(list);
+		list = next;
 	}
 }
 
@@ -151,33 +266,45 @@ static void clear_tasks() {
 //------------------------------------------------------------------------------
 
 static void *Cron_Run(void *arg) {
+	pthread_mutex_lock(&cron->mutex);
+
 	while(cron->alive) {
-		// execute due tasks
-		CRON_TASK *task = NULL;
-		while((task = CRON_Peek()) && CRON_TaskDue(task)) {
-			CRON_TASK_STATE state = task->state;
-			// task state should be either pending or aborted
-			ASSERT(state == TASK_ABORT || state == TASK_PENDING);
-
-			// advance from pending to executing
-			if(CRON_TaskAdvanceState(task, TASK_PENDING, TASK_EXECUTING)) {
-				CRON_PerformTask(task);
-				// set state to completed
-				// frees any threads waiting on task to complete
-				task->state = TASK_COMPLETED;
+		// turn the wheel up to the current time
+		uint64_t now = CRON_Now();
+		while(cron->current <= now && cron->task_count > 0) {
+			// cascade higher levels each time a lower level wraps around
+			if(WHEEL_INDEX(cron->current, 0) == 0) {
+				for(int level = 1; level < WHEEL_LEVELS; level++) {
+					if(CRON_Cascade(level) != 0) break;
+				}
 			}
 
-			CRON_RemoveTask(task);
-			CRON_FreeTask(task);
+			int idx = WHEEL_INDEX(cron->current, 0);
+			CRON_TASK *due = CRON_DetachSlot(&cron->wheel[0][idx]);
+			cron->current++;
+			CRON_PerformTasks(due);
 		}
 
-		// sleep
-		struct timespec timeout = (task) ? task->due : due_in_ms(1000);
-		pthread_mutex_lock(&cron->condv_mutex);
-		pthread_cond_timedwait(&cron->condv, &cron->condv_mutex, &timeout);
-		pthread_mutex_unlock(&cron->condv_mutex);
+		// an empty wheel can skip ahead
+		if(cron->task_count == 0 && cron->current <= now) cron->current = now + 1;
+
+		// cron might have been stopped while executing tasks
+		if(!cron->alive) break;
+
+		// sleep until the next tick holding tasks, or until a task is added
+		cron->wake = CRON_NextWake();
+		if(cron->wake == UINT64_MAX) {
+			pthread_cond_wait(&cron->condv, &cron->mutex);
+		} else {
+			now = CRON_Now();
+			if(cron->wake > now) {
+				struct timespec timeout = due_in_ms(cron->wake - now);
+				pthread_cond_timedwait(&cron->condv, &cron->mutex, &timeout);
+			}
+		}
 	}
 
+	pthread_mutex_unlock(&cron->mutex);
 	return NULL;
 }
 
@@ -188,12 +315,15 @@ static void *Cron_Run(void *arg) {
 void Cron_Start(void) {
 	ASSERT(cron == NULL);
 
-	cron = rm_malloc(sizeof(CRON));
-	cron->alive = true;
-	cron->tasks = Heap_new(CRON_JobCmp, NULL);
+	cron = rm_calloc(1, sizeof(CRON));
+	cron->alive          = true;
+	cron->wake           = UINT64_MAX;
+	cron->tasks          = array_new(CRON_TASK *, 0);
+	cron->free_positions = array_new(uint32_t, 0);
+	clock_gettime(CLOCK_MONOTONIC, &cron->start);
+
 	pthread_cond_init(&cron->condv, NULL);
 	pthread_mutex_init(&cron->mutex, NULL);
-	pthread_mutex_init(&cron->condv_mutex, NULL);
 	pthread_create(&cron->thread, NULL, Cron_Run, NULL);
 }
 
@@ -201,17 +331,23 @@ void Cron_Stop(void) {
 	ASSERT(cron != NULL);
 
 	// Stop cron main loop
+	pthread_mutex_lock(&cron->mutex);
 	cron->alive = false;
-	CRON_WakeUp();
+	pthread_cond_signal(&cron->condv);
+	pthread_mutex_unlock(&cron->mutex);
 
 	// Wait for thread to terminate
 	pthread_join(cron->thread, NULL);
 
-	clear_tasks();
+	// free pending tasks
+	uint task_table_len = array_len(cron->tasks);
+	for(uint i = 0; i < task_table_len; i++) {
+		if(cron->tasks[i] != NULL) rm_free(cron->tasks[i]);
+	}
 
-	Heap_free(cron->tasks);
+	array_free(cron->tasks);
+	array_free(cron->free_positions);
 	pthread_mutex_destroy(&cron->mutex);
-	pthread_mutex_destroy(&cron->condv_mutex);
 	pthread_cond_destroy(&cron->condv);
 	rm_free(cron);
 	cron = NULL;
@@ -224,39 +360,54 @@ CronTaskHandle Cron_AddTask(uint when, CronTaskCB cb, void *pdata) {
 	CRON_TASK *task = rm_malloc(sizeof(CRON_TASK));
 	task->cb     =  cb;
 	task->pdata  =  pdata;
-	task->due    =  due_in_ms(when);
+	task->due    =  CRON_Now() + when;
 	task->state  =  TASK_PENDING;
 
-	CRON_InsertTask(task);
+	pthread_mutex_lock(&cron->mutex);
+
+	CRON_RegisterTask(task);
+	CRON_LinkTask(task);
+	cron->task_count++;
+
+	// wake cron only if the task is due before cron is about to wake
+	if(task->due < cron->wake) pthread_cond_signal(&cron->condv);
 
-	return (uintptr_t)task;
+	CronTaskHandle handle = task->handle;
+	pthread_mutex_unlock(&cron->mutex);
+
+	return handle;
 }
 
 void Cron_AbortTask(CronTaskHandle t) {
 	ASSERT(cron != NULL);
 
-	CRON_TASK *task = (CRON_TASK *)t;
-
 	pthread_mutex_lock(&cron->mutex);
-	if(Heap_contains_item(cron->tasks, task)) {
-		// as long as we're holding the cron's mutex it is safe to access task
-
-		CRON_TASK_STATE state = task->state;
-		if(state != TASK_COMPLETED && state != TASK_ABORT) {
-			// try marking task as aborted
-			bool abort = CRON_TaskAdvanceState(task, TASK_PENDING, TASK_ABORT);
-			if(!abort) {
-				// task is executing, wait for it to finish
-				// shouldn't happen often and shouldn't take long
-				volatile CRON_TASK *task_pending = task;
-				while(task_pending->state != TASK_COMPLETED);
+
+	// as long as we're holding the cron's mutex it is safe to access task
+	CRON_TASK *task = CRON_LookupTask(t);
+	if(task != NULL) {
+		if(task->slot != NULL) {
+			// task is waiting in the wheel, remove it
+			CRON_UnlinkTask(task);
+			CRON_FreeTask(task);
+		} else {
+			// task is due, it will be freed by the cron thread
+			CRON_TASK_STATE state = task->state;
+			if(state != TASK_COMPLETED && state != TASK_ABORT) {
+				// try marking task as aborted
+				bool abort = CRON_TaskAdvanceState(task, TASK_PENDING, TASK_ABORT);
+				if(!abort) {
+					// task is executing, wait for it to finish
+					// shouldn't happen often and shouldn't take long
+					while(__atomic_load_n(&task->state, __ATOMIC_ACQUIRE) !=
+							TASK_COMPLETED);
+				}
 			}
-		}
 
-		state = task->state;
-		ASSERT(state == TASK_COMPLETED || state == TASK_ABORT);
+			state = task->state;
+			ASSERT(state == TASK_COMPLETED || state == TASK_ABORT);
+		}
 	}
 
 	pthread_mutex_unlock(&cron->mutex);
 }
-
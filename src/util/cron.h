@@ -6,7 +6,6 @@
 
 #pragma once
 
-#include "heap.h"
 #include <stdint.h>
 #include <stdbool.h>
 #include <sys/types.h>
@@ -16,6 +15,9 @@
 // when it should run; delta in ms from the time it's introduced
 // a callback to call when it is time to execute the task
 // and an optional private data passed to the callback
+//
+// tasks are kept in a hierarchical timing wheel with a resolution of 1ms
+// adding and aborting a task are constant time operations
 
 // task callback function
 typedef void (*CronTaskCB)(void *pdata);
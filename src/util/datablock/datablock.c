@@ -185,6 +185,15 @@ void *DataBlock_AllocateItem(DataBlock *dataBlock, uint64_t *idx) {
 	return ITEM_DATA(item_header);
 }
 
+uint64_t DataBlock_NextItemIdx(const DataBlock *dataBlock) {
+	ASSERT(dataBlock != NULL);
+
+	// same as DataBlock_AllocateItem, free indicies are reused first
+	uint deleted = array_len(dataBlock->deletedIdx);
+	if(deleted > 0) return dataBlock->deletedIdx[deleted - 1];
+	return dataBlock->itemCount;
+}
+
 void DataBlock_DeleteItem(DataBlock *dataBlock, uint64_t idx) {
 	ASSERT(dataBlock != NULL);
 	ASSERT(!_DataBlock_IndexOutOfBounds(dataBlock, idx));
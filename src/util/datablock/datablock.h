@@ -86,6 +86,9 @@ void *DataBlock_GetItem(const DataBlock *dataBlock, uint64_t idx);
 // return a pointer to the newly allocated item.
 void *DataBlock_AllocateItem(DataBlock *dataBlock, uint64_t *idx);
 
+// Returns the position the next allocated item will occupy.
+uint64_t DataBlock_NextItemIdx(const DataBlock *dataBlock);
+
 // Removes item at position idx.
 void DataBlock_DeleteItem(DataBlock *dataBlock, uint64_t idx);
 
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "histogram.h"
+#include "../RG.h"
+
+#include <math.h>
+
+// returns the bucket of a sample
+static inline uint _Histogram_Bucket
+(
+	double ms
+) {
+	double us = ms * 1000;
+	if(!(us >= 1)) return 0;  // also handles NaN
+
+	double b = 1 + floor(log2(us) * HISTOGRAM_SUB_BUCKETS);
+	return (b < HISTOGRAM_BUCKETS) ? (uint)b : HISTOGRAM_BUCKETS - 1;
+}
+
+// returns the upper bound of a bucket in milliseconds
+static inline double _Histogram_BucketUpperBound
+(
+	uint b
+) {
+	return exp2((double)b / HISTOGRAM_SUB_BUCKETS) / 1000;
+}
+
+void Histogram_Record
+(
+	Histogram *h,
+	double ms
+) {
+	ASSERT(h != NULL);
+
+	__atomic_add_fetch(h->buckets + _Histogram_Bucket(ms), 1, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&h->count, 1, __ATOMIC_RELAXED);
+}
+
+double Histogram_Percentile
+(
+	const Histogram *h,
+	double percentile
+) {
+	ASSERT(h != NULL);
+	ASSERT(percentile > 0 && percentile <= 100);
+
+	uint64_t count = __atomic_load_n(&h->count, __ATOMIC_RELAXED);
+	if(count == 0) return 0;
+
+	// number of samples at or below the percentile
+	uint64_t rank = ceil(count * percentile / 100);
+
+	uint64_t seen = 0;
+	for(uint b = 0; b < HISTOGRAM_BUCKETS; b++) {
+		seen += __atomic_load_n(h->buckets + b, __ATOMIC_RELAXED);
+		if(seen >= rank) return _Histogram_BucketUpperBound(b);
+	}
+
+	// concurrent updates might leave 'count' ahead of the buckets
+	return _Histogram_BucketUpperBound(HISTOGRAM_BUCKETS - 1);
+}
+
+void Histogram_Merge
+(
+	Histogram *dest,
+	const Histogram *src
+) {
+	ASSERT(src != NULL);
+	ASSERT(dest != NULL);
+
+	for(uint b = 0; b < HISTOGRAM_BUCKETS; b++) {
+		uint32_t n = __atomic_load_n(src->buckets + b, __ATOMIC_RELAXED);
+		if(n > 0) __atomic_add_fetch(dest->buckets + b, n, __ATOMIC_RELAXED);
+	}
+	__atomic_add_fetch(&dest->count, __atomic_load_n(&src->count,
+				__ATOMIC_RELAXED), __ATOMIC_RELAXED);
+}
+
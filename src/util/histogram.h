@@ -0,0 +1,51 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Histogram counts latency samples in logarithmic buckets
+// each power of 2 microseconds is split into HISTOGRAM_SUB_BUCKETS buckets
+// such that a reported percentile is at most ~19% above the recorded value
+//
+// bucket 0 holds samples under 1 microsecond, bucket b > 0 holds samples
+// in the range [2^((b-1)/4), 2^(b/4)) microseconds, the last bucket
+// also holds all samples above its range (over ~1 hour)
+//
+// samples are recorded using atomic operations, a histogram can be updated
+// by multiple threads concurrently without additional synchronization
+
+#define HISTOGRAM_SUB_BUCKETS 4
+#define HISTOGRAM_BUCKETS 128
+
+typedef struct {
+	uint64_t count;                       // number of samples
+	uint32_t buckets[HISTOGRAM_BUCKETS];  // number of samples in each bucket
+} Histogram;
+
+// record a sample
+void Histogram_Record
+(
+	Histogram *h,  // histogram to update
+	double ms      // sample value in milliseconds
+);
+
+// returns the value in milliseconds below which 'percentile' of the samples
+// fall, 0 if the histogram is empty
+double Histogram_Percentile
+(
+	const Histogram *h,  // histogram
+	double percentile    // percentile in the range (0, 100]
+);
+
+// add the samples of 'src' to 'dest'
+void Histogram_Merge
+(
+	Histogram *dest,      // histogram to update
+	const Histogram *src  // histogram to add
+);
+
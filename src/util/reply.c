@@ -0,0 +1,22 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include <stdio.h>
+
+#include "./reply.h"
+
+void Reply_WithRoundedDouble
+(
+	RedisModuleCtx *ctx,
+	double d
+) {
+	// get length required to print number
+	int len = snprintf(NULL, 0, "%.5g", d);
+	char str[len + 1];
+	sprintf(str, "%.5g", d);
+	// output string-formatted number
+	RedisModule_ReplyWithStringBuffer(ctx, str, len);
+}
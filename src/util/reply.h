@@ -0,0 +1,18 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../redismodule.h"
+
+// Redis prints doubles with up to 17 digits of precision,
+// reply with a string formatted double of 5 significant digits instead
+// used by the statistics commands, e.g. GRAPH.SLOWLOG
+void Reply_WithRoundedDouble
+(
+	RedisModuleCtx *ctx,  // redis module context
+	double d              // value to reply with
+);
@@ -139,28 +139,30 @@ void ThreadPools_Resume
 int ThreadPools_AddWorkReader
 (
 	void (*function_p)(void *),
-	void *arg_p
+	void *arg_p,
+	uint64_t group
 ) {
 	ASSERT(_readers_thpool != NULL);
 
 	// make sure there's enough room in thread pool queue
 	if(thpool_queue_full(_readers_thpool)) return THPOOL_QUEUE_FULL;
 
-	return thpool_add_work(_readers_thpool, function_p, arg_p);
+	return thpool_add_group_work(_readers_thpool, function_p, arg_p, group);
 }
 
 // add task for writer thread
 int ThreadPools_AddWorkWriter
 (
 	void (*function_p)(void *),
-	void *arg_p
+	void *arg_p,
+	uint64_t group
 ) {
 	ASSERT(_writers_thpool != NULL);
 
 	// make sure there's enough room in thread pool queue
 	if(thpool_queue_full(_writers_thpool)) return THPOOL_QUEUE_FULL;
 
-	return thpool_add_work(_writers_thpool, function_p, arg_p);
+	return thpool_add_group_work(_writers_thpool, function_p, arg_p, group);
 }
 
 void ThreadPools_SetMaxPendingWork(uint64_t val) {
@@ -58,17 +58,21 @@ void ThreadPools_Resume
 );
 
 // adds a read task
+// pending tasks of different groups are served round-robin
 int ThreadPools_AddWorkReader
 (
-	void (*function_p)(void *),
-	void *arg_p
+	void (*function_p)(void *),  // task
+	void *arg_p,                 // task argument
+	uint64_t group               // task group, e.g. graph the task operates on
 );
 
 // add a write task
+// pending tasks of different groups are served round-robin
 int ThreadPools_AddWorkWriter
 (
-	void (*function_p)(void *),
-	void *arg_p
+	void (*function_p)(void *),  // task
+	void *arg_p,                 // task argument
+	uint64_t group               // task group, e.g. graph the task operates on
 );
 
 // sets the limit on max queued queries in each thread pool
@@ -39,6 +39,9 @@
 static volatile int threads_keepalive;
 static volatile int threads_on_hold;
 
+/* initial number of job group hash buckets, must be a power of 2 */
+#define JOBQUEUE_INITIAL_BUCKETS 64
+
 /* ========================== STRUCTURES ============================ */
 
 /* Binary semaphore */
@@ -53,13 +56,33 @@ typedef struct job {
 	struct job *prev;            /* pointer to previous job   */
 	void (*function)(void *arg); /* function pointer          */
 	void *arg;                   /* function's argument       */
+	uint64_t group;              /* group the job belongs to  */
 } job;
 
-/* Job queue */
+/* Pending jobs of a single group */
+typedef struct jobgroup {
+	struct jobgroup *next;       /* next group to be served   */
+	struct jobgroup *hnext;      /* next group in hash bucket */
+	uint64_t id;                 /* group id                  */
+	job *front;                  /* pointer to front of group */
+	job *rear;                   /* pointer to rear  of group */
+} jobgroup;
+
+/* Job queue
+ *
+ * Jobs are kept in per group FIFOs, groups with pending jobs form a
+ * round-robin list, each pull serves the front group and moves it to
+ * the rear of the list, such that groups share workers evenly
+ *
+ * pending groups are additionally hashed by their id, such that
+ * locating a job's group does not require walking the list */
 typedef struct jobqueue {
 	pthread_mutex_t rwmutex; 		/* used for queue r/w access */
-	job *front;              		/* pointer to front of queue */
-	job *rear;               		/* pointer to rear  of queue */
+	jobgroup *front;         		/* next group to serve       */
+	jobgroup *rear;          		/* last group to serve       */
+	jobgroup **buckets;             /* pending groups by id      */
+	uint32_t nbuckets;              /* number of buckets, pow 2  */
+	uint32_t ngroups;               /* number of pending groups  */
 	bsem *has_jobs;          		/* flag as binary semaphore  */
 	int len;                 		/* number of jobs in queue   */
 	uint64_t cap;                   /* capacity of the queue     */
@@ -92,7 +115,7 @@ static void thread_destroy(struct thread *thread_p);
 
 static int jobqueue_init(jobqueue *jobqueue_p);
 static void jobqueue_clear(jobqueue *jobqueue_p);
-static void jobqueue_push(jobqueue *jobqueue_p, struct job *newjob_p);
+static int jobqueue_push(jobqueue *jobqueue_p, struct job *newjob_p);
 static struct job *jobqueue_pull(jobqueue *jobqueue_p);
 static void jobqueue_destroy(jobqueue *jobqueue_p);
 
@@ -167,6 +190,12 @@ struct thpool_ *thpool_init(int num_threads, const char *name) {
 
 /* Add work to the thread pool */
 int thpool_add_work(thpool_* thpool_p, void (*function_p)(void *), void *arg_p) {
+	return thpool_add_group_work(thpool_p, function_p, arg_p, 0);
+}
+
+/* Add work associated with a group to the thread pool */
+int thpool_add_group_work(thpool_* thpool_p, void (*function_p)(void *),
+		void *arg_p, uint64_t group) {
 	job *newjob;
 
 	newjob = (struct job *)malloc(sizeof(struct job));
@@ -178,9 +207,14 @@ int thpool_add_work(thpool_* thpool_p, void (*function_p)(void *), void *arg_p)
 	/* add function and argument */
 	newjob->function = function_p;
 	newjob->arg = arg_p;
+	newjob->group = group;
 
 	/* add job to queue */
-	jobqueue_push(&thpool_p->jobqueue, newjob);
+	if(jobqueue_push(&thpool_p->jobqueue, newjob) == -1) {
+		err("thpool_add_work(): Could not allocate memory for job group\n");
+		free(newjob);
+		return -1;
+	}
 
 	return 0;
 }
@@ -408,9 +442,18 @@ static int jobqueue_init(jobqueue *jobqueue_p) {
 	jobqueue_p->len         =  0;
 	jobqueue_p->front       =  NULL;
 	jobqueue_p->rear        =  NULL;
+	jobqueue_p->ngroups     =  0;
+	jobqueue_p->nbuckets    =  JOBQUEUE_INITIAL_BUCKETS;
+
+	jobqueue_p->buckets = (struct jobgroup **)calloc(jobqueue_p->nbuckets,
+			sizeof(struct jobgroup *));
+	if(jobqueue_p->buckets == NULL) {
+		return -1;
+	}
 
 	jobqueue_p->has_jobs = (struct bsem *)malloc(sizeof(struct bsem));
 	if(jobqueue_p->has_jobs == NULL) {
+		free(jobqueue_p->buckets);
 		return -1;
 	}
 
@@ -435,55 +478,144 @@ static void jobqueue_clear(jobqueue *jobqueue_p) {
 	jobqueue_p->len = 0;
 }
 
-/* Add (allocated) job to queue */
-static void jobqueue_push(jobqueue *jobqueue_p, struct job *newjob) {
+/* Bucket of group id, ids are typically pointers hence the mixing */
+static inline uint32_t jobqueue_bucket(uint64_t id, uint32_t nbuckets) {
+	id ^= id >> 33;
+	id *= 0xff51afd7ed558ccdULL;
+	id ^= id >> 33;
+	return (uint32_t)(id & (nbuckets - 1));
+}
+
+/* Locate pending group by id, returns NULL if group has no pending jobs */
+static jobgroup *jobqueue_find_group(jobqueue *jobqueue_p, uint64_t id) {
+	jobgroup *group_p =
+		jobqueue_p->buckets[jobqueue_bucket(id, jobqueue_p->nbuckets)];
+	while(group_p != NULL && group_p->id != id) group_p = group_p->hnext;
+	return group_p;
+}
+
+/* Double the number of buckets, on failure the current buckets are kept */
+static void jobqueue_grow_buckets(jobqueue *jobqueue_p) {
+	uint32_t nbuckets = jobqueue_p->nbuckets * 2;
+	jobgroup **buckets = (struct jobgroup **)calloc(nbuckets,
+			sizeof(struct jobgroup *));
+	if(buckets == NULL) return;
+
+	for(uint32_t i = 0; i < jobqueue_p->nbuckets; i++) {
+		jobgroup *group_p = jobqueue_p->buckets[i];
+		while(group_p != NULL) {
+			jobgroup *hnext = group_p->hnext;
+			uint32_t b = jobqueue_bucket(group_p->id, nbuckets);
+			group_p->hnext = buckets[b];
+			buckets[b] = group_p;
+			group_p = hnext;
+		}
+	}
+
+	free(jobqueue_p->buckets);
+	jobqueue_p->buckets = buckets;
+	jobqueue_p->nbuckets = nbuckets;
+}
+
+/* Track group as pending */
+static void jobqueue_hash_group(jobqueue *jobqueue_p, jobgroup *group_p) {
+	if(jobqueue_p->ngroups >= jobqueue_p->nbuckets) {
+		jobqueue_grow_buckets(jobqueue_p);
+	}
+
+	uint32_t b = jobqueue_bucket(group_p->id, jobqueue_p->nbuckets);
+	group_p->hnext = jobqueue_p->buckets[b];
+	jobqueue_p->buckets[b] = group_p;
+	jobqueue_p->ngroups++;
+}
+
+/* Stop tracking group, once it has no more pending jobs */
+static void jobqueue_unhash_group(jobqueue *jobqueue_p, jobgroup *group_p) {
+	jobgroup **link =
+		jobqueue_p->buckets + jobqueue_bucket(group_p->id, jobqueue_p->nbuckets);
+	while(*link != group_p) link = &(*link)->hnext;
+	*link = group_p->hnext;
+	jobqueue_p->ngroups--;
+}
+
+/* Append group to the rear of the round-robin list */
+static void jobqueue_append_group(jobqueue *jobqueue_p, jobgroup *group_p) {
+	group_p->next = NULL;
+	if(jobqueue_p->rear == NULL) {
+		jobqueue_p->front = group_p;
+	} else {
+		jobqueue_p->rear->next = group_p;
+	}
+	jobqueue_p->rear = group_p;
+}
+
+/* Add (allocated) job to queue
+ *
+ * returns -1 if a new group could not be allocated, 0 otherwise */
+static int jobqueue_push(jobqueue *jobqueue_p, struct job *newjob) {
 	newjob->prev = NULL;
 
 	pthread_mutex_lock(&jobqueue_p->rwmutex);
 
-	switch(jobqueue_p->len) {
-		case 0: /* no jobs in queue */
-			jobqueue_p->front = newjob;
-			jobqueue_p->rear = newjob;
-			break;
-		default: /* jobs in queue */
-			jobqueue_p->rear->prev = newjob;
-			jobqueue_p->rear = newjob;
+	/* locate job's group, only groups with pending jobs are tracked */
+	jobgroup *group_p = jobqueue_find_group(jobqueue_p, newjob->group);
+
+	if(group_p == NULL) { /* no pending jobs in group */
+		group_p = (struct jobgroup *)malloc(sizeof(struct jobgroup));
+		if(group_p == NULL) {
+			pthread_mutex_unlock(&jobqueue_p->rwmutex);
+			return -1;
+		}
+		group_p->id = newjob->group;
+		group_p->front = newjob;
+		group_p->rear = newjob;
+		jobqueue_hash_group(jobqueue_p, group_p);
+		jobqueue_append_group(jobqueue_p, group_p);
+	} else { /* jobs in group */
+		group_p->rear->prev = newjob;
+		group_p->rear = newjob;
 	}
 
 	jobqueue_p->len++;
 	bsem_post(jobqueue_p->has_jobs);
 
 	pthread_mutex_unlock(&jobqueue_p->rwmutex);
+	return 0;
 }
 
-/* Get first job from queue(removes it from queue)
+/* Get next job from queue(removes it from queue)
  *
- * Notice: Caller MUST hold a mutex
+ * the job is taken from the front group, which is then moved to the
+ * rear of the round-robin list, or discarded if it has no more jobs
  */
 static struct job *jobqueue_pull(jobqueue *jobqueue_p) {
 
 	pthread_mutex_lock(&jobqueue_p->rwmutex);
-	job *job_p = jobqueue_p->front;
 
-	switch(jobqueue_p->len) {
+	jobgroup *group_p = jobqueue_p->front;
+	if(group_p == NULL) { /* if no jobs in queue */
+		pthread_mutex_unlock(&jobqueue_p->rwmutex);
+		return NULL;
+	}
 
-	case 0: /* if no jobs in queue */
-		break;
+	job *job_p = group_p->front;
+	group_p->front = job_p->prev;
 
-	case 1: /* if one job in queue */
-		jobqueue_p->front = NULL;
-		jobqueue_p->rear = NULL;
-		jobqueue_p->len = 0;
-		break;
+	/* detach group from the front of the list */
+	jobqueue_p->front = group_p->next;
+	if(jobqueue_p->front == NULL) jobqueue_p->rear = NULL;
 
-	default: /* if >1 jobs in queue */
-		jobqueue_p->front = job_p->prev;
-		jobqueue_p->len--;
-		/* more than one job in queue -> post it */
-		bsem_post(jobqueue_p->has_jobs);
+	if(group_p->front == NULL) {
+		jobqueue_unhash_group(jobqueue_p, group_p);
+		free(group_p);
+	} else {
+		jobqueue_append_group(jobqueue_p, group_p);
 	}
 
+	jobqueue_p->len--;
+	/* more jobs in queue -> post it */
+	if(jobqueue_p->len > 0) bsem_post(jobqueue_p->has_jobs);
+
 	pthread_mutex_unlock(&jobqueue_p->rwmutex);
 	return job_p;
 }
@@ -492,6 +624,7 @@ static struct job *jobqueue_pull(jobqueue *jobqueue_p) {
 static void jobqueue_destroy(jobqueue *jobqueue_p) {
 	jobqueue_clear(jobqueue_p);
 	free(jobqueue_p->has_jobs);
+	free(jobqueue_p->buckets);
 }
 
 /* ======================== SYNCHRONISATION ========================= */
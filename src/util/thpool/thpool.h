@@ -12,6 +12,7 @@ extern "C" {
 #endif
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <sys/types.h>
 
 /* =================================== API ======================================= */
@@ -71,6 +72,24 @@ threadpool thpool_init(int num_threads, const char *name);
 int thpool_add_work(threadpool, void (*function_p)(void*), void* arg_p);
 
 
+/**
+ * @brief Add work associated with a group to the job queue
+ *
+ * Jobs of the same group are served in the order they were added,
+ * pending groups are served round-robin, one job at a time, such that
+ * a burst of jobs from one group does not starve jobs of other groups.
+ * Jobs added via thpool_add_work belong to group 0.
+ *
+ * @param  threadpool    threadpool to which the work will be added
+ * @param  function_p    pointer to function to add as work
+ * @param  arg_p         pointer to an argument
+ * @param  group         group the job belongs to
+ * @return 0 on successs -1 otherwise
+ */
+int thpool_add_group_work(threadpool, void (*function_p)(void*), void* arg_p,
+		uint64_t group);
+
+
 /**
  * @brief Wait for all queued jobs to finish
  *
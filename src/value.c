@@ -14,6 +14,7 @@
 #include <stdio.h>
 #include <ctype.h>
 #include <sys/param.h>
+#include "util/arena.h"
 #include "util/rmalloc.h"
 #include "datatypes/map.h"
 #include "datatypes/array.h"
@@ -111,6 +112,21 @@ SIValue SI_TransferStringVal(char *s) {
 	};
 }
 
+SIValue SI_TransientStringBuffer(size_t len) {
+	Arena *arena = Arena_GetActive();
+	if(arena == NULL) return SI_TransferStringVal(rm_malloc(len));
+
+	// the arena owns the buffer, which remains valid until the arena rewinds
+	return SI_ConstStringVal(Arena_Alloc(arena, len));
+}
+
+SIValue SI_TransientStringVal(const char *s) {
+	size_t len = strlen(s) + 1;
+	SIValue v = SI_TransientStringBuffer(len);
+	memcpy(v.stringval, s, len);
+	return v;
+}
+
 SIValue SI_Point(float latitude, float longitude) {
 	return (SIValue) {
 		.type = T_POINT, .allocation = M_NONE,
@@ -371,12 +387,22 @@ void SIValue_StringJoin(SIValue *strings, unsigned int string_count, const char
 
 // assumption: either a or b is a string
 static SIValue SIValue_ConcatString(const SIValue a, const SIValue b) {
+	if(a.type == T_STRING && b.type == T_STRING) {
+		// both operands are strings, concatenate directly into the result
+		size_t a_len = strlen(a.stringval);
+		size_t b_len = strlen(b.stringval);
+		SIValue result = SI_TransientStringBuffer(a_len + b_len + 1);
+		memcpy(result.stringval, a.stringval, a_len);
+		memcpy(result.stringval + a_len, b.stringval, b_len + 1);
+		return result;
+	}
+
 	size_t bufferLen = 512;
 	size_t argument_len = 0;
 	char *buffer = rm_calloc(bufferLen, sizeof(char));
 	SIValue args[2] = {a, b};
 	SIValue_StringJoin(args, 2, "", &buffer, &bufferLen, &argument_len);
-	SIValue result = SI_DuplicateStringVal(buffer);
+	SIValue result = SI_TransientStringVal(buffer);
 	rm_free(buffer);
 	return result;
 }
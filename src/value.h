@@ -119,6 +119,15 @@ SIValue SI_ConstStringVal(const char *s);
 // Don't duplicate input string, but assume ownership.
 SIValue SI_TransferStringVal(char *s);
 
+// Create a string value holding an uninitialized buffer of 'len' bytes.
+// Intermediate values produced during evaluation draw the buffer from the
+// thread's active arena, in which case the value does not own it,
+// otherwise the buffer is heap allocated and owned by the value.
+SIValue SI_TransientStringBuffer(size_t len);
+
+// Duplicate the input string into a transient string value.
+SIValue SI_TransientStringVal(const char *s);
+
 /* Functions for copying and guaranteeing memory safety for SIValues. */
 // SI_ShareValue creates an SIValue that shares all of the original's allocations.
 SIValue SI_ShareValue(const SIValue v);
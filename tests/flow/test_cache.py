@@ -1,4 +1,5 @@
 from RLTest import Env
+from redis import ResponseError
 from redisgraph import Graph, Node, Edge
 
 from base import FlowTestsBase
@@ -25,15 +26,16 @@ class testCache(FlowTestsBase):
 
     def test_sanity_check(self):
         graph = Graph('Cache_Sanity_Check', redis_con)
+        # literals are parameterized, vary the queried label
         for i in range(CACHE_SIZE + 1):
-            result = graph.query("MATCH (n) WHERE n.value = {val} RETURN n".format(val=i))
+            result = graph.query("MATCH (n:L{val}) RETURN n".format(val=i))
             self.env.assertFalse(result.cached_execution)
         
         for i in range(1,CACHE_SIZE + 1):
-            result = graph.query("MATCH (n) WHERE n.value = {val} RETURN n".format(val=i))
+            result = graph.query("MATCH (n:L{val}) RETURN n".format(val=i))
             self.env.assertTrue(result.cached_execution)
         
-        result = graph.query("MATCH (n) WHERE n.value = 0 RETURN n")
+        result = graph.query("MATCH (n:L0) RETURN n")
         self.env.assertFalse(result.cached_execution)
 
         graph.delete()
@@ -245,3 +247,110 @@ class testCache(FlowTestsBase):
         cached_result = graph.query(query, params)
         self.env.assertEqual(expected_result, cached_result.result_set)
         self.env.assertTrue(cached_result.cached_execution)
+
+    def test13_test_literal_parameterization(self):
+        # queries differing only by their literal values share a cached plan
+        graph = Graph('Cache_Test_Literals', redis_con)
+        graph.query("CREATE (:N {v: 1, s: 'a'}), (:N {v: 2, s: 'b'})")
+
+        uncached_result = graph.query("MATCH (n:N) WHERE n.v = 1 RETURN n.s AS s")
+        cached_result = graph.query("MATCH (n:N) WHERE n.v = 2 RETURN n.s AS s")
+        self.env.assertFalse(uncached_result.cached_execution)
+        self.env.assertTrue(cached_result.cached_execution)
+        self.env.assertEqual([['a']], uncached_result.result_set)
+        self.env.assertEqual([['b']], cached_result.result_set)
+
+        # string literals are bound as well
+        result = graph.query("MATCH (n:N) WHERE n.s = 'a' RETURN n.v AS v")
+        self.env.assertFalse(result.cached_execution)
+        self.env.assertEqual([[1]], result.result_set)
+        result = graph.query("MATCH (n:N) WHERE n.s = 'b' RETURN n.v AS v")
+        self.env.assertTrue(result.cached_execution)
+        self.env.assertEqual([[2]], result.result_set)
+
+        # literals of a different type are cached separately
+        result = graph.query("MATCH (n:N) WHERE n.v = 2.0 RETURN n.s AS s")
+        self.env.assertFalse(result.cached_execution)
+        self.env.assertEqual([['b']], result.result_set)
+
+        # unaliased projections keep their literals, column names are unchanged
+        result = graph.query("RETURN 1, 'a' AS x")
+        self.env.assertEqual(['1', 'x'], [c[1] for c in result.header])
+        self.env.assertEqual([[1, 'a']], result.result_set)
+        result = graph.query("RETURN 1, 'b' AS x")
+        self.env.assertTrue(result.cached_execution)
+        self.env.assertEqual([[1, 'b']], result.result_set)
+
+        # variable-length traversal bounds are not parameterized
+        graph.query("MATCH (a:N {v: 1}), (b:N {v: 2}) CREATE (a)-[:R]->(b)")
+        result = graph.query("MATCH (a:N)-[*1..1]->(b) RETURN count(b) AS c")
+        self.env.assertEqual([[1]], result.result_set)
+        result = graph.query("MATCH (a:N)-[*2..2]->(b) RETURN count(b) AS c")
+        self.env.assertFalse(result.cached_execution)
+        self.env.assertEqual([[0]], result.result_set)
+
+        graph.delete()
+
+    def test14_test_literal_parameterization_validation(self):
+        graph = Graph('Cache_Test_Literals_Validation', redis_con)
+
+        # SKIP and LIMIT literals of an invalid type are rejected
+        queries = {"UNWIND [1, 2] AS x RETURN x LIMIT 1.5": "LIMIT specified value of invalid type",
+                   "UNWIND [1, 2] AS x RETURN x SKIP 'a'": "SKIP specified value of invalid type"}
+        for q, err in queries.items():
+            try:
+                graph.query(q)
+                self.env.assertTrue(False)
+            except ResponseError as e:
+                self.env.assertIn(err, str(e))
+
+        # integer SKIP and LIMIT literals share a cached plan
+        result = graph.query("UNWIND [1, 2, 3] AS x RETURN x SKIP 1 LIMIT 1")
+        self.env.assertEqual([[2]], result.result_set)
+        result = graph.query("UNWIND [1, 2, 3] AS x RETURN x SKIP 2 LIMIT 1")
+        self.env.assertTrue(result.cached_execution)
+        self.env.assertEqual([[3]], result.result_set)
+
+        # keywords used as property keys and string operators
+        graph.query("CREATE (:N {limit: 'ab'})")
+        result = graph.query("MATCH (n:N) WHERE n.limit STARTS WITH 'a' RETURN n.limit AS l")
+        self.env.assertEqual([['ab']], result.result_set)
+        result = graph.query("MATCH (n:N) WHERE n.limit STARTS WITH 'b' RETURN n.limit AS l")
+        self.env.assertTrue(result.cached_execution)
+        self.env.assertEqual([], result.result_set)
+
+        graph.delete()
+
+    def test15_test_skip_limit_spare_plans(self):
+        # spare plans are cloned after an execution completes
+        # SKIP and LIMIT values must be taken from the executing query
+        # rather than from the query the spare was cloned after
+        graph = Graph('Cache_Test_Spare_Skip_Limit', redis_con)
+        graph.query("UNWIND range(0, 9) AS x CREATE (:N {v: x})")
+
+        queries = [("MATCH (n:N) RETURN n.v AS v ORDER BY v SKIP 0 LIMIT 5", [[0], [1], [2], [3], [4]]),
+                   ("MATCH (n:N) RETURN n.v AS v ORDER BY v SKIP 2 LIMIT 1", [[2]]),
+                   ("MATCH (n:N) RETURN n.v AS v ORDER BY v SKIP 7 LIMIT 9", [[7], [8], [9]]),
+                   ("MATCH (n:N) RETURN n.v AS v ORDER BY v SKIP 0 LIMIT 0", []),
+                   ("MATCH (n:N) RETURN n.v AS v ORDER BY v SKIP 4 LIMIT 2", [[4], [5]])]
+
+        # run each query a number of times such that spare plans are used
+        for i in range(3):
+            for q, expected in queries:
+                result = graph.query(q)
+                self.env.assertEqual(expected, result.result_set)
+
+        # parameterized values are validated on every execution
+        q = "UNWIND [1, 2, 3] AS x RETURN x SKIP $s LIMIT $l"
+        result = graph.query(q, {'s': 1, 'l': 1})
+        self.env.assertEqual([[2]], result.result_set)
+        try:
+            graph.query(q, {'s': 1, 'l': -1})
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("Limit operates only on non-negative integers", str(e))
+        result = graph.query(q, {'s': 2, 'l': 1})
+        self.env.assertTrue(result.cached_execution)
+        self.env.assertEqual([[3]], result.result_set)
+
+        graph.delete()
@@ -1,5 +1,6 @@
 import os
 import sys
+import time
 import redis
 from RLTest import Env
 from redisgraph import Graph
@@ -206,7 +207,10 @@ class testConfig(FlowTestsBase):
         # TIMEOUT
         # QUERY_MEM_CAPACITY
         # DELTA_MAX_PENDING_CHANGES
+        # DELTA_FLUSH_INTERVAL
         # RESULTSET_SIZE
+        # NATIVE_INDEX
+        # EFFECTS_REPLICATION
 
         # Validate that attempting to set these configurations to
         # invalid values fails
@@ -220,7 +224,8 @@ class testConfig(FlowTestsBase):
 
         # TIMEOUT, QUERY_MEM_CAPACITY, and DELTA_MAX_PENDING_CHANGES must be
         # non-negative values, 0 resets to default
-        for config in ["TIMEOUT", "QUERY_MEM_CAPACITY", "DELTA_MAX_PENDING_CHANGES"]:
+        for config in ["TIMEOUT", "QUERY_MEM_CAPACITY", "DELTA_MAX_PENDING_CHANGES",
+                       "DELTA_FLUSH_INTERVAL"]:
             try:
                 redis_con.execute_command("GRAPH.CONFIG SET %s -1" % config)
                 assert(False)
@@ -230,7 +235,8 @@ class testConfig(FlowTestsBase):
 
         # No configuration can be set to a string
         for config in ["MAX_QUEUED_QUERIES", "TIMEOUT", "QUERY_MEM_CAPACITY",
-                       "DELTA_MAX_PENDING_CHANGES", "RESULTSET_SIZE"]:
+                       "DELTA_MAX_PENDING_CHANGES", "DELTA_FLUSH_INTERVAL",
+                       "RESULTSET_SIZE", "NATIVE_INDEX", "EFFECTS_REPLICATION"]:
             try:
                 redis_con.execute_command("GRAPH.CONFIG SET %s invalid" % config)
                 assert(False)
@@ -272,3 +278,161 @@ class testConfig(FlowTestsBase):
         expected_response = ["NODE_CREATION_BUFFER", 1024]
         self.env.assertEqual(creation_buffer_size, expected_response)
 
+    def test12_set_get_delta_flush_interval(self):
+        config_name = "DELTA_FLUSH_INTERVAL"
+        graph = Graph("delta_flush", redis_con)
+
+        # background flushing is enabled by default
+        response = redis_con.execute_command("GRAPH.CONFIG GET " + config_name)
+        expected_response = [config_name, 1000]
+        self.env.assertEqual(response, expected_response)
+
+        # with background flushing disabled, pending changes remain
+        response = redis_con.execute_command("GRAPH.CONFIG SET %s %d" % (config_name, 0))
+        self.env.assertEqual(response, "OK")
+
+        graph.query("UNWIND range(1, 100) AS x CREATE (:F {v:x})-[:R]->(:F {v:x})")
+        pending = redis_con.execute_command("GRAPH.DEBUG", "PENDING", "delta_flush")
+        self.env.assertEqual(pending, 1)
+
+        # flush frequently, pending changes are merged in the background
+        response = redis_con.execute_command("GRAPH.CONFIG SET %s %d" % (config_name, 1))
+        self.env.assertEqual(response, "OK")
+
+        # a disabled flush checks back every second
+        for i in range(50):
+            pending = redis_con.execute_command("GRAPH.DEBUG", "PENDING", "delta_flush")
+            if pending == 0:
+                break
+            time.sleep(0.1)
+        self.env.assertEqual(pending, 0)
+
+        # flushing doesn't affect query results
+        for i in range(9):
+            graph.query("UNWIND range(1, 100) AS x CREATE (:F {v:x})-[:R]->(:F {v:x})")
+        result = graph.query("MATCH (:F)-[:R]->(b:F) RETURN count(b)")
+        self.env.assertEqual(result.result_set[0][0], 1000)
+
+        # disable background flushing
+        response = redis_con.execute_command("GRAPH.CONFIG SET %s %d" % (config_name, 0))
+        self.env.assertEqual(response, "OK")
+
+        response = redis_con.execute_command("GRAPH.CONFIG GET " + config_name)
+        expected_response = [config_name, 0]
+        self.env.assertEqual(response, expected_response)
+
+    def test13_set_get_native_index(self):
+        config_name = "NATIVE_INDEX"
+        graph = Graph("native_index", redis_con)
+
+        # native indices are disabled by default
+        response = redis_con.execute_command("GRAPH.CONFIG GET " + config_name)
+        expected_response = [config_name, 0]
+        self.env.assertEqual(response, expected_response)
+
+        response = redis_con.execute_command("GRAPH.CONFIG SET %s yes" % config_name)
+        self.env.assertEqual(response, "OK")
+
+        response = redis_con.execute_command("GRAPH.CONFIG GET " + config_name)
+        expected_response = [config_name, 1]
+        self.env.assertEqual(response, expected_response)
+
+        # indices created from now on are native
+        graph.query("CREATE INDEX ON :N(v)")
+        graph.query("UNWIND range(1, 10) AS x CREATE (:N {v:x})")
+        result = graph.query("MATCH (n:N) WHERE n.v = 5 RETURN n.v")
+        self.env.assertEqual(result.result_set, [[5]])
+
+        response = redis_con.execute_command("GRAPH.CONFIG SET %s no" % config_name)
+        self.env.assertEqual(response, "OK")
+
+        # an index keeps its backing store across reloads
+        # regardless of the configuration
+        redis_con.execute_command("DEBUG", "RELOAD")
+        result = graph.query("CALL db.indexes() YIELD label, info WHERE label = 'N' RETURN info")
+        self.env.assertEqual(result.result_set[0][0]['provider'], 'native')
+        result = graph.query("MATCH (n:N) WHERE n.v = 5 RETURN n.v")
+        self.env.assertEqual(result.result_set, [[5]])
+
+    def test14_set_get_max_queries_per_graph(self):
+        config_name = "MAX_QUERIES_PER_GRAPH"
+        graph = Graph("max_queries", redis_con)
+
+        # number of queries per graph is unlimited by default
+        response = redis_con.execute_command("GRAPH.CONFIG GET " + config_name)
+        expected_response = [config_name, 0]
+        self.env.assertEqual(response, expected_response)
+
+        response = redis_con.execute_command("GRAPH.CONFIG SET %s %d" % (config_name, 1))
+        self.env.assertEqual(response, "OK")
+
+        response = redis_con.execute_command("GRAPH.CONFIG GET " + config_name)
+        expected_response = [config_name, 1]
+        self.env.assertEqual(response, expected_response)
+
+        # sequential queries release their admission once they complete
+        for i in range(5):
+            result = graph.query("RETURN %d" % i)
+            self.env.assertEqual(result.result_set[0][0], i)
+
+        # negative values are rejected
+        try:
+            redis_con.execute_command("GRAPH.CONFIG SET %s -1" % config_name)
+            assert(False)
+        except redis.exceptions.ResponseError as e:
+            assert("Failed to set config value %s to -1" % config_name in str(e))
+
+        # restore default
+        response = redis_con.execute_command("GRAPH.CONFIG SET %s %d" % (config_name, 0))
+        self.env.assertEqual(response, "OK")
+
+    def test15_set_get_spare_plans(self):
+        config_name = "SPARE_PLANS"
+        graph = Graph("spare_plans", redis_con)
+        graph.query("CREATE ()")
+        q = "MATCH (n) RETURN count(n)"
+
+        # a few spare plans are held per cached query by default
+        response = redis_con.execute_command("GRAPH.CONFIG GET " + config_name)
+        expected_response = [config_name, 4]
+        self.env.assertEqual(response, expected_response)
+
+        # a spare plan is cloned once a query replies
+        result = graph.query(q)
+        self.env.assertEqual(result.result_set, [[1]])
+        spares = redis_con.execute_command("GRAPH.DEBUG", "SPARES", "spare_plans", q)
+        self.env.assertEqual(spares, 1)
+
+        # each execution consumes a spare plan and replenishes it
+        for i in range(5):
+            result = graph.query(q)
+            self.env.assertEqual(result.result_set, [[1]])
+            spares = redis_con.execute_command("GRAPH.DEBUG", "SPARES", "spare_plans", q)
+            self.env.assertEqual(spares, 1)
+
+        # disable spare plans
+        response = redis_con.execute_command("GRAPH.CONFIG SET %s %d" % (config_name, 0))
+        self.env.assertEqual(response, "OK")
+
+        # the remaining spare plan is consumed and not replenished
+        for i in range(2):
+            result = graph.query(q)
+            self.env.assertEqual(result.result_set, [[1]])
+            spares = redis_con.execute_command("GRAPH.DEBUG", "SPARES", "spare_plans", q)
+            self.env.assertEqual(spares, 0)
+
+        # negative values are rejected
+        try:
+            redis_con.execute_command("GRAPH.CONFIG SET %s -1" % config_name)
+            assert(False)
+        except redis.exceptions.ResponseError as e:
+            assert("Failed to set config value %s to -1" % config_name in str(e))
+
+        # restore default
+        response = redis_con.execute_command("GRAPH.CONFIG SET %s %d" % (config_name, 4))
+        self.env.assertEqual(response, "OK")
+
+        result = graph.query(q)
+        self.env.assertEqual(result.result_set, [[1]])
+        spares = redis_con.execute_command("GRAPH.DEBUG", "SPARES", "spare_plans", q)
+        self.env.assertEqual(spares, 1)
@@ -0,0 +1,133 @@
+from RLTest import Env
+from redisgraph import Graph
+
+from base import FlowTestsBase
+
+GRAPH_ID = "effects_replication"
+
+# test to see if effects replication works as expected
+# with EFFECTS_REPLICATION enabled write queries are replicated by their
+# effects, replicas apply them via GRAPH.EFFECT and end up with the same graph
+# as the primary
+
+class testEffectsReplication(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True, env='oss', useSlaves=True,
+                       moduleArgs='EFFECTS_REPLICATION yes')
+
+        # skip test if we're running under Valgrind
+        if self.env.envRunner.debugger is not None:
+            self.env.skip() # valgrind is not working correctly with replication
+
+        self.source_con = self.env.getConnection()
+        self.replica_con = self.env.getSlaveConnection()
+
+        # enable write commands on slave, required as all RedisGraph
+        # commands are registered as write commands
+        self.replica_con.config_set("slave-read-only", "no")
+
+        self.graph = Graph(GRAPH_ID, self.source_con)
+        self.replica = Graph(GRAPH_ID, self.replica_con)
+
+    # count number of effects applied by replica
+    def effect_calls(self):
+        stats = self.replica_con.info('commandstats')
+        for k, v in stats.items():
+            if k.lower() == 'cmdstat_graph.effect':
+                return v['calls']
+        return 0
+
+    # make sure query yields the same result on both primary and replica
+    def assert_in_sync(self, q):
+        # give replica some time to catch up
+        self.source_con.execute_command("WAIT", 1, 0)
+
+        result = self.graph.query(q).result_set
+        replica_result = self.replica.query(q).result_set
+        self.env.assertEquals(replica_result, result)
+
+    def test01_config(self):
+        response = self.source_con.execute_command("GRAPH.CONFIG GET EFFECTS_REPLICATION")
+        self.env.assertEquals(response, ["EFFECTS_REPLICATION", 1])
+
+    def test02_create(self):
+        q = """UNWIND range(0, 9) AS x
+               CREATE (:L {id: x, name: 'n' + toString(x), vals: [x, 'a', 1.5],
+                           loc: point({latitude: x, longitude: 1.0})})-[:R {w: x}]->(:M:N {id: x})"""
+        self.graph.query(q)
+
+        self.assert_in_sync("MATCH (n) RETURN n ORDER BY n")
+        self.assert_in_sync("MATCH ()-[e]->() RETURN e ORDER BY e")
+        self.env.assertGreater(self.effect_calls(), 0)
+
+    def test03_update(self):
+        # set, update and remove attributes
+        self.graph.query("MATCH (n:L) WHERE n.id < 3 SET n.id = n.id + 100, n.new = true")
+        self.graph.query("MATCH (n:L {id: 5}) SET n.name = NULL")
+        self.graph.query("MATCH (n:L {id: 6}) SET n = {x: 1}")
+        self.graph.query("MATCH (n:L {id: 7}) SET n += {y: 2}")
+        self.graph.query("MATCH ()-[e:R]->() WHERE e.w > 5 SET e.w = -e.w")
+
+        self.assert_in_sync("MATCH (n) RETURN n ORDER BY n")
+        self.assert_in_sync("MATCH ()-[e]->() RETURN e ORDER BY e")
+
+    def test04_merge(self):
+        self.graph.query("MERGE (n:L {id: 100}) ON MATCH SET n.merged = 1")
+        self.graph.query("MERGE (n:L {id: 200}) ON CREATE SET n.merged = 2")
+        self.graph.query("MATCH (a:L {id: 200}), (b:M {id: 1}) MERGE (a)-[:R2]->(b)")
+
+        self.assert_in_sync("MATCH (n) RETURN n ORDER BY n")
+        self.assert_in_sync("MATCH ()-[e]->() RETURN e ORDER BY e")
+
+    def test05_index(self):
+        self.graph.query("CREATE INDEX ON :L(id)")
+        self.graph.query("CREATE INDEX FOR ()-[e:R]-() ON (e.w)")
+
+        self.assert_in_sync("CALL db.indexes()")
+
+        # updates are reflected in replica's index
+        self.graph.query("MATCH (n:L {id: 3}) SET n.id = 300")
+
+        q = "MATCH (n:L) WHERE n.id = 300 RETURN n.name"
+        replica_plan = self.replica.execution_plan(q)
+        self.env.assertIn("Index Scan", replica_plan)
+        self.assert_in_sync(q)
+
+        self.graph.query("DROP INDEX ON :R(w)")
+        self.assert_in_sync("CALL db.indexes()")
+
+    def test06_delete(self):
+        # explicit edge deletion
+        self.graph.query("MATCH ()-[e:R]->() WHERE e.w < 2 DELETE e")
+        # node deletion, implicitly deleting edges
+        self.graph.query("MATCH (n:M) WHERE n.id > 7 DELETE n")
+
+        self.assert_in_sync("MATCH (n) RETURN n ORDER BY n")
+        self.assert_in_sync("MATCH ()-[e]->() RETURN e ORDER BY e")
+
+        # deleted IDs are reused by both primary and replica
+        self.graph.query("CREATE (:L {id: 1000})-[:R {w: 1000}]->(:M {id: 1000})")
+        self.assert_in_sync("MATCH (n) RETURN ID(n), n ORDER BY ID(n)")
+        self.assert_in_sync("MATCH ()-[e]->() RETURN ID(e), e ORDER BY ID(e)")
+
+    def test07_fallback(self):
+        calls = self.effect_calls()
+
+        # procedures are replicated as queries
+        self.graph.query("CALL db.idx.fulltext.createNodeIndex('L', 'name')")
+        self.assert_in_sync("CALL db.indexes()")
+
+        self.env.assertEquals(self.effect_calls(), calls)
+
+    def test08_client_effects(self):
+        # effects are only accepted from the replication stream
+        # a well formed changelog creating a node
+        effects = "\x01\x04" + "\x00" * 8 + "\x00" * 8
+        for payload in ["\x07garbage", effects]:
+            try:
+                self.source_con.execute_command("GRAPH.EFFECT", GRAPH_ID, payload)
+                self.env.assertTrue(False)
+            except Exception as e:
+                self.env.assertIn("restricted to replication", str(e))
+
+        self.assert_in_sync("MATCH (n) RETURN count(n)")
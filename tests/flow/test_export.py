@@ -0,0 +1,187 @@
+import os
+import shutil
+import struct
+import tempfile
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+from redis import ResponseError
+
+GRAPH_ID = "export_test"
+MAGIC = b"RGCOLS01"
+EXPORT_ROOT = tempfile.mkdtemp()
+redis_con = None
+redis_graph = None
+
+# column types
+BOOL, INT64, DOUBLE, STRING, POINT, ARRAY = range(6)
+
+def read_column_file(path):
+    """read a column file, returns a list of rows, each a dict mapping
+    (column name, column type) to value"""
+    with open(path, "rb") as f:
+        data = f.read()
+
+    assert data[:8] == MAGIC
+    pos = 8
+    rows = []
+    row_groups = 0
+
+    while True:
+        row_count, = struct.unpack_from("<Q", data, pos)
+        pos += 8
+        if row_count == 0:
+            break
+
+        row_groups += 1
+        group = [dict() for _ in range(row_count)]
+        column_count, = struct.unpack_from("<I", data, pos)
+        pos += 4
+
+        for _ in range(column_count):
+            name_len, = struct.unpack_from("<I", data, pos)
+            pos += 4
+            name = data[pos:pos + name_len].decode()
+            pos += name_len
+            col_type = data[pos]
+            pos += 1
+            validity = data[pos:pos + (row_count + 7) // 8]
+            pos += (row_count + 7) // 8
+
+            if col_type in (STRING, ARRAY):
+                offsets = struct.unpack_from("<%dQ" % (row_count + 1), data, pos)
+                pos += 8 * (row_count + 1)
+                values = [data[pos + offsets[i]:pos + offsets[i + 1]].decode()
+                          for i in range(row_count)]
+                pos += offsets[-1]
+            elif col_type == POINT:
+                flat = struct.unpack_from("<%df" % (2 * row_count), data, pos)
+                values = list(zip(flat[0::2], flat[1::2]))
+                pos += 8 * row_count
+            else:
+                fmt = {BOOL: "B", INT64: "q", DOUBLE: "d"}[col_type]
+                size = struct.calcsize(fmt)
+                values = struct.unpack_from("<%d%s" % (row_count, fmt), data, pos)
+                pos += size * row_count
+                if col_type == BOOL:
+                    values = [bool(v) for v in values]
+
+            for i in range(row_count):
+                if validity[i // 8] & (1 << (i % 8)):
+                    group[i][(name, col_type)] = values[i]
+
+        rows.extend(group)
+
+    total_rows, group_count = struct.unpack_from("<QQ", data, pos)
+    pos += 16
+    assert data[pos:] == MAGIC
+    assert total_rows == len(rows)
+    assert group_count == row_groups
+
+    return rows
+
+class testExport(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True,
+                       moduleArgs='EXPORT_DIR %s' % EXPORT_ROOT)
+        global redis_con
+        global redis_graph
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+    def export(self, name):
+        res = redis_con.execute_command("GRAPH.EXPORT", GRAPH_ID, name)
+        return os.path.join(EXPORT_ROOT, name), dict(zip(res[0::2], res[1::2]))
+
+    def test01_export(self):
+        # export should fail when graph doesn't exists
+        try:
+            redis_con.execute_command("GRAPH.EXPORT", "NONE_EXISTING_GRAPH",
+                                      "none")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("Invalid graph operation on empty key", str(e))
+
+        redis_graph.query("""CREATE (a:A {v: 1, s: 'a', b: true}),
+                                    (b:A:B {v: 2.5, p: point({latitude: 1, longitude: 2})}),
+                                    (c {l: [1, 2]}),
+                                    (a)-[:R {w: 1}]->(b),
+                                    (a)-[:R {w: 2}]->(b),
+                                    (b)-[:S]->(c)""")
+
+        path, stats = self.export("export01")
+        self.env.assertEquals(stats["nodes"], 3)
+        self.env.assertEquals(stats["labels"], 3)
+        self.env.assertEquals(stats["edges"], 3)
+        self.env.assertFalse(os.path.exists(path + ".partial"))
+
+        # nodes, an attribute holding values of different types
+        # is stored in a column per type
+        nodes = read_column_file(os.path.join(path, "nodes.rgc"))
+        self.env.assertEquals(len(nodes), 3)
+        self.env.assertEquals(nodes[0], {("_id", INT64): 0, ("v", INT64): 1,
+                                         ("s", STRING): "a", ("b", BOOL): True})
+        self.env.assertEquals(nodes[1], {("_id", INT64): 1, ("v", DOUBLE): 2.5,
+                                         ("p", POINT): (1.0, 2.0)})
+        self.env.assertEquals(nodes[2], {("_id", INT64): 2, ("l", ARRAY): "[1, 2]"})
+
+        labels = read_column_file(os.path.join(path, "labels.rgc"))
+        labels = sorted((r[("_id", INT64)], r[("_label", STRING)]) for r in labels)
+        self.env.assertEquals(labels, [(0, "A"), (1, "A"), (1, "B")])
+
+        # multiple edges connecting the same nodes are all exported
+        edges = read_column_file(os.path.join(path, "edges.rgc"))
+        edges = sorted((r[("_type", STRING)], r[("_src", INT64)],
+                        r[("_dest", INT64)], r.get(("w", INT64))) for r in edges)
+        self.env.assertEquals(edges, [("R", 0, 1, 1), ("R", 0, 1, 2),
+                                      ("S", 1, 2, None)])
+
+    def test02_existing_path(self):
+        # export refuses to overwrite an existing path
+        try:
+            redis_con.execute_command("GRAPH.EXPORT", GRAPH_ID, "export01")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("already exists", str(e))
+
+    def test03_row_groups(self):
+        # rows are written in groups of 65536 rows
+        redis_graph.query("UNWIND range(1, 70000) AS x CREATE (:C {v: x})")
+
+        path, stats = self.export("export03")
+        self.env.assertEquals(stats["nodes"], 70003)
+
+        nodes = read_column_file(os.path.join(path, "nodes.rgc"))
+        self.env.assertEquals(len(nodes), 70003)
+        self.env.assertEquals(nodes[-1][("v", INT64)], 70000)
+
+    def test04_rejected_names(self):
+        # the export directory is reported by GRAPH.CONFIG
+        res = redis_con.execute_command("GRAPH.CONFIG", "GET", "EXPORT_DIR")
+        self.env.assertEquals(res, ["EXPORT_DIR", EXPORT_ROOT])
+
+        # the export directory can't be reconfigured at runtime
+        try:
+            redis_con.execute_command("GRAPH.CONFIG", "SET", "EXPORT_DIR", "/tmp")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("Field can not be re-configured", str(e))
+
+        # exports are confined to the export directory
+        outside = tempfile.mkdtemp()
+        names = ["", ".", "..", ".hidden", "../escape", "a/b",
+                 os.path.join(outside, "abs")]
+        for name in names:
+            try:
+                redis_con.execute_command("GRAPH.EXPORT", GRAPH_ID, name)
+                self.env.assertTrue(False)
+            except ResponseError as e:
+                self.env.assertIn("Export name must be a file name", str(e))
+
+        # nothing was written outside of the export directory
+        self.env.assertEquals(os.listdir(outside), [])
+        self.env.assertFalse(os.path.exists(os.path.join(EXPORT_ROOT, "..", "escape")))
+
+        shutil.rmtree(outside, ignore_errors=True)
+        shutil.rmtree(EXPORT_ROOT, ignore_errors=True)
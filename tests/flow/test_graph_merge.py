@@ -575,3 +575,26 @@ class testGraphMergeFlow(FlowTestsBase):
         except redis.exceptions.ResponseError as e:
             # Expecting an error.
             self.env.assertIn("undefined property", str(e))
+
+    def test28_merge_on_create_retains_projected_properties(self):
+        redis_con = self.env.getConnection()
+        graph = Graph("merge_on_create_scalars", redis_con)
+
+        graph.query("CREATE ({name: 'a'}), ({name: 'b'})")
+
+        # ON CREATE repacks n's properties while nm refers to n.name
+        query = """MATCH (n) WITH n, n.name AS nm
+                   MERGE (n)-[:R]->(:M)
+                   ON CREATE SET n.x = 1
+                   RETURN nm ORDER BY nm"""
+        result = graph.query(query)
+        self.env.assertEquals(result.result_set, [['a'], ['b']])
+        self.env.assertEquals(result.properties_set, 2)
+
+        # same when the projected property itself is updated
+        query = """MATCH (n) WHERE n.name IS NOT NULL WITH n, n.name AS nm
+                   MERGE (n)-[:S]->(:M)
+                   ON CREATE SET n.name = 'updated'
+                   RETURN nm ORDER BY nm"""
+        result = graph.query(query)
+        self.env.assertEquals(result.result_set, [['a'], ['b']])
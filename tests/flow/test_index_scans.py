@@ -605,3 +605,54 @@ class testIndexScanFlow():
         result = redis_graph.query("CALL db.idx.fulltext.queryNodes('User', 'stop')")
         self.env.assertEquals(result.result_set, [])
 
+
+    def test21_index_restricted_traversal_destination(self):
+        # traversal destination filtered by an indexed attribute
+        query = """MATCH (p:person)-[:friend]->(f:person) WHERE f.age > 30 AND f.age <= 40
+                   RETURN p.name, f.name ORDER BY p.name, f.name"""
+        indexed_result = redis_graph.query(query)
+
+        # same query, filter can't be resolved by index
+        query = """MATCH (p:person)-[:friend]->(f:person) WHERE f.age + 0 > 30 AND f.age + 0 <= 40
+                   RETURN p.name, f.name ORDER BY p.name, f.name"""
+        unindexed_result = redis_graph.query(query)
+
+        self.env.assertGreater(len(indexed_result.result_set), 0)
+        self.env.assertEquals(indexed_result.result_set, unindexed_result.result_set)
+
+        # destination filter referring to the traversal source
+        query = """MATCH (p:person)-[:friend]->(f:person) WHERE f.age = p.age
+                   RETURN p.name, f.name ORDER BY p.name, f.name"""
+        indexed_result = redis_graph.query(query)
+
+        query = """MATCH (p:person)-[:friend]->(f:person) WHERE f.age + 0 = p.age
+                   RETURN p.name, f.name ORDER BY p.name, f.name"""
+        unindexed_result = redis_graph.query(query)
+        self.env.assertEquals(indexed_result.result_set, unindexed_result.result_set)
+
+        # the index restricts the traversal only when it reports few nodes
+        g = Graph('dest_index', self.env.getConnection())
+        g.query("CREATE INDEX ON :Q(v, g)")
+        g.query("UNWIND range(0, 99) AS x CREATE (:Q {v: x, g: x % 2})-[:R]->(:Q {v: x + 100, g: x % 2})")
+
+        # a unique value matches a single node
+        query = "MATCH (a:Q)-[:R]->(b:Q) WHERE b.v = 105 RETURN a.v"
+        plan = g.execution_plan(query)
+        traverse = [l for l in plan.split('\n') if 'Conditional Traverse' in l]
+        self.env.assertEquals(len(traverse), 1)
+        self.env.assertIn('Index :Q', traverse[0])
+        self.env.assertEquals(g.query(query).result_set, [[5]])
+
+        # half of the nodes share a value
+        query = "MATCH (a:Q)-[:R]->(b:Q) WHERE b.g = 1 RETURN count(a)"
+        plan = g.execution_plan(query)
+        self.env.assertIn('Conditional Traverse', plan)
+        self.env.assertNotIn('Index :Q', plan)
+        self.env.assertEquals(g.query(query).result_set, [[50]])
+
+        # a range over unknown values is estimated once its value is known
+        query = "MATCH (a:Q)-[:R]->(b:Q) WHERE b.v >= $min RETURN count(a)"
+        self.env.assertEquals(g.query(query, {'min': 198}).result_set, [[2]])
+        self.env.assertEquals(g.query(query, {'min': 0}).result_set, [[100]])
+
+        g.delete()
@@ -0,0 +1,225 @@
+import os
+import sys
+from RLTest import Env
+from redisgraph import Graph, Node, Edge
+from base import FlowTestsBase
+
+GRAPH_ID = "native_index"
+redis_con = None
+redis_graph = None
+
+class testNativeIndex(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True, moduleArgs='NATIVE_INDEX yes')
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # values of mixed types
+        redis_graph.query("UNWIND range(0, 99) AS x CREATE (:P {v:x, s:toString(x % 10)})")
+        redis_graph.query("CREATE (:P {v:2.5}), (:P {v:'str'}), (:P {v:true}), (:P {v:[1,2]}), (:P)")
+        redis_graph.query("CREATE INDEX ON :P(v)")
+        redis_graph.query("CREATE INDEX ON :P(s)")
+
+    def compare_to_label_scan(self, query, label='P'):
+        # run query using the native index
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn('Node By Index Scan', plan)
+        indexed = redis_graph.query(query).result_set
+
+        # run query without the index
+        unindexed_query = query.replace("(p:%s)" % label, "(p)")
+        plan = redis_graph.execution_plan(unindexed_query)
+        self.env.assertNotIn('Node By Index Scan', plan)
+        unindexed = redis_graph.query(unindexed_query).result_set
+
+        self.env.assertEquals(indexed, unindexed)
+        return indexed
+
+    def test01_equality(self):
+        result = self.compare_to_label_scan("MATCH (p:P) WHERE p.v = 5 RETURN p.v")
+        self.env.assertEquals(result, [[5]])
+
+        # integers and floats share an order
+        result = self.compare_to_label_scan("MATCH (p:P) WHERE p.v = 5.0 RETURN p.v")
+        self.env.assertEquals(result, [[5]])
+
+        result = self.compare_to_label_scan("MATCH (p:P) WHERE p.v = 'str' RETURN p.v")
+        self.env.assertEquals(result, [['str']])
+
+        result = self.compare_to_label_scan("MATCH (p:P) WHERE p.v = true RETURN p.v")
+        self.env.assertEquals(result, [[True]])
+
+        result = self.compare_to_label_scan("MATCH (p:P) WHERE p.s = '3' RETURN count(p)")
+        self.env.assertEquals(result, [[10]])
+
+    def test02_range(self):
+        result = self.compare_to_label_scan("MATCH (p:P) WHERE p.v > 2 AND p.v <= 4 RETURN p.v ORDER BY p.v")
+        self.env.assertEquals(result, [[2.5], [3], [4]])
+
+        result = self.compare_to_label_scan("MATCH (p:P) WHERE p.v >= 98 RETURN p.v ORDER BY p.v")
+        self.env.assertEquals(result, [[98], [99]])
+
+        result = self.compare_to_label_scan("MATCH (p:P) WHERE p.v < 0 RETURN p.v")
+        self.env.assertEquals(result, [])
+
+        result = self.compare_to_label_scan("MATCH (p:P) WHERE p.s >= '8' RETURN count(p)")
+        self.env.assertEquals(result, [[20]])
+
+    def test03_in(self):
+        # duplicate list elements do not produce duplicate results
+        result = self.compare_to_label_scan("MATCH (p:P) WHERE p.v IN [1, 3, 3, 'str', 1000] RETURN count(p)")
+        self.env.assertEquals(result, [[3]])
+
+        result = self.compare_to_label_scan("MATCH (p:P) WHERE p.v IN [] RETURN p.v")
+        self.env.assertEquals(result, [])
+
+    def test04_runtime_values(self):
+        # seek values are computed per input record
+        query = "UNWIND [1, 2, 3] AS x MATCH (p:P) WHERE p.v = x * 10 RETURN p.v ORDER BY p.v"
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn('Node By Index Scan', plan)
+        result = redis_graph.query(query).result_set
+        self.env.assertEquals(result, [[10], [20], [30]])
+
+        query = "MATCH (p:P) WHERE p.v = $v RETURN p.v"
+        result = redis_graph.query(query, {'v': 42}).result_set
+        self.env.assertEquals(result, [[42]])
+
+    def test05_updates(self):
+        # update indexed values while scanning the index
+        query = "MATCH (p:P) WHERE p.v >= 90 AND p.v < 100 SET p.v = p.v + 1000"
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.properties_set, 10)
+
+        result = self.compare_to_label_scan("MATCH (p:P) WHERE p.v >= 90 RETURN count(p)")
+        self.env.assertEquals(result, [[10]])
+
+        # removed nodes are no longer reported
+        redis_graph.query("MATCH (p:P) WHERE p.v >= 1000 DELETE p")
+        result = self.compare_to_label_scan("MATCH (p:P) WHERE p.v >= 90 RETURN count(p)")
+        self.env.assertEquals(result, [[0]])
+
+    def test06_disjunction(self):
+        # filters without a conjunct to seek by are not resolved by the index
+        query = "MATCH (p:P) WHERE p.v = 1 OR p.v = 2 RETURN p.v ORDER BY p.v"
+        plan = redis_graph.execution_plan(query)
+        self.env.assertNotIn('Node By Index Scan', plan)
+        result = redis_graph.query(query).result_set
+        self.env.assertEquals(result, [[1], [2]])
+
+    def test07_list_indexes(self):
+        result = redis_graph.query("CALL db.indexes() YIELD label, properties, info WHERE label = 'P' RETURN properties, info")
+        self.env.assertEquals(result.result_set[0][0], ['v', 's'])
+        self.env.assertEquals(result.result_set[0][1]['provider'], 'native')
+
+    def test08_composite(self):
+        redis_graph.query("UNWIND range(0, 99) AS x CREATE (:E {tenant:x % 4, ts:x})")
+        redis_graph.query("CREATE (:E {tenant:1})")
+        redis_graph.query("CREATE INDEX ON :E(tenant, ts)")
+
+        # equality on the leading property followed by a range
+        query = "MATCH (p:E) WHERE p.tenant = 1 AND p.ts > 80 RETURN p.ts ORDER BY p.ts"
+        result = self.compare_to_label_scan(query, 'E')
+        self.env.assertEquals(result, [[81], [85], [89], [93], [97]])
+
+        query = "MATCH (p:E) WHERE p.tenant = $t AND p.ts >= $x AND p.ts < 20 RETURN p.ts ORDER BY p.ts"
+        result = redis_graph.query(query, {'t': 2, 'x': 5}).result_set
+        self.env.assertEquals(result, [[6], [10], [14], [18]])
+
+        # equality on both properties
+        query = "MATCH (p:E) WHERE p.ts = 42 AND p.tenant = 2 RETURN p.ts"
+        result = self.compare_to_label_scan(query, 'E')
+        self.env.assertEquals(result, [[42]])
+
+        # range over the leading property alone
+        query = "MATCH (p:E) WHERE p.tenant < 1 RETURN count(p)"
+        result = self.compare_to_label_scan(query, 'E')
+        self.env.assertEquals(result, [[25]])
+
+        # nodes missing the trailing property
+        query = "MATCH (p:E) WHERE p.tenant = 1 RETURN count(p)"
+        result = self.compare_to_label_scan(query, 'E')
+        self.env.assertEquals(result, [[26]])
+
+        # composite keys aren't counted as records
+        # 101 tenant entries and 100 ts entries
+        result = redis_graph.query("CALL db.indexes() YIELD label, info WHERE label = 'E' RETURN info")
+        self.env.assertEquals(result.result_set[0][0]['numRecords'], 201)
+
+        # properties indexed by separate statements don't declare a composite key
+        redis_graph.query("UNWIND range(0, 19) AS x CREATE (:F {tenant:x % 4, ts:x})")
+        redis_graph.query("CREATE INDEX ON :F(tenant)")
+        redis_graph.query("CREATE INDEX ON :F(ts)")
+        query = "MATCH (p:F) WHERE p.tenant = 1 AND p.ts > 10 RETURN p.ts ORDER BY p.ts"
+        result = self.compare_to_label_scan(query, 'F')
+        self.env.assertEquals(result, [[13], [17]])
+
+        # dropping a property keeps the order of the remaining ones
+        redis_graph.query("CREATE INDEX ON :F(s)")
+        redis_graph.query("DROP INDEX ON :F(tenant)")
+        result = redis_graph.query("CALL db.indexes() YIELD label, properties WHERE label = 'F' RETURN properties")
+        self.env.assertEquals(result.result_set[0][0], ['ts', 's'])
+
+    def test09_ordered_scan(self):
+        redis_graph.query("UNWIND range(0, 49) AS x CREATE (:O {ts:x})")
+        redis_graph.query("CREATE (:O {ts:'a'}), (:O {ts:true}), (:O {ts:[1]}), (:O {ts:2.5}), (:O)")
+        redis_graph.query("CREATE INDEX ON :O(ts)")
+
+        # a limited sort over the indexed attribute is replaced by an ordered scan
+        query = "MATCH (o:O) RETURN o.ts ORDER BY o.ts DESC LIMIT 3"
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn('Node By Ordered Index Scan', plan)
+        self.env.assertNotIn('Sort', plan)
+        result = redis_graph.query(query).result_set
+        self.env.assertEquals(result, [[None], [49], [48]])
+
+        # the ordered scan follows the same global order as a sort
+        sorted_query = "MATCH (o:O) RETURN o.ts ORDER BY o.ts"
+        plan = redis_graph.execution_plan(sorted_query)
+        self.env.assertIn('Sort', plan)
+        expected = redis_graph.query(sorted_query).result_set
+        result = redis_graph.query(sorted_query + " LIMIT 100").result_set
+        self.env.assertEquals(result, expected)
+
+        expected.reverse()
+        result = redis_graph.query(sorted_query + " DESC LIMIT 100").result_set
+        self.env.assertEquals(result, expected)
+
+        query = "MATCH (o:O) RETURN o.ts ORDER BY o.ts SKIP 2 LIMIT 3"
+        result = redis_graph.query(query).result_set
+        self.env.assertEquals(result, [[True], [0], [1]])
+
+        # filters remain applied on top of the ordered scan
+        query = "MATCH (o:O) WHERE o.ts <> 49 RETURN o.ts ORDER BY o.ts DESC LIMIT 2"
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn('Node By Ordered Index Scan', plan)
+        result = redis_graph.query(query).result_set
+        self.env.assertEquals(result, [[48], [47]])
+
+        # sorting by multiple keys is not reduced
+        query = "MATCH (o:O) RETURN o.ts ORDER BY o.ts, id(o) LIMIT 1"
+        plan = redis_graph.execution_plan(query)
+        self.env.assertNotIn('Node By Ordered Index Scan', plan)
+
+        # ID ranges over the label scan are retained, the sort isn't reduced
+        redis_graph.query("UNWIND range(0, 19) AS x CREATE (:R {v:20 - x})")
+        redis_graph.query("CREATE INDEX ON :R(v)")
+        # IDs of deleted nodes might be reused
+        entries = redis_graph.query("MATCH (r:R) RETURN ID(r), r.v ORDER BY ID(r)").result_set
+        pivot = entries[5][0]
+
+        query = "MATCH (r:R) WHERE ID(r) > %d RETURN r.v ORDER BY r.v LIMIT 3" % pivot
+        plan = redis_graph.execution_plan(query)
+        self.env.assertNotIn('Node By Ordered Index Scan', plan)
+        result = redis_graph.query(query).result_set
+        expected = sorted([[v] for (i, v) in entries if i > pivot])[:3]
+        self.env.assertEquals(result, expected)
+
+        query = "MATCH (r:R) WHERE ID(r) < %d RETURN r.v ORDER BY r.v LIMIT 3" % pivot
+        result = redis_graph.query(query).result_set
+        expected = sorted([[v] for (i, v) in entries if i < pivot])[:3]
+        self.env.assertEquals(result, expected)
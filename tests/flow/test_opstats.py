@@ -0,0 +1,66 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+from redis import ResponseError
+
+GRAPH_ID = "opstats_test"
+redis_con = None
+redis_graph = None
+
+class testOpStats(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_con
+        global redis_graph
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+    def test01_opstats(self):
+        # OpStats should fail when graph doesn't exists.
+        try:
+            redis_con.execute_command("GRAPH.OPSTATS NONE_EXISTING_GRAPH")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("Invalid graph operation on empty key", str(e))
+
+        redis_graph.query("UNWIND range(1, 10) AS x CREATE (:L {v: x})")
+
+        # profiled queries are always sampled
+        redis_con.execute_command("GRAPH.PROFILE", GRAPH_ID, "MATCH (n:L) RETURN n.v")
+
+        stats = redis_con.execute_command("GRAPH.OPSTATS " + GRAPH_ID)
+        stats = {s[0]: s[1:] for s in stats}
+
+        self.env.assertIn("Results", stats)
+        self.env.assertIn("Node By Label Scan", stats)
+
+        # each operation produced 10 records
+        count, records_in, records_out, _ = stats["Node By Label Scan"]
+        self.env.assertEquals(count, 1)
+        self.env.assertEquals(records_in, 0)
+        self.env.assertEquals(records_out, 10)
+
+        count, records_in, records_out, _ = stats["Results"]
+        self.env.assertEquals(count, 1)
+        self.env.assertEquals(records_in, 10)
+        self.env.assertEquals(records_out, 10)
+
+    def test02_sampled_executions(self):
+        # one out of every 16 executions is sampled
+        for i in range(64):
+            redis_graph.query("MATCH (n:L) WHERE n.v > 5 RETURN n.v")
+
+        stats = redis_con.execute_command("GRAPH.OPSTATS " + GRAPH_ID)
+        stats = {s[0]: s[1:] for s in stats}
+
+        self.env.assertIn("Filter", stats)
+        count, records_in, records_out, _ = stats["Filter"]
+        self.env.assertGreater(count, 0)
+        self.env.assertEquals(records_in, count * 10)
+        self.env.assertEquals(records_out, count * 5)
+
+    def test03_info(self):
+        info = redis_con.info("graph_operators")
+        self.env.assertGreater(info["graph_sampled_executions"], 0)
+        self.env.assertIn("graph_op_node_by_label_scan", info)
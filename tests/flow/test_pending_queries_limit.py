@@ -8,16 +8,18 @@ from pathos.pools import ProcessPool as Pool
 #    expect to get error!
 # 3. test overflowing the server when there's no limit
 #    expect not to get any exceptions
+# 4. test overflowing a single graph when there's a per graph limit
+#    expect to get error!
 
 GRAPH_NAME = "max_pending_queries"
 SLOW_QUERY = "UNWIND range (0, 1000000) AS x WITH x WHERE (x / 2) = 50 RETURN x"
 
-def issue_query(conn, q):
+def issue_query(conn, q, err="Max pending queries exceeded"):
     try:
         conn.execute_command("GRAPH.QUERY", GRAPH_NAME, q)
         return False
     except Exception as e:
-        assert "Max pending queries exceeded" in str(e)
+        assert err in str(e)
         return True
 
 class testPendingQueryLimit():
@@ -29,10 +31,11 @@ class testPendingQueryLimit():
 
         self.conn = self.env.getConnection()
 
-    def stress_server(self):
+    def stress_server(self, err="Max pending queries exceeded"):
         threadpool_size = self.conn.execute_command("GRAPH.CONFIG", "GET", "THREAD_COUNT")[1]
         thread_count = threadpool_size * 5
         qs = [SLOW_QUERY] * thread_count
+        errs = [err] * thread_count
         connections = []
         pool = Pool(nodes=thread_count)
 
@@ -41,7 +44,7 @@ class testPendingQueryLimit():
             connections.append(self.env.getConnection())
 
         # invoke queries
-        result = pool.map(issue_query, connections, qs)
+        result = pool.map(issue_query, connections, qs, errs)
 
         # return if error encountered
         return any(result)
@@ -77,3 +80,23 @@ class testPendingQueryLimit():
         error_encountered = self.stress_server()
 
         self.env.assertTrue(error_encountered)
+
+    def test_04_overflow_graph_limit(self):
+        # lift the global limit, such that only the per graph limit applies
+        self.conn.execute_command("GRAPH.CONFIG", "SET", "MAX_QUEUED_QUERIES", 4294967295)
+
+        # admit a single query against the graph at any given time
+        self.conn.execute_command("GRAPH.CONFIG", "SET", "MAX_QUERIES_PER_GRAPH", 1)
+
+        error_encountered = self.stress_server("Max pending queries for graph exceeded")
+        self.env.assertTrue(error_encountered)
+
+        # once the burst is over, queries against the graph are admitted again
+        result = self.conn.execute_command("GRAPH.QUERY", GRAPH_NAME, "RETURN 1")
+        self.env.assertEquals(result[1][0][0], 1)
+
+        # restore default
+        self.conn.execute_command("GRAPH.CONFIG", "SET", "MAX_QUERIES_PER_GRAPH", 0)
+
+        error_encountered = self.stress_server()
+        self.env.assertFalse(error_encountered)
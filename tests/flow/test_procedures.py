@@ -375,6 +375,65 @@ class testProcedures(FlowTestsBase):
                            ["READ", "db.indexes"],
                            ["READ", "db.labels"],
                            ["READ", "db.propertyKeys"],
+                           ["READ", "db.propertyStats"],
+                           ["WRITE", "db.propertyStats.rebuild"],
                            ["READ", "db.relationshipTypes"],
                            ["READ", "dbms.procedures"]]
         self.env.assertEquals(actual_resultset, expected_result)
+
+    def test13_procedure_property_stats(self):
+        redis_graph.query("UNWIND range(0, 99) AS x CREATE (:stats {v: x % 10})")
+        redis_graph.query("CREATE (:stats)")
+
+        query = """CALL db.propertyStats()
+                   YIELD label, property, count, nullFraction, distinct, min, max, histogram
+                   WHERE label = 'stats'
+                   RETURN property, count, nullFraction, distinct, min, max, histogram"""
+
+        # statistics are maintained as nodes are created
+        # the histogram is only computed on rebuild
+        actual_resultset = redis_graph.query(query).result_set
+        self.env.assertEquals(len(actual_resultset), 1)
+        [prop, count, null_fraction, distinct, min_val, max_val, histogram] = actual_resultset[0]
+        self.env.assertEquals(prop, "v")
+        self.env.assertEquals(count, 100)
+        self.env.assertAlmostEqual(null_fraction, 1 / 101, 0.0001)
+        self.env.assertTrue(9 <= distinct <= 11)
+        self.env.assertEquals(min_val, 0)
+        self.env.assertEquals(max_val, 9)
+        self.env.assertEquals(histogram, None)
+
+        # rebuild statistics, computing histograms
+        redis_graph.query("CALL db.propertyStats.rebuild()")
+
+        actual_resultset = redis_graph.query(query).result_set
+        [prop, count, null_fraction, distinct, min_val, max_val, histogram] = actual_resultset[0]
+        self.env.assertEquals(count, 100)
+        self.env.assertTrue(9 <= distinct <= 11)
+        self.env.assertEquals(histogram, sorted(histogram))
+        self.env.assertEquals(histogram[-1], 9)
+
+        # updates and deletions are reflected in statistics
+        redis_graph.query("MATCH (n:stats) WHERE n.v = 0 SET n.v = NULL")
+        redis_graph.query("MATCH (n:stats) WHERE n.v = 1 DELETE n")
+        redis_graph.query("MATCH (n:stats) WHERE n.v = 2 SET n = {w: 1}")
+        redis_graph.query("MATCH (n:stats) WHERE n.v = 3 SET n.v = 'a'")
+
+        query = """CALL db.propertyStats()
+                   YIELD label, property, count
+                   WHERE label = 'stats'
+                   RETURN property, count
+                   ORDER BY property"""
+        actual_resultset = redis_graph.query(query).result_set
+        self.env.assertEquals(actual_resultset, [["v", 70], ["w", 10]])
+
+        # statistics are persisted
+        query = """CALL db.propertyStats()
+                   YIELD label, property, count, distinct, min, max, histogram
+                   WHERE label = 'stats'
+                   RETURN property, count, distinct, min, max, histogram
+                   ORDER BY property"""
+        expected_result = redis_graph.query(query).result_set
+        redis_con.execute_command("DEBUG", "RELOAD")
+        actual_resultset = redis_graph.query(query).result_set
+        self.env.assertEquals(actual_resultset, expected_result)
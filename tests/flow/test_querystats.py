@@ -0,0 +1,98 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+from redis import ResponseError
+
+GRAPH_ID = "querystats_test"
+redis_con = None
+redis_graph = None
+
+class testQueryStats(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_con
+        global redis_graph
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+    def test01_querystats(self):
+        # QueryStats should fail when graph doesn't exists.
+        try:
+            redis_con.execute_command("GRAPH.QUERYSTATS NONE_EXISTING_GRAPH")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("Invalid graph operation on empty key", str(e))
+
+        redis_graph.query("UNWIND range(1, 10) AS x CREATE (:L {v: x})")
+
+        # queries which differ only by their literals share a fingerprint
+        for i in range(5):
+            redis_graph.query("MATCH (n:L) WHERE n.v > %d RETURN n.v" % i)
+
+        stats = redis_con.execute_command("GRAPH.QUERYSTATS " + GRAPH_ID)
+        self.env.assertEquals(len(stats), 2)
+
+        entry = [s for s in stats if "MATCH" in s[0]][0]
+        fingerprint, calls, total, min_t, max_t, p99, rows, cache_hit_ratio = entry
+        self.env.assertEquals(calls, 5)
+        # 9 + 8 + 7 + 6 + 5 rows
+        self.env.assertEquals(rows, 35)
+        self.env.assertLessEqual(float(min_t), float(max_t))
+        self.env.assertLessEqual(float(p99), float(max_t))
+        self.env.assertLessEqual(float(max_t), float(total))
+        # first execution populated the cache
+        self.env.assertEquals(float(cache_hit_ratio), 0.8)
+
+    def test02_latency(self):
+        stages = redis_con.execute_command("GRAPH.QUERYSTATS", GRAPH_ID, "LATENCY")
+        names = [s[0] for s in stages]
+        self.env.assertEquals(names, ["wait", "parse", "plan", "lock", "execute", "reply"])
+
+        for name, count, p50, p99, p999 in stages:
+            # create query and 5 match queries
+            self.env.assertEquals(count, 6)
+            self.env.assertLessEqual(float(p50), float(p99))
+            self.env.assertLessEqual(float(p99), float(p999))
+
+    def test03_reset(self):
+        # unknown subcommand
+        try:
+            redis_con.execute_command("GRAPH.QUERYSTATS", GRAPH_ID, "FLUSH")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("Unknown subcommand", str(e))
+
+        res = redis_con.execute_command("GRAPH.QUERYSTATS", GRAPH_ID, "RESET")
+        self.env.assertEquals(res, "OK")
+
+        stats = redis_con.execute_command("GRAPH.QUERYSTATS " + GRAPH_ID)
+        self.env.assertEquals(len(stats), 0)
+
+        stages = redis_con.execute_command("GRAPH.QUERYSTATS", GRAPH_ID, "LATENCY")
+        for stage in stages:
+            self.env.assertEquals(stage[1], 0)
+
+    def test04_eviction(self):
+        # a frequently called fingerprint
+        popular = "MATCH (n:L) RETURN count(n)"
+        for i in range(50):
+            redis_graph.query(popular)
+
+        # flood query stats with more distinct fingerprints than tracked
+        n = 1200
+        for i in range(n):
+            redis_graph.query("RETURN 1 AS a%d" % i)
+
+        stats = redis_con.execute_command("GRAPH.QUERYSTATS " + GRAPH_ID)
+        fingerprints = [s[0] for s in stats]
+        self.env.assertLessEqual(len(fingerprints), 1000)
+
+        # the frequently called fingerprint survives the flood
+        self.env.assertIn(popular, fingerprints)
+
+        # recent fingerprints are not evicted ahead of older ones
+        recent = [f for f in fingerprints if f.endswith(" AS a%d" % (n - 1))]
+        self.env.assertEquals(len(recent), 1)
+        oldest = [f for f in fingerprints if f.endswith(" AS a0")]
+        self.env.assertEquals(len(oldest), 0)
@@ -151,3 +151,31 @@ class testTraversalConstruction():
         self.env.assertTrue("Node By Label Scan | (a:L)" in ops[0]) # scan A
         self.env.assertTrue("Filter" in ops[1]) # filter A
         self.env.assertTrue("Conditional Variable Length Traverse" in ops[2]) # bidirectional var-len traverse from A to B
+
+    # make sure traversal begins with the least populated label
+    def test_start_with_smallest_label(self):
+        g = Graph("TraversalConstructionSkewed", self.env.getConnection())
+        g.query("UNWIND range(1, 100) AS x CREATE (:Big {v:x})")
+        g.query("CREATE (:Small {v:1})")
+
+        # neither side is filtered nor bound, start from the smaller label
+        q = """MATCH (a:Big)-[]->(b:Small) RETURN a, b"""
+        plan = g.execution_plan(q)
+        ops = plan.split(os.linesep)
+        ops.reverse()
+        self.env.assertTrue("Node By Label Scan | (b:Small)" in ops[0])
+
+        q = """MATCH (a:Small)-[]->(b:Big) RETURN a, b"""
+        plan = g.execution_plan(q)
+        ops = plan.split(os.linesep)
+        ops.reverse()
+        self.env.assertTrue("Node By Label Scan | (a:Small)" in ops[0])
+
+        # filters outweigh label cardinality
+        q = """MATCH (a:Big)-[]->(b:Small) WHERE a.v = 1 RETURN a, b"""
+        plan = g.execution_plan(q)
+        ops = plan.split(os.linesep)
+        ops.reverse()
+        self.env.assertTrue("Node By Label Scan | (a:Big)" in ops[0])
+
+        g.delete()
@@ -0,0 +1,39 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "micro.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/value.h"
+#include "../../src/arithmetic/arithmetic_expression.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+// evaluate 1 + 2.5 * 3
+MICRO_BENCHMARK(arithmetic, evaluate) {
+	AR_ExpNode *mul = AR_EXP_NewOpNode("mul", 2);
+	mul->op.children[0] = AR_EXP_NewConstOperandNode(SI_DoubleVal(2.5));
+	mul->op.children[1] = AR_EXP_NewConstOperandNode(SI_LongVal(3));
+
+	AR_ExpNode *add = AR_EXP_NewOpNode("add", 2);
+	add->op.children[0] = AR_EXP_NewConstOperandNode(SI_LongVal(1));
+	add->op.children[1] = mul;
+	Micro_ResetTimer(b);
+
+	for(uint64_t i = 0; i < b->n; i++) {
+		SIValue v = AR_EXP_Evaluate(add, NULL);
+		SIValue_Free(v);
+	}
+
+	Micro_StopTimer(b);
+	AR_EXP_Free(add);
+}
+
@@ -0,0 +1,49 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "micro.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include "../../src/util/rmalloc.h"
+#include "../../src/util/cache/cache.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+#define CACHE_SIZE 64
+
+static void *_Copy(void *item) {
+	int64_t *copy = (int64_t *)rm_malloc(sizeof(int64_t));
+	*copy = *(int64_t *)item;
+	return copy;
+}
+
+// retrieve a cached item
+MICRO_BENCHMARK(cache, hit) {
+	char keys[CACHE_SIZE][64];
+	Cache *cache = Cache_New(CACHE_SIZE, (CacheEntryFreeFunc)rm_free, _Copy);
+	for(int i = 0; i < CACHE_SIZE; i++) {
+		sprintf(keys[i], "MATCH (n) WHERE n.v = %d RETURN n", i);
+		int64_t *item = (int64_t *)rm_malloc(sizeof(int64_t));
+		*item = i;
+		Cache_SetValue(cache, keys[i], item);
+	}
+	Micro_ResetTimer(b);
+
+	for(uint64_t i = 0; i < b->n; i++) {
+		void *item = Cache_GetValue(cache, keys[i % CACHE_SIZE]);
+		rm_free(item);
+	}
+
+	Micro_StopTimer(b);
+	Cache_Free(cache);
+}
+
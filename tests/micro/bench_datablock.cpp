@@ -0,0 +1,72 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "micro.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/util/datablock/datablock.h"
+#include "../../src/util/datablock/datablock_iterator.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+#define ITEM_SIZE 32
+
+// allocate 'n' items
+MICRO_BENCHMARK(datablock, allocate) {
+	DataBlock *block = DataBlock_New(16384, 1024, ITEM_SIZE, NULL);
+	Micro_ResetTimer(b);
+
+	uint64_t id;
+	for(uint64_t i = 0; i < b->n; i++) DataBlock_AllocateItem(block, &id);
+
+	Micro_StopTimer(b);
+	DataBlock_Free(block);
+}
+
+// delete 'n' items, then allocate 'n' items reusing the deleted slots
+MICRO_BENCHMARK(datablock, delete_reuse) {
+	DataBlock *block = DataBlock_New(16384, b->n, ITEM_SIZE, NULL);
+	uint64_t id;
+	for(uint64_t i = 0; i < b->n; i++) DataBlock_AllocateItem(block, &id);
+	Micro_ResetTimer(b);
+
+	for(uint64_t i = 0; i < b->n; i++) DataBlock_DeleteItem(block, i);
+	for(uint64_t i = 0; i < b->n; i++) DataBlock_AllocateItem(block, &id);
+
+	Micro_StopTimer(b);
+	DataBlock_Free(block);
+}
+
+// scan 'n' items of a block in which every 8th item is deleted
+MICRO_BENCHMARK(datablock, scan) {
+	static DataBlock *block = NULL;
+	uint64_t count = 1 << 20;
+
+	// block is shared across runs
+	if(block == NULL) {
+		uint64_t id;
+		block = DataBlock_New(16384, count, ITEM_SIZE, NULL);
+		for(uint64_t i = 0; i < count; i++) DataBlock_AllocateItem(block, &id);
+		for(uint64_t i = 0; i < count; i += 8) DataBlock_DeleteItem(block, i);
+	}
+
+	DataBlockIterator *it = DataBlock_Scan(block);
+	Micro_ResetTimer(b);
+
+	uint64_t id;
+	for(uint64_t i = 0; i < b->n; i++) {
+		if(DataBlockIterator_Next(it, &id) == NULL) DataBlockIterator_Reset(it);
+	}
+
+	Micro_StopTimer(b);
+	DataBlockIterator_Free(it);
+}
+
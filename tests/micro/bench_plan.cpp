@@ -0,0 +1,125 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "micro.h"
+#include "synthetic_graph.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include "../../src/query_ctx.h"
+#include "../../src/util/arena.h"
+#include "../../src/execution_plan/execution_plan.h"
+#include "../../src/execution_plan/execution_plan_clone.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+// plan level benchmarks
+//
+// each iteration executes a query against a synthetic graph the way a
+// cached query is executed: the plan is cloned from a template,
+// prepared, executed and freed, parsing and planning are excluded
+//
+// the reporting run profiles a single execution and prints the
+// throughput of every operation in the plan
+
+#define QUERY_SCAN      "MATCH (n:N) WHERE n.v < 10 RETURN n.v"
+#define QUERY_ONE_HOP   "MATCH (a:N)-[:E]->(b) RETURN b.v"
+#define QUERY_TWO_HOP   "MATCH (a:N)-[:E]->(b)-[:E]->(c) WHERE a.v = 0 RETURN c.v"
+#define QUERY_JOIN      "MATCH (a:N), (b:N) WHERE a.v = b.v AND a.v < 5 RETURN count(b)"
+#define QUERY_AGGREGATE "MATCH (a:N)-[:E]->(b) RETURN b.v, count(a)"
+
+// print the profiled statistics of 'op' and its children
+static void _ReportOp(const char *bench, const OpBase *op, int depth) {
+	// profiled execution time is in milliseconds, excluding children
+	// which might leave a slightly negative value due to rounding
+	double ms = op->stats->profileExecTime;
+	if(ms < 0) ms = 0;
+	int records = op->stats->profileRecordCount;
+	double records_per_sec = (ms > 0) ? records / (ms / 1000) : 0;
+
+	printf("{\"name\": \"%s\", \"operation\": \"%s\", \"depth\": %d, "
+			"\"records\": %d, \"ms\": %.3f, \"records_per_sec\": %.0f}\n",
+			bench, op->name, depth, records, ms, records_per_sec);
+
+	for(int i = 0; i < op->childCount; i++) {
+		_ReportOp(bench, op->children[i], depth + 1);
+	}
+}
+
+static void _PlanBench(MicroBench *b, SyntheticGraphType type,
+		const char *query) {
+	// building the graph is not measured
+	Micro_StopTimer(b);
+	GraphContext *gc = SyntheticGraph_Get(type);
+	QueryCtx_SetGraphCtx(gc);
+
+	// results are consumed without being formatted
+	ResultSet *result_set = NewResultSet(NULL, FORMATTER_NOP);
+	QueryCtx_SetResultSet(result_set);
+
+	// build the plan template
+	QueryCtx *ctx = QueryCtx_GetQueryCtx();
+	ctx->query_data.query_no_params = query;
+	cypher_parse_result_t *parse_result = cypher_parse(query, NULL, NULL,
+			CYPHER_PARSE_ONLY_STATEMENTS);
+	AST *ast = AST_Build(parse_result);
+	ExecutionPlan *template_plan = NewExecutionPlan();
+
+	// values produced during execution are released after every iteration
+	Arena *arena = QueryCtx_GetArena();
+	ArenaMark mark = Arena_Mark(arena);
+
+	Graph_AcquireReadLock(gc->g);
+	Micro_StartTimer(b);
+
+	for(uint64_t i = 0; i < b->n; i++) {
+		ExecutionPlan *plan = ExecutionPlan_Clone(template_plan);
+		ExecutionPlan_PreparePlan(plan);
+		if(b->report) {
+			ExecutionPlan_Profile(plan);
+			_ReportOp(b->name, plan->root, 0);
+		} else {
+			ExecutionPlan_Execute(plan);
+		}
+		ExecutionPlan_Free(plan);
+		Arena_Rewind(arena, mark);
+	}
+
+	Micro_StopTimer(b);
+	Graph_ReleaseLock(gc->g);
+
+	ExecutionPlan_Free(template_plan);
+	AST_Free(ast);
+	ResultSet_Free(result_set);
+}
+
+#define PLAN_BENCHMARK(graph, type, query, QUERY)    \
+	MICRO_BENCHMARK(plan, graph##_##query) {         \
+		_PlanBench(b, type, QUERY);                  \
+	}
+
+PLAN_BENCHMARK(rmat, SYNTHETIC_RMAT, scan, QUERY_SCAN)
+PLAN_BENCHMARK(rmat, SYNTHETIC_RMAT, one_hop, QUERY_ONE_HOP)
+PLAN_BENCHMARK(rmat, SYNTHETIC_RMAT, two_hop, QUERY_TWO_HOP)
+PLAN_BENCHMARK(rmat, SYNTHETIC_RMAT, join, QUERY_JOIN)
+PLAN_BENCHMARK(rmat, SYNTHETIC_RMAT, aggregate, QUERY_AGGREGATE)
+
+PLAN_BENCHMARK(power_law, SYNTHETIC_POWER_LAW, scan, QUERY_SCAN)
+PLAN_BENCHMARK(power_law, SYNTHETIC_POWER_LAW, one_hop, QUERY_ONE_HOP)
+PLAN_BENCHMARK(power_law, SYNTHETIC_POWER_LAW, two_hop, QUERY_TWO_HOP)
+PLAN_BENCHMARK(power_law, SYNTHETIC_POWER_LAW, join, QUERY_JOIN)
+PLAN_BENCHMARK(power_law, SYNTHETIC_POWER_LAW, aggregate, QUERY_AGGREGATE)
+
+PLAN_BENCHMARK(grid, SYNTHETIC_GRID, scan, QUERY_SCAN)
+PLAN_BENCHMARK(grid, SYNTHETIC_GRID, one_hop, QUERY_ONE_HOP)
+PLAN_BENCHMARK(grid, SYNTHETIC_GRID, two_hop, QUERY_TWO_HOP)
+PLAN_BENCHMARK(grid, SYNTHETIC_GRID, join, QUERY_JOIN)
+PLAN_BENCHMARK(grid, SYNTHETIC_GRID, aggregate, QUERY_AGGREGATE)
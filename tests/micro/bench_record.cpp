@@ -0,0 +1,65 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "micro.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "rax.h"
+#include "../../src/value.h"
+#include "../../src/execution_plan/record.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+#define RECORD_ENTRIES 8
+
+// create a record, populate its entries and free it
+MICRO_BENCHMARK(record, lifecycle) {
+	rax *mapping = raxNew();
+	for(int i = 0; i < RECORD_ENTRIES; i++) {
+		char key[2] = {(char)('a' + i), '\0'};
+		raxInsert(mapping, (unsigned char *)key, 2, (void *)(intptr_t)i, NULL);
+	}
+	Micro_ResetTimer(b);
+
+	for(uint64_t i = 0; i < b->n; i++) {
+		Record r = Record_New(mapping);
+		for(int j = 0; j < RECORD_ENTRIES; j++) {
+			Record_AddScalar(r, j, SI_LongVal(j));
+		}
+		Record_Free(r);
+	}
+
+	Micro_StopTimer(b);
+	raxFree(mapping);
+}
+
+// clone a populated record
+MICRO_BENCHMARK(record, clone) {
+	rax *mapping = raxNew();
+	for(int i = 0; i < RECORD_ENTRIES; i++) {
+		char key[2] = {(char)('a' + i), '\0'};
+		raxInsert(mapping, (unsigned char *)key, 2, (void *)(intptr_t)i, NULL);
+	}
+	Record r = Record_New(mapping);
+	for(int j = 0; j < RECORD_ENTRIES; j++) Record_AddScalar(r, j, SI_LongVal(j));
+	Micro_ResetTimer(b);
+
+	for(uint64_t i = 0; i < b->n; i++) {
+		Record clone = Record_New(mapping);
+		Record_Clone(r, clone);
+		Record_Free(clone);
+	}
+
+	Micro_StopTimer(b);
+	Record_Free(r);
+	raxFree(mapping);
+}
+
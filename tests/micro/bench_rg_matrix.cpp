@@ -0,0 +1,90 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "micro.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/graph/rg_matrix/rg_matrix.h"
+#include "../../src/graph/rg_matrix/rg_matrix_iter.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+// matrix dimension
+#define DIM (1 << 16)
+
+// spread entries across rows and columns, distinct for i < DIM * DIM
+#define ROW(i) ((i) % DIM)
+#define COL(i) (((i) / DIM + (i) * 7919) % DIM)
+
+// set 'n' entries and flush them into the matrix
+MICRO_BENCHMARK(rg_matrix, set_sync) {
+	RG_Matrix A;
+	RG_Matrix_new(&A, GrB_BOOL, DIM, DIM);
+	Micro_ResetTimer(b);
+
+	for(uint64_t i = 0; i < b->n; i++) {
+		RG_Matrix_setElement_BOOL(A, ROW(i), COL(i));
+	}
+	RG_Matrix_wait(A, true);
+
+	Micro_StopTimer(b);
+	RG_Matrix_free(&A);
+}
+
+// remove 'n' synced entries and flush the deletions
+MICRO_BENCHMARK(rg_matrix, remove_sync) {
+	RG_Matrix A;
+	RG_Matrix_new(&A, GrB_BOOL, DIM, DIM);
+	for(uint64_t i = 0; i < b->n; i++) {
+		RG_Matrix_setElement_BOOL(A, ROW(i), COL(i));
+	}
+	RG_Matrix_wait(A, true);
+	Micro_ResetTimer(b);
+
+	for(uint64_t i = 0; i < b->n; i++) {
+		RG_Matrix_removeElement_BOOL(A, ROW(i), COL(i));
+	}
+	RG_Matrix_wait(A, true);
+
+	Micro_StopTimer(b);
+	RG_Matrix_free(&A);
+}
+
+// iterate over 'n' entries of a synced matrix
+MICRO_BENCHMARK(rg_matrix, tuple_iter) {
+	static RG_Matrix A = NULL;
+	uint64_t nvals = 1 << 20;
+
+	// matrix is shared across runs
+	if(A == NULL) {
+		RG_Matrix_new(&A, GrB_BOOL, DIM, DIM);
+		for(uint64_t i = 0; i < nvals; i++) {
+			RG_Matrix_setElement_BOOL(A, ROW(i), (i / DIM) * 16 + i % 16);
+		}
+		RG_Matrix_wait(A, true);
+	}
+
+	RG_MatrixTupleIter *it;
+	RG_MatrixTupleIter_new(&it, A);
+	Micro_ResetTimer(b);
+
+	GrB_Index row;
+	GrB_Index col;
+	bool depleted;
+	for(uint64_t i = 0; i < b->n; i++) {
+		RG_MatrixTupleIter_next(it, &row, &col, NULL, &depleted);
+		if(depleted) RG_MatrixTupleIter_reset(it);
+	}
+
+	Micro_StopTimer(b);
+	RG_MatrixTupleIter_free(&it);
+}
+
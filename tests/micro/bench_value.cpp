@@ -0,0 +1,49 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "micro.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/value.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+// prevents the compiler from discarding benchmarked computations
+static volatile int64_t sink;
+
+MICRO_BENCHMARK(value, compare_int) {
+	SIValue a = SI_LongVal(1);
+	SIValue c = SI_LongVal(2);
+	for(uint64_t i = 0; i < b->n; i++) sink = SIValue_Compare(a, c, NULL);
+}
+
+MICRO_BENCHMARK(value, compare_int_double) {
+	SIValue a = SI_LongVal(1);
+	SIValue c = SI_DoubleVal(2.5);
+	for(uint64_t i = 0; i < b->n; i++) sink = SIValue_Compare(a, c, NULL);
+}
+
+MICRO_BENCHMARK(value, compare_string) {
+	SIValue a = SI_ConstStringVal((char *)"micro benchmark string a");
+	SIValue c = SI_ConstStringVal((char *)"micro benchmark string b");
+	for(uint64_t i = 0; i < b->n; i++) sink = SIValue_Compare(a, c, NULL);
+}
+
+MICRO_BENCHMARK(value, hash_int) {
+	SIValue a = SI_LongVal(42);
+	for(uint64_t i = 0; i < b->n; i++) sink = SIValue_HashCode(a);
+}
+
+MICRO_BENCHMARK(value, hash_string) {
+	SIValue a = SI_ConstStringVal((char *)"micro benchmark string");
+	for(uint64_t i = 0; i < b->n; i++) sink = SIValue_HashCode(a);
+}
+
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "micro.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../../src/query_ctx.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/arithmetic/funcs.h"
+#include "../../src/procedures/procedure.h"
+#include "../../src/configuration/config.h"
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+// usage: micro.run [filter] [min time ms]
+//
+// runs every registered benchmark whose name contains 'filter'
+// each benchmark is reported as a single JSON object per line:
+// {"name": "datablock/allocate", "iterations": 1048576, "ns_per_op": 12.3}
+
+#define MICRO_MAX_BENCHMARKS 256
+#define MICRO_DEFAULT_MIN_TIME_MS 200
+#define MICRO_MAX_ITERATIONS 1000000000
+
+typedef struct {
+	const char *name;
+	MicroBenchFunc func;
+} MicroBenchDesc;
+
+static MicroBenchDesc benchmarks[MICRO_MAX_BENCHMARKS];
+static int benchmark_count = 0;
+
+int Micro_Register(const char *name, MicroBenchFunc func) {
+	if(benchmark_count == MICRO_MAX_BENCHMARKS) {
+		fprintf(stderr, "too many benchmarks, raise MICRO_MAX_BENCHMARKS\n");
+		exit(1);
+	}
+	benchmarks[benchmark_count].name = name;
+	benchmarks[benchmark_count].func = func;
+	return benchmark_count++;
+}
+
+// run benchmark once performing 'n' iterations, returns elapsed nanoseconds
+static uint64_t _Micro_RunOnce(const MicroBenchDesc *desc, uint64_t n,
+		bool report) {
+	MicroBench b = {n, 0, 0, false, report, desc->name};
+	Micro_StartTimer(&b);
+	desc->func(&b);
+	Micro_StopTimer(&b);
+	return b.elapsed;
+}
+
+static void _Micro_Run(const MicroBenchDesc *desc, uint64_t min_time_ns) {
+	uint64_t n = 1;
+	uint64_t elapsed = _Micro_RunOnce(desc, n, false);
+
+	// grow 'n' until a run lasts at least 'min_time_ns'
+	while(elapsed < min_time_ns && n < MICRO_MAX_ITERATIONS) {
+		// aim 20% above the target, grow at most 100x per round
+		uint64_t next = (elapsed > 0) ? n * min_time_ns * 1.2 / elapsed : n * 100;
+		if(next > n * 100) next = n * 100;
+		if(next <= n) next = n + 1;
+		n = next;
+		elapsed = _Micro_RunOnce(desc, n, false);
+	}
+
+	printf("{\"name\": \"%s\", \"iterations\": %lu, \"ns_per_op\": %.2f}\n",
+			desc->name, n, (double)elapsed / n);
+
+	// let the benchmark report details of a single iteration
+	_Micro_RunOnce(desc, 1, true);
+	fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+	const char *filter = (argc > 1) ? argv[1] : "";
+	uint64_t min_time_ms = (argc > 2) ? strtoull(argv[2], NULL, 10) :
+		MICRO_DEFAULT_MIN_TIME_MS;
+
+	// use the malloc family for allocations
+	Alloc_Reset();
+
+	// initialize GraphBLAS, all matrices in CSR format
+	GrB_init(GrB_NONBLOCKING);
+	GxB_Global_Option_set(GxB_FORMAT, GxB_BY_ROW);
+	Config_Option_set(Config_DELTA_MAX_PENDING_CHANGES, "10000");
+
+	// prepare thread-local variables, register functions and procedures
+	QueryCtx_Init();
+	AR_RegisterFuncs();
+	Proc_Register();
+
+	for(int i = 0; i < benchmark_count; i++) {
+		if(strstr(benchmarks[i].name, filter) == NULL) continue;
+		_Micro_Run(benchmarks + i, min_time_ms * 1000000);
+	}
+
+	GrB_finalize();
+	return 0;
+}
+
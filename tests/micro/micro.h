@@ -0,0 +1,72 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include <time.h>
+#include <stdint.h>
+
+// micro benchmark harness
+//
+// a benchmark is a function performing 'b->n' iterations of the measured
+// operation, the harness grows 'n' until a single run lasts long enough
+// to be measured reliably and reports the average time per iteration
+//
+// setup which shouldn't be measured is excluded by calling
+// Micro_ResetTimer once setup is done, or by stopping and starting the timer
+//
+// once timed, each benchmark is run a final time with 'b->report' set
+// and 'b->n' = 1, benchmarks may use this run to print additional
+// JSON lines describing their results, e.g. per operation throughput
+
+typedef struct MicroBench {
+	uint64_t n;          // number of iterations to perform
+	uint64_t elapsed;    // measured time in nanoseconds
+	uint64_t start;      // time at which the timer was last started
+	bool running;        // timer is running
+	bool report;         // reporting run, print details rather than time
+	const char *name;    // benchmark name
+} MicroBench;
+
+typedef void (*MicroBenchFunc)(MicroBench *b);
+
+static inline uint64_t Micro_Now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// resume measuring
+static inline void Micro_StartTimer(MicroBench *b) {
+	if(b->running) return;
+	b->start = Micro_Now();
+	b->running = true;
+}
+
+// pause measuring
+static inline void Micro_StopTimer(MicroBench *b) {
+	if(!b->running) return;
+	b->elapsed += Micro_Now() - b->start;
+	b->running = false;
+}
+
+// discard time measured so far
+static inline void Micro_ResetTimer(MicroBench *b) {
+	b->elapsed = 0;
+	b->start = Micro_Now();
+}
+
+// register a benchmark, called by MICRO_BENCHMARK
+int Micro_Register(const char *name, MicroBenchFunc func);
+
+// defines and registers a benchmark function
+// benchmark names are of the form "<suite>/<case>"
+#define MICRO_BENCHMARK(suite, name)                                          \
+	static void micro_##suite##_##name(MicroBench *b);                        \
+	__attribute__((unused)) static int micro_##suite##_##name##_registered =  \
+		Micro_Register(#suite "/" #name, micro_##suite##_##name);             \
+	static void micro_##suite##_##name(MicroBench *b)
+
@@ -0,0 +1,228 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "synthetic_graph.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <string.h>
+#include "../../src/RG.h"
+#include "../../src/util/arr.h"
+#include "../../src/util/rmalloc.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+#define SYNTHETIC_SEED 0x2545F4914F6CDD1DULL
+
+// RMAT quadrant probabilities, as specified by graph500
+#define RMAT_A 0.57
+#define RMAT_B 0.19
+#define RMAT_C 0.19
+
+static GraphContext *graphs[SYNTHETIC_GRID + 1];
+
+// xorshift64*, deterministic across platforms
+static inline uint64_t _Rand(uint64_t *state) {
+	*state ^= *state >> 12;
+	*state ^= *state << 25;
+	*state ^= *state >> 27;
+	return *state * 0x2545F4914F6CDD1DULL;
+}
+
+// uniform double in [0, 1)
+static inline double _RandUniform(uint64_t *state) {
+	return (_Rand(state) >> 11) * (1.0 / (1ULL << 53));
+}
+
+//------------------------------------------------------------------------------
+// edge generators
+//------------------------------------------------------------------------------
+
+// each generator appends edge endpoints to 'srcs' and 'dests'
+// and returns the number of nodes in the graph
+
+static uint64_t _GenerateRMAT(NodeID **srcs, NodeID **dests) {
+	uint64_t state = SYNTHETIC_SEED;
+	uint64_t node_count = 1ULL << SYNTHETIC_RMAT_SCALE;
+	uint64_t edge_count = node_count * SYNTHETIC_EDGE_FACTOR;
+
+	for(uint64_t i = 0; i < edge_count; i++) {
+		NodeID src = 0;
+		NodeID dest = 0;
+		// descend into one of the four quadrants per bit of the node ID
+		for(int bit = 0; bit < SYNTHETIC_RMAT_SCALE; bit++) {
+			double p = _RandUniform(&state);
+			if(p < RMAT_A) continue;
+			if(p < RMAT_A + RMAT_B) {
+				dest |= 1ULL << bit;
+			} else if(p < RMAT_A + RMAT_B + RMAT_C) {
+				src |= 1ULL << bit;
+			} else {
+				src |= 1ULL << bit;
+				dest |= 1ULL << bit;
+			}
+		}
+		array_append(*srcs, src);
+		array_append(*dests, dest);
+	}
+
+	return node_count;
+}
+
+static uint64_t _GeneratePowerLaw(NodeID **srcs, NodeID **dests) {
+	uint64_t state = SYNTHETIC_SEED;
+	uint64_t node_count = 1ULL << SYNTHETIC_RMAT_SCALE;
+
+	// every new node connects to SYNTHETIC_EDGE_FACTOR existing nodes
+	// picking a random endpoint of an existing edge selects a node
+	// with probability proportional to its degree
+	for(NodeID src = 1; src < node_count; src++) {
+		for(int i = 0; i < SYNTHETIC_EDGE_FACTOR; i++) {
+			uint64_t edge_count = array_len(*srcs);
+			NodeID dest = 0;
+			if(edge_count > 0) {
+				uint64_t endpoint = _Rand(&state) % (edge_count * 2);
+				dest = (endpoint % 2 == 0) ? (*srcs)[endpoint / 2] :
+					(*dests)[endpoint / 2];
+			}
+			array_append(*srcs, src);
+			array_append(*dests, dest);
+		}
+	}
+
+	return node_count;
+}
+
+static uint64_t _GenerateGrid(NodeID **srcs, NodeID **dests) {
+	uint64_t side = SYNTHETIC_GRID_SIDE;
+
+	for(uint64_t row = 0; row < side; row++) {
+		for(uint64_t col = 0; col < side; col++) {
+			NodeID id = row * side + col;
+			if(col + 1 < side) {
+				array_append(*srcs, id);
+				array_append(*dests, id + 1);
+			}
+			if(row + 1 < side) {
+				array_append(*srcs, id);
+				array_append(*dests, id + side);
+			}
+		}
+	}
+
+	return side * side;
+}
+
+//------------------------------------------------------------------------------
+// graph construction
+//------------------------------------------------------------------------------
+
+static GraphContext *_GraphContext_New(const char *name, uint64_t node_count,
+		uint64_t edge_count) {
+	GraphContext *gc = (GraphContext *)rm_calloc(1, sizeof(GraphContext));
+
+	gc->g = Graph_New(node_count, edge_count);
+	gc->ref_count = 1;
+	gc->graph_name = rm_strdup(name);
+	gc->attributes = AttributeMap_New();
+	pthread_mutex_init(&gc->_attribute_lock, NULL);
+	gc->node_schemas = (Schema **)array_new(Schema *, GRAPH_DEFAULT_LABEL_CAP);
+	gc->relation_schemas = (Schema **)array_new(Schema *,
+			GRAPH_DEFAULT_RELATION_TYPE_CAP);
+
+	return gc;
+}
+
+static GraphContext *_SyntheticGraph_Build(SyntheticGraphType type) {
+	NodeID *srcs = array_new(NodeID, 1024);
+	NodeID *dests = array_new(NodeID, 1024);
+
+	uint64_t node_count = 0;
+	switch(type) {
+		case SYNTHETIC_RMAT:
+			node_count = _GenerateRMAT(&srcs, &dests);
+			break;
+		case SYNTHETIC_POWER_LAW:
+			node_count = _GeneratePowerLaw(&srcs, &dests);
+			break;
+		case SYNTHETIC_GRID:
+			node_count = _GenerateGrid(&srcs, &dests);
+			break;
+		default:
+			ASSERT(false);
+	}
+	uint64_t edge_count = array_len(srcs);
+
+	GraphContext *gc = _GraphContext_New(SyntheticGraph_Name(type), node_count,
+			edge_count);
+	Graph *g = gc->g;
+
+	int label = Schema_GetID(GraphContext_AddSchema(gc, "N", SCHEMA_NODE));
+	int relation = Schema_GetID(GraphContext_AddSchema(gc, "E",
+			SCHEMA_EDGE));
+	Attribute_ID attr = GraphContext_FindOrAddAttribute(gc, "v");
+
+	Graph_AllocateNodes(g, node_count);
+	Graph_AllocateEdges(g, edge_count);
+
+	// sync each matrix once, as done by bulk insert
+	Graph_SetMatrixPolicy(g, SYNC_POLICY_RESIZE);
+	Graph_GetLabelMatrix(g, label);
+	Graph_GetNodeLabelMatrix(g);
+	Graph_GetRelationMatrix(g, relation, false);
+	Graph_GetAdjacencyMatrix(g, false);
+	Graph_SetMatrixPolicy(g, SYNC_POLICY_NOP);
+
+	for(uint64_t i = 0; i < node_count; i++) {
+		Node n;
+		Graph_CreateNode(g, &n, &label, 1);
+		GraphEntity_AddProperty((GraphEntity *)&n, attr, SI_LongVal(i % 100));
+	}
+
+	Edge *edges = (Edge *)rm_malloc(sizeof(Edge) * edge_count);
+	Graph_CreateEdges(g, relation, srcs, dests, edge_count, edges);
+
+	// flush pending changes, benchmarks should not pay for them
+	Graph_SetMatrixPolicy(g, SYNC_POLICY_FLUSH_RESIZE);
+	Graph_ApplyAllPending(g, true);
+
+	rm_free(edges);
+	array_free(srcs);
+	array_free(dests);
+
+	return gc;
+}
+
+GraphContext *SyntheticGraph_Get
+(
+	SyntheticGraphType type
+) {
+	ASSERT(type <= SYNTHETIC_GRID);
+
+	if(graphs[type] == NULL) graphs[type] = _SyntheticGraph_Build(type);
+	return graphs[type];
+}
+
+const char *SyntheticGraph_Name
+(
+	SyntheticGraphType type
+) {
+	switch(type) {
+		case SYNTHETIC_RMAT:
+			return "rmat";
+		case SYNTHETIC_POWER_LAW:
+			return "power_law";
+		case SYNTHETIC_GRID:
+			return "grid";
+		default:
+			ASSERT(false);
+			return NULL;
+	}
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/graph/graphcontext.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+// synthetic graphs for plan level benchmarks
+//
+// graphs are built directly through the Graph API, without a server
+// every node is labeled 'N' and has an integer attribute 'v' = ID % 100
+// every edge is of type 'E'
+//
+// generators are seeded with a constant, the same graph is produced
+// on every run
+
+typedef enum {
+	SYNTHETIC_RMAT,       // graph500 recursive matrix, skewed degrees
+	SYNTHETIC_POWER_LAW,  // preferential attachment (Barabasi-Albert)
+	SYNTHETIC_GRID,       // 2D grid, edges to the right and downwards
+} SyntheticGraphType;
+
+// number of nodes in an RMAT graph is 2^SYNTHETIC_RMAT_SCALE
+#define SYNTHETIC_RMAT_SCALE 12
+
+// average number of outgoing edges per node in RMAT and power-law graphs
+#define SYNTHETIC_EDGE_FACTOR 8
+
+// side of a grid graph
+#define SYNTHETIC_GRID_SIDE 64
+
+// returns a synthetic graph of the given type
+// graphs are built on first use and kept for the lifetime of the process
+GraphContext *SyntheticGraph_Get
+(
+	SyntheticGraphType type  // graph type
+);
+
+// name of a synthetic graph type
+const char *SyntheticGraph_Name
+(
+	SyntheticGraphType type  // graph type
+);
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <string.h>
+#include "../../src/value.h"
+#include "../../src/util/arena.h"
+#include "../../src/util/rmalloc.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class ArenaTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(ArenaTest, Arena_Alloc) {
+	Arena *a = Arena_New(64);
+
+	// allocations are aligned and do not overlap
+	char *x = (char *)Arena_Alloc(a, 3);
+	char *y = (char *)Arena_Alloc(a, 5);
+	ASSERT_EQ((uintptr_t)x % 8, 0);
+	ASSERT_EQ((uintptr_t)y % 8, 0);
+	ASSERT_GE(y - x, 3);
+	ASSERT_TRUE(Arena_Contains(a, x));
+	ASSERT_TRUE(Arena_Contains(a, y));
+
+	// allocation larger than the chunk size
+	char *big = (char *)Arena_Alloc(a, 1024);
+	memset(big, 'a', 1024);
+	ASSERT_TRUE(Arena_Contains(a, big + 1023));
+
+	int local;
+	ASSERT_FALSE(Arena_Contains(a, &local));
+
+	Arena_Free(a);
+}
+
+TEST_F(ArenaTest, Arena_Rewind) {
+	Arena *a = Arena_New(64);
+
+	char *x = (char *)Arena_Alloc(a, 8);
+	ArenaMark mark = Arena_Mark(a);
+
+	// fill a number of chunks
+	char *last = NULL;
+	for(int i = 0; i < 32; i++) last = (char *)Arena_Alloc(a, 48);
+	ASSERT_TRUE(Arena_Contains(a, last));
+
+	// allocations made after the mark are released
+	Arena_Rewind(a, mark);
+	ASSERT_TRUE(Arena_Contains(a, x));
+	ASSERT_FALSE(Arena_Contains(a, last));
+
+	// released memory is reused
+	char *y = (char *)Arena_Alloc(a, 8);
+	ASSERT_EQ(y, x + 8);
+
+	Arena_Free(a);
+}
+
+TEST_F(ArenaTest, Arena_TransientString) {
+	// without an active arena transient strings are heap allocated
+	ASSERT_TRUE(Arena_GetActive() == NULL);
+	SIValue v = SI_TransientStringVal("abc");
+	ASSERT_EQ(v.allocation, M_SELF);
+	ASSERT_STREQ(v.stringval, "abc");
+	SIValue_Free(v);
+
+	// with an active arena transient strings are owned by the arena
+	Arena *a = Arena_New(64);
+	Arena_SetActive(a);
+
+	v = SI_TransientStringVal("abc");
+	ASSERT_EQ(v.allocation, M_CONST);
+	ASSERT_STREQ(v.stringval, "abc");
+	ASSERT_TRUE(Arena_Contains(a, v.stringval));
+
+	// cloning a transient string moves it to the heap
+	SIValue clone = SI_CloneValue(v);
+	ASSERT_EQ(clone.allocation, M_SELF);
+	ASSERT_FALSE(Arena_Contains(a, clone.stringval));
+	SIValue_Free(clone);
+
+	// freeing the arena deactivates it
+	Arena_Free(a);
+	ASSERT_TRUE(Arena_GetActive() == NULL);
+}
+
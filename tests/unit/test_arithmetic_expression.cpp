@@ -1758,3 +1758,67 @@ TEST_F(ArithmeticTest, ReplaceTest) {
 	ASSERT_EQ(AR_EXP_CONSTANT, arExp->operand.type);
 	ASSERT_EQ(0, SIValue_Compare(SI_ConstStringVal("0a0b0c0a0b0c0"), arExp->operand.constant, NULL));
 }
+
+TEST_F(ArithmeticTest, CompiledEvaluation) {
+	rax *mapping = raxNew();
+	raxInsert(mapping, (unsigned char *)"x", 1, (void *)0, NULL);
+	raxInsert(mapping, (unsigned char *)"s", 1, (void *)1, NULL);
+	Record r = Record_New(mapping);
+
+	// x + 1 < 10 = true
+	AR_ExpNode *add = AR_EXP_NewOpNode("add", 2);
+	add->op.children[0] = AR_EXP_NewVariableOperandNode("x");
+	add->op.children[1] = AR_EXP_NewConstOperandNode(SI_LongVal(1));
+	AR_ExpNode *lt = AR_EXP_NewOpNode("lt", 2);
+	lt->op.children[0] = add;
+	lt->op.children[1] = AR_EXP_NewConstOperandNode(SI_LongVal(10));
+	AR_ExpNode *eq = AR_EXP_NewOpNode("eq", 2);
+	eq->op.children[0] = lt;
+	eq->op.children[1] = AR_EXP_NewConstOperandNode(SI_BoolVal(true));
+
+	// toLower(s)
+	AR_ExpNode *lower = AR_EXP_NewOpNode("tolower", 1);
+	lower->op.children[0] = AR_EXP_NewVariableOperandNode("s");
+
+	// compiled program is reused across evaluations and records
+	for(int i = 0; i < 20; i++) {
+		Record_AddScalar(r, 0, SI_LongVal(i));
+		Record_AddScalar(r, 1, SI_ConstStringVal((char *)"AbC"));
+
+		SIValue res = AR_EXP_Evaluate(eq, r);
+		ASSERT_EQ(SI_TYPE(res), T_BOOL);
+		ASSERT_EQ(res.longval, i + 1 < 10);
+
+		res = AR_EXP_Evaluate(lower, r);
+		ASSERT_STREQ(res.stringval, "abc");
+		SIValue_Free(res);
+	}
+
+	// mismatched types fall back to the generic function call
+	Record_AddScalar(r, 0, SI_DoubleVal(1.5));
+	SIValue res = AR_EXP_Evaluate(eq, r);
+	ASSERT_EQ(SI_TYPE(res), T_BOOL);
+	ASSERT_TRUE(res.longval);
+
+	Record_AddScalar(r, 0, SI_NullVal());
+	res = AR_EXP_Evaluate(eq, r);
+	ASSERT_EQ(SI_TYPE(res), T_NULL);
+
+	// clones share the compiled program, which outlives the original tree
+	AR_ExpNode *clone = AR_EXP_Clone(eq);
+	AR_EXP_Free(eq);
+
+	Record_AddScalar(r, 0, SI_LongVal(3));
+	res = AR_EXP_Evaluate(clone, r);
+	ASSERT_EQ(SI_TYPE(res), T_BOOL);
+	ASSERT_TRUE(res.longval);
+
+	Record_AddScalar(r, 0, SI_LongVal(12));
+	res = AR_EXP_Evaluate(clone, r);
+	ASSERT_FALSE(res.longval);
+
+	AR_EXP_Free(clone);
+	AR_EXP_Free(lower);
+	Record_Free(r);
+	raxFree(mapping);
+}
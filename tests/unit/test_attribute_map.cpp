@@ -0,0 +1,67 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include "../../src/util/rmalloc.h"
+#include "../../src/graph/attribute_map.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class AttributeMapTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(AttributeMapTest, AttributeMap_FindOrAdd) {
+	AttributeMap *map = AttributeMap_New();
+	ASSERT_EQ(AttributeMap_Count(map), 0);
+	ASSERT_EQ(AttributeMap_Find(map, "a"), ATTRIBUTE_NOTFOUND);
+
+	ASSERT_EQ(AttributeMap_Add(map, "a"), 0);
+	ASSERT_EQ(AttributeMap_Add(map, "b"), 1);
+
+	ASSERT_EQ(AttributeMap_Count(map), 2);
+	ASSERT_EQ(AttributeMap_Find(map, "a"), 0);
+	ASSERT_EQ(AttributeMap_Find(map, "b"), 1);
+	ASSERT_EQ(AttributeMap_Find(map, "c"), ATTRIBUTE_NOTFOUND);
+	ASSERT_STREQ(AttributeMap_GetName(map, 0), "a");
+	ASSERT_STREQ(AttributeMap_GetName(map, 1), "b");
+
+	AttributeMap_Free(map);
+}
+
+TEST_F(AttributeMapTest, AttributeMap_Grow) {
+	AttributeMap *map = AttributeMap_New();
+	char name[32];
+	int n = 1000;
+
+	// add enough attributes to force both the table and names array to grow
+	for(int i = 0; i < n; i++) {
+		sprintf(name, "attr_%d", i);
+		ASSERT_EQ(AttributeMap_Add(map, name), i);
+	}
+
+	ASSERT_EQ(AttributeMap_Count(map), n);
+	for(int i = 0; i < n; i++) {
+		sprintf(name, "attr_%d", i);
+		ASSERT_EQ(AttributeMap_Find(map, name), i);
+		ASSERT_STREQ(AttributeMap_GetName(map, i), name);
+	}
+
+	AttributeMap_Free(map);
+}
+
@@ -0,0 +1,127 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../../src/value.h"
+#include "../../src/util/arr.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/schema/attribute_stats.h"
+#ifdef __cplusplus
+}
+#endif
+
+class AttributeStatsTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(AttributeStatsTest, AttributeStats_Add) {
+	AttributeStats stats;
+	AttributeStats_Init(&stats, 0);
+
+	ASSERT_EQ(stats.count, 0);
+	ASSERT_EQ(AttributeStats_DistinctCount(&stats), 0);
+
+	// introduce 5000 values, 1000 of which are distinct
+	for(int i = 0; i < 5000; i++) {
+		AttributeStats_Add(&stats, SI_LongVal(i % 1000));
+	}
+
+	ASSERT_EQ(stats.count, 5000);
+	ASSERT_EQ(stats.min.longval, 0);
+	ASSERT_EQ(stats.max.longval, 999);
+	ASSERT_TRUE(stats.bounds == NULL);
+
+	// HyperLogLog estimate is expected to be within 10% of the true count
+	uint64_t distinct = AttributeStats_DistinctCount(&stats);
+	ASSERT_GT(distinct, 900);
+	ASSERT_LT(distinct, 1100);
+
+	AttributeStats_Free(&stats);
+}
+
+TEST_F(AttributeStatsTest, AttributeStats_Remove) {
+	AttributeStats stats;
+	AttributeStats_Init(&stats, 0);
+
+	AttributeStats_Add(&stats, SI_LongVal(1));
+	AttributeStats_Add(&stats, SI_LongVal(2));
+
+	// removing a value decreases count, min and max are kept
+	AttributeStats_Remove(&stats, SI_LongVal(1));
+	ASSERT_EQ(stats.count, 1);
+	ASSERT_EQ(stats.min.longval, 1);
+	ASSERT_EQ(stats.max.longval, 2);
+
+	// removing the last value resets statistics
+	AttributeStats_Remove(&stats, SI_LongVal(2));
+	ASSERT_EQ(stats.count, 0);
+	ASSERT_EQ(SI_TYPE(stats.min), T_NULL);
+	ASSERT_EQ(SI_TYPE(stats.max), T_NULL);
+	ASSERT_EQ(AttributeStats_DistinctCount(&stats), 0);
+
+	// removing from empty statistics doesn't wrap the count
+	AttributeStats_Remove(&stats, SI_LongVal(2));
+	ASSERT_EQ(stats.count, 0);
+
+	AttributeStats_Free(&stats);
+}
+
+TEST_F(AttributeStatsTest, AttributeStats_MinMaxStrings) {
+	AttributeStats stats;
+	AttributeStats_Init(&stats, 0);
+
+	AttributeStats_Add(&stats, SI_ConstStringVal((char *)"b"));
+	AttributeStats_Add(&stats, SI_ConstStringVal((char *)"a"));
+	AttributeStats_Add(&stats, SI_ConstStringVal((char *)"c"));
+
+	// min and max own their strings
+	ASSERT_STREQ(stats.min.stringval, "a");
+	ASSERT_STREQ(stats.max.stringval, "c");
+
+	AttributeStats_Free(&stats);
+}
+
+TEST_F(AttributeStatsTest, AttributeStats_BuildHistogram) {
+	AttributeStats stats;
+	AttributeStats_Init(&stats, 0);
+
+	// values in descending order
+	uint n = 100;
+	SIValue *values = array_new(SIValue, n);
+	for(uint i = 0; i < n; i++) {
+		SIValue v = SI_LongVal(n - i);
+		AttributeStats_Add(&stats, v);
+		array_append(values, v);
+	}
+
+	AttributeStats_BuildHistogram(&stats, values, n);
+
+	// 100 values in 15 buckets of 7 values each, last bucket holds 2
+	uint bucket_count = array_len(stats.bounds);
+	ASSERT_EQ(stats.depth, 7);
+	ASSERT_EQ(bucket_count, 15);
+
+	for(uint i = 0; i < bucket_count - 1; i++) {
+		ASSERT_EQ(stats.bounds[i].longval, (i + 1) * 7);
+	}
+	ASSERT_EQ(stats.bounds[bucket_count - 1].longval, 100);
+
+	// rebuilding replaces the previous histogram
+	AttributeStats_BuildHistogram(&stats, values, 7);
+	ASSERT_EQ(array_len(stats.bounds), 7);
+
+	array_free(values);
+	AttributeStats_Free(&stats);
+}
+
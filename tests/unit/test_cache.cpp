@@ -102,3 +102,29 @@ TEST_F(CacheTest, ExecutionPlanCache) {
 	ASSERT_EQ(free_count, 9);
 }
 
+
+static int visit_count = 0;  // count how many cache objects been visited
+
+void CacheObj_Visit(CacheObj *obj, void *pdata) {
+	visit_count++;
+}
+
+TEST_F(CacheTest, CacheVisit) {
+	Cache *cache = Cache_New(1, (CacheEntryFreeFunc)CacheObj_Free,
+			(CacheEntryCopyFunc)CacheObj_Dup);
+
+	const char *key = "MATCH (a) RETURN a";
+	Cache_SetValue(cache, key, CacheObj_New("1"));
+
+	// visit an existing entry
+	ASSERT_TRUE(Cache_Visit(cache, key, (CacheEntryVisitFunc)CacheObj_Visit,
+				NULL));
+	ASSERT_EQ(visit_count, 1);
+
+	// visit a missing entry
+	ASSERT_FALSE(Cache_Visit(cache, "None existing",
+				(CacheEntryVisitFunc)CacheObj_Visit, NULL));
+	ASSERT_EQ(visit_count, 1);
+
+	Cache_Free(cache);
+}
@@ -188,3 +188,80 @@ TEST_F(CRONTest, AbortRunningTask) {
 	ASSERT_GT(time_taken_sec, 2);
 }
 
+
+static int executed = 0;  // number of executed count tasks
+
+static void count_task(void *pdata) {
+	__atomic_fetch_add(&executed, 1, __ATOMIC_RELAXED);
+}
+
+TEST_F(CRONTest, ManyTasks) {
+	// issue tasks spread across multiple wheel levels
+	// abort every other task
+	// validate only none aborted tasks executed
+
+	int n = 1000;
+	CronTaskHandle handles[1000];
+
+	for(int i = 0; i < n; i++) {
+		handles[i] = Cron_AddTask((i * 7) % 1500, count_task, NULL);
+	}
+
+	// a task due far in the future
+	CronTaskHandle far_task = Cron_AddTask(100000, count_task, NULL);
+
+	for(int i = 0; i < n; i += 2) Cron_AbortTask(handles[i]);
+	Cron_AbortTask(far_task);
+
+	sleep(2); // sleep for 2 sec
+
+	ASSERT_EQ(executed, n / 2);
+}
+
+#define CASCADE_TASK_COUNT 16
+
+static uint64_t ms_now(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+typedef struct {
+	uint64_t due;       // time task is due at
+	uint64_t ran;       // time task executed at, 0 if it did not run
+} TimedTask;
+
+static void timed_task(void *pdata) {
+	TimedTask *t = (TimedTask *)pdata;
+	__atomic_store_n(&t->ran, ms_now(), __ATOMIC_RELEASE);
+}
+
+TEST_F(CRONTest, CascadeFromLevel2) {
+	// level 2 slots hold tasks due 64^2 = 4096 ticks ahead or later
+	// such tasks are cascaded to level 1 and then to level 0
+	// before being executed, validate they run on time
+	TimedTask tasks[CASCADE_TASK_COUNT];
+	CronTaskHandle handles[CASCADE_TASK_COUNT];
+
+	for(int i = 0; i < CASCADE_TASK_COUNT; i++) {
+		uint when = 4100 + i * 37;
+		tasks[i].ran = 0;
+		tasks[i].due = ms_now() + when;
+		handles[i] = Cron_AddTask(when, timed_task, tasks + i);
+	}
+
+	// abort a task ahead of its execution
+	sleep(3);
+	Cron_AbortTask(handles[0]);
+
+	sleep(3); // sleep past the last task's due time
+
+	ASSERT_EQ(__atomic_load_n(&tasks[0].ran, __ATOMIC_ACQUIRE), 0);
+	for(int i = 1; i < CASCADE_TASK_COUNT; i++) {
+		uint64_t ran = __atomic_load_n(&tasks[i].ran, __ATOMIC_ACQUIRE);
+		// task must not run early, nor be held back by cascading
+		// allow for a millisecond of rounding
+		ASSERT_GE(ran + 1, tasks[i].due);
+		ASSERT_LT(ran, tasks[i].due + 100);
+	}
+}
@@ -44,8 +44,8 @@ class FilterTreeTest: public ::testing::Test {
 		 * accessible via thread local storage, as such we're creating a
 		 * fake graph context and placing it within thread local storage. */
 		GraphContext *gc = (GraphContext *)calloc(1, sizeof(GraphContext));
-		gc->attributes = raxNew();
-		pthread_rwlock_init(&gc->_attribute_rwlock, NULL);
+		gc->attributes = AttributeMap_New();
+		pthread_mutex_init(&gc->_attribute_lock, NULL);
 
 		// No indicies.
 		gc->index_count = 0;
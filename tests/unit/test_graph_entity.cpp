@@ -0,0 +1,133 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <string.h>
+#include "../../src/value.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/graph/entities/graph_entity.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class GraphEntityTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(GraphEntityTest, PropertyBag) {
+	Entity en = {0, NULL};
+	GraphEntity ge = {&en, 0};
+
+	char long_str[256];
+	memset(long_str, 'x', sizeof(long_str) - 1);
+	long_str[sizeof(long_str) - 1] = '\0';
+
+	ASSERT_TRUE(GraphEntity_AddProperty(&ge, 0, SI_ConstStringVal((char *)"short")));
+	ASSERT_TRUE(GraphEntity_AddProperty(&ge, 1, SI_LongVal(7)));
+	ASSERT_TRUE(GraphEntity_AddProperty(&ge, 2, SI_ConstStringVal(long_str)));
+	ASSERT_EQ(ENTITY_PROP_COUNT(&ge), 3);
+
+	// short strings reside within the property bag
+	SIValue *v = GraphEntity_GetProperty(&ge, 0);
+	ASSERT_STREQ(v->stringval, "short");
+	ASSERT_EQ(v->allocation, M_CONST);
+	ASSERT_EQ(v->stringval, (char *)(ENTITY_PROPS(&ge) + 3));
+
+	// long strings are allocated separately
+	v = GraphEntity_GetProperty(&ge, 2);
+	ASSERT_STREQ(v->stringval, long_str);
+	ASSERT_EQ(v->allocation, M_SELF);
+
+	ASSERT_EQ(GraphEntity_GetProperty(&ge, 1)->longval, 7);
+
+	// set a property to the value of another property
+	SIValue short_val = *GraphEntity_GetProperty(&ge, 0);
+	ASSERT_TRUE(GraphEntity_SetProperty(&ge, 1, short_val));
+	ASSERT_STREQ(GraphEntity_GetProperty(&ge, 0)->stringval, "short");
+	ASSERT_STREQ(GraphEntity_GetProperty(&ge, 1)->stringval, "short");
+
+	// replace inlined string with a long string
+	ASSERT_TRUE(GraphEntity_SetProperty(&ge, 0, SI_ConstStringVal(long_str)));
+	ASSERT_STREQ(GraphEntity_GetProperty(&ge, 0)->stringval, long_str);
+	ASSERT_EQ(GraphEntity_GetProperty(&ge, 0)->allocation, M_SELF);
+
+	// remove property
+	ASSERT_TRUE(GraphEntity_SetProperty(&ge, 1, SI_NullVal()));
+	ASSERT_EQ(ENTITY_PROP_COUNT(&ge), 2);
+	ASSERT_EQ(GraphEntity_GetProperty(&ge, 1), PROPERTY_NOTFOUND);
+	ASSERT_STREQ(GraphEntity_GetProperty(&ge, 2)->stringval, long_str);
+
+	ASSERT_EQ(GraphEntity_ClearProperties(&ge), 2);
+	ASSERT_EQ(ENTITY_PROP_COUNT(&ge), 0);
+	ASSERT_TRUE(ENTITY_PROPS(&ge) == NULL);
+}
+
+
+TEST_F(GraphEntityTest, AddProperties) {
+	Entity en = {0, NULL};
+	GraphEntity ge = {&en, 0};
+
+	char long_str[256];
+	memset(long_str, 'x', sizeof(long_str) - 1);
+	long_str[sizeof(long_str) - 1] = '\0';
+
+	Attribute_ID ids[4] = {0, 1, 2, 3};
+	SIValue values[4] = {
+		SI_ConstStringVal((char *)"a"),
+		SI_LongVal(1),
+		SI_ConstStringVal(long_str),
+		SI_ConstStringVal((char *)"b")
+	};
+
+	ASSERT_EQ(GraphEntity_AddProperties(&ge, ids, values, 4), 4);
+	ASSERT_EQ(ENTITY_PROP_COUNT(&ge), 4);
+	ASSERT_STREQ(GraphEntity_GetProperty(&ge, 0)->stringval, "a");
+	ASSERT_EQ(GraphEntity_GetProperty(&ge, 1)->longval, 1);
+	ASSERT_STREQ(GraphEntity_GetProperty(&ge, 2)->stringval, long_str);
+	ASSERT_STREQ(GraphEntity_GetProperty(&ge, 3)->stringval, "b");
+
+	// growing the bag relocates short strings past the property array
+	Attribute_ID more_ids[3] = {4, 5, 6};
+	SIValue more_values[3] = {
+		SI_ConstStringVal((char *)"c"),
+		SI_NullVal(),  // invalid property values are skipped
+		SI_DoubleVal(2.5)
+	};
+
+	ASSERT_EQ(GraphEntity_AddProperties(&ge, more_ids, more_values, 3), 2);
+	ASSERT_EQ(ENTITY_PROP_COUNT(&ge), 6);
+	ASSERT_EQ(GraphEntity_GetProperty(&ge, 5), PROPERTY_NOTFOUND);
+
+	const char *expected[3] = {"a", "b", "c"};
+	Attribute_ID inlined[3] = {0, 3, 4};
+	char *tail = (char *)(ENTITY_PROPS(&ge) + 6);
+	for(int i = 0; i < 3; i++) {
+		SIValue *v = GraphEntity_GetProperty(&ge, inlined[i]);
+		ASSERT_EQ(v->allocation, M_CONST);
+		ASSERT_EQ(v->stringval, tail);
+		ASSERT_STREQ(v->stringval, expected[i]);
+		tail += strlen(tail) + 1;
+	}
+	ASSERT_EQ(GraphEntity_GetProperty(&ge, 6)->doubleval, 2.5);
+
+	// add a property holding the value of an existing short string
+	SIValue aliased = *GraphEntity_GetProperty(&ge, 3);
+	ASSERT_TRUE(GraphEntity_AddProperty(&ge, 7, aliased));
+	ASSERT_STREQ(GraphEntity_GetProperty(&ge, 7)->stringval, "b");
+	ASSERT_STREQ(GraphEntity_GetProperty(&ge, 3)->stringval, "b");
+
+	ASSERT_EQ(GraphEntity_ClearProperties(&ge), 7);
+}
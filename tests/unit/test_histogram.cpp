@@ -0,0 +1,58 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <string.h>
+#include "../../src/util/histogram.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class HistogramTest: public ::testing::Test {};
+
+TEST_F(HistogramTest, Histogram_Percentile) {
+	Histogram h;
+	memset(&h, 0, sizeof(Histogram));
+
+	// empty histogram
+	ASSERT_EQ(Histogram_Percentile(&h, 99), 0);
+
+	// 99 fast samples and a single slow sample
+	for(int i = 0; i < 99; i++) Histogram_Record(&h, 1);
+	Histogram_Record(&h, 100);
+	ASSERT_EQ(h.count, 100);
+
+	// reported percentiles are at most ~19% above the recorded values
+	double p50 = Histogram_Percentile(&h, 50);
+	ASSERT_GE(p50, 1);
+	ASSERT_LE(p50, 1.19);
+
+	double p99 = Histogram_Percentile(&h, 99);
+	ASSERT_GE(p99, 1);
+	ASSERT_LE(p99, 1.19);
+
+	double p100 = Histogram_Percentile(&h, 100);
+	ASSERT_GE(p100, 100);
+	ASSERT_LE(p100, 119);
+
+	// sub-microsecond samples
+	Histogram sub;
+	memset(&sub, 0, sizeof(Histogram));
+	Histogram_Record(&sub, 0);
+	ASSERT_EQ(Histogram_Percentile(&sub, 100), 0.001);
+
+	// merged histogram holds the samples of both histograms
+	Histogram_Merge(&h, &sub);
+	ASSERT_EQ(h.count, 101);
+	ASSERT_EQ(Histogram_Percentile(&h, 0.5), 0.001);
+}
+
@@ -0,0 +1,369 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../../src/value.h"
+#include "../../src/query_ctx.h"
+#include "../../src/util/arr.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/arithmetic/funcs.h"
+#include "../../src/index/native_index.h"
+#include "../../src/filter_tree/ft_to_native.h"
+#include "../../src/ast/ast_build_filter_tree.h"
+#ifdef __cplusplus
+}
+#endif
+
+class NativeIndexTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// use the malloc family for allocations
+		Alloc_Reset();
+		_fake_graph_context();
+	}
+
+	static void TearDownTestCase() {
+		GraphContext *gc = QueryCtx_GetGraphCtx();
+		free(gc);
+	}
+
+	static void _fake_graph_context() {
+		// resolving filters into seeks requires access to attribute IDs
+		// which reside within the graph context
+		GraphContext *gc = (GraphContext *)calloc(1, sizeof(GraphContext));
+		gc->attributes = AttributeMap_New();
+		pthread_mutex_init(&gc->_attribute_lock, NULL);
+		AttributeMap_Add(gc->attributes, "v");
+
+		ASSERT_TRUE(QueryCtx_Init());
+		QueryCtx_SetGraphCtx(gc);
+		AR_RegisterFuncs();
+	}
+};
+
+// collect all IDs reported by iterator
+static EntityID *_Collect(NativeIndexIterator *it) {
+	EntityID id;
+	EntityID *ids = array_new(EntityID, 0);
+	while(NativeIndexIterator_Next(it, &id)) array_append(ids, id);
+	return ids;
+}
+
+TEST_F(NativeIndexTest, NativeIndex_Equals) {
+	NativeIndex *idx = NativeIndex_New();
+
+	// attribute 0 holds i % 3, attribute 1 holds i
+	for(EntityID i = 0; i < 9; i++) {
+		NativeIndex_Add(idx, i, 0, SI_LongVal(i % 3));
+		NativeIndex_Add(idx, i, 1, SI_LongVal(i));
+	}
+	ASSERT_EQ(NativeIndex_EntryCount(idx), 18);
+
+	NativeIndexIterator *it = NativeIndexIterator_New(idx);
+	NativeIndexIterator_AddEquals(it, 0, SI_DoubleVal(1.0));
+
+	// integers and floating points compare as equal, IDs are sorted
+	EntityID *ids = _Collect(it);
+	ASSERT_EQ(array_len(ids), 3);
+	ASSERT_EQ(ids[0], 1);
+	ASSERT_EQ(ids[1], 4);
+	ASSERT_EQ(ids[2], 7);
+	array_free(ids);
+
+	// reset restarts the scan
+	NativeIndexIterator_Reset(it);
+	ids = _Collect(it);
+	ASSERT_EQ(array_len(ids), 3);
+	array_free(ids);
+
+	NativeIndexIterator_Free(it);
+	NativeIndex_Free(idx);
+}
+
+TEST_F(NativeIndexTest, NativeIndex_Range) {
+	NativeIndex *idx = NativeIndex_New();
+
+	// negative, zero and positive values
+	for(EntityID i = 0; i < 10; i++) {
+		NativeIndex_Add(idx, i, 0, SI_DoubleVal((double)i - 5.5));
+	}
+	NativeIndex_Add(idx, 10, 0, SI_ConstStringVal((char *)"a"));
+
+	SIValue lo = SI_LongVal(-3);
+	SIValue hi = SI_LongVal(2);
+
+	NativeIndexIterator *it = NativeIndexIterator_New(idx);
+	NativeIndexIterator_AddRange(it, 0, &lo, &hi);
+
+	// -2.5, -1.5, -0.5, 0.5, 1.5
+	EntityID *ids = _Collect(it);
+	ASSERT_EQ(array_len(ids), 5);
+	for(uint i = 0; i < 5; i++) ASSERT_EQ(ids[i], i + 3);
+	array_free(ids);
+	NativeIndexIterator_Free(it);
+
+	// unbounded range only covers values of the same type
+	it = NativeIndexIterator_New(idx);
+	NativeIndexIterator_AddRange(it, 0, &lo, NULL);
+	ids = _Collect(it);
+	ASSERT_EQ(array_len(ids), 7);
+	array_free(ids);
+	NativeIndexIterator_Free(it);
+
+	// bounds of different types yield nothing
+	SIValue s = SI_ConstStringVal((char *)"z");
+	it = NativeIndexIterator_New(idx);
+	NativeIndexIterator_AddRange(it, 0, &lo, &s);
+	ids = _Collect(it);
+	ASSERT_EQ(array_len(ids), 0);
+	array_free(ids);
+	NativeIndexIterator_Free(it);
+
+	NativeIndex_Free(idx);
+}
+
+TEST_F(NativeIndexTest, NativeIndex_OverlappingRanges) {
+	NativeIndex *idx = NativeIndex_New();
+
+	for(EntityID i = 0; i < 4; i++) {
+		NativeIndex_Add(idx, i, 0, SI_LongVal(i));
+	}
+
+	// IN [2, 0, 2], duplicates are reported once
+	NativeIndexIterator *it = NativeIndexIterator_New(idx);
+	NativeIndexIterator_AddEquals(it, 0, SI_LongVal(2));
+	NativeIndexIterator_AddEquals(it, 0, SI_LongVal(0));
+	NativeIndexIterator_AddEquals(it, 0, SI_LongVal(2));
+
+	EntityID *ids = _Collect(it);
+	ASSERT_EQ(array_len(ids), 2);
+	ASSERT_EQ(ids[0], 0);
+	ASSERT_EQ(ids[1], 2);
+	array_free(ids);
+
+	NativeIndexIterator_Free(it);
+	NativeIndex_Free(idx);
+}
+
+TEST_F(NativeIndexTest, NativeIndex_Remove) {
+	NativeIndex *idx = NativeIndex_New();
+
+	for(EntityID i = 0; i < 6; i++) {
+		NativeIndex_Add(idx, i, 0, SI_LongVal(1));
+	}
+
+	NativeIndexIterator *it = NativeIndexIterator_New(idx);
+	NativeIndexIterator_AddEquals(it, 0, SI_LongVal(1));
+
+	// remove entities while iterating
+	EntityID id;
+	uint count = 0;
+	while(NativeIndexIterator_Next(it, &id)) {
+		count++;
+		NativeIndex_Remove(idx, id);
+		NativeIndex_Remove(idx, id + 1);
+	}
+
+	// every other entity been removed before it was reached
+	ASSERT_EQ(count, 3);
+	ASSERT_EQ(NativeIndex_EntryCount(idx), 0);
+
+	NativeIndexIterator_Free(it);
+	NativeIndex_Free(idx);
+}
+
+TEST_F(NativeIndexTest, NativeIndex_Composite) {
+	NativeIndex *idx = NativeIndex_New();
+
+	// composite key over attributes 0 and 1
+	Attribute_ID attrs[2] = {0, 1};
+	NativeIndex_SetComposite(idx, attrs, 2);
+
+	// attribute 0 holds i % 2, attribute 1 holds i
+	// entity 10 lacks attribute 1
+	for(EntityID i = 0; i < 10; i++) {
+		SIValue values[2] = {SI_LongVal(i % 2), SI_LongVal(i)};
+		NativeIndex_AddComposite(idx, i, values);
+	}
+	SIValue values[2] = {SI_LongVal(0), SI_NullVal()};
+	NativeIndex_AddComposite(idx, 10, values);
+
+	// a = 0 AND b >= 4
+	SIValue prefix = SI_LongVal(0);
+	SIValue lo = SI_LongVal(4);
+	NativeIndexIterator *it = NativeIndexIterator_New(idx);
+	NativeIndexIterator_AddCompositeRange(it, &prefix, 1, &lo, NULL);
+
+	EntityID *ids = _Collect(it);
+	ASSERT_EQ(array_len(ids), 3);
+	ASSERT_EQ(ids[0], 4);
+	ASSERT_EQ(ids[1], 6);
+	ASSERT_EQ(ids[2], 8);
+	array_free(ids);
+	NativeIndexIterator_Free(it);
+
+	// a = 0, prefix only
+	it = NativeIndexIterator_New(idx);
+	NativeIndexIterator_AddCompositeRange(it, &prefix, 1, NULL, NULL);
+	ids = _Collect(it);
+	ASSERT_EQ(array_len(ids), 6);
+	array_free(ids);
+	NativeIndexIterator_Free(it);
+
+	// a = 1 AND b = 3
+	SIValue full[2] = {SI_LongVal(1), SI_LongVal(3)};
+	it = NativeIndexIterator_New(idx);
+	NativeIndexIterator_AddCompositeRange(it, full, 2, NULL, NULL);
+	ids = _Collect(it);
+	ASSERT_EQ(array_len(ids), 1);
+	ASSERT_EQ(ids[0], 3);
+	array_free(ids);
+	NativeIndexIterator_Free(it);
+
+	// composite keys aren't counted as entries
+	ASSERT_EQ(NativeIndex_EntryCount(idx), 0);
+	NativeIndex_Add(idx, 3, 0, SI_LongVal(1));
+	NativeIndex_Add(idx, 3, 1, SI_LongVal(3));
+	ASSERT_EQ(NativeIndex_EntryCount(idx), 2);
+
+	// entity's composite key is removed along with its entries
+	NativeIndex_Remove(idx, 3);
+	ASSERT_EQ(NativeIndex_EntryCount(idx), 0);
+
+	NativeIndex_Free(idx);
+}
+
+TEST_F(NativeIndexTest, NativeIndex_Ordered) {
+	NativeIndex *idx = NativeIndex_New();
+
+	// numerics, a string and a boolean
+	for(EntityID i = 0; i < 5; i++) {
+		NativeIndex_Add(idx, i, 0, SI_LongVal(i * 10));
+	}
+	NativeIndex_Add(idx, 5, 0, SI_ConstStringVal((char *)"a"));
+	NativeIndex_Add(idx, 6, 0, SI_BoolVal(true));
+	NativeIndex_Add(idx, 7, 1, SI_LongVal(1));
+
+	ASSERT_EQ(NativeIndex_AttributeCount(idx, 0), 7);
+	ASSERT_EQ(NativeIndex_AttributeCount(idx, 1), 1);
+	ASSERT_EQ(NativeIndex_AttributeCount(idx, 2), 0);
+
+	// ranges are scanned in the order they were introduced
+	NativeIndexIterator *it = NativeIndexIterator_New(idx);
+	NativeIndexIterator_AddType(it, 0, T_STRING);
+	NativeIndexIterator_AddType(it, 0, T_BOOL);
+	NativeIndexIterator_AddType(it, 0, T_INT64);
+	NativeIndexIterator_SetOrder(it, false);
+
+	EntityID *ids = _Collect(it);
+	EntityID ascending[7] = {5, 6, 0, 1, 2, 3, 4};
+	ASSERT_EQ(array_len(ids), 7);
+	for(uint i = 0; i < 7; i++) ASSERT_EQ(ids[i], ascending[i]);
+	array_free(ids);
+	NativeIndexIterator_Free(it);
+
+	// descending order
+	it = NativeIndexIterator_New(idx);
+	NativeIndexIterator_AddType(it, 0, T_STRING);
+	NativeIndexIterator_AddType(it, 0, T_BOOL);
+	NativeIndexIterator_AddType(it, 0, T_INT64);
+	NativeIndexIterator_SetOrder(it, true);
+
+	EntityID id;
+	ASSERT_TRUE(NativeIndexIterator_Next(it, &id));
+	ASSERT_EQ(id, 4);
+
+	// removal while iterating descending
+	NativeIndex_Remove(idx, 3);
+	ASSERT_EQ(NativeIndex_AttributeCount(idx, 0), 6);
+
+	ids = _Collect(it);
+	EntityID descending[5] = {2, 1, 0, 6, 5};
+	ASSERT_EQ(array_len(ids), 5);
+	for(uint i = 0; i < 5; i++) ASSERT_EQ(ids[i], descending[i]);
+	array_free(ids);
+	NativeIndexIterator_Free(it);
+
+	NativeIndex_Free(idx);
+}
+
+// seek by the filter in query, returns the IDs reported by the seek alone
+static EntityID *_Seek(const NativeIndex *idx, const char *query) {
+	cypher_parse_result_t *parse_result = cypher_parse(query, NULL, NULL,
+			CYPHER_PARSE_ONLY_STATEMENTS);
+	AST *ast = AST_Build(parse_result);
+	FT_FilterNode *filter = AST_BuildFilterTree(ast);
+
+	NativeIndexIterator *it = NativeIndexIterator_New(idx);
+	FilterTreeToNativeRanges(it, filter);
+	EntityID *ids = _Collect(it);
+
+	NativeIndexIterator_Free(it);
+	FilterTree_Free(filter);
+	AST_Free(ast);
+	return ids;
+}
+
+TEST_F(NativeIndexTest, NativeIndex_FilterSeek) {
+	NativeIndex *idx = NativeIndex_New();
+
+	// attribute 'v' holds i
+	Attribute_ID v = GraphContext_GetAttributeID(QueryCtx_GetGraphCtx(), "v");
+	for(EntityID i = 0; i < 10; i++) {
+		NativeIndex_Add(idx, i, v, SI_LongVal(i));
+	}
+
+	// literals are parameterized ahead of planning
+	// constants and parameters must both seek rather than scan 'v'
+	rax *params = raxNew();
+	raxInsert(params, (unsigned char *)"p", 1,
+			AR_EXP_NewConstOperandNode(SI_LongVal(4)), NULL);
+	raxInsert(params, (unsigned char *)"m", 1,
+			AR_EXP_NewConstOperandNode(SI_LongVal(-4)), NULL);
+	raxInsert(params, (unsigned char *)"lo", 2,
+			AR_EXP_NewConstOperandNode(SI_LongVal(3)), NULL);
+	raxInsert(params, (unsigned char *)"hi", 2,
+			AR_EXP_NewConstOperandNode(SI_LongVal(6)), NULL);
+	QueryCtx_SetParams(params);
+
+	// equality
+	const char *equals[3] = {
+		"MATCH (n) WHERE n.v = 4 RETURN n",
+		"MATCH (n) WHERE n.v = $p RETURN n",
+		"MATCH (n) WHERE n.v = -$m RETURN n"
+	};
+	for(uint i = 0; i < 3; i++) {
+		EntityID *ids = _Seek(idx, equals[i]);
+		ASSERT_EQ(array_len(ids), 1);
+		ASSERT_EQ(ids[0], 4);
+		array_free(ids);
+	}
+
+	// range, strict bounds are inclusive as the filter is re-applied
+	const char *ranges[2] = {
+		"MATCH (n) WHERE n.v > 3 AND n.v <= 6 RETURN n",
+		"MATCH (n) WHERE n.v > $lo AND n.v <= $hi RETURN n"
+	};
+	for(uint i = 0; i < 2; i++) {
+		EntityID *ids = _Seek(idx, ranges[i]);
+		ASSERT_EQ(array_len(ids), 4);
+		for(uint j = 0; j < 4; j++) ASSERT_EQ(ids[j], j + 3);
+		array_free(ids);
+	}
+
+	// IN list holding a parameter
+	EntityID *ids = _Seek(idx, "MATCH (n) WHERE n.v IN [$p, 7] RETURN n");
+	ASSERT_EQ(array_len(ids), 2);
+	ASSERT_EQ(ids[0], 4);
+	ASSERT_EQ(ids[1], 7);
+	array_free(ids);
+
+	NativeIndex_Free(idx);
+}
@@ -59,3 +59,49 @@ TEST_F(RecordTest, RecordToString) {
 	Record_Free(r);
 }
 
+
+TEST_F(RecordTest, RecordShare) {
+	rax *_rax = raxNew();
+	for(int i = 0; i < 3; i++) {
+		char buf[2] = {(char)i, '\0'};
+		raxInsert(_rax, (unsigned char *)buf, 2, NULL, NULL);
+	}
+
+	Record parent = Record_New(_rax);
+	Record_AddScalar(parent, 0, SI_DuplicateStringVal("shared"));
+	Record_AddScalar(parent, 1, SI_LongVal(1));
+
+	Record child = Record_New(_rax);
+	Record_Share(parent, child);
+	ASSERT_EQ(parent->ref_count, 2);
+
+	// entries are looked up in the shared record
+	ASSERT_TRUE(Record_ContainsEntry(child, 0));
+	ASSERT_FALSE(Record_ContainsEntry(child, 2));
+	ASSERT_EQ(Record_Get(child, 1).longval, 1);
+
+	// shared scalars are not owned by the child
+	SIValue v = Record_Get(child, 0);
+	ASSERT_STREQ(v.stringval, "shared");
+	ASSERT_EQ(v.allocation, M_VOLATILE);
+
+	// entries set on the child shadow shared entries
+	Record_AddScalar(child, 1, SI_LongVal(2));
+	Record_AddScalar(child, 2, SI_LongVal(3));
+	ASSERT_EQ(Record_Get(child, 1).longval, 2);
+	ASSERT_EQ(Record_Get(parent, 1).longval, 1);
+	ASSERT_FALSE(Record_ContainsEntry(parent, 2));
+
+	// cloning a child copies shared entries
+	Record clone = Record_New(_rax);
+	Record_Clone(child, clone);
+	ASSERT_EQ(clone->parent, (Record)NULL);
+	ASSERT_STREQ(Record_Get(clone, 0).stringval, "shared");
+	ASSERT_EQ(Record_Get(clone, 1).longval, 2);
+	ASSERT_EQ(Record_Get(clone, 2).longval, 3);
+
+	Record_Free(clone);
+	Record_Free(child);
+	Record_Free(parent);
+	raxFree(_rax);
+}
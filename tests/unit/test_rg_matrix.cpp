@@ -10,6 +10,7 @@
 extern "C" {
 #endif
 
+#include "../../src/util/arr.h"
 #include "../../src/util/rmalloc.h"
 #include "../../src/configuration/config.h"
 #include "../../src/graph/rg_matrix/rg_matrix.h"
@@ -1457,6 +1458,79 @@ TEST_F(RGMatrixTest, RGMatrix_mxm) {
 	ASSERT_TRUE(C == NULL);
 }
 
+// test RG_Matrix_build_UINT64
+// build tuples into a matrix holding an existing entry
+// expecting duplicates to form a multi-edge entry
+TEST_F(RGMatrixTest, RGMatrix_build) {
+	RG_Matrix   A      =  NULL;
+	GrB_Matrix  M      =  NULL;
+	GrB_Matrix  DP     =  NULL;
+	GrB_Matrix  DM     =  NULL;
+	GrB_Info    info   =  GrB_SUCCESS;
+	GrB_Type    t      =  GrB_UINT64;
+	GrB_Index   nvals  =  0;
+	GrB_Index   nrows  =  100;
+	GrB_Index   ncols  =  100;
+	uint64_t    x      =  0;
+	bool        b      =  false;
+
+	info = RG_Matrix_new(&A, t, nrows, ncols);
+	ASSERT_EQ(info, GrB_SUCCESS);
+
+	M   =  RG_MATRIX_M(A);
+	DP  =  RG_MATRIX_DELTA_PLUS(A);
+	DM  =  RG_MATRIX_DELTA_MINUS(A);
+
+	// pending entry at [0,1]
+	info = RG_Matrix_setElement_UINT64(A, 0, 0, 1);
+	ASSERT_EQ(info, GrB_SUCCESS);
+
+	// tuples sorted by row then column
+	// [0,1] collides with the existing entry
+	// [2,3] is repeated
+	GrB_Index  I[4]  =  {0, 2, 2, 5};
+	GrB_Index  J[4]  =  {1, 3, 3, 6};
+	uint64_t   X[4]  =  {1, 2, 3, 4};
+
+	info = RG_Matrix_build_UINT64(A, I, J, X, 4);
+	ASSERT_EQ(info, GrB_SUCCESS);
+
+	//--------------------------------------------------------------------------
+	// validations
+	//--------------------------------------------------------------------------
+
+	// entries are written directly into M
+	DP_EMPTY();
+	DM_EMPTY();
+
+	RG_Matrix_nvals(&nvals, A);
+	ASSERT_EQ(nvals, 3);
+
+	// [0,1] and [2,3] are multi-edge entries
+	info = RG_Matrix_extractElement_UINT64(&x, A, 0, 1);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	ASSERT_FALSE(SINGLE_EDGE(x));
+	ASSERT_EQ(array_len((uint64_t *)(CLEAR_MSB(x))), 2);
+
+	info = RG_Matrix_extractElement_UINT64(&x, A, 2, 3);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	ASSERT_FALSE(SINGLE_EDGE(x));
+	ASSERT_EQ(array_len((uint64_t *)(CLEAR_MSB(x))), 2);
+
+	info = RG_Matrix_extractElement_UINT64(&x, A, 5, 6);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	ASSERT_EQ(x, 4);
+
+	// transposed matrix is maintained
+	info = RG_Matrix_extractElement_BOOL(&b, RG_Matrix_getTranspose(A), 6, 5);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	RG_Matrix_nvals(&nvals, RG_Matrix_getTranspose(A));
+	ASSERT_EQ(nvals, 3);
+
+	RG_Matrix_free(&A);
+	ASSERT_TRUE(A == NULL);
+}
+
 TEST_F(RGMatrixTest, RGMatrix_resize) {
 	RG_Matrix  A        =  NULL;
 	RG_Matrix  T        =  NULL;
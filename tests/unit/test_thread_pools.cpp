@@ -11,6 +11,7 @@ extern "C" {
 #endif
 
 #include "assert.h"
+#include <unistd.h>
 #include "../../src/util/rmalloc.h"
 #include "../../src/util/thpool/pools.h"
 #include "../../src/configuration/config.h"
@@ -32,10 +33,36 @@ class ThreadPoolsTest: public ::testing::Test {
 
 	static void get_thread_friendly_id(void *arg) {
 		int *threadID = (int*)arg;
-		*threadID = ThreadPools_GetThreadID();	
+		__atomic_store_n(threadID, ThreadPools_GetThreadID(), __ATOMIC_RELEASE);
 	}
 };
 
+#define GROUP_COUNT 200                        // exceeds initial hash buckets
+#define WAIT_TIMEOUT_MS 5000                   // bound on waiting for jobs
+
+static bool writer_blocked = false;            // writer thread is blocked
+static bool writer_release = false;            // release blocked writer
+static int served[GROUP_COUNT * 2];            // order in which jobs ran
+static int served_count = 0;                   // number of jobs ran
+
+// wait until 'flag' equals 'expected', gives up after WAIT_TIMEOUT_MS
+// returns true if 'flag' reached 'expected'
+static bool wait_for(int *flag, int expected) {
+	for(int ms = 0; ms < WAIT_TIMEOUT_MS; ms++) {
+		if(__atomic_load_n(flag, __ATOMIC_ACQUIRE) == expected) return true;
+		usleep(1000);
+	}
+	return __atomic_load_n(flag, __ATOMIC_ACQUIRE) == expected;
+}
+
+static bool wait_for_flag(bool *flag) {
+	for(int ms = 0; ms < WAIT_TIMEOUT_MS; ms++) {
+		if(__atomic_load_n(flag, __ATOMIC_ACQUIRE)) return true;
+		usleep(1000);
+	}
+	return __atomic_load_n(flag, __ATOMIC_ACQUIRE);
+}
+
 TEST_F(ThreadPoolsTest, ThreadPools_ThreadID) {
 	// verify thread count equals to the number of reader and writer threads
 	ASSERT_EQ (READER_COUNT + WRITER_COUNT, ThreadPools_ThreadCount());
@@ -50,7 +77,7 @@ TEST_F(ThreadPoolsTest, ThreadPools_ThreadID) {
 		int offset = i + 1;
 		ASSERT_EQ(0,
 				ThreadPools_AddWorkReader(get_thread_friendly_id,
-					thread_ids + offset));
+					thread_ids + offset, 0));
 	}
 
 	// get writer threads friendly ids
@@ -58,12 +85,16 @@ TEST_F(ThreadPoolsTest, ThreadPools_ThreadID) {
 		int offset = i + READER_COUNT + 1;
 		ASSERT_EQ(0,
 				ThreadPools_AddWorkWriter(get_thread_friendly_id,
-					thread_ids + offset));
+					thread_ids + offset, 0));
 	}
 
 	// wait for all threads
 	for(int i = 0; i < READER_COUNT + WRITER_COUNT + 1; i++) {
-		while(thread_ids[i] == -1) { i = i; }
+		for(int ms = 0; ms < WAIT_TIMEOUT_MS; ms++) {
+			if(__atomic_load_n(thread_ids + i, __ATOMIC_ACQUIRE) != -1) break;
+			usleep(1000);
+		}
+		ASSERT_NE(__atomic_load_n(thread_ids + i, __ATOMIC_ACQUIRE), -1);
 	}
 
 	// main thread
@@ -83,3 +114,73 @@ TEST_F(ThreadPoolsTest, ThreadPools_ThreadID) {
 	}
 }
 
+
+static void block_writer(void *arg) {
+	__atomic_store_n(&writer_blocked, true, __ATOMIC_RELEASE);
+	// bounded, such that a failing test does not hang the writer
+	wait_for_flag(&writer_release);
+}
+
+// jobs run on the single writer thread, one at a time
+static void record_job(void *arg) {
+	int i = __atomic_load_n(&served_count, __ATOMIC_RELAXED);
+	served[i] = (int)(intptr_t)arg;
+	__atomic_store_n(&served_count, i + 1, __ATOMIC_RELEASE);
+}
+
+// occupy the single writer thread, such that jobs accumulate
+static void hold_writer(void) {
+	__atomic_store_n(&writer_blocked, false, __ATOMIC_RELEASE);
+	__atomic_store_n(&writer_release, false, __ATOMIC_RELEASE);
+	__atomic_store_n(&served_count, 0, __ATOMIC_RELEASE);
+
+	ASSERT_EQ(0, ThreadPools_AddWorkWriter(block_writer, NULL, 0));
+	ASSERT_TRUE(wait_for_flag(&writer_blocked));
+}
+
+static void release_writer(void) {
+	__atomic_store_n(&writer_release, true, __ATOMIC_RELEASE);
+}
+
+TEST_F(ThreadPoolsTest, ThreadPools_GroupFairness) {
+	hold_writer();
+
+	// a burst of jobs from group 1 followed by a single job from group 2
+	ASSERT_EQ(0, ThreadPools_AddWorkWriter(record_job, (void *)1, 1));
+	ASSERT_EQ(0, ThreadPools_AddWorkWriter(record_job, (void *)2, 1));
+	ASSERT_EQ(0, ThreadPools_AddWorkWriter(record_job, (void *)3, 1));
+	ASSERT_EQ(0, ThreadPools_AddWorkWriter(record_job, (void *)4, 2));
+
+	release_writer();
+	ASSERT_TRUE(wait_for(&served_count, 4));
+
+	// group 2 is served right after the first job of group 1
+	// jobs within a group are served in order
+	ASSERT_EQ(served[0], 1);
+	ASSERT_EQ(served[1], 4);
+	ASSERT_EQ(served[2], 2);
+	ASSERT_EQ(served[3], 3);
+}
+
+TEST_F(ThreadPoolsTest, ThreadPools_ManyGroups) {
+	hold_writer();
+
+	// two jobs for each of many groups, group ids resemble pointers
+	for(int j = 0; j < 2; j++) {
+		for(int g = 0; g < GROUP_COUNT; g++) {
+			uint64_t group = 0x7f0000001000 + g * 64;
+			intptr_t job = g * 2 + j;
+			ASSERT_EQ(0, ThreadPools_AddWorkWriter(record_job, (void *)job,
+						group));
+		}
+	}
+
+	release_writer();
+	ASSERT_TRUE(wait_for(&served_count, GROUP_COUNT * 2));
+
+	// groups are served round-robin, in the order they became pending
+	for(int g = 0; g < GROUP_COUNT; g++) {
+		ASSERT_EQ(served[g], g * 2);
+		ASSERT_EQ(served[GROUP_COUNT + g], g * 2 + 1);
+	}
+}